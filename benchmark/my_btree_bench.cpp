@@ -0,0 +1,129 @@
+/**
+ * @file      my_btree_bench.cpp
+ * @brief     [btree_map/btree_set 与红黑树 my::map/my::set 的插入、查找、顺序遍历耗时和每元素内存对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_btree_map.h"
+#include "my_btree_set.h"
+#include "my_map.h"
+#include "my_set.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/// 用法：my_btree_bench [元素个数]
+/// 每种容器输出：随机插入 / 随机查找 / 顺序遍历 每元素耗时（ns），以及每元素占用的堆内存（字节）
+
+namespace {
+    size_t g_live_bytes = 0;
+
+    /// operator new 前面多申请一个头部记录大小，用来统计当前存活的堆内存
+    constexpr size_t kHeader = alignof(std::max_align_t);
+
+    volatile long long g_sink = 0;
+
+    /// 顺序遍历时取出 key：set 元素本身就是 key，map 元素取 first
+    long long key_of(int v) { return v; }
+
+    template<typename K, typename V>
+    long long key_of(const std::pair<K, V> &kv) { return kv.first; }
+
+    double elapsed_ns(std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        return ns.count();
+    }
+
+    template<typename Container, typename Insert, typename Lookup>
+    void run(const char *name, const std::vector<int> &keys, const std::vector<int> &probes,
+             Insert insert, Lookup lookup) {
+        size_t n = keys.size();
+        auto *c = new Container();
+        size_t bytes_empty = g_live_bytes;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int k: keys) {
+            insert(*c, k);
+        }
+        double insert_ns = elapsed_ns(start) / n;
+        double bytes_per_elem = static_cast<double>(g_live_bytes - bytes_empty) / n;
+
+        start = std::chrono::steady_clock::now();
+        long long found = 0;
+        for (int k: probes) {
+            found += lookup(*c, k);
+        }
+        double lookup_ns = elapsed_ns(start) / probes.size();
+
+        start = std::chrono::steady_clock::now();
+        long long sum = 0;
+        for (int rep = 0; rep < 5; ++rep) {
+            for (auto it = c->begin(); it != c->end(); ++it) {
+                sum += key_of(*it);
+            }
+        }
+        double scan_ns = elapsed_ns(start) / (5 * n);
+        g_sink = g_sink + found + sum;
+
+        delete c;
+        std::printf("%-28s %10.1f %10.1f %10.2f %12.1f\n", name, insert_ns, lookup_ns, scan_ns, bytes_per_elem);
+    }
+}
+
+void *operator new(size_t size) {
+    void *p = std::malloc(size + kHeader);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(p) = size;
+    g_live_bytes += size;
+    return static_cast<char *>(p) + kHeader;
+}
+
+void operator delete(void *p) noexcept {
+    if (p) {
+        char *raw = static_cast<char *>(p) - kHeader;
+        g_live_bytes -= *reinterpret_cast<size_t *>(raw);
+        std::free(raw);
+    }
+}
+
+void operator delete(void *p, size_t) noexcept {
+    ::operator delete(p);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    /// 不重复的随机 key；查找序列一半命中一半不命中
+    std::vector<int> keys(n);
+    std::iota(keys.begin(), keys.end(), 0);
+    for (auto &k: keys) {
+        k *= 2;
+    }
+    std::mt19937 rng(42);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::vector<int> probes(n);
+    for (auto &p: probes) {
+        p = static_cast<int>(rng() % (2 * n));
+    }
+
+    std::printf("%-28s %10s %10s %10s %12s\n", "container", "insert ns", "find ns", "scan ns", "bytes/elem");
+
+    auto map_insert = [](auto &m, int k) { m.insert({k, k}); };
+    auto set_insert = [](auto &s, int k) { s.insert(k); };
+    auto lookup = [](auto &c, int k) -> long long { return c.find(k) != c.end(); };
+
+    run<my::map<int, int>>("my::map<int,int> (rbtree)", keys, probes, map_insert, lookup);
+    run<my::btree_map<int, int>>("my::btree_map<int,int>", keys, probes, map_insert, lookup);
+    run<my::set<int>>("my::set<int> (rbtree)", keys, probes, set_insert, lookup);
+    run<my::btree_set<int>>("my::btree_set<int>", keys, probes, set_insert, lookup);
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file      my_concurrent_unordered_map_bench.cpp
+ * @brief     [concurrent_unordered_map 与 unordered_map + 全局互斥锁 的多线程扩展性对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_concurrent_unordered_map.h"
+#include "my_unordered_map.h"
+#include "mutex_/my_recursive_mutex.h"
+#include "mutex_/my_lock_guard.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+/// 用法：my_concurrent_unordered_map_bench [最大线程数] [每线程操作数]
+/// 线程数按 1, 2, 4 ... 递增，读比例分别为 50% / 90% / 99%
+
+namespace {
+    const int kKeySpace = 1 << 16;
+
+    /// 对照组：单张 unordered_map 外面包一把全局锁
+    struct locked_map {
+        my::mutex mtx_;
+        my::unordered_map<int, int> map_;
+
+        void write(int key, int value) {
+            my::lock_guard<my::mutex> lock(mtx_);
+            map_[key] = value;
+        }
+
+        bool read(int key) {
+            my::lock_guard<my::mutex> lock(mtx_);
+            return map_.find(key) != map_.end();
+        }
+    };
+
+    struct striped_map {
+        my::concurrent_unordered_map<int, int> map_{kKeySpace, 64};
+
+        void write(int key, int value) {
+            map_.insert_or_assign(key, value);
+        }
+
+        bool read(int key) {
+            return map_.contains(key);
+        }
+    };
+
+    /// 返回每秒操作数
+    template<typename Map>
+    double run(Map &map, int threads, int ops, int read_percent) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 rng(t + 1);
+                size_t hits = 0;
+                for (int i = 0; i < ops; ++i) {
+                    unsigned r = rng();
+                    int key = static_cast<int>(r % kKeySpace);
+                    if (static_cast<int>((r >> 16) % 100) < read_percent) {
+                        hits += map.read(key);
+                    } else {
+                        map.write(key, i);
+                    }
+                }
+                volatile size_t sink = hits;
+                (void) sink;
+            });
+        }
+        for (auto &w: workers) {
+            w.join();
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(threads) * ops / sec.count();
+    }
+
+    template<typename Map>
+    void prefill(Map &map) {
+        for (int k = 0; k < kKeySpace; k += 2) {
+            map.write(k, k);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int ops = argc > 2 ? std::atoi(argv[2]) : 200000;
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+
+    std::printf("%-8s %-8s %16s %16s %8s\n", "threads", "read%", "mutex+map ops/s", "striped ops/s", "speedup");
+    const int read_ratios[] = {50, 90, 99};
+    for (int read_percent: read_ratios) {
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            locked_map baseline;
+            striped_map striped;
+            prefill(baseline);
+            prefill(striped);
+            double a = run(baseline, threads, ops, read_percent);
+            double b = run(striped, threads, ops, read_percent);
+            std::printf("%-8d %-8d %16.0f %16.0f %7.2fx\n", threads, read_percent, a, b, b / a);
+        }
+    }
+    return 0;
+}
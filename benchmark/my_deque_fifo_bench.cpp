@@ -0,0 +1,80 @@
+/**
+ * @file      my_deque_fifo_bench.cpp
+ * @brief     [稳定状态先进先出（push_back + pop_front）的吞吐量和分配次数：my::deque（不同块大小）与 std::deque 对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_deque.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+
+/// 用法：my_deque_fifo_bench [队列长度] [操作次数]
+/// 先预热到稳定状态，再统计每次 push_back + pop_front 的耗时（ns）和这期间调用分配器的次数
+
+namespace {
+    size_t g_allocs = 0;
+    volatile long long g_sink = 0;
+
+    template<typename T>
+    struct CountingAlloc {
+        using value_type = T;
+
+        CountingAlloc() = default;
+
+        template<typename U>
+        CountingAlloc(const CountingAlloc<U> &) {}
+
+        T *allocate(size_t n) {
+            ++g_allocs;
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+        template<typename U>
+        bool operator==(const CountingAlloc<U> &) const { return true; }
+    };
+
+    template<typename Deque>
+    void run(const char *name, size_t depth, size_t ops) {
+        Deque d;
+        long long next = 0;
+        for (size_t i = 0; i < depth; ++i) {
+            d.push_back(next++);
+        }
+        /// 预热：队列整体向后移动几圈，map 和备用块缓存都稳定下来
+        for (size_t i = 0; i < depth * 4 + 100000; ++i) {
+            d.push_back(next++);
+            g_sink = g_sink + d.front();
+            d.pop_front();
+        }
+        size_t allocsBefore = g_allocs;
+        auto start = std::chrono::steady_clock::now();
+        long long sum = 0;
+        for (size_t i = 0; i < ops; ++i) {
+            d.push_back(next++);
+            sum += d.front();
+            d.pop_front();
+        }
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        g_sink = g_sink + sum;
+        std::printf("%-32s %12.2f %14zu\n", name, ns.count() / ops, g_allocs - allocsBefore);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t depth = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    size_t ops = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50000000;
+    std::printf("depth = %zu, ops = %zu\n", depth, ops);
+    std::printf("%-32s %12s %14s\n", "container", "ns/op", "allocations");
+    run<std::deque<long long, CountingAlloc<long long>>>("std::deque", depth, ops);
+    run<my::deque<long long, CountingAlloc<long long>>>("my::deque (512 per chunk)", depth, ops);
+    run<my::deque<long long, CountingAlloc<long long>, 64>>("my::deque (64 per chunk)", depth, ops);
+    run<my::deque<long long, CountingAlloc<long long>, 4096>>("my::deque (4096 per chunk)", depth, ops);
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file      my_flat_map_bench.cpp
+ * @brief     [flat_map 与 my::map / my::unordered_map 的构建、查找吞吐和每元素内存对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_flat_map.h"
+#include "my_map.h"
+#include "my_unordered_map.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// 用法：my_flat_map_bench [元素个数]
+/// 分别在给定元素个数（默认 1M，远大于缓存）和 4096 个元素（能放进 L1/L2）下，输出每种容器：
+/// 构建每元素耗时（ns）、随机查找每次耗时（ns，一半命中）、每元素占用的堆内存（字节）
+
+namespace {
+    size_t g_live_bytes = 0;
+
+    /// operator new 前面多申请一个头部记录大小，用来统计当前存活的堆内存
+    constexpr size_t kHeader = alignof(std::max_align_t);
+
+    volatile long long g_sink = 0;
+
+    double elapsed_ns(std::chrono::steady_clock::time_point start) {
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        return ns.count();
+    }
+
+    /// build 在 c 中放入全部 kv，lookup 返回是否找到
+    template<typename Container, typename Build, typename Lookup>
+    void run(const char *name, const std::vector<std::pair<int, int>> &kvs, const std::vector<int> &probes,
+             Build build, Lookup lookup) {
+        size_t n = kvs.size();
+        auto *c = new Container();
+        size_t bytes_empty = g_live_bytes;
+
+        auto start = std::chrono::steady_clock::now();
+        build(*c, kvs);
+        double build_ns = elapsed_ns(start) / n;
+        double bytes_per_elem = static_cast<double>(g_live_bytes - bytes_empty) / n;
+
+        start = std::chrono::steady_clock::now();
+        long long found = 0;
+        for (int k: probes) {
+            found += lookup(*c, k);
+        }
+        double lookup_ns = elapsed_ns(start) / probes.size();
+        g_sink = g_sink + found;
+
+        delete c;
+        std::printf("%-36s %10.1f %10.1f %12.1f\n", name, build_ns, lookup_ns, bytes_per_elem);
+    }
+
+    void run_all(size_t n, size_t probe_count) {
+        /// 不重复的随机 key（偶数），查找序列一半命中一半不命中
+        std::vector<std::pair<int, int>> kvs(n);
+        for (size_t i = 0; i < n; ++i) {
+            kvs[i] = {static_cast<int>(i) * 2, static_cast<int>(i)};
+        }
+        std::mt19937 rng(42);
+        std::shuffle(kvs.begin(), kvs.end(), rng);
+        std::vector<int> probes(probe_count);
+        for (auto &p: probes) {
+            p = static_cast<int>(rng() % (2 * n));
+        }
+
+        std::printf("\n%zu elements\n", n);
+        std::printf("%-36s %10s %10s %12s\n", "container", "build ns", "find ns", "bytes/elem");
+
+        auto insert_each = [](auto &m, const std::vector<std::pair<int, int>> &src) {
+            for (const auto &kv: src) {
+                m.insert(kv);
+            }
+        };
+        auto find = [](auto &m, int k) -> long long { return m.find(k) != m.end(); };
+
+        run<my::map<int, int>>("my::map<int,int> (rbtree)", kvs, probes, insert_each, find);
+        run<my::unordered_map<int, int>>("my::unordered_map<int,int>", kvs, probes, insert_each, find);
+        run<my::flat_map<int, int>>("my::flat_map<int,int> (bulk insert)", kvs, probes,
+                                    [](auto &m, const std::vector<std::pair<int, int>> &src) {
+                                        m.insert(src.begin(), src.end());
+                                    }, find);
+        /// 同样的 key 数组，改用有分支的 std::lower_bound，对比无分支二分
+        run<my::flat_map<int, int>>("my::flat_map keys + std::lower_bound", kvs, probes,
+                                    [](auto &m, const std::vector<std::pair<int, int>> &src) {
+                                        m.insert(src.begin(), src.end());
+                                    },
+                                    [](auto &m, int k) -> long long {
+                                        const auto &keys = m.keys();
+                                        auto it = std::lower_bound(keys.begin(), keys.end(), k);
+                                        return it != keys.end() && *it == k;
+                                    });
+    }
+}
+
+/// 替换版 operator new/delete 不允许内联：否则 g++ 会把内联后的 free 与调用方的
+/// ::operator new 配对，误报 -Wmismatched-new-delete / -Warray-bounds
+[[gnu::noinline]] void *operator new(size_t size) {
+    void *p = std::malloc(size + kHeader);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t *>(p) = size;
+    g_live_bytes += size;
+    return static_cast<char *>(p) + kHeader;
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    if (p) {
+        char *raw = static_cast<char *>(p) - kHeader;
+        g_live_bytes -= *reinterpret_cast<size_t *>(raw);
+        std::free(raw);
+    }
+}
+
+void operator delete(void *p, size_t) noexcept {
+    ::operator delete(p);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    run_all(n, 2000000);
+    run_all(4096, 2000000);
+    return 0;
+}
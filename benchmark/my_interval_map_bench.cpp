@@ -0,0 +1,107 @@
+/**
+ * @file      my_interval_map_bench.cpp
+ * @brief     [interval_map 的区间重叠 / 点查询与扫描 multiset 的耗时对比，以及维护 _max 对插入的额外开销]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_interval_map.h"
+#include "my_multiset.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// 用法：my_interval_map_bench [区间个数]
+/// 区间左端点均匀分布在 [0, 100 * n)，长度 0 ~ 1000，输出每次操作的平均耗时（us）
+
+namespace {
+    volatile size_t g_sink = 0;
+
+    template<typename F>
+    double time_us(size_t ops, F &&f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+        return us.count() / ops;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937 rng(5);
+    std::vector<std::pair<my::interval<long>, int>> items;
+    for (size_t i = 0; i < n; ++i) {
+        long low = static_cast<long>(rng() % (100 * n));
+        items.push_back({{low, low + static_cast<long>(rng() % 1000)}, static_cast<int>(i)});
+    }
+
+    my::interval_map<long, int> m;
+    double insertMap = time_us(n, [&]() {
+        for (auto &item: items) {
+            m.insert(item);
+        }
+    });
+    my::multiset<std::pair<long, long>> plain;
+    double insertSet = time_us(n, [&]() {
+        for (auto &item: items) {
+            plain.insert({item.first.low, item.first.high});
+        }
+    });
+
+    std::vector<std::pair<my::interval<long>, int>> sorted = items;
+    std::sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) {
+        return a.first.low < b.first.low || (a.first.low == b.first.low && a.first.high < b.first.high);
+    });
+    my::interval_map<long, int> built;
+    double build = time_us(n, [&]() {
+        built = my::interval_map<long, int>(my::sorted_equivalent, sorted.begin(), sorted.end());
+    });
+
+    size_t queries = 100000;
+    std::vector<long> points(queries);
+    for (auto &p: points) {
+        p = static_cast<long>(rng() % (100 * n));
+    }
+    double stab = time_us(queries, [&]() {
+        size_t hits = 0;
+        for (long p: points) {
+            for (auto &kv: m.stabbing(p)) {
+                hits += static_cast<size_t>(kv.second) & 1;
+            }
+        }
+        g_sink = g_sink + hits;
+    });
+    double range = time_us(queries, [&]() {
+        size_t hits = 0;
+        for (long p: points) {
+            for (auto &kv: m.overlapping(p, p + 5000)) {
+                hits += static_cast<size_t>(kv.second) & 1;
+            }
+        }
+        g_sink = g_sink + hits;
+    });
+    size_t scanQueries = 20;
+    double scan = time_us(scanQueries, [&]() {
+        size_t hits = 0;
+        for (size_t q = 0; q < scanQueries; ++q) {
+            for (auto &iv: plain) {
+                hits += iv.first <= points[q] && iv.second >= points[q];
+            }
+        }
+        g_sink = g_sink + hits;
+    });
+
+    std::printf("%-40s %12s\n", "operation", "us/op");
+    std::printf("%-40s %12.3f\n", "interval_map insert", insertMap);
+    std::printf("%-40s %12.3f\n", "multiset<pair> insert", insertSet);
+    std::printf("%-40s %12.3f\n", "interval_map sorted build (per element)", build);
+    std::printf("%-40s %12.3f\n", "interval_map stabbing(point)", stab);
+    std::printf("%-40s %12.3f\n", "interval_map overlapping(p, p + 5000)", range);
+    std::printf("%-40s %12.3f\n", "multiset scan for one point", scan);
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file      my_list_sort_bench.cpp
+ * @brief     [节点在堆里随机散落时 my::list 三种排序方式的对比，以及带预取的 unique / remove_if / merge，std::list 作参照]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_list.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <thread>
+
+/// 用法：my_list_sort_bench [元素个数]，默认 1000 万个 int
+/// 刚 push_back 出来的链表节点在内存中基本是按顺序排的，遍历时硬件预取就能猜中下一个节点，测不出真实情况
+/// 所以先按随机值排一次序打乱链接顺序，再重新填一遍随机值：之后顺着链表走，每一步都跳到堆里一个随机的位置
+/// 每一项都重新构造链表，只统计操作本身的时间，单位是 ns / 元素
+
+namespace {
+    volatile long long g_sink = 0;
+
+    using clock_type = std::chrono::steady_clock;
+
+    double ns_since(clock_type::time_point start, size_t n) {
+        std::chrono::duration<double, std::nano> ns = clock_type::now() - start;
+        return ns.count() / n;
+    }
+
+    /// 构造链接顺序和地址顺序无关的链表，valueRange 为 0 时取任意 int
+    template<typename List>
+    void make_scattered(List &lst, size_t n, unsigned seed, unsigned valueRange = 0) {
+        std::mt19937 rng(seed);
+        for (size_t i = 0; i < n; ++i) {
+            lst.push_back(static_cast<int>(rng()));
+        }
+        lst.sort();
+        for (auto &v : lst) {
+            unsigned r = rng();
+            v = static_cast<int>(valueRange ? r % valueRange : r);
+        }
+    }
+
+    template<typename List>
+    long long checksum(List &lst) {
+        long long sum = 0;
+        for (int v : lst) {
+            sum = sum * 31 + v;
+        }
+        return sum;
+    }
+
+    template<typename List, typename Sort>
+    double time_sort(size_t n, Sort sort) {
+        List lst;
+        make_scattered(lst, n, 1);
+        auto start = clock_type::now();
+        sort(lst);
+        double ns = ns_since(start, n);
+        g_sink = g_sink + checksum(lst);
+        return ns;
+    }
+
+    /// 排好序且有大量重复值的链表去重（节点仍然散落）
+    template<typename List>
+    double time_unique(size_t n) {
+        List lst;
+        make_scattered(lst, n, 2, static_cast<unsigned>(n / 2));
+        lst.sort();
+        auto start = clock_type::now();
+        lst.unique();
+        double ns = ns_since(start, n);
+        g_sink = g_sink + checksum(lst);
+        return ns;
+    }
+
+    /// 删掉一半（奇数）
+    template<typename List>
+    double time_remove_if(size_t n) {
+        List lst;
+        make_scattered(lst, n, 3);
+        auto start = clock_type::now();
+        lst.remove_if([](int v) { return v & 1; });
+        double ns = ns_since(start, n);
+        g_sink = g_sink + checksum(lst);
+        return ns;
+    }
+
+    /// 两个各 n / 2 个元素的有序链表合并
+    template<typename List>
+    double time_merge(size_t n) {
+        List a;
+        List b;
+        make_scattered(a, n / 2, 4);
+        make_scattered(b, n - n / 2, 5);
+        a.sort();
+        b.sort();
+        auto start = clock_type::now();
+        a.merge(b);
+        double ns = ns_since(start, n);
+        g_sink = g_sink + checksum(a);
+        return ns;
+    }
+
+    void print_row(const char *name, double ns) {
+        std::printf("%-40s %12.2f\n", name, ns);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    std::printf("elements = %zu (int, scattered nodes), hardware threads = %u, times in ns per element\n", n,
+                std::thread::hardware_concurrency());
+
+    std::printf("\n%-40s %12s\n", "sort", "ns / elem");
+    print_row("std::list::sort", time_sort<std::list<int>>(n, [](auto &l) { l.sort(); }));
+    print_row("my::list sort(merge)", time_sort<my::list<int>>(n, [](auto &l) {
+        l.sort(my::list_sort_mode::merge);
+    }));
+    print_row("my::list sort(gather), radix", time_sort<my::list<int>>(n, [](auto &l) {
+        l.sort(my::list_sort_mode::gather);
+    }));
+    print_row("my::list sort(gather), stable_sort", time_sort<my::list<int>>(n, [](auto &l) {
+        l.sort(my::list_sort_mode::gather, [](int a, int b) { return a < b; });
+    }));
+    print_row("my::list sort(parallel)", time_sort<my::list<int>>(n, [](auto &l) {
+        l.sort(my::list_sort_mode::parallel);
+    }));
+    print_row("my::list parallel_sort(4), stable_sort", time_sort<my::list<int>>(n, [](auto &l) {
+        l.parallel_sort(4, [](int a, int b) { return a < b; });
+    }));
+
+    std::printf("\n%-40s %12s %12s\n", "algorithm", "std::list", "my::list");
+    std::printf("%-40s %12.2f %12.2f\n", "unique", time_unique<std::list<int>>(n), time_unique<my::list<int>>(n));
+    std::printf("%-40s %12.2f %12.2f\n", "remove_if (half)", time_remove_if<std::list<int>>(n),
+                time_remove_if<my::list<int>>(n));
+    std::printf("%-40s %12.2f %12.2f\n", "merge", time_merge<std::list<int>>(n), time_merge<my::list<int>>(n));
+    return 0;
+}
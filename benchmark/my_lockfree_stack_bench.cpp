@@ -0,0 +1,135 @@
+/**
+ * @file      my_lockfree_stack_bench.cpp
+ * @brief     [共享空闲链表的竞争测试：多个线程反复借出归还对象，lockfree_stack 与 mutex 保护的 my::stack 对比；以及 chain 批量入栈与逐个入栈对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_lockfree_stack.h"
+#include "my_stack.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// 用法：my_lockfree_stack_bench [每个线程的借还次数] [对象个数]
+/// 每个线程循环：从空闲链表弹出一个对象，做一点点工作，再压回去；统计所有线程每秒完成的借还次数
+/// 对象个数远小于线程数时栈顶竞争最激烈
+
+namespace {
+    volatile long long g_sink = 0;
+
+    /// 对照组：mutex 保护的 my::stack
+    class locked_stack {
+    public:
+        void push(int v) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stack_.push(v);
+        }
+
+        bool try_pop(int &out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stack_.empty()) {
+                return false;
+            }
+            out = stack_.top();
+            stack_.pop();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        my::stack<int> stack_;
+    };
+
+    template<typename Stack>
+    double borrow_return(int threads, size_t rounds, int objects) {
+        Stack freeList;
+        for (int i = 0; i < objects; ++i) {
+            freeList.push(i);
+        }
+        std::vector<std::thread> pool;
+        std::vector<long long> sums(threads, 0);
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                long long sum = 0;
+                int id = 0;
+                for (size_t i = 0; i < rounds;) {
+                    if (!freeList.try_pop(id)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    sum += id * 31 + static_cast<long long>(i);
+                    freeList.push(id);
+                    ++i;
+                }
+                sums[t] = sum;
+            });
+        }
+        for (auto &th : pool) {
+            th.join();
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        for (long long s : sums) {
+            g_sink = g_sink + s;
+        }
+        return threads * rounds / sec.count();
+    }
+
+    /// 单线程：每次压入 64 个元素再全部取走，chain 一次 CAS 与 64 次 push 对比
+    void bulk_push(size_t rounds) {
+        constexpr int kBatch = 64;
+        my::lockfree_stack<int> s;
+        long long sum = 0;
+        int v = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (int i = 0; i < kBatch; ++i) {
+                s.push(i);
+            }
+            auto all = s.pop_all();
+            while (all.try_pop(v)) {
+                sum += v;
+            }
+        }
+        std::chrono::duration<double, std::nano> single = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            auto c = s.make_chain();
+            for (int i = 0; i < kBatch; ++i) {
+                c.push(i);
+            }
+            s.push_chain(std::move(c));
+            auto all = s.pop_all();
+            while (all.try_pop(v)) {
+                sum += v;
+            }
+        }
+        std::chrono::duration<double, std::nano> chained = std::chrono::steady_clock::now() - start;
+        g_sink = g_sink + sum;
+        std::printf("\nbulk push of %d elements (ns per element, single thread)\n", kBatch);
+        std::printf("%-24s %12.2f\n", "push one by one", single.count() / (rounds * kBatch));
+        std::printf("%-24s %12.2f\n", "chain + push_chain", chained.count() / (rounds * kBatch));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    int objects = argc > 2 ? std::atoi(argv[2]) : 4;
+    std::printf("rounds per thread = %zu, objects = %d, hardware threads = %u\n", rounds, objects,
+                std::thread::hardware_concurrency());
+    std::printf("%-10s %24s %24s\n", "threads", "mutex + my::stack (op/s)", "lockfree_stack (op/s)");
+    for (int threads : {1, 2, 4, 8, 16}) {
+        double locked = borrow_return<locked_stack>(threads, rounds, objects);
+        double lockfree = borrow_return<my::lockfree_stack<int>>(threads, rounds, objects);
+        std::printf("%-10d %24.3e %24.3e\n", threads, locked, lockfree);
+    }
+    bulk_push(rounds / 10 + 1);
+    return 0;
+}
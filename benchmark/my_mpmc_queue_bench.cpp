@@ -0,0 +1,131 @@
+/**
+ * @file      my_mpmc_queue_bench.cpp
+ * @brief     [多生产者多消费者吞吐量：mpmc_queue（自旋 / 阻塞）与 mutex + condition_variable 保护的 my::queue 对比，1P1C 到 16P16C]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_mpmc_queue.h"
+#include "my_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// 用法：my_mpmc_queue_bench [消息总数] [队列容量]
+/// N 个生产者和 N 个消费者（N = 1, 2, 4, 8, 16），每个生产者发 总数 / N 条，每个消费者收 总数 / N 条，统计每秒传递的消息数
+/// 对照组用 std::mutex / std::condition_variable：本库的 my::condition_variable 目前只有 Windows 实现
+
+namespace {
+    volatile long long g_sink = 0;
+
+    /// mutex + condition_variable 保护的 my::queue，即现有的做法
+    class locked_queue {
+    public:
+        explicit locked_queue(size_t capacity) : capacity_(capacity) {}
+
+        void push(long long v) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notFull_.wait(lock, [&] { return queue_.size() < capacity_; });
+            queue_.push(v);
+            notEmpty_.notify_one();
+        }
+
+        void pop(long long &out) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [&] { return !queue_.empty(); });
+            out = queue_.front();
+            queue_.pop();
+            notFull_.notify_one();
+        }
+
+    private:
+        size_t capacity_;
+        std::mutex mutex_;
+        std::condition_variable notEmpty_;
+        std::condition_variable notFull_;
+        my::queue<long long> queue_;
+    };
+
+    /// 非阻塞队列的等待方式由调用方决定：这里自旋，spin_backoff 到一定次数后让出时间片
+    struct spin_ops {
+        template<typename Q>
+        static void push(Q &q, long long v) {
+            for (unsigned spin = 0; !q.try_push(v); ++spin) {
+                my::detail::spin_backoff(spin);
+            }
+        }
+
+        template<typename Q>
+        static void pop(Q &q, long long &out) {
+            for (unsigned spin = 0; !q.try_pop(out); ++spin) {
+                my::detail::spin_backoff(spin);
+            }
+        }
+    };
+
+    struct blocking_ops {
+        template<typename Q>
+        static void push(Q &q, long long v) { q.push(v); }
+
+        template<typename Q>
+        static void pop(Q &q, long long &out) { q.pop(out); }
+    };
+
+    template<typename Queue, typename Ops>
+    double throughput(int pairs, size_t messages, size_t capacity) {
+        Queue q(capacity);
+        size_t perThread = messages / pairs;
+        std::vector<std::thread> threads;
+        std::vector<long long> sums(pairs, 0);
+        auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < pairs; ++p) {
+            threads.emplace_back([&] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    Ops::push(q, static_cast<long long>(i));
+                }
+            });
+        }
+        for (int c = 0; c < pairs; ++c) {
+            threads.emplace_back([&, c] {
+                long long v = 0;
+                long long sum = 0;
+                for (size_t i = 0; i < perThread; ++i) {
+                    Ops::pop(q, v);
+                    sum += v;
+                }
+                sums[c] = sum;
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        for (long long s : sums) {
+            g_sink = g_sink + s;
+        }
+        return perThread * pairs / sec.count();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    size_t capacity = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024;
+    std::printf("messages = %zu, capacity = %zu, hardware threads = %u\n",
+                messages, capacity, std::thread::hardware_concurrency());
+    std::printf("%-10s %22s %22s %22s\n", "threads", "mutex + condvar (msg/s)", "mpmc spin (msg/s)",
+                "mpmc blocking (msg/s)");
+    for (int pairs : {1, 2, 4, 8, 16}) {
+        char label[16];
+        std::snprintf(label, sizeof(label), "%dP%dC", pairs, pairs);
+        double locked = throughput<locked_queue, blocking_ops>(pairs, messages, capacity);
+        double spin = throughput<my::mpmc_queue<long long>, spin_ops>(pairs, messages, capacity);
+        double blocking = throughput<my::mpmc_queue<long long, true>, blocking_ops>(pairs, messages, capacity);
+        std::printf("%-10s %22.3e %22.3e %22.3e\n", label, locked, spin, blocking);
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file      my_order_statistic_bench.cpp
+ * @brief     [顺序统计红黑树：维护子树大小对插入/删除的额外开销，以及 select/rank 与逐个前进的对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_multiset.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/// 用法：my_order_statistic_bench [元素个数]
+/// 输出每次操作的平均耗时（ns）
+
+namespace {
+    volatile size_t g_sink = 0;
+
+    template<typename F>
+    double time_ns(size_t ops, F &&f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        return ns.count() / ops;
+    }
+
+    /// 同一组操作分别在普通 multiset 和 order_statistic_multiset 上执行
+    template<typename Set>
+    void run_updates(const char *name, const std::vector<int> &keys) {
+        size_t n = keys.size();
+        Set s;
+        double insert = time_ns(n, [&]() {
+            for (int k: keys) {
+                s.insert(k);
+            }
+        });
+        Set appended;
+        double append = time_ns(n, [&]() {
+            for (size_t i = 0; i < n; ++i) {
+                appended.insert(appended.end(), static_cast<int>(i));
+            }
+        });
+        double erase = time_ns(n / 2, [&]() {
+            for (size_t i = 0; i < n / 2; ++i) {
+                s.erase(s.find(keys[i]));
+            }
+        });
+        g_sink = g_sink + s.size() + appended.size();
+        std::printf("%-28s %12.1f %12.1f %12.1f\n", name, insert, append, erase);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937 rng(12345);
+    std::vector<int> keys(n);
+    for (auto &k: keys) {
+        k = static_cast<int>(rng() % (n * 4));
+    }
+
+    std::printf("%-28s %12s %12s %12s\n", "update cost (ns/op)", "rand insert", "hint append", "erase(it)");
+    run_updates<my::multiset<int>>("my::multiset", keys);
+    run_updates<my::order_statistic_multiset<int>>("my::order_statistic_multiset", keys);
+
+    /// 查询：第 k 小 / 名次。普通 multiset 只能从 begin() 走 k 步，查询次数少一些
+    my::multiset<int> plain;
+    my::order_statistic_multiset<int> os;
+    for (int k: keys) {
+        plain.insert(k);
+        os.insert(k);
+    }
+    size_t linearQueries = 200;
+    size_t queries = 1000000;
+    std::vector<size_t> ranks(queries);
+    for (auto &r: ranks) {
+        r = rng() % n;
+    }
+
+    std::printf("\n%-28s %12s\n", "query cost (ns/op)", "");
+    double advance = time_ns(linearQueries, [&]() {
+        for (size_t i = 0; i < linearQueries; ++i) {
+            auto it = plain.begin();
+            for (size_t k = 0; k < ranks[i]; ++k) {
+                ++it;
+            }
+            g_sink = g_sink + *it;
+        }
+    });
+    std::printf("%-28s %12.1f\n", "++begin() k times", advance);
+    double select = time_ns(queries, [&]() {
+        for (size_t r: ranks) {
+            g_sink = g_sink + *os.select(r);
+        }
+    });
+    std::printf("%-28s %12.1f\n", "select(k)", select);
+    double rank = time_ns(queries, [&]() {
+        for (size_t i = 0; i < queries; ++i) {
+            g_sink = g_sink + os.rank(keys[i % n]);
+        }
+    });
+    std::printf("%-28s %12.1f\n", "rank(key)", rank);
+    return 0;
+}
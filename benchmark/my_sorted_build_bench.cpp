@@ -0,0 +1,90 @@
+/**
+ * @file      my_sorted_build_bench.cpp
+ * @brief     [从有序输入构建 map / btree_map：逐个插入、带提示插入与 sorted_unique 批量构建的耗时对比，检查默认 map 的带提示追加没有为子树大小付出代价]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_map.h"
+#include "my_btree_map.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// 用法：my_sorted_build_bench [元素个数]
+/// 输出每种构建方式的每元素耗时（ns），只计构建，容器的析构不计时
+/// 默认的 map 不维护子树大小，insert(end(), v) 均摊 O(1)；order_statistic_map 每次插入都要把计数更新到根，O(log n)
+/// 前者不比后者明显快时说明默认 map 又开始为顺序统计付出代价，输出 REGRESSION 并返回非零
+
+namespace {
+    volatile size_t g_sink = 0;
+
+    /// build 返回堆上的容器，计时结束之后再释放
+    template<typename Build>
+    double measure(const char *name, size_t n, Build &&build) {
+        auto start = std::chrono::steady_clock::now();
+        auto container = build();
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        g_sink = g_sink + container->size();
+        std::printf("%-44s %10.1f\n", name, ns.count() / n);
+        return ns.count() / n;
+    }
+
+    template<typename Map>
+    std::unique_ptr<Map> append_with_hint(const std::vector<std::pair<long, long>> &sorted) {
+        auto m = std::make_unique<Map>();
+        for (const auto &kv: sorted) {
+            m->insert(m->end(), kv);
+        }
+        return m;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::vector<std::pair<long, long>> sorted;
+    sorted.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        sorted.emplace_back(static_cast<long>(i) * 3, static_cast<long>(i));
+    }
+
+    std::printf("%-44s %10s\n", "build from sorted input", "ns/elem");
+
+    measure("my::map  InputIt ctor (insert one by one)", n, [&]() {
+        return std::make_unique<my::map<long, long>>(sorted.begin(), sorted.end());
+    });
+    double plainAppend = measure("my::map  insert(end(), v)", n, [&]() {
+        return append_with_hint<my::map<long, long>>(sorted);
+    });
+    double augmentedAppend = measure("my::order_statistic_map  insert(end(), v)", n, [&]() {
+        return append_with_hint<my::order_statistic_map<long, long>>(sorted);
+    });
+    measure("my::map  sorted_unique ctor", n, [&]() {
+        return std::make_unique<my::map<long, long>>(my::sorted_unique, sorted.begin(), sorted.end());
+    });
+    measure("my::map  insert_sorted into half-full map", n, [&]() {
+        size_t half = n / 2;
+        auto m = std::make_unique<my::map<long, long>>(my::sorted_unique, sorted.begin(), sorted.begin() + half);
+        m->insert_sorted(sorted.begin() + half, sorted.end());
+        return m;
+    });
+    measure("my::btree_map  InputIt ctor", n, [&]() {
+        return std::make_unique<my::btree_map<long, long>>(sorted.begin(), sorted.end());
+    });
+    measure("my::btree_map  sorted_unique ctor", n, [&]() {
+        return std::make_unique<my::btree_map<long, long>>(my::sorted_unique, sorted.begin(), sorted.end());
+    });
+
+    /// 阈值留足余量：正常情况下两者相差 2 倍以上，只有默认 map 也走到根时才会接近 1
+    double ratio = augmentedAppend / plainAppend;
+    std::printf("\nhinted append, order_statistic_map / map: %.2fx\n", ratio);
+    if (n >= 100000 && ratio < 1.3) {
+        std::printf("REGRESSION: my::map hinted append is no faster than the size-augmented tree\n");
+        return 1;
+    }
+    return 0;
+}
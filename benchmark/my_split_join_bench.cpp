@@ -0,0 +1,99 @@
+/**
+ * @file      my_split_join_bench.cpp
+ * @brief     [map 的 split / join / 区间删除与逐个转移、逐个删除的耗时对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_map.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+/// 用法：my_split_join_bench [元素个数]
+/// 输出每次操作的平均耗时（us）
+
+namespace {
+    volatile size_t g_sink = 0;
+
+    template<typename F>
+    double time_us(size_t ops, F &&f) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+        return us.count() / ops;
+    }
+
+    my::map<int, int> build(size_t n) {
+        std::vector<std::pair<int, int>> sorted;
+        for (size_t i = 0; i < n; ++i) {
+            sorted.emplace_back(static_cast<int>(i), static_cast<int>(i));
+        }
+        return my::map<int, int>(my::sorted_unique, sorted.begin(), sorted.end());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937 rng(3);
+    my::map<int, int> m = build(n);
+
+    /// 在随机位置拆开再接回去
+    size_t rounds = 10000;
+    double splitJoin = time_us(rounds, [&]() {
+        for (size_t i = 0; i < rounds; ++i) {
+            my::map<int, int> upper = m.split(static_cast<int>(rng() % n));
+            m.join(upper);
+        }
+    });
+    g_sink = g_sink + m.size();
+
+    /// 同样的事情用 extract + insert 逐个转移后半部分
+    size_t slowRounds = 3;
+    double moveEach = time_us(slowRounds, [&]() {
+        for (size_t i = 0; i < slowRounds; ++i) {
+            my::map<int, int> upper;
+            for (auto it = m.find(static_cast<int>(n / 2)); it != m.end();) {
+                auto cur = it;
+                ++it;
+                upper.insert(m.extract(cur));
+            }
+            m.merge(upper);
+        }
+    });
+
+    std::printf("%-36s %12s\n", "operation (n = map size)", "us/op");
+    std::printf("%-36s %12.2f\n", "split(random key) + join", splitJoin);
+    std::printf("%-36s %12.2f\n", "extract/insert n/2 + merge back", moveEach);
+
+    /// 删除一段连续的 k 个元素
+    for (size_t k: {size_t(16), size_t(1024), size_t(65536)}) {
+        my::map<int, int> a = build(n);
+        my::map<int, int> b = build(n);
+        size_t ops = 20;
+        double range = time_us(ops, [&]() {
+            for (size_t i = 0; i < ops; ++i) {
+                auto first = a.lower_bound(static_cast<int>(i * (n / ops)));
+                auto last = a.lower_bound(static_cast<int>(i * (n / ops) + k));
+                a.erase(first, last);
+            }
+        });
+        double each = time_us(ops, [&]() {
+            for (size_t i = 0; i < ops; ++i) {
+                auto it = b.lower_bound(static_cast<int>(i * (n / ops)));
+                auto last = b.lower_bound(static_cast<int>(i * (n / ops) + k));
+                while (it != last) {
+                    it = b.erase(it);
+                }
+            }
+        });
+        g_sink = g_sink + a.size() + b.size();
+        std::printf("erase(first, last) k = %-14zu %12.2f\n", k, range);
+        std::printf("erase(it) loop     k = %-14zu %12.2f\n", k, each);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file      my_spsc_queue_bench.cpp
+ * @brief     [两个线程之间传递消息：乒乓往返延迟和单向吞吐量，spsc_queue（自旋 / 阻塞 / 批量）与 mutex + condition_variable 保护的 my::queue 对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_queue.h"
+#include "my_spsc_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+/// 用法：my_spsc_queue_bench [往返次数] [吞吐量测试的消息数]
+/// 乒乓：主线程发一条消息，对端收到后原样发回，统计一次往返的平均耗时（ns）
+/// 吞吐量：一个线程不停地发，另一个线程不停地收，统计每秒传递的消息数
+/// 对照组用 std::mutex / std::condition_variable：本库的 my::condition_variable 目前只有 Windows 实现
+
+namespace {
+    volatile long long g_sink = 0;
+
+    /// mutex + condition_variable 保护的 my::queue，即现有的做法
+    class locked_queue {
+    public:
+        explicit locked_queue(size_t capacity) : capacity_(capacity) {}
+
+        void push(long long v) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notFull_.wait(lock, [&] { return queue_.size() < capacity_; });
+            queue_.push(v);
+            notEmpty_.notify_one();
+        }
+
+        void pop(long long &out) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [&] { return !queue_.empty(); });
+            out = queue_.front();
+            queue_.pop();
+            notFull_.notify_one();
+        }
+
+    private:
+        size_t capacity_;
+        std::mutex mutex_;
+        std::condition_variable notEmpty_;
+        std::condition_variable notFull_;
+        my::queue<long long> queue_;
+    };
+
+    /// 非阻塞队列的等待方式由调用方决定：这里自旋，spin_backoff 到一定次数后让出时间片
+    template<typename Queue>
+    void spin_push(Queue &q, long long v) {
+        for (unsigned spin = 0; !q.try_push(v); ++spin) {
+            my::detail::spin_backoff(spin);
+        }
+    }
+
+    template<typename Queue>
+    void spin_pop(Queue &q, long long &out) {
+        for (unsigned spin = 0; !q.try_pop(out); ++spin) {
+            my::detail::spin_backoff(spin);
+        }
+    }
+
+    struct spin_ops {
+        template<typename Q>
+        static void push(Q &q, long long v) { spin_push(q, v); }
+
+        template<typename Q>
+        static void pop(Q &q, long long &out) { spin_pop(q, out); }
+    };
+
+    struct blocking_ops {
+        template<typename Q>
+        static void push(Q &q, long long v) { q.push(v); }
+
+        template<typename Q>
+        static void pop(Q &q, long long &out) { q.pop(out); }
+    };
+
+    template<typename Queue, typename Ops>
+    double ping_pong_ns(size_t rounds) {
+        Queue ping(1024);
+        Queue pong(1024);
+        std::thread echo([&] {
+            long long v = 0;
+            for (size_t i = 0; i < rounds; ++i) {
+                Ops::pop(ping, v);
+                Ops::push(pong, v + 1);
+            }
+        });
+        auto start = std::chrono::steady_clock::now();
+        long long v = 0;
+        for (size_t i = 0; i < rounds; ++i) {
+            Ops::push(ping, v);
+            Ops::pop(pong, v);
+        }
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        echo.join();
+        g_sink = g_sink + v;
+        return ns.count() / rounds;
+    }
+
+    template<typename Queue, typename Ops>
+    double throughput(size_t messages) {
+        Queue q(4096);
+        auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] {
+            for (size_t i = 0; i < messages; ++i) {
+                Ops::push(q, static_cast<long long>(i));
+            }
+        });
+        long long sum = 0;
+        long long v = 0;
+        for (size_t i = 0; i < messages; ++i) {
+            Ops::pop(q, v);
+            sum += v;
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        producer.join();
+        g_sink = g_sink + sum;
+        return messages / sec.count();
+    }
+
+    /// 每次搬运 32 条消息，只发布一次下标
+    template<typename Queue>
+    double throughput_batch(size_t messages) {
+        constexpr size_t kBatch = 32;
+        Queue q(4096);
+        auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] {
+            long long buf[kBatch];
+            size_t sent = 0;
+            unsigned spin = 0;
+            while (sent < messages) {
+                size_t n = messages - sent < kBatch ? messages - sent : kBatch;
+                for (size_t i = 0; i < n; ++i) {
+                    buf[i] = static_cast<long long>(sent + i);
+                }
+                size_t pushed = q.try_push_n(buf, n);
+                sent += pushed;
+                if (pushed == 0) {
+                    my::detail::spin_backoff(spin++);
+                } else {
+                    spin = 0;
+                }
+            }
+        });
+        long long sum = 0;
+        long long buf[kBatch];
+        size_t received = 0;
+        unsigned spin = 0;
+        while (received < messages) {
+            size_t got = q.try_pop_n(buf, kBatch);
+            for (size_t i = 0; i < got; ++i) {
+                sum += buf[i];
+            }
+            received += got;
+            if (got == 0) {
+                my::detail::spin_backoff(spin++);
+            } else {
+                spin = 0;
+            }
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        producer.join();
+        g_sink = g_sink + sum;
+        return messages / sec.count();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t rounds = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t messages = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000000;
+    std::printf("round trips = %zu, messages = %zu, hardware threads = %u\n",
+                rounds, messages, std::thread::hardware_concurrency());
+    std::printf("%-36s %16s %18s\n", "queue", "round trip (ns)", "messages / s");
+
+    using spin_queue = my::spsc_queue<long long>;
+    using blocking_queue = my::spsc_queue<long long, true>;
+    std::printf("%-36s %16.1f %18.3e\n", "mutex + condvar + my::queue",
+                ping_pong_ns<locked_queue, blocking_ops>(rounds), throughput<locked_queue, blocking_ops>(messages));
+    std::printf("%-36s %16.1f %18.3e\n", "spsc_queue (spin)",
+                ping_pong_ns<spin_queue, spin_ops>(rounds), throughput<spin_queue, spin_ops>(messages));
+    std::printf("%-36s %16.1f %18.3e\n", "spsc_queue (blocking, futex)",
+                ping_pong_ns<blocking_queue, blocking_ops>(rounds), throughput<blocking_queue, blocking_ops>(messages));
+    std::printf("%-36s %16s %18.3e\n", "spsc_queue (spin, batch of 32)", "-",
+                throughput_batch<spin_queue>(messages));
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file      my_static_search_index_bench.cpp
+ * @brief     [static_search_index（Eytzinger 布局）与 std::lower_bound、无分支二分在 L1 到内存大小数组上的查找耗时对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_flat_tree.h"
+#include "my_static_search_index.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+/// 用法：my_static_search_index_bench [最大元素个数]
+/// 数组从 1K 个 int（4KB，L1）按 8 倍增长到最大元素个数（默认 16M，64MB，远大于 LLC），
+/// 每种大小随机查找 2M 次，输出每次查找的平均耗时（ns）
+
+namespace {
+    volatile size_t g_sink = 0;
+
+    template<typename F>
+    double time_per_query(size_t queries, F &&f) {
+        auto start = std::chrono::steady_clock::now();
+        size_t sum = f();
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        g_sink = g_sink + sum;
+        return ns.count() / queries;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t maxN = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (size_t(16) << 20);
+    const size_t queries = 2000000;
+    std::mt19937 rng(1);
+
+    std::printf("%10s %10s %16s %14s %16s %16s\n", "elements", "bytes", "std::lower_bound", "branchless",
+                "eytzinger", "eytzinger batch");
+    for (size_t n = 1024; n <= maxN; n *= 8) {
+        my::vector<int> sorted;
+        sorted.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            sorted.push_back(static_cast<int>(i * 2));
+        }
+        std::vector<int> probes(queries);
+        for (auto &p: probes) {
+            p = static_cast<int>(rng() % (2 * n));
+        }
+        my::static_search_index<int> index(sorted);
+
+        double stdNs = time_per_query(queries, [&]() {
+            size_t sum = 0;
+            for (int p: probes) {
+                sum += std::lower_bound(sorted.begin(), sorted.end(), p) - sorted.begin();
+            }
+            return sum;
+        });
+        double branchlessNs = time_per_query(queries, [&]() {
+            size_t sum = 0;
+            for (int p: probes) {
+                sum += my::detail::flat_lower_bound(sorted.data(), sorted.size(), p, std::less<int>());
+            }
+            return sum;
+        });
+        double eytzingerNs = time_per_query(queries, [&]() {
+            size_t sum = 0;
+            for (int p: probes) {
+                sum += index.lower_bound(p);
+            }
+            return sum;
+        });
+        std::vector<size_t> ranks(queries);
+        double batchNs = time_per_query(queries, [&]() {
+            index.lower_bound(probes.begin(), probes.end(), ranks.begin());
+            return ranks[queries / 2];
+        });
+        std::printf("%10zu %9zuK %16.1f %14.1f %16.1f %16.1f\n", n, n * sizeof(int) / 1024, stdNs, branchlessNs,
+                    eytzingerNs, batchNs);
+    }
+    return 0;
+}
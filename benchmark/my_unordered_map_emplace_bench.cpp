@@ -0,0 +1,171 @@
+/**
+ * @file      my_unordered_map_emplace_bench.cpp
+ * @brief     [统计字符串键 unordered_map 在各种插入方式下的分配次数、拷贝次数与耗时]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_unordered_map.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+/// 用法：my_unordered_map_emplace_bench [键的个数]
+
+namespace {
+    size_t g_allocs = 0;
+
+    /// 记录 mapped 被拷贝/移动的次数
+    struct Payload {
+        static size_t copies;
+        static size_t moves;
+        std::string data;
+
+        Payload() = default;
+
+        explicit Payload(const char *s) : data(s) {}
+
+        Payload(const Payload &other) : data(other.data) { ++copies; }
+
+        Payload(Payload &&other) noexcept : data(std::move(other.data)) { ++moves; }
+
+        Payload &operator=(const Payload &other) {
+            data = other.data;
+            ++copies;
+            return *this;
+        }
+
+        Payload &operator=(Payload &&other) noexcept {
+            data = std::move(other.data);
+            ++moves;
+            return *this;
+        }
+    };
+
+    size_t Payload::copies = 0;
+    size_t Payload::moves = 0;
+
+    using map_type = my::unordered_map<std::string, Payload>;
+    using value_type = map_type::value_type;
+
+    /// 键足够长，保证每次拷贝 key 都会触发一次堆分配
+    std::vector<std::string> make_keys(size_t n) {
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back("session-key-long-prefix-" + std::to_string(i));
+        }
+        return keys;
+    }
+
+    template<typename Func>
+    void measure(const char *name, size_t n, Func &&func) {
+        Payload::copies = Payload::moves = 0;
+        size_t allocs_before = g_allocs;
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        std::printf("%-44s %10.2f %12.2f %12.2f %10.1f\n", name,
+                    static_cast<double>(g_allocs - allocs_before) / n,
+                    static_cast<double>(Payload::copies) / n,
+                    static_cast<double>(Payload::moves) / n,
+                    ns.count() / n);
+    }
+}
+
+/// 替换版 operator new/delete 不允许内联：否则 g++ 会把内联后的 free 与调用方的
+/// ::operator new 配对，误报 -Wmismatched-new-delete
+[[gnu::noinline]] void *operator new(size_t size) {
+    ++g_allocs;
+    if (void *p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::vector<std::string> keys = make_keys(n);
+
+    std::printf("%-44s %10s %12s %12s %10s\n", "operation (per key)", "allocs", "val copies", "val moves", "ns");
+
+    /// 新 key 插入
+    {
+        map_type m(n);
+        measure("insert(const value_type&) new keys", n, [&]() {
+            for (const auto &k: keys) {
+                value_type v(k, Payload("v"));
+                m.insert(v);
+            }
+        });
+    }
+    {
+        map_type m(n);
+        measure("insert(value_type&&) new keys", n, [&]() {
+            for (const auto &k: keys) {
+                m.insert(value_type(k, Payload("v")));
+            }
+        });
+    }
+    {
+        map_type m(n);
+        measure("try_emplace(key, args) new keys", n, [&]() {
+            for (const auto &k: keys) {
+                m.try_emplace(k, "v");
+            }
+        });
+    }
+    {
+        map_type m(n);
+        measure("emplace(key, args) new keys", n, [&]() {
+            for (const auto &k: keys) {
+                m.emplace(k, "v");
+            }
+        });
+    }
+
+    /// 已存在 key 的访问/更新
+    map_type m(n);
+    for (const auto &k: keys) {
+        m.try_emplace(k, "v");
+    }
+    measure("old operator[]: insert(make_pair(k, T())) hit", n, [&]() {
+        for (const auto &k: keys) {
+            auto res = m.insert(std::make_pair(k, Payload()));
+            res.first->second.data.size();
+        }
+    });
+    measure("operator[] hit", n, [&]() {
+        for (const auto &k: keys) {
+            m[k].data.size();
+        }
+    });
+    measure("try_emplace hit", n, [&]() {
+        for (const auto &k: keys) {
+            m.try_emplace(k, "unused");
+        }
+    });
+    measure("insert_or_assign hit (moves value)", n, [&]() {
+        for (const auto &k: keys) {
+            m.insert_or_assign(k, Payload("w"));
+        }
+    });
+    measure("emplace hit (builds and drops a node)", n, [&]() {
+        for (const auto &k: keys) {
+            m.emplace(k, "unused");
+        }
+    });
+    return 0;
+}
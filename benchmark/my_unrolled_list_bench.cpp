@@ -0,0 +1,97 @@
+/**
+ * @file      my_unrolled_list_bench.cpp
+ * @brief     [unrolled_list 与 my::list 对比：尾部追加、遍历、遍历中间插入之后的遍历，以及每个元素占用的内存]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_list.h"
+#include "my_unrolled_list.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/// 用法：my_unrolled_list_bench [元素个数]
+/// push_back：逐个追加 n 个 int
+/// traverse：顺序遍历求和（重复 10 遍取平均）
+/// insert：从头遍历，每隔 4 个元素插入一个新元素（迭代器位置插入，共 n / 4 次）
+/// traverse after insert：插入之后再遍历，my::list 新插入的节点散落在堆里，不再和邻居相邻
+/// bytes / elem：节点大小之和 / 元素个数，不含分配器的块头（my::list 每个元素一次分配，实际占用还要更多）
+
+namespace {
+    volatile long long g_sink = 0;
+
+    using clock_type = std::chrono::steady_clock;
+
+    double ns_since(clock_type::time_point start, size_t ops) {
+        std::chrono::duration<double, std::nano> ns = clock_type::now() - start;
+        return ns.count() / ops;
+    }
+
+    template<typename List>
+    double traverse(List &lst, size_t n) {
+        constexpr int kRepeat = 10;
+        long long sum = 0;
+        auto start = clock_type::now();
+        for (int r = 0; r < kRepeat; ++r) {
+            for (auto it = lst.begin(); it != lst.end(); ++it) {
+                sum += *it;
+            }
+        }
+        double ns = ns_since(start, n * kRepeat);
+        g_sink = g_sink + sum;
+        return ns;
+    }
+
+    template<typename List>
+    void run(const char *name, size_t n, double bytesPerElement) {
+        List lst;
+        auto start = clock_type::now();
+        for (size_t i = 0; i < n; ++i) {
+            lst.push_back(static_cast<int>(i));
+        }
+        double pushNs = ns_since(start, n);
+        double traverseNs = traverse(lst, n);
+
+        start = clock_type::now();
+        size_t inserted = 0;
+        auto it = lst.begin();
+        while (it != lst.end()) {
+            for (int k = 0; k < 4 && it != lst.end(); ++k) {
+                ++it;
+            }
+            it = lst.insert(it, -1);
+            ++it;
+            ++inserted;
+        }
+        double insertNs = ns_since(start, inserted);
+        double traverseAfterNs = traverse(lst, n + inserted);
+        std::printf("%-28s %12.2f %12.2f %12.2f %16.2f %14.1f\n", name, pushNs, traverseNs, insertNs, traverseAfterNs,
+                    bytesPerElement);
+    }
+
+    /// unrolled_list 每个元素的实际占用：节点总大小 / 元素个数（追加时节点是满的）
+    template<typename List>
+    double unrolled_bytes_per_element(size_t n) {
+        List lst;
+        for (size_t i = 0; i < n; ++i) {
+            lst.push_back(static_cast<int>(i));
+        }
+        using node = my::detail::unrolled_node<int, List::node_capacity>;
+        return static_cast<double>(lst.node_count() * sizeof(node)) / lst.size();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::printf("elements = %zu (int), times in ns per element\n", n);
+    std::printf("%-28s %12s %12s %12s %16s %14s\n", "container", "push_back", "traverse", "insert",
+                "traverse after", "bytes / elem");
+    run<my::list<int>>("my::list", n, static_cast<double>(sizeof(my::ListNode<int>)));
+    run<my::unrolled_list<int, 16>>("my::unrolled_list<int, 16>", n,
+                                    unrolled_bytes_per_element<my::unrolled_list<int, 16>>(n));
+    run<my::unrolled_list<int>>("my::unrolled_list<int, 64>", n,
+                                unrolled_bytes_per_element<my::unrolled_list<int>>(n));
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file      my_ws_deque_bench.cpp
+ * @brief     [工作窃取吞吐量：一个所有者产生任务并从底部取，若干窃取者从顶部偷；ws_deque 与 mutex 保护的 my::deque 对比]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_deque.h"
+#include "my_ws_deque.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// 用法：my_ws_deque_bench [任务总数] [每批任务数]
+/// 所有者每次 push 一批任务再 pop 一半，窃取者不停地 steal；统计每秒处理的任务数和被偷走的比例
+/// 每个任务只做一点点计算，测的是队列本身的开销
+
+namespace {
+    volatile long long g_sink = 0;
+
+    /// 对照组：mutex 保护的 my::deque，所有者在尾部操作，窃取者从头部取
+    class locked_deque {
+    public:
+        explicit locked_deque(size_t) {}
+
+        void push(long long v) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            deque_.push_back(v);
+        }
+
+        bool pop(long long &out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (deque_.empty()) {
+                return false;
+            }
+            out = deque_.back();
+            deque_.pop_back();
+            return true;
+        }
+
+        bool steal(long long &out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (deque_.empty()) {
+                return false;
+            }
+            out = deque_.front();
+            deque_.pop_front();
+            return true;
+        }
+
+        bool empty_approx() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return deque_.empty();
+        }
+
+    private:
+        std::mutex mutex_;
+        my::deque<long long> deque_;
+    };
+
+    /// 把 ws_deque 的 optional 接口适配成和对照组一样的形式
+    class lockfree_deque {
+    public:
+        explicit lockfree_deque(size_t capacity) : deque_(capacity) {}
+
+        void push(long long v) { deque_.push(v); }
+
+        bool pop(long long &out) { return take_(deque_.pop(), out); }
+
+        bool steal(long long &out) { return take_(deque_.steal(), out); }
+
+        bool empty_approx() const { return deque_.empty_approx(); }
+
+    private:
+        static bool take_(const my::optional<long long> &v, long long &out) {
+            if (!v.has_value()) {
+                return false;
+            }
+            out = *v;
+            return true;
+        }
+
+        my::ws_deque<long long> deque_;
+    };
+
+    inline long long work(long long v) {
+        return v * 2654435761LL >> 7;
+    }
+
+    template<typename Deque>
+    void run(const char *name, int thieves, size_t tasks, size_t batch) {
+        Deque d(1024);
+        std::atomic<bool> done(false);
+        std::atomic<size_t> stolen(0);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int k = 0; k < thieves; ++k) {
+            threads.emplace_back([&] {
+                size_t local = 0;
+                long long sum = 0;
+                long long v = 0;
+                while (!done.load(std::memory_order_acquire) || !d.empty_approx()) {
+                    if (d.steal(v)) {
+                        sum += work(v);
+                        ++local;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                stolen.fetch_add(local);
+                g_sink = g_sink + sum;
+            });
+        }
+        long long sum = 0;
+        long long v = 0;
+        for (size_t produced = 0; produced < tasks;) {
+            size_t n = tasks - produced < batch ? tasks - produced : batch;
+            for (size_t i = 0; i < n; ++i) {
+                d.push(static_cast<long long>(produced + i));
+            }
+            produced += n;
+            for (size_t i = 0; i < n / 2 && d.pop(v); ++i) {
+                sum += work(v);
+            }
+        }
+        while (d.pop(v)) {
+            sum += work(v);
+        }
+        done.store(true, std::memory_order_release);
+        for (auto &t : threads) {
+            t.join();
+        }
+        std::chrono::duration<double> sec = std::chrono::steady_clock::now() - start;
+        g_sink = g_sink + sum;
+        std::printf("%-24s %8d %16.3e %12.1f%%\n", name, thieves, tasks / sec.count(),
+                    100.0 * stolen.load() / tasks);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t tasks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    size_t batch = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+    std::printf("tasks = %zu, batch = %zu, hardware threads = %u\n", tasks, batch,
+                std::thread::hardware_concurrency());
+    std::printf("%-24s %8s %16s %13s\n", "deque", "thieves", "tasks / s", "stolen");
+    for (int thieves : {0, 1, 2, 4, 8}) {
+        run<locked_deque>("mutex + my::deque", thieves, tasks, batch);
+        run<lockfree_deque>("ws_deque", thieves, tasks, batch);
+    }
+    return 0;
+}
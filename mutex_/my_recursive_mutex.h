@@ -180,7 +180,7 @@ namespace my {
             EnterCriticalSection(&mutex_);
 #else
             ///
-            if (pthread_mutex_lock() != 0) {
+            if (pthread_mutex_lock(&mutex_) != 0) {
                 throw std::runtime_error("recursive mutex lock failed");
             }
 #endif
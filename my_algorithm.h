@@ -1,12 +1,19 @@
 /**
  * @file      my_algorithm.h
- * @brief     [max min]
+ * @brief     [max min；识别分段迭代器（如 deque 迭代器）的 copy / move / fill / for_each / find / accumulate]
  * @author    Weijh
  * @version   1.0
  */
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
 namespace my {
     template<typename T>
     inline const T &min(const T &a, const T &b) {
@@ -17,5 +24,261 @@ namespace my {
     inline const T &max(const T &a, const T &b) {
         return a > b ? a : b;
     }
-}
 
+    /**
+     * 分段迭代器
+     * deque 这类容器的元素存放在若干块连续内存（段）中，迭代器每次 ++ 都要判断是否走到了块尾，
+     * 逐个元素的循环里多了一个分支，编译器也无法把循环向量化
+     * 分段迭代器把位置拆成（段，段内指针）两层：算法先按段切开区间，每一段内部就是普通的指针循环，
+     * 拷贝 / 填充等可以直接落到 memmove / memset 或者被向量化，整段之间才处理一次换段
+     *
+     * 容器通过特化 segmented_iterator_traits 声明自己的迭代器是分段的，需要提供：
+     *      segment_iterator / local_iterator       段迭代器和段内迭代器（通常是 T** 和 T*）
+     *      static segment(it) / local(it)          拆开一个位置
+     *      static begin(seg) / end(seg)            一个段的 [首, 尾)
+     *      static compose(seg, local)              合成一个位置，local 可以等于 end(seg)（即下一段的开头）
+     * 下面的算法在源区间或者目标区间是分段迭代器时逐段处理，其余情况直接交给 std 中对应的算法
+     */
+    template<typename It>
+    struct segmented_iterator_traits {
+        static constexpr bool is_segmented = false;
+    };
+
+    template<typename It>
+    inline constexpr bool is_segmented_iterator_v = segmented_iterator_traits<It>::is_segmented;
+
+    namespace detail {
+
+        template<typename It>
+        inline constexpr bool is_random_access_v = std::is_base_of_v<
+                std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+        /// 对 [first, last) 从前往后的每一段调用 fn(seg, localFirst, localLast)，fn 返回 false 时提前结束
+        template<typename It, typename Fn>
+        void for_each_segment(It first, It last, Fn fn) {
+            using traits = segmented_iterator_traits<It>;
+            auto seg = traits::segment(first);
+            auto segLast = traits::segment(last);
+            if (seg == segLast) {
+                fn(seg, traits::local(first), traits::local(last));
+                return;
+            }
+            if (!fn(seg, traits::local(first), traits::end(seg))) {
+                return;
+            }
+            for (++seg; seg != segLast; ++seg) {
+                if (!fn(seg, traits::begin(seg), traits::end(seg))) {
+                    return;
+                }
+            }
+            fn(segLast, traits::begin(segLast), traits::local(last));
+        }
+
+        /// 从后往前的每一段
+        template<typename It, typename Fn>
+        void for_each_segment_backward(It first, It last, Fn fn) {
+            using traits = segmented_iterator_traits<It>;
+            auto seg = traits::segment(last);
+            auto segFirst = traits::segment(first);
+            if (seg == segFirst) {
+                fn(seg, traits::local(first), traits::local(last));
+                return;
+            }
+            fn(seg, traits::begin(seg), traits::local(last));
+            for (--seg; seg != segFirst; --seg) {
+                fn(seg, traits::begin(seg), traits::end(seg));
+            }
+            fn(segFirst, traits::local(first), traits::end(segFirst));
+        }
+
+        /**
+         *  copy / move 的公共部分，op 是处理一段连续区间的 std::copy 或 std::move
+         *  源区间分段：逐段交给 op（目标也分段时递归到下面的分支）
+         *  目标区间分段：每次写满目标的一段，要求源是随机访问迭代器才能直接算出每次的长度
+         * */
+        template<typename InputIt, typename OutputIt, typename Op>
+        OutputIt segmented_copy(InputIt first, InputIt last, OutputIt out, Op op) {
+            if constexpr (is_segmented_iterator_v<InputIt>) {
+                for_each_segment(first, last, [&](auto, auto localFirst, auto localLast) {
+                    out = segmented_copy(localFirst, localLast, out, op);
+                    return true;
+                });
+                return out;
+            } else if constexpr (is_segmented_iterator_v<OutputIt> && is_random_access_v<InputIt>) {
+                using traits = segmented_iterator_traits<OutputIt>;
+                auto seg = traits::segment(out);
+                auto local = traits::local(out);
+                auto n = last - first;
+                while (n > 0) {
+                    if (local == traits::end(seg)) {
+                        ++seg;
+                        local = traits::begin(seg);
+                    }
+                    auto step = std::min<decltype(n)>(n, traits::end(seg) - local);
+                    local = op(first, first + step, local);
+                    first += step;
+                    n -= step;
+                }
+                return traits::compose(seg, local);
+            } else {
+                return op(first, last, out);
+            }
+        }
+
+        /// copy_backward / move_backward 的公共部分，out 是目标区间的尾后位置
+        template<typename BidirIt1, typename BidirIt2, typename Op>
+        BidirIt2 segmented_copy_backward(BidirIt1 first, BidirIt1 last, BidirIt2 out, Op op) {
+            if constexpr (is_segmented_iterator_v<BidirIt1>) {
+                for_each_segment_backward(first, last, [&](auto, auto localFirst, auto localLast) {
+                    out = segmented_copy_backward(localFirst, localLast, out, op);
+                });
+                return out;
+            } else if constexpr (is_segmented_iterator_v<BidirIt2> && is_random_access_v<BidirIt1>) {
+                using traits = segmented_iterator_traits<BidirIt2>;
+                auto seg = traits::segment(out);
+                auto local = traits::local(out);
+                auto n = last - first;
+                while (n > 0) {
+                    if (local == traits::begin(seg)) {
+                        --seg;
+                        local = traits::end(seg);
+                    }
+                    auto step = std::min<decltype(n)>(n, local - traits::begin(seg));
+                    local = op(last - step, last, local);
+                    last -= step;
+                    n -= step;
+                }
+                return traits::compose(seg, local);
+            } else {
+                return op(first, last, out);
+            }
+        }
+
+        struct copy_op {
+            template<typename InputIt, typename OutputIt>
+            OutputIt operator()(InputIt first, InputIt last, OutputIt out) const { return std::copy(first, last, out); }
+        };
+
+        struct move_op {
+            template<typename InputIt, typename OutputIt>
+            OutputIt operator()(InputIt first, InputIt last, OutputIt out) const { return std::move(first, last, out); }
+        };
+
+        struct copy_backward_op {
+            template<typename BidirIt1, typename BidirIt2>
+            BidirIt2 operator()(BidirIt1 first, BidirIt1 last, BidirIt2 out) const {
+                return std::copy_backward(first, last, out);
+            }
+        };
+
+        struct move_backward_op {
+            template<typename BidirIt1, typename BidirIt2>
+            BidirIt2 operator()(BidirIt1 first, BidirIt1 last, BidirIt2 out) const {
+                return std::move_backward(first, last, out);
+            }
+        };
+    }
+
+    template<typename InputIt, typename OutputIt>
+    OutputIt copy(InputIt first, InputIt last, OutputIt out) {
+        return detail::segmented_copy(first, last, out, detail::copy_op());
+    }
+
+    template<typename InputIt, typename OutputIt>
+    OutputIt move(InputIt first, InputIt last, OutputIt out) {
+        return detail::segmented_copy(first, last, out, detail::move_op());
+    }
+
+    template<typename BidirIt1, typename BidirIt2>
+    BidirIt2 copy_backward(BidirIt1 first, BidirIt1 last, BidirIt2 out) {
+        return detail::segmented_copy_backward(first, last, out, detail::copy_backward_op());
+    }
+
+    template<typename BidirIt1, typename BidirIt2>
+    BidirIt2 move_backward(BidirIt1 first, BidirIt1 last, BidirIt2 out) {
+        return detail::segmented_copy_backward(first, last, out, detail::move_backward_op());
+    }
+
+    template<typename ForwardIt, typename T>
+    void fill(ForwardIt first, ForwardIt last, const T &value) {
+        if constexpr (is_segmented_iterator_v<ForwardIt>) {
+            detail::for_each_segment(first, last, [&](auto, auto localFirst, auto localLast) {
+                std::fill(localFirst, localLast, value);
+                return true;
+            });
+        } else {
+            std::fill(first, last, value);
+        }
+    }
+
+    template<typename InputIt, typename Fn>
+    Fn for_each(InputIt first, InputIt last, Fn fn) {
+        if constexpr (is_segmented_iterator_v<InputIt>) {
+            detail::for_each_segment(first, last, [&](auto, auto localFirst, auto localLast) {
+                for (; localFirst != localLast; ++localFirst) {
+                    fn(*localFirst);
+                }
+                return true;
+            });
+            return fn;
+        } else {
+            return std::for_each(first, last, fn);
+        }
+    }
+
+    template<typename InputIt, typename Pred>
+    InputIt find_if(InputIt first, InputIt last, Pred pred) {
+        if constexpr (is_segmented_iterator_v<InputIt>) {
+            using traits = segmented_iterator_traits<InputIt>;
+            InputIt result = last;
+            detail::for_each_segment(first, last, [&](auto seg, auto localFirst, auto localLast) {
+                auto it = std::find_if(localFirst, localLast, pred);
+                if (it == localLast) {
+                    return true;
+                }
+                result = traits::compose(seg, it);
+                return false;
+            });
+            return result;
+        } else {
+            return std::find_if(first, last, pred);
+        }
+    }
+
+    template<typename InputIt, typename T>
+    InputIt find(InputIt first, InputIt last, const T &value) {
+        if constexpr (is_segmented_iterator_v<InputIt>) {
+            using traits = segmented_iterator_traits<InputIt>;
+            InputIt result = last;
+            detail::for_each_segment(first, last, [&](auto seg, auto localFirst, auto localLast) {
+                auto it = std::find(localFirst, localLast, value);
+                if (it == localLast) {
+                    return true;
+                }
+                result = traits::compose(seg, it);
+                return false;
+            });
+            return result;
+        } else {
+            return std::find(first, last, value);
+        }
+    }
+
+    template<typename InputIt, typename T, typename BinaryOp>
+    T accumulate(InputIt first, InputIt last, T init, BinaryOp op) {
+        if constexpr (is_segmented_iterator_v<InputIt>) {
+            detail::for_each_segment(first, last, [&](auto, auto localFirst, auto localLast) {
+                init = std::accumulate(localFirst, localLast, std::move(init), op);
+                return true;
+            });
+            return init;
+        } else {
+            return std::accumulate(first, last, std::move(init), op);
+        }
+    }
+
+    template<typename InputIt, typename T>
+    T accumulate(InputIt first, InputIt last, T init) {
+        return my::accumulate(first, last, std::move(init), std::plus<>());
+    }
+}
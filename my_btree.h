@@ -0,0 +1,1262 @@
+/**
+ * @file      my_btree.h
+ * @brief     [B树：btree_map/btree_set/btree_multimap/btree_multiset 的底层结构]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_sorted_tag.h"
+#include "my_type_traits.h"
+#include "memory_/my_allocator.h"
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * btree
+ * 红黑树每个元素一个节点，每个节点三个指针加一个颜色，查找时每下降一层就是一次几乎必然的缓存未命中
+ * B 树把很多个元素放在同一个节点中（节点大小约 256 字节，即几条缓存行），树高只有红黑树的几分之一：
+ *      查找：每层在节点内二分（算术类型 key 用无分支线性扫描，编译器可以向量化），节点内的访问是连续内存
+ *      遍历：同一个节点内的元素连续存放，顺序扫描基本是顺序读内存
+ *      内存：每个元素只有槽位本身的开销，再加上每个节点一个小的头部（和内部节点的孩子指针）
+ * 代价：插入/删除需要在节点内搬移元素，因此插入和删除会使所有迭代器失效（与 std::map 不同）
+ *
+ * 结构（与 abseil 的 btree 相同）：
+ *      元素同时存放在叶子节点和内部节点中；内部节点第 i 个元素位于孩子 i 和孩子 i+1 之间
+ *      除根以外每个节点都非空；所有叶子在同一层
+ *      迭代器是 (节点, 位置)，end() 是 (最右叶子, 元素个数)
+ *      插入：只在叶子上插入，叶子满了就分裂，中间元素上移到父节点（父节点满了先分裂父节点）
+ *           在节点末尾插入时分裂偏向左边，顺序插入时节点几乎是满的
+ *      删除：内部节点上的元素先用它的前驱（一定在叶子上）替换，再从叶子删除；
+ *           节点元素过少时与兄弟合并或者从兄弟借元素
+ */
+
+namespace my {
+
+    template<typename Params>
+    class btree;
+
+    namespace detail {
+
+        /// btree_map / btree_multimap 的参数
+        /// 节点中实际存放的是 std::pair<Key, T>（key 可变），这样节点内搬移元素时 key 可以移动而不是拷贝；
+        /// 对外通过 element() 以 std::pair<const Key, T> 的形式暴露，两者布局相同
+        template<typename Key, typename T, typename Compare, typename Alloc, bool Multi>
+        struct btree_map_params {
+            using key_type = Key;
+            using mapped_type = T;
+            using value_type = std::pair<const Key, T>;
+            using slot_type = std::pair<Key, T>;
+            using key_compare = Compare;
+            using allocator_type = Alloc;
+            static constexpr bool kIsMulti = Multi;
+            static constexpr bool kIsSet = false;
+
+            static const key_type &key(const slot_type *slot) {
+                return slot->first;
+            }
+
+            static value_type &element(slot_type *slot) {
+                return *std::launder(reinterpret_cast<value_type *>(slot));
+            }
+        };
+
+        /// btree_set / btree_multiset 的参数：元素就是 key，迭代器只读
+        template<typename Key, typename Compare, typename Alloc, bool Multi>
+        struct btree_set_params {
+            using key_type = Key;
+            using value_type = Key;
+            using slot_type = Key;
+            using key_compare = Compare;
+            using allocator_type = Alloc;
+            static constexpr bool kIsMulti = Multi;
+            static constexpr bool kIsSet = true;
+
+            static const key_type &key(const slot_type *slot) {
+                return *slot;
+            }
+
+            static value_type &element(slot_type *slot) {
+                return *slot;
+            }
+        };
+
+        /// 节点：叶子节点只有头部和槽位，内部节点在后面再加上 kNodeSlots + 1 个孩子指针
+        /// 槽位是未初始化的原始内存，只有 [0, count) 中的槽位存放着有效元素
+        template<typename Params>
+        struct btree_node {
+            using slot_type = typename Params::slot_type;
+            using key_type = typename Params::key_type;
+
+            static constexpr size_t kTargetNodeSize = 256;
+            static constexpr size_t kHeaderSize = sizeof(void *) + 2 * sizeof(uint16_t) + sizeof(bool);
+            static constexpr size_t kFitSlots = (kTargetNodeSize - kHeaderSize) / sizeof(slot_type);
+            /// 至少 3 个槽位，分裂后左右两边才都有元素
+            static constexpr int kNodeSlots = kFitSlots < 3 ? 3 : (kFitSlots > 255 ? 255 : static_cast<int>(kFitSlots));
+
+            btree_node *parent;         /// 父节点，根节点为 nullptr
+            uint16_t position;          /// 在父节点孩子数组中的下标
+            uint16_t count;             /// 元素个数
+            bool leaf;                  /// 是否叶子
+            alignas(slot_type) unsigned char storage[kNodeSlots * sizeof(slot_type)];
+
+            slot_type *slot(int i) {
+                return std::launder(reinterpret_cast<slot_type *>(storage)) + i;
+            }
+
+            const slot_type *slot(int i) const {
+                return std::launder(reinterpret_cast<const slot_type *>(storage)) + i;
+            }
+
+            const key_type &key(int i) const {
+                return Params::key(slot(i));
+            }
+
+            /// 以下只对内部节点有效
+            btree_node *&child(int i);
+
+            btree_node *child(int i) const;
+
+            void set_child(int i, btree_node *c) {
+                child(i) = c;
+                c->parent = this;
+                c->position = static_cast<uint16_t>(i);
+            }
+        };
+
+        template<typename Params>
+        struct btree_internal_node : btree_node<Params> {
+            btree_node<Params> *children[btree_node<Params>::kNodeSlots + 1];
+        };
+
+        template<typename Params>
+        btree_node<Params> *&btree_node<Params>::child(int i) {
+            return static_cast<btree_internal_node<Params> *>(this)->children[i];
+        }
+
+        template<typename Params>
+        btree_node<Params> *btree_node<Params>::child(int i) const {
+            return static_cast<const btree_internal_node<Params> *>(this)->children[i];
+        }
+
+        /// 双向迭代器：(节点, 位置)
+        template<typename Params, bool IsConst>
+        class btree_iterator {
+            using node = btree_node<Params>;
+            using node_pointer = my::conditional_t<IsConst, const node *, node *>;
+
+            friend class btree<Params>;
+
+            friend class btree_iterator<Params, !IsConst>;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = typename Params::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = my::conditional_t<IsConst || Params::kIsSet, const value_type &, value_type &>;
+            using pointer = my::conditional_t<IsConst || Params::kIsSet, const value_type *, value_type *>;
+
+            btree_iterator() : node_(nullptr), position_(0) {}
+
+            btree_iterator(node_pointer n, int position) : node_(n), position_(position) {}
+
+            /// 非 const 迭代器可以隐式转换为 const 迭代器
+            template<bool B = IsConst, typename = my::enable_if_t<B>>
+            btree_iterator(const btree_iterator<Params, false> &other)
+                    : node_(other.node_), position_(other.position_) {}
+
+            reference operator*() const {
+                return Params::element(const_cast<node *>(node_)->slot(position_));
+            }
+
+            pointer operator->() const {
+                return &operator*();
+            }
+
+            btree_iterator &operator++() {
+                increment_();
+                return *this;
+            }
+
+            btree_iterator operator++(int) {
+                btree_iterator tmp(*this);
+                increment_();
+                return tmp;
+            }
+
+            btree_iterator &operator--() {
+                decrement_();
+                return *this;
+            }
+
+            btree_iterator operator--(int) {
+                btree_iterator tmp(*this);
+                decrement_();
+                return tmp;
+            }
+
+            template<bool C>
+            bool operator==(const btree_iterator<Params, C> &other) const {
+                return node_ == other.node_ && position_ == other.position_;
+            }
+
+            template<bool C>
+            bool operator!=(const btree_iterator<Params, C> &other) const {
+                return !(*this == other);
+            }
+
+        private:
+            void increment_() {
+                /// 叶子内部前进是最常见的情况
+                if (node_->leaf && ++position_ < node_->count) {
+                    return;
+                }
+                if (node_->leaf) {
+                    /// 走到叶子末尾：沿父节点上升，直到找到一个还有后续元素的祖先
+                    btree_iterator save(*this);
+                    while (position_ == node_->count && node_->parent) {
+                        position_ = node_->position;
+                        node_ = node_->parent;
+                    }
+                    if (position_ == node_->count) {
+                        *this = save;       /// 已经是最后一个元素，停在 end()
+                    }
+                } else {
+                    /// 内部节点：后继是右子树的最左元素
+                    node_ = node_->child(position_ + 1);
+                    while (!node_->leaf) {
+                        node_ = node_->child(0);
+                    }
+                    position_ = 0;
+                }
+            }
+
+            void decrement_() {
+                if (node_->leaf && --position_ >= 0) {
+                    return;
+                }
+                if (node_->leaf) {
+                    btree_iterator save(*this);
+                    while (position_ < 0 && node_->parent) {
+                        position_ = node_->position - 1;
+                        node_ = node_->parent;
+                    }
+                    if (position_ < 0) {
+                        *this = save;
+                    }
+                } else {
+                    /// 内部节点：前驱是左子树的最右元素
+                    node_ = node_->child(position_);
+                    while (!node_->leaf) {
+                        node_ = node_->child(node_->count);
+                    }
+                    position_ = node_->count - 1;
+                }
+            }
+
+        private:
+            node_pointer node_;
+            int position_;
+        };
+    }
+
+    template<typename Params>
+    class btree {
+        using node = detail::btree_node<Params>;
+        using internal_node = detail::btree_internal_node<Params>;
+        using slot_type = typename Params::slot_type;
+        using leaf_allocator = typename std::allocator_traits<typename Params::allocator_type>::template rebind_alloc<node>;
+        using internal_allocator = typename std::allocator_traits<typename Params::allocator_type>::template rebind_alloc<internal_node>;
+
+        static constexpr int kNodeSlots = node::kNodeSlots;
+        static constexpr int kMinNodeValues = kNodeSlots / 2;
+
+    public:
+        using key_type = typename Params::key_type;
+        using value_type = typename Params::value_type;
+        using key_compare = typename Params::key_compare;
+        using allocator_type = typename Params::allocator_type;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = detail::btree_iterator<Params, false>;
+        using const_iterator = detail::btree_iterator<Params, true>;
+
+        explicit btree(const key_compare &comp = key_compare(), const allocator_type &alloc = allocator_type())
+                : root_(nullptr), leftmost_(nullptr), rightmost_(nullptr), size_(0), comp_(comp), alloc_(alloc) {}
+
+        /// 拷贝：源已经有序，逐个追加到最右叶子的末尾，O(n)，且节点几乎是满的
+        btree(const btree &other)
+                : btree(other.comp_,
+                        std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.alloc_)) {
+            for (const_iterator it = other.begin(); it != other.end(); ++it) {
+                append_back_(*it);
+            }
+        }
+
+        btree(btree &&other) noexcept
+                : root_(other.root_), leftmost_(other.leftmost_), rightmost_(other.rightmost_),
+                  size_(other.size_), comp_(std::move(other.comp_)), alloc_(std::move(other.alloc_)) {
+            other.root_ = other.leftmost_ = other.rightmost_ = nullptr;
+            other.size_ = 0;
+        }
+
+        btree &operator=(const btree &other) {
+            if (this != &other) {
+                btree tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        btree &operator=(btree &&other) noexcept {
+            if (this != &other) {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~btree() {
+            clear();
+        }
+
+        iterator begin() { return iterator(leftmost_, 0); }
+
+        const_iterator begin() const { return const_iterator(leftmost_, 0); }
+
+        iterator end() { return iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+
+        const_iterator end() const { return const_iterator(rightmost_, rightmost_ ? rightmost_->count : 0); }
+
+        size_type size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        const key_compare &key_comp() const { return comp_; }
+
+        allocator_type get_allocator() const { return alloc_; }
+
+        /// 唯一插入：先用 key 下降，确认 key 不存在后才构造元素
+        template<typename K, typename... Args>
+        std::pair<iterator, bool> insert_unique(const K &key, Args &&... args) {
+            if (!root_) {
+                root_ = leftmost_ = rightmost_ = new_leaf_();
+            }
+            node *n = root_;
+            int pos;
+            for (;;) {
+                pos = lower_bound_in_node_(n, key);
+                if (pos < n->count && !comp_(key, n->key(pos))) {
+                    return {iterator(n, pos), false};
+                }
+                if (n->leaf) {
+                    break;
+                }
+                n = n->child(pos);
+            }
+            alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+            slot_type *tmp = ::new(static_cast<void *>(buf)) slot_type(std::forward<Args>(args)...);
+            return {insert_at_leaf_(n, pos, tmp), true};
+        }
+
+        /// emplace 版本：不知道 key 之前只能先构造元素，key 已存在时再销毁
+        template<typename... Args>
+        std::pair<iterator, bool> emplace_unique(Args &&... args) {
+            alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+            slot_type *tmp = ::new(static_cast<void *>(buf)) slot_type(std::forward<Args>(args)...);
+            if (!root_) {
+                root_ = leftmost_ = rightmost_ = new_leaf_();
+            }
+            const key_type &key = Params::key(tmp);
+            node *n = root_;
+            int pos;
+            for (;;) {
+                pos = lower_bound_in_node_(n, key);
+                if (pos < n->count && !comp_(key, n->key(pos))) {
+                    tmp->~slot_type();
+                    return {iterator(n, pos), false};
+                }
+                if (n->leaf) {
+                    break;
+                }
+                n = n->child(pos);
+            }
+            return {insert_at_leaf_(n, pos, tmp), true};
+        }
+
+        /**
+         * 批量插入有序区间：比当前最大元素大的元素（唯一键时等价的跳过）直接追加到最右叶子末尾，
+         * 不做任何查找，追加满了才分裂，均摊 O(1)；因此在空树或者输入整体位于现有元素之后时是 O(n) 的，
+         * 而且建成的节点几乎是满的。落在现有元素中间的输入退化为普通插入
+         * 返回实际插入的元素个数
+         */
+        template<typename InputIt>
+        size_type insert_sorted(InputIt first, InputIt last) {
+            size_type inserted = 0;
+            for (; first != last; ++first) {
+                if (!root_) {
+                    root_ = leftmost_ = rightmost_ = new_leaf_();
+                }
+                alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+                slot_type *tmp = ::new(static_cast<void *>(buf)) slot_type(*first);
+                const key_type &key = Params::key(tmp);
+                bool append = size_ == 0 || comp_(rightmost_->key(rightmost_->count - 1), key);
+                if constexpr (Params::kIsMulti) {
+                    /// 与最大元素等价时也追加在它后面
+                    append = append || !comp_(key, rightmost_->key(rightmost_->count - 1));
+                }
+                if (append) {
+                    insert_at_leaf_(rightmost_, rightmost_->count, tmp);
+                    ++inserted;
+                    continue;
+                }
+                try {
+                    if constexpr (Params::kIsMulti) {
+                        emplace_multi(std::move(*tmp));
+                        ++inserted;
+                    } else {
+                        inserted += emplace_unique(std::move(*tmp)).second;
+                    }
+                } catch (...) {
+                    tmp->~slot_type();
+                    throw;
+                }
+                tmp->~slot_type();
+            }
+            return inserted;
+        }
+
+        /// 可重复插入：沿 upper_bound 下降到叶子，等价元素按插入顺序排列
+        template<typename... Args>
+        iterator emplace_multi(Args &&... args) {
+            alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+            slot_type *tmp = ::new(static_cast<void *>(buf)) slot_type(std::forward<Args>(args)...);
+            if (!root_) {
+                root_ = leftmost_ = rightmost_ = new_leaf_();
+            }
+            const key_type &key = Params::key(tmp);
+            node *n = root_;
+            int pos;
+            for (;;) {
+                pos = upper_bound_in_node_(n, key);
+                if (n->leaf) {
+                    break;
+                }
+                n = n->child(pos);
+            }
+            return insert_at_leaf_(n, pos, tmp);
+        }
+
+        template<typename K>
+        iterator lower_bound(const K &key) {
+            return lower_bound_(key);
+        }
+
+        template<typename K>
+        const_iterator lower_bound(const K &key) const {
+            return const_cast<btree *>(this)->lower_bound_(key);
+        }
+
+        template<typename K>
+        iterator upper_bound(const K &key) {
+            return upper_bound_(key);
+        }
+
+        template<typename K>
+        const_iterator upper_bound(const K &key) const {
+            return const_cast<btree *>(this)->upper_bound_(key);
+        }
+
+        template<typename K>
+        iterator find(const K &key) {
+            iterator it = lower_bound_(key);
+            if (it != end() && !comp_(key, Params::key(it.node_->slot(it.position_)))) {
+                return it;
+            }
+            return end();
+        }
+
+        template<typename K>
+        const_iterator find(const K &key) const {
+            return const_cast<btree *>(this)->find(key);
+        }
+
+        template<typename K>
+        std::pair<iterator, iterator> equal_range(const K &key) {
+            iterator first = lower_bound_(key);
+            if constexpr (!Params::kIsMulti) {
+                if (first == end() || comp_(key, Params::key(first.node_->slot(first.position_)))) {
+                    return {first, first};
+                }
+                iterator last = first;
+                return {first, ++last};
+            } else {
+                return {first, upper_bound_(key)};
+            }
+        }
+
+        template<typename K>
+        std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+            auto range = const_cast<btree *>(this)->equal_range(key);
+            return {range.first, range.second};
+        }
+
+        template<typename K>
+        size_type count(const K &key) const {
+            auto range = equal_range(key);
+            size_type n = 0;
+            for (const_iterator it = range.first; it != range.second; ++it) {
+                ++n;
+            }
+            return n;
+        }
+
+        /// 删除 it 指向的元素，返回下一个元素的迭代器（其他迭代器全部失效）
+        iterator erase(iterator it) {
+            node *n = it.node_;
+            int pos = it.position_;
+            bool internal_delete = !n->leaf;
+            n->slot(pos)->~slot_type();
+            if (internal_delete) {
+                /// 内部节点：把前驱（左子树最右叶子的最后一个元素）搬到这里，转化为从叶子上删除最后一个元素
+                iterator pred = it;
+                --pred;
+                relocate_(n->slot(pos), pred.node_->slot(pred.position_));
+                n = pred.node_;
+                pos = pred.position_;
+            } else {
+                for (int i = pos + 1; i < n->count; ++i) {
+                    relocate_(n->slot(i - 1), n->slot(i));
+                }
+            }
+            --n->count;
+            --size_;
+
+            /// 此时 (n, pos) 指向被删元素的下一个位置；若删的是内部节点上的元素，
+            /// (n, pos) 经过调整后指向顶替它的前驱，再前进一次才是真正的下一个元素
+            iterator res = rebalance_after_delete_(iterator(n, pos));
+            if (internal_delete) {
+                ++res;
+            }
+            return res;
+        }
+
+        /**
+         * 删除 [first, last)：落在同一个叶子上的一段连续元素一次删掉（析构、把剩下的元素整体前移），
+         * 然后只做一次自底向上的修复；内部节点上的元素仍然逐个删除（需要前驱顶替）
+         * 内部节点上的元素只占总数的 1/kNodeSlots 左右，删除 k 个元素约 O(k + (k / kNodeSlots) * log n)
+         * 整棵树都删掉时直接 clear()
+         */
+        iterator erase(iterator first, iterator last) {
+            size_type n = 0;
+            for (iterator it = first; it != last; ++it) {
+                ++n;
+            }
+            if (n == size_) {
+                clear();
+                return end();
+            }
+            while (n > 0) {
+                node *leaf = first.node_;
+                int pos = first.position_;
+                int run = leaf->leaf ? leaf->count - pos : 1;
+                if (static_cast<size_type>(run) > n) {
+                    run = static_cast<int>(n);
+                }
+                if (run <= 1) {
+                    first = erase(first);
+                    --n;
+                    continue;
+                }
+                for (int i = pos; i < pos + run; ++i) {
+                    leaf->slot(i)->~slot_type();
+                }
+                for (int i = pos + run; i < leaf->count; ++i) {
+                    relocate_(leaf->slot(i - run), leaf->slot(i));
+                }
+                leaf->count = static_cast<uint16_t>(leaf->count - run);
+                size_ -= run;
+                n -= run;
+                first = rebalance_after_delete_(iterator(leaf, pos));
+            }
+            return first;
+        }
+
+        template<typename K>
+        size_type erase_key(const K &key) {
+            auto range = equal_range(key);
+            size_type n = size_;
+            erase(range.first, range.second);
+            return n - size_;
+        }
+
+        void clear() {
+            if (root_) {
+                destroy_subtree_(root_);
+            }
+            root_ = leftmost_ = rightmost_ = nullptr;
+            size_ = 0;
+        }
+
+        void swap(btree &other) noexcept {
+            std::swap(root_, other.root_);
+            std::swap(leftmost_, other.leftmost_);
+            std::swap(rightmost_, other.rightmost_);
+            std::swap(size_, other.size_);
+            std::swap(comp_, other.comp_);
+            std::swap(alloc_, other.alloc_);
+        }
+
+        /// const_iterator 转为 iterator（容器的 erase(const_iterator) 用）
+        iterator to_mutable(const_iterator it) {
+            return iterator(const_cast<node *>(it.node_), it.position_);
+        }
+
+        /// 树高（空树为 0）
+        size_type height() const {
+            size_type h = 0;
+            for (const node *n = root_; n; n = n->leaf ? nullptr : n->child(0)) {
+                ++h;
+            }
+            return h;
+        }
+
+        /// 每个节点最多容纳的元素个数
+        static constexpr int node_slots() {
+            return kNodeSlots;
+        }
+
+        /// 检查 B 树的结构性质：有序、父子链接正确、所有叶子同层、非根节点非空、size 正确（用于测试）
+        bool verify() const {
+            if (!root_) {
+                return size_ == 0 && !leftmost_ && !rightmost_;
+            }
+            if (root_->parent) {
+                return false;
+            }
+            int leaf_depth = -1;
+            size_type n = verify_node_(root_, 0, leaf_depth);
+            if (n != size_) {
+                return false;
+            }
+            const node *l = root_;
+            const node *r = root_;
+            while (!l->leaf) l = l->child(0);
+            while (!r->leaf) r = r->child(r->count);
+            return l == leftmost_ && r == rightmost_;
+        }
+
+    private:
+        /// 节点内查找 —— 对算术类型 key 且用 std::less 比较时，用无分支的线性计数（可被向量化），
+        /// 其余情况用二分查找
+        static constexpr bool kLinearSearch =
+                std::is_arithmetic<key_type>::value &&
+                (std::is_same<key_compare, std::less<key_type>>::value ||
+                 std::is_same<key_compare, std::less<>>::value);
+
+        template<typename K>
+        int lower_bound_in_node_(const node *n, const K &key) const {
+            if constexpr (kLinearSearch) {
+                int pos = 0;
+                for (int i = 0; i < n->count; ++i) {
+                    pos += n->key(i) < key;
+                }
+                return pos;
+            } else {
+                int lo = 0;
+                int hi = n->count;
+                while (lo < hi) {
+                    int mid = (lo + hi) >> 1;
+                    if (comp_(n->key(mid), key)) {
+                        lo = mid + 1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                return lo;
+            }
+        }
+
+        template<typename K>
+        int upper_bound_in_node_(const node *n, const K &key) const {
+            if constexpr (kLinearSearch) {
+                int pos = 0;
+                for (int i = 0; i < n->count; ++i) {
+                    pos += !(key < n->key(i));
+                }
+                return pos;
+            } else {
+                int lo = 0;
+                int hi = n->count;
+                while (lo < hi) {
+                    int mid = (lo + hi) >> 1;
+                    if (comp_(key, n->key(mid))) {
+                        hi = mid;
+                    } else {
+                        lo = mid + 1;
+                    }
+                }
+                return lo;
+            }
+        }
+
+        /// 从节点末尾上升到下一个有效位置，走出根节点说明是 end()
+        iterator internal_last_(iterator it) {
+            while (it.node_ && it.position_ == it.node_->count) {
+                it.position_ = it.node_->position;
+                it.node_ = it.node_->parent;
+            }
+            return it.node_ ? it : end();
+        }
+
+        template<typename K>
+        iterator lower_bound_(const K &key) {
+            node *n = root_;
+            if (!n) {
+                return end();
+            }
+            int pos;
+            for (;;) {
+                pos = lower_bound_in_node_(n, key);
+                if constexpr (!Params::kIsMulti) {
+                    /// 唯一键：在内部节点上找到等价元素即可返回，左子树中不会再有等价元素
+                    if (pos < n->count && !comp_(key, n->key(pos))) {
+                        return iterator(n, pos);
+                    }
+                }
+                if (n->leaf) {
+                    break;
+                }
+                n = n->child(pos);
+            }
+            return internal_last_(iterator(n, pos));
+        }
+
+        template<typename K>
+        iterator upper_bound_(const K &key) {
+            node *n = root_;
+            if (!n) {
+                return end();
+            }
+            int pos;
+            for (;;) {
+                pos = upper_bound_in_node_(n, key);
+                if (n->leaf) {
+                    break;
+                }
+                n = n->child(pos);
+            }
+            return internal_last_(iterator(n, pos));
+        }
+
+        /// 把 src 中的元素移动到未初始化的 dst 上，并析构 src
+        static void relocate_(slot_type *dst, slot_type *src) {
+            ::new(static_cast<void *>(dst)) slot_type(std::move(*src));
+            src->~slot_type();
+        }
+
+        /// 已知大于等于所有元素时直接追加到最右叶子末尾（拷贝构造用）
+        template<typename V>
+        void append_back_(const V &value) {
+            if (!root_) {
+                root_ = leftmost_ = rightmost_ = new_leaf_();
+            }
+            alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+            slot_type *tmp = ::new(static_cast<void *>(buf)) slot_type(value);
+            insert_at_leaf_(rightmost_, rightmost_->count, tmp);
+        }
+
+        /// 把已经构造好的临时元素 tmp 搬到叶子 n 的 pos 位置，叶子满时先分裂
+        iterator insert_at_leaf_(node *n, int pos, slot_type *tmp) {
+            if (n->count == kNodeSlots) {
+                try {
+                    split_(n, pos);
+                } catch (...) {
+                    tmp->~slot_type();
+                    throw;
+                }
+            }
+            for (int i = n->count; i > pos; --i) {
+                relocate_(n->slot(i), n->slot(i - 1));
+            }
+            relocate_(n->slot(pos), tmp);
+            ++n->count;
+            ++size_;
+            return iterator(n, pos);
+        }
+
+        /**
+         * 分裂满节点 n，pos 是即将插入的位置，返回时 (n, pos) 更新为分裂后应插入的节点和位置
+         * 先保证父节点有空位（父节点满了就递归分裂父节点），n 是根时新建一个根
+         * 分裂点根据插入位置偏移：插在最右边时右节点为空，左节点保持满，顺序插入的节点利用率接近 100%
+         */
+        void split_(node *&n, int &pos) {
+            if (n->parent) {
+                if (n->parent->count == kNodeSlots) {
+                    node *p = n->parent;
+                    int ppos = n->position;
+                    split_(p, ppos);
+                }
+            } else {
+                node *new_root = new_internal_();
+                new_root->set_child(0, n);
+                root_ = new_root;
+            }
+
+            node *right = n->leaf ? new_leaf_() : new_internal_();
+            int rcount = pos == 0 ? kNodeSlots - 1 : (pos == kNodeSlots ? 0 : kNodeSlots / 2);
+            int median = kNodeSlots - rcount - 1;
+            for (int i = 0; i < rcount; ++i) {
+                relocate_(right->slot(i), n->slot(median + 1 + i));
+            }
+            if (!n->leaf) {
+                for (int i = 0; i <= rcount; ++i) {
+                    right->set_child(i, n->child(median + 1 + i));
+                }
+            }
+            right->count = static_cast<uint16_t>(rcount);
+            n->count = static_cast<uint16_t>(median);
+
+            /// 中间元素上移到父节点，right 成为它右边的孩子
+            node *parent = n->parent;
+            int at = n->position;
+            for (int i = parent->count; i > at; --i) {
+                relocate_(parent->slot(i), parent->slot(i - 1));
+            }
+            relocate_(parent->slot(at), n->slot(median));
+            for (int i = parent->count + 1; i > at + 1; --i) {
+                parent->set_child(i, parent->child(i - 1));
+            }
+            parent->set_child(at + 1, right);
+            ++parent->count;
+
+            if (n == rightmost_) {
+                rightmost_ = right;
+            }
+            if (pos > median) {
+                n = right;
+                pos -= median + 1;
+            }
+        }
+
+        /// 删除后自底向上修复：节点元素过少时与兄弟合并或者从兄弟借元素
+        iterator rebalance_after_delete_(iterator it) {
+            iterator res = it;
+            bool first_iteration = true;
+            for (;;) {
+                if (it.node_ == root_) {
+                    try_shrink_();
+                    if (empty()) {
+                        return end();
+                    }
+                    break;
+                }
+                if (it.node_->count >= kMinNodeValues) {
+                    break;
+                }
+                bool merged = try_merge_or_rebalance_(it);
+                /// 第一轮修复的是 res 所在的节点，res 需要跟着移动
+                if (first_iteration) {
+                    res = it;
+                    first_iteration = false;
+                }
+                if (!merged) {
+                    break;
+                }
+                it.position_ = it.node_->position;
+                it.node_ = it.node_->parent;
+            }
+            if (res.position_ == res.node_->count) {
+                res.position_ = res.node_->count - 1;
+                ++res;
+            }
+            return res;
+        }
+
+        /// 返回是否发生了合并（合并后父节点少了一个元素，需要继续向上检查）
+        bool try_merge_or_rebalance_(iterator &it) {
+            node *n = it.node_;
+            node *parent = n->parent;
+            if (n->position > 0) {
+                /// 尝试和左兄弟合并
+                node *left = parent->child(n->position - 1);
+                if (1 + left->count + n->count <= kNodeSlots) {
+                    it.position_ += 1 + left->count;
+                    merge_nodes_(left, n);
+                    it.node_ = left;
+                    return true;
+                }
+            }
+            if (n->position < parent->count) {
+                /// 尝试和右兄弟合并
+                node *right = parent->child(n->position + 1);
+                if (1 + n->count + right->count <= kNodeSlots) {
+                    merge_nodes_(n, right);
+                    return true;
+                }
+                /// 从右兄弟借元素；删除的是节点的第一个元素且节点非空时不借（从前往后删除的常见模式）
+                if (right->count > kMinNodeValues && (n->count == 0 || it.position_ > 0)) {
+                    int to_move = (right->count - n->count) / 2;
+                    to_move = to_move < right->count - 1 ? to_move : right->count - 1;
+                    if (to_move > 0) {
+                        rebalance_right_to_left_(n, to_move, right);
+                    }
+                    return false;
+                }
+            }
+            if (n->position > 0) {
+                /// 从左兄弟借元素；删除的是节点的最后一个元素且节点非空时不借（从后往前删除的常见模式）
+                node *left = parent->child(n->position - 1);
+                if (left->count > kMinNodeValues && (n->count == 0 || it.position_ < n->count)) {
+                    int to_move = (left->count - n->count) / 2;
+                    to_move = to_move < left->count - 1 ? to_move : left->count - 1;
+                    if (to_move > 0) {
+                        rebalance_left_to_right_(left, to_move, n);
+                        it.position_ += to_move;
+                    }
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        /// 把 right 和父节点中的分隔元素一起并入 left，释放 right
+        void merge_nodes_(node *left, node *right) {
+            node *parent = left->parent;
+            int sep = left->position;
+            relocate_(left->slot(left->count), parent->slot(sep));
+            for (int i = 0; i < right->count; ++i) {
+                relocate_(left->slot(left->count + 1 + i), right->slot(i));
+            }
+            if (!left->leaf) {
+                for (int i = 0; i <= right->count; ++i) {
+                    left->set_child(left->count + 1 + i, right->child(i));
+                }
+            }
+            left->count = static_cast<uint16_t>(left->count + 1 + right->count);
+
+            /// 从父节点中去掉分隔元素和指向 right 的孩子指针
+            for (int i = sep + 1; i < parent->count; ++i) {
+                relocate_(parent->slot(i - 1), parent->slot(i));
+            }
+            for (int i = sep + 2; i <= parent->count; ++i) {
+                parent->set_child(i - 1, parent->child(i));
+            }
+            --parent->count;
+
+            if (right == rightmost_) {
+                rightmost_ = left;
+            }
+            right->count = 0;
+            free_node_(right);
+        }
+
+        /// 从右兄弟 right 借 to_move 个元素给 left（经过父节点中的分隔元素轮转）
+        void rebalance_right_to_left_(node *left, int to_move, node *right) {
+            node *parent = left->parent;
+            int sep = left->position;
+            relocate_(left->slot(left->count), parent->slot(sep));
+            for (int i = 1; i < to_move; ++i) {
+                relocate_(left->slot(left->count + i), right->slot(i - 1));
+            }
+            relocate_(parent->slot(sep), right->slot(to_move - 1));
+            for (int i = to_move; i < right->count; ++i) {
+                relocate_(right->slot(i - to_move), right->slot(i));
+            }
+            if (!left->leaf) {
+                for (int i = 0; i < to_move; ++i) {
+                    left->set_child(left->count + 1 + i, right->child(i));
+                }
+                for (int i = to_move; i <= right->count; ++i) {
+                    right->set_child(i - to_move, right->child(i));
+                }
+            }
+            left->count = static_cast<uint16_t>(left->count + to_move);
+            right->count = static_cast<uint16_t>(right->count - to_move);
+        }
+
+        /// 从左兄弟 left 借 to_move 个元素给 right
+        void rebalance_left_to_right_(node *left, int to_move, node *right) {
+            node *parent = left->parent;
+            int sep = left->position;
+            for (int i = right->count - 1; i >= 0; --i) {
+                relocate_(right->slot(i + to_move), right->slot(i));
+            }
+            relocate_(right->slot(to_move - 1), parent->slot(sep));
+            for (int i = 0; i < to_move - 1; ++i) {
+                relocate_(right->slot(i), left->slot(left->count - to_move + 1 + i));
+            }
+            relocate_(parent->slot(sep), left->slot(left->count - to_move));
+            if (!left->leaf) {
+                for (int i = right->count; i >= 0; --i) {
+                    right->set_child(i + to_move, right->child(i));
+                }
+                for (int i = 0; i < to_move; ++i) {
+                    right->set_child(i, left->child(left->count - to_move + 1 + i));
+                }
+            }
+            left->count = static_cast<uint16_t>(left->count - to_move);
+            right->count = static_cast<uint16_t>(right->count + to_move);
+        }
+
+        /// 根节点变空时降低树高
+        void try_shrink_() {
+            if (root_->count > 0) {
+                return;
+            }
+            node *old_root = root_;
+            if (old_root->leaf) {
+                root_ = leftmost_ = rightmost_ = nullptr;
+            } else {
+                root_ = old_root->child(0);
+                root_->parent = nullptr;
+                root_->position = 0;
+            }
+            free_node_(old_root);
+        }
+
+        /// 节点内存由保存的分配器 rebind 出来的节点分配器分配，有状态的分配器（内存池等）也能正确使用
+        node *new_leaf_() {
+            leaf_allocator alloc(alloc_);
+            node *n = alloc.allocate(1);
+            ::new(static_cast<void *>(n)) node;
+            n->parent = nullptr;
+            n->position = 0;
+            n->count = 0;
+            n->leaf = true;
+            return n;
+        }
+
+        node *new_internal_() {
+            internal_allocator alloc(alloc_);
+            internal_node *n = alloc.allocate(1);
+            ::new(static_cast<void *>(n)) internal_node;
+            n->parent = nullptr;
+            n->position = 0;
+            n->count = 0;
+            n->leaf = false;
+            return n;
+        }
+
+        /// 释放节点内存（节点中的元素需要调用方事先析构或搬走）
+        void free_node_(node *n) {
+            if (n->leaf) {
+                leaf_allocator alloc(alloc_);
+                alloc.deallocate(n, 1);
+            } else {
+                internal_allocator alloc(alloc_);
+                alloc.deallocate(static_cast<internal_node *>(n), 1);
+            }
+        }
+
+        void destroy_subtree_(node *n) {
+            if (!n->leaf) {
+                for (int i = 0; i <= n->count; ++i) {
+                    destroy_subtree_(n->child(i));
+                }
+            }
+            for (int i = 0; i < n->count; ++i) {
+                n->slot(i)->~slot_type();
+            }
+            free_node_(n);
+        }
+
+        size_type verify_node_(const node *n, int depth, int &leaf_depth) const {
+            if (n != root_ && n->count == 0) {
+                return static_cast<size_type>(-1);
+            }
+            for (int i = 1; i < n->count; ++i) {
+                if (comp_(n->key(i), n->key(i - 1))) {
+                    return static_cast<size_type>(-1);
+                }
+            }
+            if (n->leaf) {
+                if (leaf_depth == -1) {
+                    leaf_depth = depth;
+                }
+                return leaf_depth == depth ? n->count : static_cast<size_type>(-1);
+            }
+            size_type total = n->count;
+            for (int i = 0; i <= n->count; ++i) {
+                const node *c = n->child(i);
+                if (c->parent != n || c->position != i) {
+                    return static_cast<size_type>(-1);
+                }
+                /// 孩子中的元素必须夹在两侧的分隔元素之间
+                if (i > 0 && c->count > 0 && comp_(c->key(0), n->key(i - 1))) {
+                    return static_cast<size_type>(-1);
+                }
+                if (i < n->count && c->count > 0 && comp_(n->key(i), c->key(c->count - 1))) {
+                    return static_cast<size_type>(-1);
+                }
+                size_type sub = verify_node_(c, depth + 1, leaf_depth);
+                if (sub == static_cast<size_type>(-1)) {
+                    return sub;
+                }
+                total += sub;
+            }
+            return total;
+        }
+
+    private:
+        node *root_;            /// 根节点，空树为 nullptr
+        node *leftmost_;        /// 最左叶子，begin()
+        node *rightmost_;       /// 最右叶子，end() = (rightmost_, rightmost_->count)
+        size_type size_;        /// 元素个数
+        key_compare comp_;      /// key 比较器
+        [[no_unique_address]] allocator_type alloc_;    /// 元素的分配器，空分配器不占空间
+    };
+
+    namespace detail {
+        /**
+         * 四种 B 树容器共享的接口：迭代器、容量、查找、删除
+         * 插入接口（唯一/可重复、map 的 operator[] 等）由具体容器提供
+         * 查找接口除了 key_type 版本，在 Compare 声明 is_transparent 时还提供异构查找版本
+         */
+        template<typename Params>
+        class btree_container {
+        protected:
+            using tree_type = btree<Params>;
+
+        public:
+            using key_type = typename Params::key_type;
+            using value_type = typename Params::value_type;
+            using key_compare = typename Params::key_compare;
+            using allocator_type = typename Params::allocator_type;
+            using size_type = typename tree_type::size_type;
+            using difference_type = typename tree_type::difference_type;
+            using reference = value_type &;
+            using const_reference = const value_type &;
+            using iterator = typename tree_type::iterator;
+            using const_iterator = typename tree_type::const_iterator;
+
+            btree_container() = default;
+
+            explicit btree_container(const key_compare &comp, const allocator_type &alloc = allocator_type())
+                    : tree_(comp, alloc) {}
+
+            iterator begin() { return tree_.begin(); }
+
+            const_iterator begin() const { return tree_.begin(); }
+
+            const_iterator cbegin() const { return tree_.begin(); }
+
+            iterator end() { return tree_.end(); }
+
+            const_iterator end() const { return tree_.end(); }
+
+            const_iterator cend() const { return tree_.end(); }
+
+            size_type size() const { return tree_.size(); }
+
+            bool empty() const { return tree_.empty(); }
+
+            key_compare key_comp() const { return tree_.key_comp(); }
+
+            allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+            void clear() { tree_.clear(); }
+
+            /// 批量插入有序区间：位于现有元素之后的部分直接追加到最右叶子，均摊 O(1)
+            template<typename InputIt>
+            void insert_sorted(InputIt first, InputIt last) { tree_.insert_sorted(first, last); }
+
+            /// 查找
+            iterator find(const key_type &key) { return tree_.find(key); }
+
+            const_iterator find(const key_type &key) const { return tree_.find(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator find(const K &key) { return tree_.find(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            const_iterator find(const K &key) const { return tree_.find(key); }
+
+            bool contains(const key_type &key) const { return tree_.find(key) != tree_.end(); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            bool contains(const K &key) const { return tree_.find(key) != tree_.end(); }
+
+            size_type count(const key_type &key) const { return tree_.count(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            size_type count(const K &key) const { return tree_.count(key); }
+
+            iterator lower_bound(const key_type &key) { return tree_.lower_bound(key); }
+
+            const_iterator lower_bound(const key_type &key) const { return tree_.lower_bound(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator lower_bound(const K &key) { return tree_.lower_bound(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            const_iterator lower_bound(const K &key) const { return tree_.lower_bound(key); }
+
+            iterator upper_bound(const key_type &key) { return tree_.upper_bound(key); }
+
+            const_iterator upper_bound(const key_type &key) const { return tree_.upper_bound(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator upper_bound(const K &key) { return tree_.upper_bound(key); }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            const_iterator upper_bound(const K &key) const { return tree_.upper_bound(key); }
+
+            std::pair<iterator, iterator> equal_range(const key_type &key) { return tree_.equal_range(key); }
+
+            std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+                return tree_.equal_range(key);
+            }
+
+            template<typename K, typename C = key_compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            std::pair<iterator, iterator> equal_range(const K &key) { return tree_.equal_range(key); }
+
+            /// 删除（会使所有迭代器失效，返回值是删除位置之后的元素）
+            iterator erase(iterator pos) { return tree_.erase(pos); }
+
+            iterator erase(const_iterator pos) { return tree_.erase(to_mutable_(pos)); }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                return tree_.erase(to_mutable_(first), to_mutable_(last));
+            }
+
+            size_type erase(const key_type &key) { return tree_.erase_key(key); }
+
+            /// 调试/测试用
+            bool verify() const { return tree_.verify(); }
+
+            size_type height() const { return tree_.height(); }
+
+            bool operator==(const btree_container &other) const {
+                if (size() != other.size()) {
+                    return false;
+                }
+                for (const_iterator a = begin(), b = other.begin(); a != end(); ++a, ++b) {
+                    if (!(*a == *b)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool operator!=(const btree_container &other) const {
+                return !(*this == other);
+            }
+
+        protected:
+            iterator to_mutable_(const_iterator it) {
+                return tree_.to_mutable(it);
+            }
+
+            tree_type tree_;
+        };
+    }
+}
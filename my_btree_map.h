@@ -0,0 +1,186 @@
+/**
+ * @file      my_btree_map.h
+ * @brief     [基于B树的btree_map和btree_multimap]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_btree.h"
+#include <initializer_list>
+
+namespace my {
+
+// ============================ my::btree_map ============================
+    /// 接口与 my::map 相同；元素紧凑地存放在宽节点中，查找和顺序遍历的缓存命中率远高于红黑树
+    /// 注意：插入和删除会使所有迭代器失效
+    template<typename Key,
+            typename T,
+            typename Compare = std::less<Key>,
+            typename Alloc = MyAlloc<std::pair<const Key, T>>>
+    class btree_map : public detail::btree_container<detail::btree_map_params<Key, T, Compare, Alloc, false>> {
+        using base = detail::btree_container<detail::btree_map_params<Key, T, Compare, Alloc, false>>;
+        using base::tree_;
+    public:
+        using mapped_type = T;
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::key_compare;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        btree_map() = default;
+
+        explicit btree_map(const key_compare &comp, const allocator_type &alloc = allocator_type()) : base(comp, alloc) {}
+
+        template<typename InputIt>
+        btree_map(InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            insert(first, last);
+        }
+
+        btree_map(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+                : btree_map(ilist.begin(), ilist.end(), comp) {}
+
+        /// 输入已经有序（没有重复）：逐个追加到最右叶子，O(n)
+        template<typename InputIt>
+        btree_map(sorted_unique_t, InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            tree_.insert_sorted(first, last);
+        }
+
+        /// 插入：key 已存在时不插入，返回已有元素
+        std::pair<iterator, bool> insert(const value_type &val) {
+            return tree_.insert_unique(val.first, val);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&val) {
+            return tree_.insert_unique(val.first, std::move(val));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return tree_.emplace_unique(std::forward<Args>(args)...);
+        }
+
+        /// key 不存在时才构造 mapped 对象
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+            return tree_.insert_unique(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                       std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&... args) {
+            return tree_.insert_unique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                       std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+            auto res = try_emplace(key, std::forward<M>(obj));
+            if (!res.second) {
+                res.first->second = std::forward<M>(obj);
+            }
+            return res;
+        }
+
+        T &operator[](const key_type &key) {
+            return try_emplace(key).first->second;
+        }
+
+        T &operator[](key_type &&key) {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        T &at(const key_type &key) {
+            iterator it = tree_.find(key);
+            if (it == tree_.end()) {
+                throw std::out_of_range("btree_map::at");
+            }
+            return it->second;
+        }
+
+        const T &at(const key_type &key) const {
+            const_iterator it = tree_.find(key);
+            if (it == tree_.end()) {
+                throw std::out_of_range("btree_map::at");
+            }
+            return it->second;
+        }
+
+        void swap(btree_map &other) noexcept {
+            tree_.swap(other.tree_);
+        }
+    };
+
+// ============================ my::btree_multimap ============================
+    template<typename Key,
+            typename T,
+            typename Compare = std::less<Key>,
+            typename Alloc = MyAlloc<std::pair<const Key, T>>>
+    class btree_multimap : public detail::btree_container<detail::btree_map_params<Key, T, Compare, Alloc, true>> {
+        using base = detail::btree_container<detail::btree_map_params<Key, T, Compare, Alloc, true>>;
+        using base::tree_;
+    public:
+        using mapped_type = T;
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::key_compare;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        btree_multimap() = default;
+
+        explicit btree_multimap(const key_compare &comp, const allocator_type &alloc = allocator_type()) : base(comp, alloc) {}
+
+        template<typename InputIt>
+        btree_multimap(InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            insert(first, last);
+        }
+
+        btree_multimap(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+                : btree_multimap(ilist.begin(), ilist.end(), comp) {}
+
+        /// 输入已经有序（可以有重复）：逐个追加到最右叶子，O(n)
+        template<typename InputIt>
+        btree_multimap(sorted_equivalent_t, InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            tree_.insert_sorted(first, last);
+        }
+
+        /// 等价的 key 按插入顺序排列
+        iterator insert(const value_type &val) {
+            return tree_.emplace_multi(val);
+        }
+
+        iterator insert(value_type &&val) {
+            return tree_.emplace_multi(std::move(val));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        template<typename... Args>
+        iterator emplace(Args &&... args) {
+            return tree_.emplace_multi(std::forward<Args>(args)...);
+        }
+
+        void swap(btree_multimap &other) noexcept {
+            tree_.swap(other.tree_);
+        }
+    };
+}
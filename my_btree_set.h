@@ -0,0 +1,133 @@
+/**
+ * @file      my_btree_set.h
+ * @brief     [基于B树的btree_set和btree_multiset]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_btree.h"
+#include <initializer_list>
+
+namespace my {
+
+// ============================ my::btree_set ============================
+    /// 接口与 my::set 相同；迭代器只读，插入和删除会使所有迭代器失效
+    template<typename Key,
+            typename Compare = std::less<Key>,
+            typename Alloc = MyAlloc<Key>>
+    class btree_set : public detail::btree_container<detail::btree_set_params<Key, Compare, Alloc, false>> {
+        using base = detail::btree_container<detail::btree_set_params<Key, Compare, Alloc, false>>;
+        using base::tree_;
+    public:
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::key_compare;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        btree_set() = default;
+
+        explicit btree_set(const key_compare &comp, const allocator_type &alloc = allocator_type()) : base(comp, alloc) {}
+
+        template<typename InputIt>
+        btree_set(InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            insert(first, last);
+        }
+
+        btree_set(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+                : btree_set(ilist.begin(), ilist.end(), comp) {}
+
+        /// 输入已经有序（没有重复）：逐个追加到最右叶子，O(n)
+        template<typename InputIt>
+        btree_set(sorted_unique_t, InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            tree_.insert_sorted(first, last);
+        }
+
+        std::pair<iterator, bool> insert(const value_type &val) {
+            return tree_.insert_unique(val, val);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&val) {
+            return tree_.insert_unique(val, std::move(val));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return tree_.emplace_unique(std::forward<Args>(args)...);
+        }
+
+        void swap(btree_set &other) noexcept {
+            tree_.swap(other.tree_);
+        }
+    };
+
+// ============================ my::btree_multiset ============================
+    template<typename Key,
+            typename Compare = std::less<Key>,
+            typename Alloc = MyAlloc<Key>>
+    class btree_multiset : public detail::btree_container<detail::btree_set_params<Key, Compare, Alloc, true>> {
+        using base = detail::btree_container<detail::btree_set_params<Key, Compare, Alloc, true>>;
+        using base::tree_;
+    public:
+        using typename base::key_type;
+        using typename base::value_type;
+        using typename base::key_compare;
+        using typename base::allocator_type;
+        using typename base::size_type;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        btree_multiset() = default;
+
+        explicit btree_multiset(const key_compare &comp, const allocator_type &alloc = allocator_type()) : base(comp, alloc) {}
+
+        template<typename InputIt>
+        btree_multiset(InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            insert(first, last);
+        }
+
+        btree_multiset(std::initializer_list<value_type> ilist, const key_compare &comp = key_compare())
+                : btree_multiset(ilist.begin(), ilist.end(), comp) {}
+
+        /// 输入已经有序（可以有重复）：逐个追加到最右叶子，O(n)
+        template<typename InputIt>
+        btree_multiset(sorted_equivalent_t, InputIt first, InputIt last, const key_compare &comp = key_compare()) : base(comp) {
+            tree_.insert_sorted(first, last);
+        }
+
+        iterator insert(const value_type &val) {
+            return tree_.emplace_multi(val);
+        }
+
+        iterator insert(value_type &&val) {
+            return tree_.emplace_multi(std::move(val));
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        template<typename... Args>
+        iterator emplace(Args &&... args) {
+            return tree_.emplace_multi(std::forward<Args>(args)...);
+        }
+
+        void swap(btree_multiset &other) noexcept {
+            tree_.swap(other.tree_);
+        }
+    };
+}
@@ -0,0 +1,301 @@
+/**
+ * @file      my_concurrent_unordered_map.h
+ * @brief     [基于hashtable分段加锁的并发哈希表]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_futex.h"
+#include "my_hashtable.h"
+#include "my_optional.h"
+#include "my_unique_ptr.h"
+#include "memory_/my_allocator.h"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * concurrent_unordered_map
+ * 锁分段（lock striping）：整张表被拆成 2^k 个段（segment），每个段是一张独立的 my::hashtable，并且有自己的锁
+ *      写操作只锁住 key 所在的段，不同段上的写操作互不阻塞
+ * 读操作：段锁是读写自旋锁，读者之间只做一次原子加减，互不阻塞，只有遇到同段的写者时才等待
+ *      （真正无锁的读需要配合 epoch/hazard pointer 等内存回收方案，本库暂不提供，因此这里采用共享锁）
+ * 扩容：每个段各自按 rehash_policy 扩容，扩容只持有本段的写锁，其他段的读写照常进行
+ */
+
+namespace my {
+    namespace detail {
+        /**
+         * 每个段锁的状态放在一个 32 位字里：最高位表示写者持有，中间 15 位是正在等待的写者个数，低 16 位为读者计数
+         * 等待的写者个数不为 0 时新读者不能进入（避免写者饥饿）；写者拿到锁时只把自己从等待计数里减掉，
+         *      unlock 也只清掉持有位，其他还在自旋的写者一直挡着新读者，不会被后来的读者插队
+         * 读者计数最多 65535，同一段上同时持有读锁的线程不会有这么多
+         */
+        class stripe_lock {
+        public:
+            stripe_lock() : state_(0) {}
+
+            stripe_lock(const stripe_lock &) = delete;
+
+            stripe_lock &operator=(const stripe_lock &) = delete;
+
+            /// 独占锁（写）：先登记为等待者，没有读者也没有写者持有时一次 CAS 同时撤销登记并获得锁
+            void lock() {
+                uint32_t s = state_.fetch_add(kWaiter_, std::memory_order_relaxed) + kWaiter_;
+                for (unsigned spin = 0;; ++spin) {
+                    if ((s & (kWriter_ | kReaderMask_)) == 0) {
+                        if (state_.compare_exchange_weak(s, (s - kWaiter_) | kWriter_, std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+                            return;
+                        }
+                        continue;
+                    }
+                    spin_backoff(spin);
+                    s = state_.load(std::memory_order_relaxed);
+                }
+            }
+
+            /// 只清掉持有位，等待的写者计数保持不变
+            void unlock() {
+                state_.fetch_and(~kWriter_, std::memory_order_release);
+            }
+
+            /// 共享锁（读）
+            void lock_shared() {
+                for (unsigned spin = 0;; ++spin) {
+                    uint32_t s = state_.load(std::memory_order_relaxed);
+                    if (!(s & (kWriter_ | kWaiterMask_))) {
+                        if (state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire,
+                                                         std::memory_order_relaxed)) {
+                            return;
+                        }
+                        continue;       /// 只是和其他读者竞争失败，立即重试
+                    }
+                    spin_backoff(spin);
+                }
+            }
+
+            void unlock_shared() {
+                state_.fetch_sub(1, std::memory_order_release);
+            }
+
+        private:
+            static constexpr uint32_t kWriter_ = 1u << 31;
+            static constexpr uint32_t kWaiter_ = 1u << 16;
+            static constexpr uint32_t kWaiterMask_ = kWriter_ - kWaiter_;
+            static constexpr uint32_t kReaderMask_ = kWaiter_ - 1;
+
+            std::atomic<uint32_t> state_;
+        };
+
+        /// RAII 共享锁守卫，对应 lock_guard 的读版本
+        class stripe_shared_guard {
+        public:
+            explicit stripe_shared_guard(stripe_lock &lock) : lock_(lock) {
+                lock_.lock_shared();
+            }
+
+            ~stripe_shared_guard() {
+                lock_.unlock_shared();
+            }
+
+            stripe_shared_guard(const stripe_shared_guard &) = delete;
+
+            stripe_shared_guard &operator=(const stripe_shared_guard &) = delete;
+
+        private:
+            stripe_lock &lock_;
+        };
+
+        class stripe_unique_guard {
+        public:
+            explicit stripe_unique_guard(stripe_lock &lock) : lock_(lock) {
+                lock_.lock();
+            }
+
+            ~stripe_unique_guard() {
+                lock_.unlock();
+            }
+
+            stripe_unique_guard(const stripe_unique_guard &) = delete;
+
+            stripe_unique_guard &operator=(const stripe_unique_guard &) = delete;
+
+        private:
+            stripe_lock &lock_;
+        };
+    }
+
+    template<typename Key,
+            typename T,
+            typename Hash = std::hash<Key>,
+            typename Pred = std::equal_to<Key>,
+            typename Alloc = MyAlloc<std::pair<const Key, T>>>
+    class concurrent_unordered_map {
+    public:
+        /// 定义类型
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<const Key, T>;
+        using hash_table = my::hashtable<Key, value_type, my::_Select1st, std::true_type, Hash, Pred, Alloc>;
+        using size_type = typename hash_table::size_type;
+        using hasher = Hash;
+
+    private:
+        /// 每个段独占一条缓存行，避免不同段的锁之间产生伪共享
+        struct alignas(64) segment {
+            segment() : table_(0) {}
+
+            mutable detail::stripe_lock lock_;
+            hash_table table_;
+        };
+
+    public:
+        /// n: 预期的总元素个数；concurrency: 期望的并发写线程数，段数取不小于它的 2 的幂
+        explicit concurrent_unordered_map(size_type n = 64, size_type concurrency = 16)
+                : hash_(hasher()) {
+            seg_count_ = 1;
+            while (seg_count_ < concurrency) {
+                seg_count_ <<= 1;
+            }
+            seg_mask_ = seg_count_ - 1;
+            segments_.reset(new segment[seg_count_]);
+            for (size_type i = 0; i < seg_count_; ++i) {
+                segments_[i].table_ = hash_table(n / seg_count_ + 1);
+            }
+        }
+
+        /// 并发容器不支持拷贝和移动（段内含锁）
+        concurrent_unordered_map(const concurrent_unordered_map &) = delete;
+
+        concurrent_unordered_map &operator=(const concurrent_unordered_map &) = delete;
+
+        ~concurrent_unordered_map() = default;
+
+        /// 插入或覆盖，返回 true 表示新插入，false 表示覆盖了已有值
+        bool insert_or_assign(const key_type &key, const mapped_type &value) {
+            segment &seg = segment_for_(key);
+            detail::stripe_unique_guard guard(seg.lock_);
+            return seg.table_.insert_or_assign(key, value).second;
+        }
+
+        /// 仅当 key 不存在时插入，返回是否插入成功
+        bool insert(const key_type &key, const mapped_type &value) {
+            segment &seg = segment_for_(key);
+            detail::stripe_unique_guard guard(seg.lock_);
+            return seg.table_.try_emplace(key, value).second;
+        }
+
+        /// 查找并返回值的拷贝，不存在时返回空 optional
+        my::optional<mapped_type> find(const key_type &key) const {
+            const segment &seg = segment_for_(key);
+            detail::stripe_shared_guard guard(seg.lock_);
+            auto it = seg.table_.find(key);
+            if (it == seg.table_.end()) {
+                return my::optional<mapped_type>();
+            }
+            return my::optional<mapped_type>(it->second);
+        }
+
+        /// 访问器版本：在持有共享锁期间以 const mapped_type& 调用 func，避免拷贝大对象
+        template<typename Func>
+        bool find(const key_type &key, Func &&func) const {
+            const segment &seg = segment_for_(key);
+            detail::stripe_shared_guard guard(seg.lock_);
+            auto it = seg.table_.find(key);
+            if (it == seg.table_.end()) {
+                return false;
+            }
+            func(it->second);
+            return true;
+        }
+
+        /// 在持有写锁期间以 mapped_type& 调用 func，用于原地修改
+        template<typename Func>
+        bool modify(const key_type &key, Func &&func) {
+            segment &seg = segment_for_(key);
+            detail::stripe_unique_guard guard(seg.lock_);
+            auto it = seg.table_.find(key);
+            if (it == seg.table_.end()) {
+                return false;
+            }
+            func(it->second);
+            return true;
+        }
+
+        bool contains(const key_type &key) const {
+            const segment &seg = segment_for_(key);
+            detail::stripe_shared_guard guard(seg.lock_);
+            return seg.table_.find(key) != seg.table_.end();
+        }
+
+        size_type erase(const key_type &key) {
+            segment &seg = segment_for_(key);
+            detail::stripe_unique_guard guard(seg.lock_);
+            return seg.table_.erase(key);
+        }
+
+        /// 逐段持有共享锁遍历，func 接收 const value_type&
+        /// 注意：遍历不是整表的快照，遍历期间其他段上的修改可能被看到也可能看不到
+        template<typename Func>
+        void for_each(Func &&func) const {
+            for (size_type i = 0; i < seg_count_; ++i) {
+                const segment &seg = segments_[i];
+                detail::stripe_shared_guard guard(seg.lock_);
+                for (auto it = seg.table_.begin(); it != seg.table_.end(); ++it) {
+                    func(*it);
+                }
+            }
+        }
+
+        /// 元素个数，各段分别加锁统计，并发修改时只是一个近似值
+        size_type size() const {
+            size_type n = 0;
+            for (size_type i = 0; i < seg_count_; ++i) {
+                detail::stripe_shared_guard guard(segments_[i].lock_);
+                n += segments_[i].table_.size();
+            }
+            return n;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        void clear() {
+            for (size_type i = 0; i < seg_count_; ++i) {
+                detail::stripe_unique_guard guard(segments_[i].lock_);
+                segments_[i].table_.clear();
+            }
+        }
+
+        size_type segment_count() const {
+            return seg_count_;
+        }
+
+    private:
+        /// 段下标：对哈希值做一次高低位混合，再取低位，避免和段内按素数取模的桶下标相关
+        size_type segment_index_(const key_type &key) const {
+            size_t h = hash_(key);
+            h ^= h >> 16;
+            h *= 0x9E3779B97F4A7C15ull;
+            return (h >> (sizeof(size_t) * 4)) & seg_mask_;
+        }
+
+        segment &segment_for_(const key_type &key) {
+            return segments_[segment_index_(key)];
+        }
+
+        const segment &segment_for_(const key_type &key) const {
+            return segments_[segment_index_(key)];
+        }
+
+    private:
+        hasher hash_;                               /// 用于选段的哈希函数
+        size_type seg_count_;                       /// 段数（2 的幂）
+        size_type seg_mask_;                        /// seg_count_ - 1
+        my::unique_ptr<segment[]> segments_;        /// 段数组
+    };
+}
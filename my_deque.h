@@ -9,6 +9,7 @@
 
 #include "my_uninitialized.h"
 #include "my_iterator.h"
+#include "my_algorithm.h"
 
 #include <cassert>
 
@@ -19,10 +20,13 @@ namespace my {
     constexpr size_t default_chunk_size = (sizeof(T) < 256) ? (4096 / sizeof(T)) : 16;
 
     /// deque_iterator
-    template <typename T, typename Ref, typename Ptr>
+    /// ChunkSize 是每个块的元素个数，与所属 deque 的 ChunkSize 相同（块大小可以由 deque 的模板参数指定）
+    template <typename T, typename Ref, typename Ptr, size_t ChunkSize = default_chunk_size<T>>
     struct deque_iterator {
-        using iterator = deque_iterator<T, T&, T*>;
-        using const_iterator = deque_iterator<T,const T&,const T*>;
+        static_assert(ChunkSize > 0, "deque chunk size must not be zero");
+
+        using iterator = deque_iterator<T, T&, T*, ChunkSize>;
+        using const_iterator = deque_iterator<T,const T&,const T*, ChunkSize>;
         using self = deque_iterator;
 
         using elt_pointer = T*;         /// 表明节点里面的位置指针
@@ -41,21 +45,21 @@ namespace my {
         elt_pointer cur_;               /// 节点中现在处于哪个位置
         elt_pointer last_;              /// 最后的位置的下一个位置（迭代器末尾一般指向最后一个元素的下一个位置）
 
-        static constexpr size_t chunk_size_ = default_chunk_size<T>;
+        static constexpr size_t chunk_size_ = ChunkSize;
 //        size_t chunk_size_;
         /// 构造函数操作
         deque_iterator()
                 : node_(nullptr), first_(nullptr), cur_(nullptr), last_(nullptr) {}
 
         deque_iterator(elt_pointer cur, map_pointer node)
-                : node_(node), first_(*node), cur_(cur), last_(*node + default_chunk_size<T>){}
+                : node_(node), first_(*node), cur_(cur), last_(*node + chunk_size_){}
 
 //        deque_iterator(elt_pointer cur, map_pointer node)
 //                : node_(node), first_(*node), cur_(cur), last_(*node + default_chunk_size<T>) {}
 
 
         template <typename T2, typename Ref2, typename Ptr2>
-        deque_iterator(const deque_iterator<T2, Ref2, Ptr2>& x)
+        deque_iterator(const deque_iterator<T2, Ref2, Ptr2, ChunkSize>& x)
                 : node_(x.node_), first_(x.first_), cur_(x.cur_), last_(x.last_){}
 
         /// 解引用和指针操作
@@ -242,8 +246,42 @@ namespace my {
         }
     };
 
-    /// deque_base是deque的基类
-    template <typename T, typename Alloc = std::allocator<T>>
+    /**
+     * deque 迭代器是分段迭代器（见 my_algorithm.h）：段就是 map 中的一个节点，段内迭代器是指向块内元素的指针
+     * my::copy / move / fill / for_each / find / accumulate 遇到 deque 迭代器时按块处理，块内是普通的指针循环
+     * */
+    template <typename T, typename Ref, typename Ptr, size_t ChunkSize>
+    struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, ChunkSize>> {
+        using iterator = deque_iterator<T, Ref, Ptr, ChunkSize>;
+        using segment_iterator = typename iterator::map_pointer;
+        using local_iterator = Ptr;
+
+        static constexpr bool is_segmented = true;
+
+        static segment_iterator segment(const iterator& it) { return it.node_; }
+
+        static local_iterator local(const iterator& it) { return it.cur_; }
+
+        static local_iterator begin(segment_iterator node) { return *node; }
+
+        static local_iterator end(segment_iterator node) { return *node + iterator::chunk_size_; }
+
+        /// 块尾等价于下一块的开头，迭代器总是指向块内（与 operator++ 一致）
+        static iterator compose(segment_iterator node, local_iterator cur) {
+            if (cur == end(node)) {
+                ++node;
+                cur = *node;
+            }
+            return iterator(const_cast<T*>(cur), node);
+        }
+    };
+
+    /**
+     * deque_base是deque的基类
+     * 块的分配和释放都在这里：释放的块先放进一个最多 max_spare_chunks_ 个的备用块缓存，分配时优先从缓存中取，
+     * 一直 push_back / pop_front 的队列每跨过一个块边界就释放一个块、再申请一个块，有了缓存之后稳定状态下不再调用分配器
+     * */
+    template <typename T, typename Alloc = std::allocator<T>, size_t ChunkSize = default_chunk_size<T>>
     class deque_base {
     public:
         using value_type    = T;
@@ -254,12 +292,14 @@ namespace my {
         using const_reference = const value_type&;
         using pointer       = typename std::allocator_traits<Alloc>::pointer;
         using const_pointer       = typename std::allocator_traits<Alloc>::const_pointer;
-        using iterator = deque_iterator<T, T&, T*>;
-        using const_iterator = deque_iterator<T, const T&, const T*>;
+        using iterator = deque_iterator<T, T&, T*, ChunkSize>;
+        using const_iterator = deque_iterator<T, const T&, const T*, ChunkSize>;
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-        static constexpr size_t chunk_size_ = default_chunk_size<T>;
+        static constexpr size_t chunk_size_ = ChunkSize;
+        /// 备用块缓存的容量
+        static constexpr size_t max_spare_chunks_ = 4;
 
         using map_pointer   = typename iterator::map_pointer ; /// T**
 
@@ -283,7 +323,10 @@ namespace my {
 
         ~deque_base()
         {
-            destroy_nodes_(start_.node_, finish_.node_ + 1);
+            for (map_pointer n = start_.node_; n < finish_.node_ + 1; ++n) {
+                free_node_(*n);
+            }
+            release_spare_chunks_();
             map_allocator_.deallocate(map_, map_size_);
         }
 
@@ -296,6 +339,9 @@ namespace my {
             std::swap(map_size_, other.map_size_);
             std::swap(data_allocator_, other.data_allocator_);
             std::swap(map_allocator_, other.map_allocator_);
+            /// 备用块由各自的分配器分配，跟着分配器一起交换
+            std::swap(spare_chunks_, other.spare_chunks_);
+            std::swap(spare_count_, other.spare_count_);
         }
 
     protected:
@@ -306,6 +352,8 @@ namespace my {
         size_type map_size_;
         data_allocator data_allocator_;
         map_allocator map_allocator_;
+        pointer spare_chunks_[max_spare_chunks_] = {};   /// 备用块缓存，[0, spare_count_) 有效
+        size_type spare_count_ = 0;
 
         /// 析构节点对象以及析构节点和分配节点的接口
         void create_nodes_(map_pointer nstart, map_pointer nfinish)
@@ -321,8 +369,12 @@ namespace my {
             }
         }
 
+        /// 优先复用备用块
         pointer allocate_node()
         {
+            if (spare_count_ > 0) {
+                return spare_chunks_[--spare_count_];
+            }
             return data_allocator_.allocate(chunk_size_);
         }
 
@@ -333,11 +385,29 @@ namespace my {
             }
         }
 
+        /// 缓存没满时留作备用，否则还给分配器
         void deallocate_node_(pointer n)
+        {
+            if (spare_count_ < max_spare_chunks_) {
+                spare_chunks_[spare_count_++] = n;
+            } else {
+                free_node_(n);
+            }
+        }
+
+        void free_node_(pointer n)
         {
             data_allocator_.deallocate(n, chunk_size_);
         }
 
+        /// 把备用块全部还给分配器
+        void release_spare_chunks_()
+        {
+            while (spare_count_ > 0) {
+                free_node_(spare_chunks_[--spare_count_]);
+            }
+        }
+
     private:
         /// 初始化"map"控制器
         void initialize_map_(size_type num_elements)
@@ -366,10 +436,14 @@ namespace my {
         }
     };
 
-    template <typename T, typename Alloc = std::allocator<T>>
-    class deque : protected deque_base<T, Alloc> {
+    /**
+     * ChunkSize 是每个块的元素个数，默认约 4KB 一块（见 default_chunk_size）
+     * 元素很大或者队列很短时可以调小，纯顺序扫描的大队列可以调大来减少换块
+     * */
+    template <typename T, typename Alloc = std::allocator<T>, size_t ChunkSize = default_chunk_size<T>>
+    class deque : protected deque_base<T, Alloc, ChunkSize> {
     public:
-        using Base = deque_base<T, Alloc>;
+        using Base = deque_base<T, Alloc, ChunkSize>;
         using map_pointer = typename Base::map_pointer;
 
         using iterator = typename Base::iterator;
@@ -393,6 +467,7 @@ namespace my {
         using Base::map_;
         using Base::map_allocator_;
         using Base::map_size_;
+        using Base::release_spare_chunks_;
         using Base::start_;
         using Base::swap_data;
 
@@ -410,7 +485,7 @@ namespace my {
         }
 
         deque(const deque& other) : Base(other.size()) {
-            uninitialized_copy_a(other.begin(), other.end(), start_, data_allocator_);
+            uninitialized_copy_chunks_(other.begin(), other.end(), start_);
         }
 
         deque(deque&& other) noexcept : Base() {
@@ -535,6 +610,36 @@ namespace my {
             return start_ + off;
         }
 
+        /// 在 pos 之前插入 [first, last)，返回指向第一个新元素的迭代器；一次预留所需的块，再按块拷贝
+        template <typename InputIterator, typename = std::enable_if_t<!std::is_integral_v<InputIterator>>>
+        iterator insert(iterator pos, InputIterator first, InputIterator last) {
+            difference_type off = pos - start_;
+            range_insert_(pos, first, last,
+                          typename std::iterator_traits<InputIterator>::iterator_category());
+            return start_ + off;
+        }
+
+        /// 批量追加到尾部
+        template <typename InputIterator>
+        void append(InputIterator first, InputIterator last) {
+            range_insert_(end(), first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+        }
+
+        template <typename Range>
+        void push_back_range(Range&& range) {
+            append(std::begin(range), std::end(range));
+        }
+
+        /// 把前 n 个元素移动到 out 并删除，n 不能超过 size()，返回写完之后的 out；整块空出来的块直接回收
+        template <typename OutputIterator>
+        OutputIterator pop_front_n(size_type n, OutputIterator out) {
+            assert(n <= size() && "pop_front_n: n exceeds size()");
+            iterator pos = start_ + difference_type(n);
+            out = my::move(start_, pos, out);
+            erase_at_begin_(pos);
+            return out;
+        }
+
         /// pop
         void pop_front() {
             if (start_.cur_ != start_.last_ - 1) {
@@ -597,6 +702,11 @@ namespace my {
             return erase_(pos);
         }
 
+        /// 释放缓存的备用块
+        void shrink_to_fit() {
+            release_spare_chunks_();
+        }
+
         void swap(deque& other) {
             swap_data(other);
         }
@@ -633,6 +743,61 @@ namespace my {
             }
         }
 
+        /// 在未初始化的 [first, last) 上逐块构造 value 的拷贝，块内是指针循环；失败时析构已经构造好的部分
+        void uninitialized_fill_chunks_(iterator first, iterator last, const value_type& value) {
+            iterator cur = first;
+            try {
+                while (cur != last) {
+                    pointer chunk_last = cur.node_ == last.node_ ? last.cur_ : cur.last_;
+                    uninitialized_fill_a(cur.cur_, chunk_last, value, data_allocator_);
+                    cur += chunk_last - cur.cur_;
+                }
+            } catch (...) {
+                destroy_data_(first, cur);
+                throw;
+            }
+        }
+
+        /// 把 [first, last) 拷贝构造到从 result 开始的未初始化位置，源和目标都按块切开，返回目标的尾后位置
+        template <typename InputIterator>
+        iterator uninitialized_copy_chunks_(InputIterator first, InputIterator last, iterator result) {
+            iterator cur = result;
+            try {
+                if constexpr (is_segmented_iterator_v<InputIterator>) {
+                    detail::for_each_segment(first, last, [&](auto, auto local_first, auto local_last) {
+                        copy_into_chunks_(local_first, local_last, cur);
+                        return true;
+                    });
+                } else {
+                    copy_into_chunks_(first, last, cur);
+                }
+                return cur;
+            } catch (...) {
+                destroy_data_(result, cur);
+                throw;
+            }
+        }
+
+        /// 按目标的块逐块构造（源至少是前向迭代器），cur 随进度前进；块内失败时由 uninitialized_copy_a 回滚那一块
+        template <typename ForwardIterator>
+        void copy_into_chunks_(ForwardIterator first, ForwardIterator last, iterator& cur) {
+            for (difference_type n = std::distance(first, last); n > 0;) {
+                difference_type step = std::min<difference_type>(n, cur.last_ - cur.cur_);
+                ForwardIterator next = std::next(first, step);
+                uninitialized_copy_a(first, next, cur.cur_, data_allocator_);
+                first = next;
+                cur += step;
+                n -= step;
+            }
+        }
+
+        /// 析构 [begin(), pos) 并释放（回收）其中整块空出来的块
+        void erase_at_begin_(iterator pos) {
+            destroy_data_(begin(), pos);
+            destroy_nodes_(start_.node_, pos.node_);
+            start_ = pos;
+        }
+
         void erase_at_end_(iterator pos) {
             destroy_data_(pos, end());
             destroy_nodes_(pos.node_ + 1, finish_.node_ + 1);
@@ -726,8 +891,13 @@ namespace my {
                 map_ = new_map;
                 map_size_ = new_map_size;
             }
+            /// set_node_ 会把 cur_ 放到块首，需要恢复原来在块内的偏移
+            difference_type start_offset = start_.cur_ - start_.first_;
+            difference_type finish_offset = finish_.cur_ - finish_.first_;
             start_.set_node_(new_nstart);
+            start_.cur_ = start_.first_ + start_offset;
             finish_.set_node_(new_nstart + old_num_nodes - 1);
+            finish_.cur_ = finish_.first_ + finish_offset;
         }
 
         template <typename... Args>
@@ -790,7 +960,7 @@ namespace my {
                 pos = start_ + index;
                 iterator pos1 = pos;
                 ++pos1;
-                std::copy(front2, pos1, front1);  /// [front2, pos1) -> [front1, pos)
+                my::move(front2, pos1, front1);  /// [front2, pos1) -> [front1, pos)
             } else {
                 push_back(back());
                 iterator back1 = finish_;
@@ -798,7 +968,7 @@ namespace my {
                 iterator back2 = back1;
                 --back2;
                 pos = start_ + index;
-                std::copy_backward(pos, back2, back1);  /// [pos, back2) -> [pos + 1, back1)
+                my::move_backward(pos, back2, back1);  /// [pos, back2) -> [pos + 1, back1)
             }
             *pos = std::move(v_copy);
             return pos;
@@ -816,18 +986,23 @@ namespace my {
                     if (elems_before >= difference_type(n)) {  /// 前面的元素足够多
                         iterator start_n = start_ + difference_type(n);
                         // [start_, start_n) -> [new_start, new_start + n)
-                        uninitialized_copy_a(start_, start_n, new_start, data_allocator_);
+                        uninitialized_copy_chunks_(start_, start_n, new_start);
                         start_ = new_start;
                         // [start_n, pos) -> [old_start, pos)
-                        std::copy(start_n, pos, old_start);
+                        my::move(start_n, pos, old_start);
                         // [pos, pos + n) -> [pos, pos + n)
-                        std::fill(pos - difference_type(n), pos, v_copy);
+                        my::fill(pos - difference_type(n), pos, v_copy);
                     } else {
                         // [start_, pos) -> [new_start, new_start + elems_before)
-                        uninitialized_copy_a(start_, pos, new_start, data_allocator_);
-                        uninitialized_fill_n_a(new_start + elems_before, n - elems_before, v_copy, data_allocator_);
+                        iterator mid = uninitialized_copy_chunks_(start_, pos, new_start);
+                        try {
+                            uninitialized_fill_chunks_(mid, old_start, v_copy);
+                        } catch (...) {
+                            destroy_data_(new_start, mid);
+                            throw;
+                        }
                         start_ = new_start;
-                        std::fill(old_start, pos, v_copy);
+                        my::fill(old_start, pos, v_copy);
                     }
                 } catch (...) {
                     destroy_nodes_(new_start.node_, start_.node_);
@@ -842,17 +1017,128 @@ namespace my {
                     if (elems_after > difference_type(n)) {  // 后面的元素足够多
                         iterator finish_n = finish_ - difference_type(n);
                         // [finish_ - n, finish_) -> [finish_, finish_ + n)
-                        uninitialized_copy_a(finish_n, finish_, finish_, data_allocator_);
+                        uninitialized_copy_chunks_(finish_n, finish_, finish_);
                         finish_ = new_finish;
                         // [pos, finish_n) -> [old_finish - n, old_finish)
-                        std::copy_backward(pos, finish_n, old_finish);
-                        std::fill(pos, pos + difference_type(n), v_copy);
+                        my::move_backward(pos, finish_n, old_finish);
+                        my::fill(pos, pos + difference_type(n), v_copy);
                     } else {
-                        uninitialized_fill_n_a(finish_, n - elems_after, v_copy,
-                                               data_allocator_);  //
-                        uninitialized_copy_a(pos, finish_, finish_ + n, data_allocator_);
+                        iterator mid = finish_ + difference_type(n - elems_after);
+                        uninitialized_fill_chunks_(finish_, mid, v_copy);
+                        try {
+                            uninitialized_copy_chunks_(pos, finish_, mid);
+                        } catch (...) {
+                            destroy_data_(finish_, mid);
+                            throw;
+                        }
                         finish_ = new_finish;
-                        std::fill(pos, old_finish, v_copy);
+                        my::fill(pos, old_finish, v_copy);
+                    }
+                } catch (...) {
+                    destroy_nodes_(finish_.node_ + 1, new_finish.node_ + 1);
+                    throw;
+                }
+            }
+        }
+
+        /// 单遍的输入迭代器不能先算出长度，只能逐个插入
+        template <typename InputIterator>
+        void range_insert_(iterator pos, InputIterator first, InputIterator last, std::input_iterator_tag) {
+            if (pos == end()) {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            } else {
+                for (; first != last; ++first, ++pos) {
+                    pos = insert(pos, *first);
+                }
+            }
+        }
+
+        template <typename ForwardIterator>
+        void range_insert_(iterator pos, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+            size_type n = std::distance(first, last);
+            if (n == 0) {
+                return;
+            }
+            if (pos.cur_ == start_.cur_) {
+                iterator new_start = reserve_elements_at_front_(n);
+                try {
+                    uninitialized_copy_chunks_(first, last, new_start);
+                    start_ = new_start;
+                } catch (...) {
+                    destroy_nodes_(new_start.node_, start_.node_);
+                    throw;
+                }
+            } else if (pos.cur_ == finish_.cur_) {
+                iterator new_finish = reserve_elements_at_back_(n);
+                try {
+                    uninitialized_copy_chunks_(first, last, finish_);
+                    finish_ = new_finish;
+                } catch (...) {
+                    destroy_nodes_(finish_.node_ + 1, new_finish.node_ + 1);
+                    throw;
+                }
+            } else {
+                insert_aux_(pos, first, last, n);
+            }
+        }
+
+        /// 与 insert_aux_(pos, n, v) 相同的思路：移动离 pos 较近的一端，新元素一部分构造在预留的空间、一部分赋值到原来的位置
+        template <typename ForwardIterator>
+        void insert_aux_(iterator pos, ForwardIterator first, ForwardIterator last, size_type n) {
+            const difference_type elems_before = pos - start_;
+            size_type length = size();
+            if (elems_before < difference_type(length / 2)) {  /// 在前半部分插入
+                iterator new_start = reserve_elements_at_front_(n);
+                iterator old_start = start_;
+                pos = start_ + elems_before;
+                try {
+                    if (elems_before >= difference_type(n)) {
+                        iterator start_n = start_ + difference_type(n);
+                        uninitialized_copy_chunks_(start_, start_n, new_start);
+                        start_ = new_start;
+                        my::move(start_n, pos, old_start);
+                        my::copy(first, last, pos - difference_type(n));
+                    } else {
+                        ForwardIterator mid = std::next(first, difference_type(n) - elems_before);
+                        iterator cur = uninitialized_copy_chunks_(start_, pos, new_start);
+                        try {
+                            uninitialized_copy_chunks_(first, mid, cur);
+                        } catch (...) {
+                            destroy_data_(new_start, cur);
+                            throw;
+                        }
+                        start_ = new_start;
+                        my::copy(mid, last, old_start);
+                    }
+                } catch (...) {
+                    destroy_nodes_(new_start.node_, start_.node_);
+                    throw;
+                }
+            } else {
+                iterator new_finish = reserve_elements_at_back_(n);
+                iterator old_finish = finish_;
+                const difference_type elems_after = difference_type(length) - elems_before;
+                pos = finish_ - elems_after;
+                try {
+                    if (elems_after > difference_type(n)) {
+                        iterator finish_n = finish_ - difference_type(n);
+                        uninitialized_copy_chunks_(finish_n, finish_, finish_);
+                        finish_ = new_finish;
+                        my::move_backward(pos, finish_n, old_finish);
+                        my::copy(first, last, pos);
+                    } else {
+                        ForwardIterator mid = std::next(first, elems_after);
+                        iterator cur = uninitialized_copy_chunks_(mid, last, finish_);
+                        try {
+                            uninitialized_copy_chunks_(pos, finish_, cur);
+                        } catch (...) {
+                            destroy_data_(finish_, cur);
+                            throw;
+                        }
+                        finish_ = new_finish;
+                        my::copy(first, mid, pos);
                     }
                 } catch (...) {
                     destroy_nodes_(finish_.node_ + 1, new_finish.node_ + 1);
@@ -862,22 +1148,25 @@ namespace my {
         }
 
         void fill_insert_(iterator pos, size_type n, const value_type& v) {
+            if (n == 0) {
+                return;
+            }
             if (pos.cur_ == start_.cur_) {
                 iterator new_start = reserve_elements_at_front_(n);
                 try {
-                    uninitialized_fill_n_a(new_start, n, v, data_allocator_);
+                    uninitialized_fill_chunks_(new_start, start_, v);
                     start_ = new_start;
                 } catch (...) {
-                    destroy_data_(new_start, start_);
+                    destroy_nodes_(new_start.node_, start_.node_);
                     throw;
                 }
             } else if (pos.cur_ == finish_.cur_) {
                 iterator new_finish = reserve_elements_at_back_(n);
                 try {
-                    uninitialized_fill_n_a(finish_, n, v, data_allocator_);
+                    uninitialized_fill_chunks_(finish_, new_finish, v);
                     finish_ = new_finish;
                 } catch (...) {
-                    destroy_data_(finish_, new_finish);
+                    destroy_nodes_(finish_.node_ + 1, new_finish.node_ + 1);
                     throw;
                 }
             } else {
@@ -891,12 +1180,12 @@ namespace my {
             difference_type elems_before = pos - begin();
             if (elems_before < size() / 2) {  // 在前半部分
                 if (pos != begin()) {
-                    std::copy_backward(begin(), pos, next);
+                    my::move_backward(begin(), pos, next);
                 }
                 pop_front();
             } else {
                 if (next != end()) {
-                    std::copy(next, end(), pos);
+                    my::move(next, end(), pos);
                 }
                 pop_back();
             }
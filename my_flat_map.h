@@ -0,0 +1,606 @@
+/**
+ * @file      my_flat_map.h
+ * @brief     [基于有序 my::vector 的 flat_map：key 和 mapped 分别连续存放]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_flat_tree.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * flat_map
+ * key 和 mapped 分别放在两个按 key 有序的 my::vector 中（第 i 个 key 对应第 i 个 mapped）：
+ *      查找只在 key 数组上二分，key 紧密排列，一条缓存行里能放下很多个 key，mapped 不会挤占缓存
+ *      每个元素的内存就是 sizeof(Key) + sizeof(T)（加上 vector 的空余容量），没有节点和指针
+ * 接口与 my::map 相同，区别：
+ *      元素不是以 std::pair 的形式存放的，解引用迭代器得到的是 std::pair<const Key &, T &>（代理引用）
+ *      单个插入/删除是 O(n) 的，并且会使所有迭代器失效；批量插入请用 insert(first, last)
+ *      批量插入中途抛出异常（已经开始重排元素之后）时容器被清空，以保证始终有序
+ */
+
+namespace my {
+
+    template<typename Key,
+            typename T,
+            typename Compare = std::less<Key>,
+            typename KeyContainer = my::vector<Key>,
+            typename MappedContainer = my::vector<T>>
+    class flat_map {
+        template<bool Const>
+        class iterator_impl;
+
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using key_compare = Compare;
+        using reference = std::pair<const Key &, T &>;
+        using const_reference = std::pair<const Key &, const T &>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = iterator_impl<false>;
+        using const_iterator = iterator_impl<true>;
+        using key_container_type = KeyContainer;
+        using mapped_container_type = MappedContainer;
+
+        /// extract() 的返回值：交出两个底层数组
+        struct containers {
+            key_container_type keys;
+            mapped_container_type values;
+        };
+
+        flat_map() = default;
+
+        explicit flat_map(const Compare &comp) : comp_(comp) {}
+
+        /// 从两个等长的数组构造，内部排序并去重（等价的 key 保留先出现的）
+        flat_map(key_container_type keys, mapped_container_type values, const Compare &comp = Compare())
+                : keys_(std::move(keys)), values_(std::move(values)), comp_(comp) {
+            check_sizes_(keys_, values_);
+            merge_tail_(0, false);
+        }
+
+        /// 两个数组已按 key 升序排列且没有重复：直接接管，O(1)
+        flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values,
+                 const Compare &comp = Compare())
+                : keys_(std::move(keys)), values_(std::move(values)), comp_(comp) {
+            check_sizes_(keys_, values_);
+        }
+
+        template<typename InputIt>
+        flat_map(InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+            insert(first, last);
+        }
+
+        template<typename InputIt>
+        flat_map(sorted_unique_t tag, InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+            insert(tag, first, last);
+        }
+
+        flat_map(std::initializer_list<value_type> ilist, const Compare &comp = Compare())
+                : flat_map(ilist.begin(), ilist.end(), comp) {}
+
+        flat_map(sorted_unique_t tag, std::initializer_list<value_type> ilist, const Compare &comp = Compare())
+                : flat_map(tag, ilist.begin(), ilist.end(), comp) {}
+
+        /// 迭代器
+        iterator begin() { return iterator(keys_.data(), values_.data()); }
+
+        iterator end() { return begin() + size(); }
+
+        const_iterator begin() const { return const_iterator(keys_.data(), values_.data()); }
+
+        const_iterator end() const { return begin() + size(); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        /// 容量
+        bool empty() const { return keys_.empty(); }
+
+        size_type size() const { return keys_.size(); }
+
+        void reserve(size_type n) {
+            keys_.reserve(n);
+            values_.reserve(n);
+        }
+
+        void clear() {
+            keys_.clear();
+            values_.clear();
+        }
+
+        /// 底层数组（只读）
+        const key_container_type &keys() const { return keys_; }
+
+        const mapped_container_type &values() const { return values_; }
+
+        /// 交出底层数组，容器变为空
+        containers extract() && {
+            containers result{std::move(keys_), std::move(values_)};
+            clear();
+            return result;
+        }
+
+        /// 用两个已按 key 升序排列且没有重复的数组替换当前内容
+        void replace(key_container_type &&keys, mapped_container_type &&values) {
+            check_sizes_(keys, values);
+            keys_ = std::move(keys);
+            values_ = std::move(values);
+        }
+
+        /// 元素访问
+        T &operator[](const key_type &key) {
+            return try_emplace(key).first->second;
+        }
+
+        T &operator[](key_type &&key) {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        T &at(const key_type &key) {
+            iterator it = find(key);
+            if (it == end()) {
+                throw std::out_of_range("flat_map::at");
+            }
+            return it->second;
+        }
+
+        const T &at(const key_type &key) const {
+            const_iterator it = find(key);
+            if (it == end()) {
+                throw std::out_of_range("flat_map::at");
+            }
+            return it->second;
+        }
+
+        /// 插入单个元素：二分找到位置后在两个数组的同一下标处插入，key 已存在时不插入
+        std::pair<iterator, bool> insert(const value_type &val) {
+            return try_emplace(val.first, val.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&val) {
+            return try_emplace(std::move(val.first), std::move(val.second));
+        }
+
+        /// 带提示的插入：key 恰好落在 hint 之前时省掉二分查找（搬移元素的开销不变）
+        iterator insert(const_iterator hint, const value_type &val) {
+            return try_emplace(hint, val.first, val.second);
+        }
+
+        iterator insert(const_iterator hint, value_type &&val) {
+            return try_emplace(hint, std::move(val.first), std::move(val.second));
+        }
+
+        /// 批量插入：先追加到末尾，对追加的部分排序，再和原有元素原地归并，O(n + m log m)
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            insert_range_(first, last, false);
+        }
+
+        /// 输入已按 key 升序排列且没有重复：省掉排序，只做一次 O(n + m) 的归并
+        template<typename InputIt>
+        void insert(sorted_unique_t, InputIt first, InputIt last) {
+            insert_range_(first, last, true);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            value_type val(std::forward<Args>(args)...);
+            return try_emplace(std::move(val.first), std::move(val.second));
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            value_type val(std::forward<Args>(args)...);
+            return try_emplace(hint, std::move(val.first), std::move(val.second));
+        }
+
+        /// key 不存在时才构造 mapped 对象
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+            return try_emplace_(lower_bound_(key), key, std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&... args) {
+            size_type pos = lower_bound_(key);
+            return try_emplace_(pos, std::move(key), std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator try_emplace(const_iterator hint, const key_type &key, Args &&... args) {
+            return try_emplace_(hint_pos_(hint, key), key, std::forward<Args>(args)...).first;
+        }
+
+        template<typename... Args>
+        iterator try_emplace(const_iterator hint, key_type &&key, Args &&... args) {
+            size_type pos = hint_pos_(hint, key);
+            return try_emplace_(pos, std::move(key), std::forward<Args>(args)...).first;
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+            auto res = try_emplace(key, std::forward<M>(obj));
+            if (!res.second) {
+                res.first->second = std::forward<M>(obj);
+            }
+            return res;
+        }
+
+        /// 删除：后面的元素整体前移，返回指向下一个元素的迭代器
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(iterator pos) {
+            return erase(const_iterator(pos));
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            size_type from = index_of_(first);
+            size_type to = index_of_(last);
+            keys_.erase(keys_.begin() + from, keys_.begin() + to);
+            values_.erase(values_.begin() + from, values_.begin() + to);
+            return begin() + from;
+        }
+
+        size_type erase(const key_type &key) {
+            iterator it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+            erase(it);
+            return 1;
+        }
+
+        void swap(flat_map &other) {
+            keys_.swap(other.keys_);
+            values_.swap(other.values_);
+            std::swap(comp_, other.comp_);
+        }
+
+        key_compare key_comp() const { return comp_; }
+
+        /// 查找：在 key 数组上做无分支二分，O(log n)；Compare 声明了 is_transparent 时支持异构 key
+        iterator find(const key_type &key) { return find_(key); }
+
+        const_iterator find(const key_type &key) const { return find_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator find(const K &key) { return find_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        const_iterator find(const K &key) const { return find_(key); }
+
+        size_type count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_type count(const K &key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type &key) const { return find_(key) != end(); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        bool contains(const K &key) const { return find_(key) != end(); }
+
+        iterator lower_bound(const key_type &key) { return begin() + lower_bound_(key); }
+
+        const_iterator lower_bound(const key_type &key) const { return begin() + lower_bound_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator lower_bound(const K &key) { return begin() + lower_bound_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        const_iterator lower_bound(const K &key) const { return begin() + lower_bound_(key); }
+
+        iterator upper_bound(const key_type &key) { return begin() + upper_bound_(key); }
+
+        const_iterator upper_bound(const key_type &key) const { return begin() + upper_bound_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator upper_bound(const K &key) { return begin() + upper_bound_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        const_iterator upper_bound(const K &key) const { return begin() + upper_bound_(key); }
+
+        std::pair<iterator, iterator> equal_range(const key_type &key) {
+            iterator it = lower_bound(key);
+            return {it, it == end() || comp_(key, it->first) ? it : it + 1};
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        std::pair<iterator, iterator> equal_range(const K &key) {
+            iterator it = lower_bound(key);
+            return {it, it == end() || comp_(key, it->first) ? it : it + 1};
+        }
+
+        bool operator==(const flat_map &rhs) const {
+            return size() == rhs.size() && std::equal(keys_.begin(), keys_.end(), rhs.keys_.begin()) &&
+                   std::equal(values_.begin(), values_.end(), rhs.values_.begin());
+        }
+
+        bool operator!=(const flat_map &rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        template<typename K>
+        size_type lower_bound_(const K &key) const {
+            return detail::flat_lower_bound(keys_.data(), keys_.size(), key, comp_);
+        }
+
+        template<typename K>
+        size_type upper_bound_(const K &key) const {
+            return detail::flat_upper_bound(keys_.data(), keys_.size(), key, comp_);
+        }
+
+        template<typename K>
+        iterator find_(const K &key) {
+            size_type pos = lower_bound_(key);
+            return pos != size() && !comp_(key, keys_[pos]) ? begin() + pos : end();
+        }
+
+        template<typename K>
+        const_iterator find_(const K &key) const {
+            size_type pos = lower_bound_(key);
+            return pos != size() && !comp_(key, keys_[pos]) ? begin() + pos : end();
+        }
+
+        size_type index_of_(const_iterator it) const {
+            return static_cast<size_type>(it - begin());
+        }
+
+        /// hint 正确（key 落在 hint 的前一个元素和 hint 之间）时直接用 hint 的位置，否则二分
+        size_type hint_pos_(const_iterator hint, const key_type &key) const {
+            size_type pos = index_of_(hint);
+            if ((pos == 0 || comp_(keys_[pos - 1], key)) && (pos == size() || !comp_(keys_[pos], key))) {
+                return pos;
+            }
+            return lower_bound_(key);
+        }
+
+        /// pos 为 key 的 lower_bound：key 已存在时不插入，否则在两个数组的 pos 处插入
+        template<typename KeyArg, typename... Args>
+        std::pair<iterator, bool> try_emplace_(size_type pos, KeyArg &&key, Args &&... args) {
+            if (pos != size() && !comp_(key, keys_[pos])) {
+                return {begin() + pos, false};
+            }
+            keys_.emplace(keys_.begin() + pos, std::forward<KeyArg>(key));
+            try {
+                values_.emplace(values_.begin() + pos, std::forward<Args>(args)...);
+            } catch (...) {
+                keys_.erase(keys_.begin() + pos, keys_.begin() + pos + 1);
+                throw;
+            }
+            return {begin() + pos, true};
+        }
+
+        static void check_sizes_(const key_container_type &keys, const mapped_container_type &values) {
+            if (keys.size() != values.size()) {
+                throw std::invalid_argument("flat_map: keys and values differ in size");
+            }
+        }
+
+        /// 把 [first, last) 追加到末尾再归并；追加的过程中失败就把追加的部分去掉，原有内容不变
+        template<typename InputIt>
+        void insert_range_(InputIt first, InputIt last, bool sorted) {
+            size_type n = size();
+            try {
+                for (; first != last; ++first) {
+                    auto &&kv = *first;
+                    keys_.emplace_back(kv.first);
+                    values_.emplace_back(kv.second);
+                }
+            } catch (...) {
+                keys_.erase(keys_.begin() + n, keys_.end());
+                values_.erase(values_.begin() + n, values_.end());
+                throw;
+            }
+            try {
+                merge_tail_(n, sorted);
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        void swap_at_(size_type a, size_type b) {
+            using std::swap;
+            swap(keys_[a], keys_[b]);
+            swap(values_[a], values_[b]);
+        }
+
+        /**
+         *  [0, n) 有序且没有重复，[n, size()) 是新追加的元素：
+         *  1. sorted 为 false 时对追加的部分做稳定排序：先对下标排序，再按下标原地重排两个数组
+         *  2. 去掉追加部分中和前一个新元素等价、或者和原有元素等价的（保留先出现的），在末尾原地压缩
+         *  3. 原有部分中只有不小于最小新 key 的那一段需要参与归并：算出每个元素归并后的下标，再原地重排
+         *     新 key 都比原有 key 大（按顺序追加）时这一步什么也不做
+         *  全程只搬移元素本身，额外空间是 m（或者参与归并的元素个数）个下标
+         * */
+        void merge_tail_(size_type n, bool sorted) {
+            size_type total = size();
+            if (total == n) {
+                return;
+            }
+            auto swap = [this](size_type a, size_type b) { swap_at_(a, b); };
+            if (!sorted) {
+                my::vector<size_t> order(total - n);
+                std::iota(order.begin(), order.end(), n);
+                std::stable_sort(order.begin(), order.end(),
+                                 [this](size_t a, size_t b) { return comp_(keys_[a], keys_[b]); });
+                my::vector<size_t> dest(total - n);
+                for (size_type r = 0; r < order.size(); ++r) {
+                    dest[order[r] - n] = n + r;
+                }
+                detail::flat_apply_permutation(dest, n, total, swap);
+            }
+
+            size_type start = lower_bound_in_(n, keys_[n]);
+            size_type e = start;
+            size_type w = n;
+            for (size_type r = n; r < total; ++r) {
+                if (w > n && !comp_(keys_[w - 1], keys_[r])) {
+                    continue;
+                }
+                while (e < n && comp_(keys_[e], keys_[r])) {
+                    ++e;
+                }
+                if (e < n && !comp_(keys_[r], keys_[e])) {
+                    continue;
+                }
+                if (w != r) {
+                    keys_[w] = std::move(keys_[r]);
+                    values_[w] = std::move(values_[r]);
+                }
+                ++w;
+            }
+            keys_.erase(keys_.begin() + w, keys_.end());
+            values_.erase(values_.begin() + w, values_.end());
+
+            if (start == n || w == n) {
+                return;
+            }
+            my::vector<size_t> dest(w - start);
+            size_type i = start;
+            size_type j = n;
+            size_type d = start;
+            while (i < n && j < w) {
+                if (comp_(keys_[j], keys_[i])) {
+                    dest[j++ - start] = d++;
+                } else {
+                    dest[i++ - start] = d++;
+                }
+            }
+            while (i < n) {
+                dest[i++ - start] = d++;
+            }
+            while (j < w) {
+                dest[j++ - start] = d++;
+            }
+            detail::flat_apply_permutation(dest, start, w, swap);
+        }
+
+        size_type lower_bound_in_(size_type n, const key_type &key) const {
+            return detail::flat_lower_bound(keys_.data(), n, key, comp_);
+        }
+
+    private:
+        key_container_type keys_;
+        mapped_container_type values_;
+        Compare comp_;
+    };
+
+// ============================ flat_map 的迭代器 ============================
+    /// 随机访问迭代器：同时指向 key 数组和 mapped 数组中的同一个下标
+    /// 解引用返回 std::pair<const Key &, T &>，operator-> 返回一个持有这个 pair 的代理对象
+    template<typename Key, typename T, typename Compare, typename KeyContainer, typename MappedContainer>
+    template<bool Const>
+    class flat_map<Key, T, Compare, KeyContainer, MappedContainer>::iterator_impl {
+        friend class flat_map;
+        friend class iterator_impl<!Const>;
+
+        using mapped_pointer = std::conditional_t<Const, const T *, T *>;
+        using mapped_ref = std::conditional_t<Const, const T &, T &>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = ptrdiff_t;
+        using reference = std::pair<const Key &, mapped_ref>;
+
+        struct pointer {
+            reference ref;
+
+            reference *operator->() { return &ref; }
+        };
+
+        iterator_impl() : key_(nullptr), value_(nullptr) {}
+
+        /// iterator 可以隐式转换为 const_iterator
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        iterator_impl(const iterator_impl<false> &other) : key_(other.key_), value_(other.value_) {}
+
+        reference operator*() const { return reference(*key_, *value_); }
+
+        pointer operator->() const { return pointer{**this}; }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        iterator_impl &operator++() {
+            ++key_;
+            ++value_;
+            return *this;
+        }
+
+        iterator_impl operator++(int) {
+            iterator_impl tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        iterator_impl &operator--() {
+            --key_;
+            --value_;
+            return *this;
+        }
+
+        iterator_impl operator--(int) {
+            iterator_impl tmp(*this);
+            --*this;
+            return tmp;
+        }
+
+        iterator_impl &operator+=(difference_type n) {
+            key_ += n;
+            value_ += n;
+            return *this;
+        }
+
+        iterator_impl &operator-=(difference_type n) { return *this += -n; }
+
+        iterator_impl operator+(difference_type n) const { return iterator_impl(*this) += n; }
+
+        friend iterator_impl operator+(difference_type n, const iterator_impl &it) { return it + n; }
+
+        iterator_impl operator-(difference_type n) const { return iterator_impl(*this) -= n; }
+
+        difference_type operator-(const iterator_impl &rhs) const { return key_ - rhs.key_; }
+
+        bool operator==(const iterator_impl &rhs) const { return key_ == rhs.key_; }
+
+        bool operator!=(const iterator_impl &rhs) const { return key_ != rhs.key_; }
+
+        bool operator<(const iterator_impl &rhs) const { return key_ < rhs.key_; }
+
+        bool operator>(const iterator_impl &rhs) const { return key_ > rhs.key_; }
+
+        bool operator<=(const iterator_impl &rhs) const { return key_ <= rhs.key_; }
+
+        bool operator>=(const iterator_impl &rhs) const { return key_ >= rhs.key_; }
+
+    private:
+        iterator_impl(const Key *key, mapped_pointer value) : key_(key), value_(value) {}
+
+        const Key *key_;
+        mapped_pointer value_;
+    };
+}
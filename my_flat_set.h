@@ -0,0 +1,310 @@
+/**
+ * @file      my_flat_set.h
+ * @brief     [基于有序 my::vector 的 flat_set]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_flat_tree.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+/**
+ * flat_set
+ * 元素按 Compare 升序连续存放在一个 my::vector 中，接口与 my::set 相同
+ * 迭代器是只读的随机访问迭代器（指向数组的指针），单个插入/删除是 O(n) 的并且会使所有迭代器失效
+ */
+
+namespace my {
+
+    template<typename Key,
+            typename Compare = std::less<Key>,
+            typename KeyContainer = my::vector<Key>>
+    class flat_set {
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = const Key *;
+        using const_iterator = const Key *;
+        using container_type = KeyContainer;
+
+        flat_set() = default;
+
+        explicit flat_set(const Compare &comp) : comp_(comp) {}
+
+        /// 从数组构造，内部排序并去重
+        explicit flat_set(container_type keys, const Compare &comp = Compare())
+                : keys_(std::move(keys)), comp_(comp) {
+            merge_tail_(0, false);
+        }
+
+        /// 数组已经有序且没有重复：直接接管，O(1)
+        flat_set(sorted_unique_t, container_type keys, const Compare &comp = Compare())
+                : keys_(std::move(keys)), comp_(comp) {}
+
+        template<typename InputIt>
+        flat_set(InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+            insert(first, last);
+        }
+
+        template<typename InputIt>
+        flat_set(sorted_unique_t tag, InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp) {
+            insert(tag, first, last);
+        }
+
+        flat_set(std::initializer_list<value_type> ilist, const Compare &comp = Compare())
+                : flat_set(ilist.begin(), ilist.end(), comp) {}
+
+        flat_set(sorted_unique_t tag, std::initializer_list<value_type> ilist, const Compare &comp = Compare())
+                : flat_set(tag, ilist.begin(), ilist.end(), comp) {}
+
+        iterator begin() const { return keys_.data(); }
+
+        iterator end() const { return keys_.data() + keys_.size(); }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        bool empty() const { return keys_.empty(); }
+
+        size_type size() const { return keys_.size(); }
+
+        void reserve(size_type n) { keys_.reserve(n); }
+
+        void clear() { keys_.clear(); }
+
+        /// 交出底层数组，容器变为空
+        container_type extract() && {
+            container_type result(std::move(keys_));
+            keys_.clear();
+            return result;
+        }
+
+        /// 用已经有序且没有重复的数组替换当前内容
+        void replace(container_type &&keys) {
+            keys_ = std::move(keys);
+        }
+
+        /// 插入单个元素：二分找到位置后插入，已存在等价元素时不插入
+        std::pair<iterator, bool> insert(const value_type &val) {
+            return insert_at_(lower_bound_(val), val);
+        }
+
+        std::pair<iterator, bool> insert(value_type &&val) {
+            size_type pos = lower_bound_(val);
+            return insert_at_(pos, std::move(val));
+        }
+
+        /// 带提示的插入：val 恰好落在 hint 之前时省掉二分查找
+        iterator insert(const_iterator hint, const value_type &val) {
+            return insert_at_(hint_pos_(hint, val), val).first;
+        }
+
+        iterator insert(const_iterator hint, value_type &&val) {
+            size_type pos = hint_pos_(hint, val);
+            return insert_at_(pos, std::move(val)).first;
+        }
+
+        /// 批量插入：先追加到末尾，对追加的部分排序去重，再和原有元素原地归并，O(n + m log m)
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            insert_range_(first, last, false);
+        }
+
+        /// 输入已经有序且没有重复：省掉排序，只做一次 O(n + m) 的归并
+        template<typename InputIt>
+        void insert(sorted_unique_t, InputIt first, InputIt last) {
+            insert_range_(first, last, true);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            return insert(hint, value_type(std::forward<Args>(args)...));
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            size_type from = static_cast<size_type>(first - begin());
+            size_type to = static_cast<size_type>(last - begin());
+            keys_.erase(keys_.begin() + from, keys_.begin() + to);
+            return begin() + from;
+        }
+
+        size_type erase(const key_type &key) {
+            iterator it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+            erase(it);
+            return 1;
+        }
+
+        void swap(flat_set &other) {
+            keys_.swap(other.keys_);
+            std::swap(comp_, other.comp_);
+        }
+
+        key_compare key_comp() const { return comp_; }
+
+        value_compare value_comp() const { return comp_; }
+
+        /// 查找：无分支二分，O(log n)；Compare 声明了 is_transparent 时支持异构 key
+        iterator find(const key_type &key) const { return find_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator find(const K &key) const { return find_(key); }
+
+        size_type count(const key_type &key) const { return find_(key) != end() ? 1 : 0; }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_type count(const K &key) const { return find_(key) != end() ? 1 : 0; }
+
+        bool contains(const key_type &key) const { return find_(key) != end(); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        bool contains(const K &key) const { return find_(key) != end(); }
+
+        iterator lower_bound(const key_type &key) const { return begin() + lower_bound_(key); }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator lower_bound(const K &key) const { return begin() + lower_bound_(key); }
+
+        iterator upper_bound(const key_type &key) const {
+            return begin() + detail::flat_upper_bound(keys_.data(), keys_.size(), key, comp_);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator upper_bound(const K &key) const {
+            return begin() + detail::flat_upper_bound(keys_.data(), keys_.size(), key, comp_);
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type &key) const {
+            iterator it = find_(key);
+            return it == end() ? std::make_pair(lower_bound(key), lower_bound(key)) : std::make_pair(it, it + 1);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        std::pair<iterator, iterator> equal_range(const K &key) const {
+            iterator it = find_(key);
+            return it == end() ? std::make_pair(lower_bound(key), lower_bound(key)) : std::make_pair(it, it + 1);
+        }
+
+        bool operator==(const flat_set &rhs) const {
+            return size() == rhs.size() && std::equal(begin(), end(), rhs.begin());
+        }
+
+        bool operator!=(const flat_set &rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        template<typename K>
+        size_type lower_bound_(const K &key) const {
+            return detail::flat_lower_bound(keys_.data(), keys_.size(), key, comp_);
+        }
+
+        template<typename K>
+        iterator find_(const K &key) const {
+            size_type pos = lower_bound_(key);
+            return pos != size() && !comp_(key, keys_[pos]) ? begin() + pos : end();
+        }
+
+        size_type hint_pos_(const_iterator hint, const value_type &val) const {
+            size_type pos = static_cast<size_type>(hint - begin());
+            if ((pos == 0 || comp_(keys_[pos - 1], val)) && (pos == size() || !comp_(keys_[pos], val))) {
+                return pos;
+            }
+            return lower_bound_(val);
+        }
+
+        /// pos 为 val 的 lower_bound
+        template<typename Arg>
+        std::pair<iterator, bool> insert_at_(size_type pos, Arg &&val) {
+            if (pos != size() && !comp_(val, keys_[pos])) {
+                return {begin() + pos, false};
+            }
+            keys_.emplace(keys_.begin() + pos, std::forward<Arg>(val));
+            return {begin() + pos, true};
+        }
+
+        template<typename InputIt>
+        void insert_range_(InputIt first, InputIt last, bool sorted) {
+            size_type n = size();
+            try {
+                for (; first != last; ++first) {
+                    keys_.emplace_back(*first);
+                }
+            } catch (...) {
+                keys_.erase(keys_.begin() + n, keys_.end());
+                throw;
+            }
+            try {
+                merge_tail_(n, sorted);
+            } catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        /// [0, n) 有序且没有重复，[n, size()) 是新追加的元素：
+        /// 追加部分稳定排序、去掉重复的和已经存在的，再用 std::inplace_merge 与原有部分中不小于最小新元素的那一段归并
+        void merge_tail_(size_type n, bool sorted) {
+            size_type total = size();
+            if (total == n) {
+                return;
+            }
+            if (!sorted) {
+                std::stable_sort(keys_.begin() + n, keys_.end(), comp_);
+            }
+            size_type start = detail::flat_lower_bound(keys_.data(), n, keys_[n], comp_);
+            size_type e = start;
+            size_type w = n;
+            for (size_type r = n; r < total; ++r) {
+                if (w > n && !comp_(keys_[w - 1], keys_[r])) {
+                    continue;
+                }
+                while (e < n && comp_(keys_[e], keys_[r])) {
+                    ++e;
+                }
+                if (e < n && !comp_(keys_[r], keys_[e])) {
+                    continue;
+                }
+                if (w != r) {
+                    keys_[w] = std::move(keys_[r]);
+                }
+                ++w;
+            }
+            keys_.erase(keys_.begin() + w, keys_.end());
+            if (start != n && w != n) {
+                std::inplace_merge(keys_.begin() + start, keys_.begin() + n, keys_.end(), comp_);
+            }
+        }
+
+    private:
+        container_type keys_;
+        Compare comp_;
+    };
+}
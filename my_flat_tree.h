@@ -0,0 +1,74 @@
+/**
+ * @file      my_flat_tree.h
+ * @brief     [flat_map/flat_set 的公共部分：有序数组上的无分支二分查找和原地重排]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_sorted_tag.h"
+#include "my_type_traits.h"
+#include "my_vector.h"
+
+#include <cstddef>
+#include <utility>
+
+/**
+ * flat 容器
+ * 元素按 key 排好序连续存放在 my::vector 中，没有节点、没有指针：
+ *      查找：对连续数组二分，每个元素没有额外的内存开销，顺序遍历就是顺序读内存
+ *      插入/删除单个元素：要搬移后面的元素，O(n)，所以适合“先批量建好、之后以查询为主”的场景
+ *      批量插入：新元素先追加到末尾，对追加的部分排序，再和原有部分原地归并，O(n + m log m)
+ *
+ * 二分查找用无分支的写法：每一步只根据一次比较的结果选择下一段的起点（编译器生成 cmov），
+ * 循环次数只取决于元素个数，不会因为分支预测失败而冲刷流水线
+ */
+
+namespace my {
+    namespace detail {
+
+        /// 第一个不小于 key 的下标（[first, first + n) 已按 comp 升序排列）
+        template<typename T, typename K, typename Compare>
+        size_t flat_lower_bound(const T *first, size_t n, const K &key, Compare comp) {
+            if (n == 0) {
+                return 0;
+            }
+            const T *base = first;
+            while (n > 1) {
+                size_t half = n / 2;
+                base = comp(base[half], key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<size_t>(base - first) + (comp(*base, key) ? 1 : 0);
+        }
+
+        /// 第一个大于 key 的下标
+        template<typename T, typename K, typename Compare>
+        size_t flat_upper_bound(const T *first, size_t n, const K &key, Compare comp) {
+            if (n == 0) {
+                return 0;
+            }
+            const T *base = first;
+            while (n > 1) {
+                size_t half = n / 2;
+                base = comp(key, base[half]) ? base : base + half;
+                n -= half;
+            }
+            return static_cast<size_t>(base - first) + (comp(key, *base) ? 0 : 1);
+        }
+
+        /// 按 dest 原地重排 [first, last)：下标 k 处的元素最终放到 dest[k]，swap(i, j) 交换两个位置的元素
+        /// 沿置换的环交换，每次交换都至少把一个元素放到最终位置，最多 last - first - 1 次交换；结束后 dest[k] == k
+        template<typename Swap>
+        void flat_apply_permutation(my::vector<size_t> &dest, size_t first, size_t last, Swap swap) {
+            for (size_t k = first; k < last; ++k) {
+                while (dest[k - first] != k) {
+                    size_t d = dest[k - first];
+                    swap(k, d);
+                    std::swap(dest[k - first], dest[d - first]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file      my_futex.h
+ * @brief     [无锁容器阻塞等待用的基础设施：32 位原子变量上的 futex 等待 / 唤醒，以及自旋时的 CPU 提示]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * futex（fast userspace mutex）：线程在一个 32 位整数上睡眠，“值还等于 expected 才睡”这一检查和入睡由内核原子地完成，
+ * 所以“检查条件 -> 睡眠”之间别的线程修改了值再唤醒，不会丢失唤醒
+ * 无锁队列的阻塞等待都按“事件计数”的方式使用它：
+ *      等待方：seq = word.load(); 宣告自己在等; 再检查一次条件; 条件仍不满足才 futex_wait(word, seq)
+ *      通知方：修改共享状态; 看到有人在等才 word.fetch_add(1) 并 futex_wake —— 没有等待者时不进内核
+ * Linux 上直接调用 futex 系统调用；其他平台用 C++20 的 std::atomic::wait / notify（Windows 上是 WaitOnAddress）
+ */
+
+namespace my {
+    namespace detail {
+
+        /// 自旋等待时告诉 CPU 这是忙等（x86 的 pause），减少功耗和对超线程兄弟的干扰
+        inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        /// 自旋到一定次数之后让出时间片（单核或者线程数多于核数时，对方可能正等着这个核）
+        inline void spin_backoff(unsigned spin) {
+            if (spin < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        /// word 的值仍等于 expected 时睡眠，直到被唤醒（可能虚假唤醒，调用方需要重新检查条件）
+        inline void futex_wait(std::atomic<uint32_t> &word, uint32_t expected) {
+#if defined(__linux__)
+            static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+            word.wait(expected, std::memory_order_acquire);
+#endif
+        }
+
+        inline void futex_wake_one(std::atomic<uint32_t> &word) {
+#if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+            word.notify_one();
+#endif
+        }
+
+        inline void futex_wake_all(std::atomic<uint32_t> &word) {
+#if defined(__linux__)
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+            word.notify_all();
+#endif
+        }
+
+        /// 一条缓存行的大小；相邻的写热点放在不同的缓存行上，避免伪共享
+        inline constexpr size_t cache_line_size = 64;
+    }
+}
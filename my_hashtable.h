@@ -11,11 +11,14 @@
 #include "my_utility.h"
 #include "my_type_traits.h"
 #include "my_pair.h"
+#include "my_node_handle.h"
 
 #include <cmath>
 #include <functional>
 #include <memory>
 #include <cassert>
+#include <tuple>
+#include <utility>
 
 /**
  * hashtable
@@ -28,19 +31,65 @@
  */
 
 namespace my {
+    /// 节点基类：只包含next指针，哈希表中的 before_begin_ 哨兵就是一个基类节点
+    /// 所有节点串成一条全局单链表，同一个桶中的节点在链表中连续存放
+    struct HashTableNodeBase {
+        HashTableNodeBase *next;    /// 指向下一个节点指针
+
+        HashTableNodeBase() : next(nullptr) {}
+    };
+
     /// 哈希表采用链地址法，所以需要创建节点
     template<typename Value>
-    struct HashTableNode {
+    struct HashTableNode : HashTableNodeBase {
         Value value;            /// 存储的数据
-        HashTableNode *next;    /// 指向下一个节点指针
+        size_t hash_code;       /// 缓存的哈希值，rehash 和判断桶边界时不必重新计算哈希
 
         HashTableNode(const Value &val)
-                : value(val), next(nullptr) {}
+                : value(val), hash_code(0) {}
 
         HashTableNode(Value &&val)
-                : value(my::move(val)), next(nullptr) {}
+                : value(my::move(val)), hash_code(0) {}
+
+        HashTableNode *next_node() const {
+            return static_cast<HashTableNode *>(next);
+        }
     };
 
+    namespace detail {
+        /// 哈希表节点的 node_handle 描述：节点由 NodeAlloc 分配，元素由 ValueAlloc 构造
+        template<typename Value, typename NodeAlloc, typename ValueAlloc>
+        struct hashtable_node_traits {
+            using node_pointer = HashTableNode<Value> *;
+            using value_type = Value;
+            using handle_type = my::node_handle<hashtable_node_traits>;
+
+            static value_type &value(node_pointer node) {
+                return node->value;
+            }
+
+            void destroy(node_pointer node) {
+                std::allocator_traits<ValueAlloc>::destroy(value_alloc, std::addressof(node->value));
+                node_alloc.deallocate(node, 1);
+            }
+
+            static handle_type make(node_pointer node, const NodeAlloc &na, const ValueAlloc &va) {
+                return handle_type(node, hashtable_node_traits{na, va});
+            }
+
+            static node_pointer get(const handle_type &nh) {
+                return nh.node_;
+            }
+
+            static node_pointer release(handle_type &nh) {
+                return nh.release_();
+            }
+
+            NodeAlloc node_alloc;
+            ValueAlloc value_alloc;
+        };
+    }
+
     /// hashtable前置声明
     template<typename Key,
             typename Value,
@@ -126,29 +175,10 @@ namespace my {
         }
 
         /// 前置++
+        /// 所有节点在一条单链表上，直接走到下一个节点即可，O(1)，不再扫描空桶
         iterator_type &operator++() {
             if (current_) {
-                /// 如果cur_的下一个节点存在就移动到下一个节点
-                if (current_->next) {
-                    current_ = current_->next;
-                } else {
-                    /// 当前桶没有下一个节点，则需要找到下一个current_的位置
-                    /// 获取当前 value 的哈希桶索引（通过 bucket_index_ 函数）
-                    size_t index = table_->bucket_index_(current_->value);
-                    ++index;
-                    /// 向后查找下一个非空桶，并更新为该桶的第一个节点
-                    while (index < table_->buckets_.size() && table_->buckets_[index] == nullptr) {
-                        ++index;
-                    }
-                    if (index < table_->buckets_.size()) {
-                        current_ = table_->buckets_[index];
-                    } else {
-                        /// 将 current_ 置为 nullptr，表示 end()
-                        current_ = nullptr;
-                    }
-                    /// 可以优化为三目运算
-//                        current_ = (index < table_->buckets_.size()) ? table_->buckets_[index] : nullptr;
-                }
+                current_ = current_->next_node();
             }
             return *this;
         }
@@ -308,10 +338,15 @@ namespace my {
 
         friend class hashtable_iterator<Key, Value, ExtractKey, UniqueKeys, Hash, EqualKey, Alloc, true>;
 
+        /// merge 需要访问另一种实例化（哈希函数/唯一性不同）的内部链表
+        template<typename, typename, typename, typename, typename, typename, typename>
+        friend class hashtable;
+
     public:
         using key_type = Key;
         using value_type = Value;
         using node_type = HashTableNode<Value>;
+        using node_base = HashTableNodeBase;
         using size_type = size_t;
         using difference_type = ptrdiff_t;
         using hasher = Hash;
@@ -326,6 +361,18 @@ namespace my {
         using const_iterator = hashtable_iterator<Key, Value, ExtractKey, UniqueKeys, Hash, EqualKey, Alloc, true>;
         using rehash_policy = detail::prime_rehash_policy;          /// detail这个作用域中的哈希策略
         using unique_keys = UniqueKeys;
+        using node_traits = detail::hashtable_node_traits<Value, node_allocator_type, allocator_type>;
+        using node_handle_type = typename node_traits::handle_type;       /// extract 返回的节点句柄
+        using insert_return_type = node_insert_return<iterator, node_handle_type>;
+
+        /**
+         * 桶与节点的组织方式（与 libstdc++ 相同）
+         *      所有节点串成一条以 before_begin_ 为头的单链表，同一个桶的节点在链表中是连续的一段
+         *      buckets_[i] 存放的不是桶中第一个节点，而是“桶中第一个节点的前一个节点”，空桶为 nullptr
+         *      第一个非空桶的 buckets_[i] 指向 &before_begin_
+         * 这样 begin() 就是 before_begin_.next，O(1)；遍历只沿着链表走，O(size)，与桶数无关
+         * 删除桶中第一个节点时也能直接拿到它的前驱，单链表足够完成所有操作
+         * */
     public:
 
         /// 构造函数遵循 rules of five
@@ -337,6 +384,7 @@ namespace my {
             buckets_.resize(rehash_policy_.next_bkt(n));
         }
 
+        /// 拷贝构造：沿着 other 的链表逐个复制节点，并在遇到新桶时记录前驱，O(size)
         hashtable(const hashtable &other)
                 : hash_(other.hash_), equals_(other.equals_), get_key_(other.get_key_),
                   buckets_(other.buckets_.size(), nullptr), num_elements_(0),
@@ -345,17 +393,22 @@ namespace my {
                   value_alloc_(std::allocator_traits<allocator_type>::
                                select_on_container_copy_construction(other.value_alloc_)),
                   rehash_policy_(other.rehash_policy_) {
-            /// 逐个复制所有节点
-            for (size_t i = 0; i < other.buckets_.size(); ++i) {
-                node_type *cur = other.buckets_[i];
-                node_type **tail = &buckets_[i];
-                while (cur) {
-                    node_type *new_node = create_node_(cur->value);
-                    *tail = new_node;
-                    tail = &new_node->next;
-                    cur = cur->next;
+            try {
+                node_base *prev = &before_begin_;
+                for (const node_type *src = other.begin_node_(); src; src = src->next_node()) {
+                    node_type *new_node = create_node_(src->value);
+                    new_node->hash_code = src->hash_code;
+                    prev->next = new_node;
+                    size_type bkt = bucket_index_(new_node);
+                    if (!buckets_[bkt]) {
+                        buckets_[bkt] = prev;
+                    }
+                    prev = new_node;
                     ++num_elements_;
                 }
+            } catch (...) {
+                clear();
+                throw;
             }
         }
 
@@ -372,7 +425,7 @@ namespace my {
                   buckets_(my::move(other.buckets_)), num_elements_(other.num_elements_),
                   node_alloc_(my::move(other.node_alloc_)), value_alloc_(my::move(other.value_alloc_)),
                   rehash_policy_(my::move(other.rehash_policy_)) {
-            other.num_elements_ = 0;
+            steal_chain_(other);
         }
 
         hashtable &operator=(hashtable &&other) noexcept {
@@ -388,7 +441,7 @@ namespace my {
                 value_alloc_ = my::move(other.value_alloc_);
                 rehash_policy_ = my::move(other.rehash_policy_);
 
-                other.num_elements_ = 0;
+                steal_chain_(other);
             }
             return *this;
         }
@@ -398,24 +451,13 @@ namespace my {
         }
 
         /// 迭代器相关操作
+        /// begin() 直接取链表头，O(1)
         iterator begin() {
-            /// 找到第一个非空桶，返回第一个节点
-            for (size_t i = 0; i < buckets_.size(); i++) {
-                if (buckets_[i]) {
-                    return iterator(buckets_[i], this);
-                }
-            }
-            return end();
+            return iterator(begin_node_(), this);
         }
 
         const_iterator begin() const {
-            /// 找到第一个非空桶，返回第一个节点
-            for (size_t i = 0; i < buckets_.size(); i++) {
-                if (buckets_[i]) {
-                    return const_iterator(buckets_[i], this);
-                }
-            }
-            return end();
+            return const_iterator(begin_node_(), this);
         }
 
         const_iterator end() const {
@@ -428,152 +470,176 @@ namespace my {
         }
 
         const_iterator cbegin() const {
-            for (size_t i = 0; i < buckets_.size(); ++i) {
-                if (buckets_[i]) {
-                    return const_iterator(buckets_[i], this);
-                }
-            }
-            return const_iterator(nullptr, this);
+            return const_iterator(begin_node_(), this);
         }
 
         const_iterator cend() const {
             return const_iterator(nullptr, this);
         }
 
-        std::pair<iterator, bool> insert_dispatch(const value_type &value, std::true_type) {
+        /// 唯一键版本：先用 value 中的 key 查找，确实需要插入时才创建节点（右值直接移动进节点）
+        template<typename V>
+        std::pair<iterator, bool> insert_dispatch(V &&value, std::true_type) {
             if (buckets_.empty()) {
                 rehash_(rehash_policy_.next_bkt(1));
             }
 
-            std::pair<bool, size_t> do_rehash = rehash_policy_.need_rehash(buckets_.size(), num_elements_, 1);
-            if (do_rehash.first) {
-                rehash_(do_rehash.second);
-            }
-
-            size_type idx = bucket_index_(value);
-            node_type *cur = buckets_[idx];
-            while (cur) {
-                if (equals_(get_key_(cur->value), get_key_(value))) {
-                    return {iterator(cur, this), false};
-                }
-                cur = cur->next;
+            size_type code = hash_(get_key_(value));
+            size_type idx = code % buckets_.size();
+            if (node_base *prev = find_before_node_(idx, get_key_(value), code)) {
+                return {iterator(static_cast<node_type *>(prev->next), this), false};
             }
 
-            node_type *node = create_node_(value);
-            node->next = buckets_[idx];
-            buckets_[idx] = node;
-            ++num_elements_;
-            return {iterator(node, this), true};
+            node_type *node = create_node_(my::forward<V>(value));
+            return {insert_unique_node_(idx, code, node), true};
         }
 
         /// 可重复键版本（multiset/multimap）
-        iterator insert_dispatch(const value_type &value, std::false_type) {
+        template<typename V>
+        iterator insert_dispatch(V &&value, std::false_type) {
+            size_type code = hash_(get_key_(value));
+            return insert_multi_node_(code, create_node_(my::forward<V>(value)));
+        }
+
+        /// 插入
+        auto insert(const value_type &value) {
+            /// 根据unique_keys匹配模板判断是否可以重复插入，然后去调用对应版本的插入
+            return insert_dispatch(value, unique_keys{});
+        }
+
+        auto insert(value_type &&value) {
+            return insert_dispatch(my::move(value), unique_keys{});
+        }
+
+        /// 带位置提示的插入：链式哈希表中节点位置完全由哈希值决定，提示只为与 STL 接口保持一致，直接忽略
+        iterator insert(const_iterator, const value_type &value) {
+            return to_iterator_(insert(value));
+        }
+
+        iterator insert(const_iterator, value_type &&value) {
+            return to_iterator_(insert(my::move(value)));
+        }
+
+        /// emplace：必须先构造出节点才能拿到 key，唯一键且 key 已存在时销毁刚构造的节点
+        /// 如果只想在 key 不存在时才构造，请使用 try_emplace
+        template<typename... Args>
+        auto emplace(Args &&... args) {
+            return emplace_dispatch(unique_keys{}, my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator, Args &&... args) {
+            return to_iterator_(emplace(my::forward<Args>(args)...));
+        }
+
+        /// try_emplace：仅适用于 value 为 pair<const Key, T> 的唯一键表（unordered_map）
+        /// 先按 key 查找，不存在时才以 piecewise 方式在节点中就地构造 key 和 mapped，key 已存在时不会构造或移动任何参数
+        template<typename KeyArg, typename... Args>
+        std::pair<iterator, bool> try_emplace(KeyArg &&key, Args &&... args) {
+            static_assert(UniqueKeys::value, "try_emplace requires unique keys");
             if (buckets_.empty()) {
                 rehash_(rehash_policy_.next_bkt(1));
             }
 
-            std::pair<bool, size_t> do_rehash = rehash_policy_.need_rehash(buckets_.size(), num_elements_, 1);
-            if (do_rehash.first) {
-                rehash_(do_rehash.second);
+            size_type code = hash_(key);
+            size_type idx = code % buckets_.size();
+            if (node_base *prev = find_before_node_(idx, key, code)) {
+                return {iterator(static_cast<node_type *>(prev->next), this), false};
             }
 
-            size_type idx = bucket_index_(value);
-            node_type *node = create_node_(value);
-            node->next = buckets_[idx];
-            buckets_[idx] = node;
-            ++num_elements_;
-            return iterator(node, this);
+            node_type *node = create_node_(std::piecewise_construct,
+                                           std::forward_as_tuple(my::forward<KeyArg>(key)),
+                                           std::forward_as_tuple(my::forward<Args>(args)...));
+            return {insert_unique_node_(idx, code, node), true};
         }
 
-        /// 插入
-        auto insert(const value_type &value) {
-            /// 根据unique_keys匹配模板判断是否可以重复插入，然后去调用对应版本的插入
-            return insert_dispatch(value, unique_keys{});
+        /// key 不存在时插入，存在时把 obj 赋给已有的 mapped
+        template<typename KeyArg, typename M>
+        std::pair<iterator, bool> insert_or_assign(KeyArg &&key, M &&obj) {
+            /// try_emplace 在 key 已存在时不会动 obj，所以这里可以再把它转发给赋值
+            std::pair<iterator, bool> res = try_emplace(my::forward<KeyArg>(key), my::forward<M>(obj));
+            if (!res.second) {
+                res.first->second = my::forward<M>(obj);
+            }
+            return res;
         }
 
         /// 查询函数
         /// 按key查找
         iterator find(const key_type &key) {
-            if (buckets_.empty()) {
-                rehash_(rehash_policy_.next_bkt(1));
-            }
+            return iterator(find_node_(key), this);     /// 没找到时节点为空，即尾迭代器
+        }
 
-            size_type idx = hash_(key) % buckets_.size();
-            node_type *cur = buckets_[idx];
-            while (cur) {
-                if (equals_(get_key_(cur->value), key)) {
-                    return iterator(cur, this);
-                }
-                cur = cur->next;
-            }
-            return end();       /// 没找到就返回尾迭代器
+        /// const 版本，不做空桶扩容，供只读场景（如并发容器的读路径）使用
+        const_iterator find(const key_type &key) const {
+            return const_iterator(find_node_(key), this);
+        }
+
+        /// 异构查找：Hash 和 EqualKey 都声明了 is_transparent 时，可以直接用与 key 可比较的类型查找，不构造临时 key
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        iterator find(const K &key) {
+            return iterator(find_node_(key), this);
+        }
+
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        const_iterator find(const K &key) const {
+            return const_iterator(find_node_(key), this);
+        }
+
+        bool contains(const key_type &key) const {
+            return find_node_(key) != nullptr;
+        }
+
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        bool contains(const K &key) const {
+            return find_node_(key) != nullptr;
         }
 
         /// 迭代器删除 erase
         iterator erase(iterator it) {
-            if (buckets_.empty()) {
-                rehash_(rehash_policy_.next_bkt(1));
-            }
-
             assert(it.table_ == this);
 
             /// 按照迭代器删除
-            /// 先找到这个迭代器对应的桶
+            /// 先找到这个迭代器对应的桶，再在桶内找到它的前驱节点
             node_type *cur = it.current_;
-            size_type idx = bucket_index_(cur->value);
-            node_type *first = buckets_[idx];
-
-            /// 先保存下一个节点指针
-            node_type *next = find_next_node(cur);
-
-            /// 判断当前的桶是否和cur一致
-            if (first == cur) {
-                buckets_[idx] = cur->next;
-                /// 释放这个节点对象
-            } else {
-                node_type *prev = first;    /// 如果暂时不相等的话，直接找到被删除迭代器的前一个迭代器
-                while (prev->next != cur) {
-                    prev = prev->next;
-                }
-                prev->next = cur->next;
+            size_type idx = bucket_index_(cur);
+            node_base *prev = buckets_[idx];
+            while (prev->next != cur) {
+                prev = prev->next;
             }
 
-            destroy_node_(cur);
-            --num_elements_;
-            return next ? iterator(next, this) : end();         /// 如果prev的下一个节点还存在的话，就返回这个迭代器，否则返回end
+            /// 下一个节点就是链表中的下一个，不需要再扫描后续的桶
+            node_type *next = cur->next_node();
+            erase_node_(idx, prev, cur);
+            return iterator(next, this);
         }
 
         /// 按照键删除,并且返回删除了多少个
         size_type erase(key_type key) {
             if (buckets_.empty()) {
-                rehash_(rehash_policy_.next_bkt(1));
+                return 0;
             }
 
-            /// 按照键删除，直接用两个指针分别指向当前节点和当前节点的前一个节点，找到之后，进行删除
-            size_type idx = hash_(key) % buckets_.size();
-            node_type *cur = buckets_[idx];
-            node_type *prev = nullptr;
-            size_type cnt = 0;
-            while (cur) {
-                if (equals_(get_key_(cur->value), key)) {
-                    /// cur找到了当前需要被删除的键
-                    if (prev) {
-                        /// 考虑是不是头节点，如果是头节点prev= nullptr
-                        prev->next = cur->next;
-                    } else {
-                        buckets_[idx] = cur->next;      /// 每个桶地址就是其中的第一个节点的地址
-                    }
-                    node_type *next = cur->next;
-                    destroy_node_(cur);
-                    cur = next;
-                    ++cnt;
-                    --num_elements_;
-                } else {
-                    /// 没有找到相等的key
-                    prev = cur;
-                    cur = cur->next;
-                }
+            /// 先找到第一个匹配节点的前驱，等价节点在链表中相邻，依次删除即可
+            size_type code = hash_(key);
+            size_type idx = code % buckets_.size();
+            node_base *prev = find_before_node_(idx, key, code);
+            if (!prev) {
+                return 0;
             }
+
+            size_type cnt = 0;
+            node_type *cur = static_cast<node_type *>(prev->next);
+            do {
+                node_type *next = cur->next_node();
+                erase_node_(idx, prev, cur);
+                ++cnt;
+                cur = next;
+            } while (cur && bucket_index_(cur) == idx && cur->hash_code == code
+                     && equals_(get_key_(cur->value), key));
             return cnt;
         }
 
@@ -582,6 +648,106 @@ namespace my {
             return erase(iterator(it.current_, const_cast<hashtable *>(it.table_)));
         }
 
+        /// 节点操作：extract 把节点从表中摘下交给句柄，insert(node_handle&&) 把句柄中的节点挂回表中
+        /// 整个过程不分配内存，也不拷贝/移动元素
+        node_handle_type extract(const_iterator it) {
+            node_type *cur = const_cast<node_type *>(it.current_);
+            size_type idx = bucket_index_(cur);
+            node_base *prev = buckets_[idx];
+            while (prev->next != cur) {
+                prev = prev->next;
+            }
+            unlink_node_(idx, prev, cur);
+            return node_traits::make(cur, node_alloc_, value_alloc_);
+        }
+
+        /// 按键摘下一个节点，找不到时返回空句柄
+        node_handle_type extract(const key_type &key) {
+            if (buckets_.empty()) {
+                return node_handle_type();
+            }
+            size_type code = hash_(key);
+            size_type idx = code % buckets_.size();
+            node_base *prev = find_before_node_(idx, key, code);
+            if (!prev) {
+                return node_handle_type();
+            }
+            node_type *cur = static_cast<node_type *>(prev->next);
+            unlink_node_(idx, prev, cur);
+            return node_traits::make(cur, node_alloc_, value_alloc_);
+        }
+
+        /// 唯一键表返回 insert_return_type，key 已存在时节点原样留在返回值的 node 中
+        /// 可重复键表返回指向新节点的迭代器
+        /// 扩容失败抛出异常时，节点仍然由 nh 持有
+        auto insert(node_handle_type &&nh) {
+            if constexpr (UniqueKeys::value) {
+                insert_return_type ret{end(), false, node_handle_type()};
+                if (nh.empty()) {
+                    return ret;
+                }
+                node_type *node = node_traits::get(nh);
+                size_type code = hash_(get_key_(node->value));
+                if (!buckets_.empty()) {
+                    size_type idx = code % buckets_.size();
+                    if (node_base *prev = find_before_node_(idx, get_key_(node->value), code)) {
+                        ret.position = iterator(static_cast<node_type *>(prev->next), this);
+                        ret.node = my::move(nh);
+                        return ret;
+                    }
+                }
+                grow_for_insert_();
+                ret.position = link_unique_node_(code % buckets_.size(), code, node_traits::release(nh));
+                ret.inserted = true;
+                return ret;
+            } else {
+                if (nh.empty()) {
+                    return end();
+                }
+                size_type code = hash_(get_key_(node_traits::get(nh)->value));
+                grow_for_insert_();
+                return link_multi_node_(code, node_traits::release(nh));
+            }
+        }
+
+        iterator insert(const_iterator, node_handle_type &&nh) {
+            return to_iterator_(insert(my::move(nh)));
+        }
+
+        /// 把 source 中的节点逐个摘下挂到本表中，只改指针，不分配也不拷贝
+        /// 唯一键表中已存在的 key 对应的节点留在 source 中
+        /// source 可以使用不同的哈希函数/相等比较，也可以是可重复键表；哈希函数类型相同时直接复用节点缓存的哈希值
+        template<typename UK2, typename H2, typename E2>
+        void merge(hashtable<Key, Value, ExtractKey, UK2, H2, E2, Alloc> &source) {
+            if (static_cast<void *>(&source) == static_cast<void *>(this)) {
+                return;
+            }
+            node_base *prev = &source.before_begin_;
+            while (prev->next) {
+                node_type *cur = static_cast<node_type *>(prev->next);
+                size_type code;
+                if constexpr (std::is_same<Hash, H2>::value) {
+                    code = cur->hash_code;
+                } else {
+                    code = hash_(get_key_(cur->value));
+                }
+                if constexpr (UniqueKeys::value) {
+                    if (!buckets_.empty() &&
+                        find_before_node_(code % buckets_.size(), get_key_(cur->value), code)) {
+                        prev = cur;     /// 已存在，跳过
+                        continue;
+                    }
+                }
+                grow_for_insert_();     /// 先扩容，失败时 source 保持不变
+                source.unlink_node_(source.bucket_index_(cur), prev, cur);
+                if constexpr (UniqueKeys::value) {
+                    link_unique_node_(code % buckets_.size(), code, cur);
+                } else {
+                    link_multi_node_(code, cur);
+                }
+            }
+        }
+
 
 
         /// 获取大小
@@ -596,16 +762,13 @@ namespace my {
 
         /// count计算目标键相等的有多少个
         size_type count(const key_type &key) const {
-            size_type idx = hash_(key) % buckets_.size();
-            node_type *cur = buckets_[idx];
-            size_type cnt = 0;
-            while (cur) {
-                if (equals_(get_key_(cur->value), key)) {
-                    ++cnt;
-                }
-                cur = cur->next;
-            }
-            return cnt;
+            return count_(key);
+        }
+
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        size_type count(const K &key) const {
+            return count_(key);
         }
 
         /// load_factor
@@ -613,6 +776,11 @@ namespace my {
             return static_cast<float>(num_elements_) / buckets_.size();
         }
 
+        /// 桶的个数
+        size_type bucket_count() const {
+            return buckets_.size();
+        }
+
         /// 重载==与！=
         bool operator==(const hashtable &other) const {
             if (this == &other) {
@@ -642,6 +810,7 @@ namespace my {
         }
 
         /// swap 将两者的所有资源交换
+        /// 桶数组中指向 before_begin_ 的那一项需要改指向各自的哨兵
         void swap(hashtable &other) {
             my::swap(hash_, other.hash_);
             my::swap(equals_, other.equals_);
@@ -651,92 +820,52 @@ namespace my {
             my::swap(node_alloc_, other.node_alloc_);
             my::swap(value_alloc_, other.value_alloc_);
             my::swap(rehash_policy_, other.rehash_policy_);
+            my::swap(before_begin_.next, other.before_begin_.next);
+            fix_before_begin_bucket_();
+            other.fix_before_begin_bucket_();
         }
 
         /// clear()
+        /// 只沿链表析构节点，并只把这些节点所在的桶置空，代价与元素个数成正比
         void clear() {
-            /// 将所有的节点对象析构
-            for (size_t i = 0; i < buckets_.size(); i++) {
-                /// 取出当前节点
-                node_type *cur = buckets_[i];
-                while (cur) {
-                    /// 提前保存下一个节点
-                    node_type *next = cur->next;
-                    destroy_node_(cur);
-                    cur = next;
-                }
-                buckets_[i] = nullptr;
+            node_type *cur = begin_node_();
+            while (cur) {
+                /// 提前保存下一个节点
+                node_type *next = cur->next_node();
+                buckets_[bucket_index_(cur)] = nullptr;
+                destroy_node_(cur);
+                cur = next;
             }
+            before_begin_.next = nullptr;
             /// 清空节点元素数量
             num_elements_ = 0;
         }
 
         /// 兼容唯一键和重复键的equal_range()实现
+        /// 等价节点在链表中相邻，找到第一个匹配节点后向后走到第一个不匹配的节点即可
         my::pair<iterator, iterator> equal_range(const key_type &key) {
-            if constexpr (UniqueKeys::value) {
-                /// 唯一键模式（如 unordered_map），最多只有一个
-                iterator it = find(key);
-                if (it == end()) {
-                    return {end(), end()};
-                }
-                iterator next = it;
-                ++next;
-                return {it, next};
-            } else {
-                /// 多键模式（如 unordered_multimap）
-                size_type index = hash_index(key);
-                node_type *node = buckets_[index];
-
-                /// 找到第一个 key 匹配的位置
-                while (node && !equals_(get_key_(node->value), key)) {
-                    node = node->next;
-                }
-
-                node_type *first = node;
-
-                /// 向后找，直到 key 不匹配为止
-                while (node && equals_(get_key_(node->value), key)) {
-                    node = node->next;
-                }
+            my::pair<node_type *, node_type *> range = equal_range_(key);
+            return {iterator(range.first_, this), iterator(range.second_, this)};
+        }
 
-                return {
-                        iterator(first, this),
-                        iterator(node, this)
-                };
-            }
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        my::pair<iterator, iterator> equal_range(const K &key) {
+            my::pair<node_type *, node_type *> range = equal_range_(key);
+            return {iterator(range.first_, this), iterator(range.second_, this)};
         }
 
         /// const 版本的 equal_range()
         std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
-            if constexpr (UniqueKeys::value) {
-                /// 唯一键模式（如 unordered_map），最多只有一个
-                const_iterator it = find(key);
-                if (it == cend()) {
-                    return {cend(), cend()};
-                }
-                const_iterator next = it;
-                ++next;
-                return {it, next};
-            } else {
-                /// 多键模式（如 unordered_multimap）
-                size_type index = hash_index(key);
-                const node_type *node = buckets_[index];  // 注意这里是 const node_type*
-
-                /// 找到第一个 key 匹配的位置
-                while (node && !equals_(get_key_(node->value), key)) {
-                    node = node->next;
-                }
-
-                const node_type *first = node;
-
-                /// 向后找，直到 key 不匹配为止
-                while (node && equals_(get_key_(node->value), key)) {
-                    node = node->next;
-                }
-                const node_type *last = node;
+            my::pair<node_type *, node_type *> range = equal_range_(key);
+            return {const_iterator(range.first_, this), const_iterator(range.second_, this)};
+        }
 
-                return { const_iterator(first, this), const_iterator(last, this) };
-            }
+        template<typename K, typename H = Hash, typename E = EqualKey,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<E>>>
+        std::pair<const_iterator, const_iterator> equal_range(const K &key) const {
+            my::pair<node_type *, node_type *> range = equal_range_(key);
+            return {const_iterator(range.first_, this), const_iterator(range.second_, this)};
         }
 
 
@@ -751,10 +880,11 @@ namespace my {
             std::cout << "=== Hashtable Buckets Dump ===\n";
             for (size_t i = 0; i < buckets_.size(); ++i) {
                 std::cout << "Bucket[" << i << "]: ";
-                node_type *cur = buckets_[i];
-                while (cur) {
-                    std::cout << cur->value << " -> ";
-                    cur = cur->next;
+                if (buckets_[i]) {
+                    for (const node_type *cur = static_cast<const node_type *>(buckets_[i]->next);
+                         cur && bucket_index_(cur) == i; cur = cur->next_node()) {
+                        std::cout << cur->value << " -> ";
+                    }
                 }
                 std::cout << "null\n";
             }
@@ -763,40 +893,269 @@ namespace my {
 
     private:
         /// 私有接口
-        /// 找到当前节点cur的全局下一个节点
-        node_type *find_next_node(node_type *cur) {
-            size_type idx = bucket_index_(cur->value);
-            /// 桶内还有下一个节点就直接返回
-            if (cur->next) {
-                return cur->next;
+        /// 链表中的第一个节点
+        node_type *begin_node_() const {
+            return static_cast<node_type *>(before_begin_.next);
+        }
+
+        /// 获取桶下标，直接使用节点缓存的哈希值
+        size_type bucket_index_(const node_type *node, size_t n) const {
+            return node->hash_code % n;
+        }
+
+        size_type bucket_index_(const node_type *node) const {
+            return bucket_index_(node, buckets_.size());
+        }
+
+        /// 为插入一个元素准备桶：空表先分配桶，超过负载因子则扩容，返回是否发生了 rehash
+        bool grow_for_insert_() {
+            if (buckets_.empty()) {
+                rehash_(rehash_policy_.next_bkt(1));
+                return true;
             }
+            std::pair<bool, size_t> do_rehash = rehash_policy_.need_rehash(buckets_.size(), num_elements_, 1);
+            if (do_rehash.first) {
+                rehash_(do_rehash.second);
+            }
+            return do_rehash.first;
+        }
 
-            /// 否则往后找下一个非空桶
-            for (size_type i = idx + 1; i < buckets_.size(); ++i) {
-                if (buckets_[i]) {
-                    return buckets_[i];
+        /// 把已经构造好的节点挂到唯一键表中（调用方已确认 key 不存在），必要时先扩容
+        iterator insert_unique_node_(size_type idx, size_type code, node_type *node) {
+            try {
+                if (grow_for_insert_()) {
+                    idx = code % buckets_.size();
                 }
+            } catch (...) {
+                destroy_node_(node);
+                throw;
+            }
+            return link_unique_node_(idx, code, node);
+        }
+
+        /// 把已经构造好的节点挂到可重复键表中
+        iterator insert_multi_node_(size_type code, node_type *node) {
+            try {
+                grow_for_insert_();
+            } catch (...) {
+                destroy_node_(node);
+                throw;
+            }
+            return link_multi_node_(code, node);
+        }
+
+        /// 以下两个函数只负责挂链，不会抛异常，调用方需保证桶已经足够
+        iterator link_unique_node_(size_type idx, size_type code, node_type *node) {
+            node->hash_code = code;
+            insert_bucket_begin_(idx, node);
+            ++num_elements_;
+            return iterator(node, this);
+        }
+
+        /// 相同的键插入到已有等价节点之前，保证等价节点在链表中相邻，equal_range 才能一次走完
+        iterator link_multi_node_(size_type code, node_type *node) {
+            size_type idx = code % buckets_.size();
+            node->hash_code = code;
+            if (node_base *prev = find_before_node_(idx, get_key_(node->value), code)) {
+                node->next = prev->next;
+                prev->next = node;
+            } else {
+                insert_bucket_begin_(idx, node);
+            }
+            ++num_elements_;
+            return iterator(node, this);
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace_dispatch(std::true_type, Args &&... args) {
+            if (buckets_.empty()) {
+                rehash_(rehash_policy_.next_bkt(1));
+            }
+
+            node_type *node = create_node_(my::forward<Args>(args)...);
+            size_type code;
+            try {
+                code = hash_(get_key_(node->value));
+            } catch (...) {
+                destroy_node_(node);
+                throw;
+            }
+            size_type idx = code % buckets_.size();
+            if (node_base *prev = find_before_node_(idx, get_key_(node->value), code)) {
+                destroy_node_(node);
+                return {iterator(static_cast<node_type *>(prev->next), this), false};
+            }
+            return {insert_unique_node_(idx, code, node), true};
+        }
+
+        template<typename... Args>
+        iterator emplace_dispatch(std::false_type, Args &&... args) {
+            node_type *node = create_node_(my::forward<Args>(args)...);
+            size_type code;
+            try {
+                code = hash_(get_key_(node->value));
+            } catch (...) {
+                destroy_node_(node);
+                throw;
+            }
+            return insert_multi_node_(code, node);
+        }
+
+        static iterator to_iterator_(iterator it) {
+            return it;
+        }
+
+        static iterator to_iterator_(const std::pair<iterator, bool> &res) {
+            return res.first;
+        }
+
+        static iterator to_iterator_(const insert_return_type &res) {
+            return res.position;
+        }
+
+        /// 在桶 idx 中查找 key，返回匹配节点的前驱（找不到返回 nullptr）
+        /// 桶中的节点在链表上连续，遇到下一个节点不再属于本桶时停止
+        /// K 可以是 key_type，也可以是透明查找时与 key 可比较的其他类型
+        template<typename K>
+        node_base *find_before_node_(size_type idx, const K &key, size_type code) const {
+            node_base *prev = buckets_[idx];
+            if (!prev) {
+                return nullptr;
+            }
+            for (node_type *cur = static_cast<node_type *>(prev->next);; cur = cur->next_node()) {
+                if (cur->hash_code == code && equals_(get_key_(cur->value), key)) {
+                    return prev;
+                }
+                if (!cur->next || bucket_index_(cur->next_node()) != idx) {
+                    break;
+                }
+                prev = cur;
             }
-            /// 如果已经没有了则返回nullptr
             return nullptr;
         }
 
-        /// 获取桶下标
-        size_type bucket_index_(const value_type &value, size_t n) const {
-            return hash_(get_key_(value)) % n;
+        template<typename K>
+        node_type *find_node_(const K &key) const {
+            if (buckets_.empty()) {
+                return nullptr;
+            }
+            size_type code = hash_(key);
+            node_base *prev = find_before_node_(code % buckets_.size(), key, code);
+            return prev ? static_cast<node_type *>(prev->next) : nullptr;
+        }
+
+        template<typename K>
+        size_type count_(const K &key) const {
+            if (buckets_.empty()) {
+                return 0;
+            }
+
+            size_type code = hash_(key);
+            size_type idx = code % buckets_.size();
+            node_base *prev = find_before_node_(idx, key, code);
+            if (!prev) {
+                return 0;
+            }
+            size_type cnt = 0;
+            for (node_type *cur = static_cast<node_type *>(prev->next);
+                 cur && bucket_index_(cur) == idx; cur = cur->next_node()) {
+                if (cur->hash_code == code && equals_(get_key_(cur->value), key)) {
+                    ++cnt;
+                } else {
+                    break;      /// 等价节点相邻，遇到第一个不相等的就可以结束
+                }
+            }
+            return cnt;
+        }
+
+        template<typename K>
+        my::pair<node_type *, node_type *> equal_range_(const K &key) const {
+            node_type *first = find_node_(key);
+            if (!first) {
+                return {nullptr, nullptr};
+            }
+            node_type *last = first->next_node();
+            if constexpr (!UniqueKeys::value) {
+                /// 多键模式（如 unordered_multimap）
+                while (last && last->hash_code == first->hash_code && equals_(get_key_(last->value), key)) {
+                    last = last->next_node();
+                }
+            }
+            return {first, last};
         }
 
-        size_type bucket_index_(const value_type &value) const {
-            return bucket_index_(value, buckets_.size());
+        /// 把节点插到桶 idx 的开头
+        void insert_bucket_begin_(size_type idx, node_type *node) {
+            if (buckets_[idx]) {
+                /// 桶非空：插在桶的前驱节点之后
+                node->next = buckets_[idx]->next;
+                buckets_[idx]->next = node;
+            } else {
+                /// 空桶：插到整条链表的开头，原来的链表头所在的桶的前驱变成新节点
+                node->next = before_begin_.next;
+                before_begin_.next = node;
+                if (node->next) {
+                    buckets_[bucket_index_(node->next_node())] = node;
+                }
+                buckets_[idx] = &before_begin_;
+            }
+        }
+
+        /// 删除桶 idx 中的节点 cur，prev 是它的前驱
+        void erase_node_(size_type idx, node_base *prev, node_type *cur) {
+            unlink_node_(idx, prev, cur);
+            destroy_node_(cur);
+        }
+
+        /// 把节点 cur 从链表和桶中摘下（不销毁），prev 是它的前驱
+        void unlink_node_(size_type idx, node_base *prev, node_type *cur) {
+            node_type *next = cur->next_node();
+            if (prev == buckets_[idx]) {
+                /// cur 是桶中第一个节点
+                if (!next || bucket_index_(next) != idx) {
+                    /// 删除后桶为空：下一个桶的前驱改为 prev
+                    if (next) {
+                        buckets_[bucket_index_(next)] = prev;
+                    }
+                    buckets_[idx] = nullptr;
+                }
+            } else if (next) {
+                /// cur 是桶中最后一个节点时，下一个桶的前驱从 cur 变为 prev
+                size_type next_idx = bucket_index_(next);
+                if (next_idx != idx) {
+                    buckets_[next_idx] = prev;
+                }
+            }
+            prev->next = next;
+            cur->next = nullptr;
+            --num_elements_;
+        }
+
+        /// 桶数组被移动/交换之后，让第一个非空桶重新指向本对象的 before_begin_
+        void fix_before_begin_bucket_() {
+            if (before_begin_.next) {
+                buckets_[bucket_index_(begin_node_())] = &before_begin_;
+            }
+        }
+
+        /// 移动构造/赋值时接管 other 的链表，other 变为空表
+        void steal_chain_(hashtable &other) {
+            before_begin_.next = other.before_begin_.next;
+            fix_before_begin_bucket_();
+            other.before_begin_.next = nullptr;
+            other.num_elements_ = 0;
         }
 
         /// 创建节点和销毁节点
-        node_type *create_node_(const value_type &value) {
+        /// 可变参数转发给 value 的构造函数，支持拷贝、移动以及就地构造
+        template<typename... Args>
+        node_type *create_node_(Args &&... args) {
             /// 先分配空间
             node_type *n = node_alloc_.allocate(1);
             try {
                 /// 构造节点中的 value 成员
-                std::allocator_traits<allocator_type>::construct(value_alloc_, std::addressof(n->value), value);
+                std::allocator_traits<allocator_type>::construct(value_alloc_, std::addressof(n->value),
+                                                                 my::forward<Args>(args)...);
                 /// 初始化 next 指针
                 n->next = nullptr;      /// 如果不初始化的话，很容易造成野指针，导致未定义的随机值，后续崩溃
             } catch (...) {
@@ -815,20 +1174,29 @@ namespace my {
         }
 
         /// rehash策略
+        /// 沿链表把节点逐个挂到新桶数组上：新桶为空时节点放到链表头，否则放到该桶的前驱之后
         void rehash_(size_type n) {
-            std::vector<node_type *> new_buckets(n);
-            for (size_t i = 0; i < buckets_.size(); i++) {
-                node_type *cur = buckets_[i];
-                while (cur) {
-                    /// 获取hash值
-                    size_type idx = bucket_index_(cur->value, n);
-                    /// 保存下一个节点
-                    node_type *next = cur->next;
-                    /// 指向新的桶数组
-                    cur->next = new_buckets[idx];
-                    new_buckets[idx] = cur;
-                    cur = next;
+            std::vector<node_base *> new_buckets(n, nullptr);
+            node_type *cur = begin_node_();
+            before_begin_.next = nullptr;
+            size_type bbegin_idx = 0;       /// 当前链表头所在的桶
+            while (cur) {
+                /// 保存下一个节点
+                node_type *next = cur->next_node();
+                size_type idx = bucket_index_(cur, n);
+                if (!new_buckets[idx]) {
+                    cur->next = before_begin_.next;
+                    before_begin_.next = cur;
+                    new_buckets[idx] = &before_begin_;
+                    if (cur->next) {
+                        new_buckets[bbegin_idx] = cur;
+                    }
+                    bbegin_idx = idx;
+                } else {
+                    cur->next = new_buckets[idx]->next;
+                    new_buckets[idx]->next = cur;
                 }
+                cur = next;
             }
             /// 交换新旧桶
             buckets_.swap(new_buckets);
@@ -839,11 +1207,12 @@ namespace my {
         hasher hash_;                            /// 哈希函数对象
         key_equal equals_;                      /// 键等价比较器
         ExtractKey get_key_;                    /// 提取 key 的函数对象
-        std::vector<node_type *> buckets_;       /// 哈希函数桶，每个桶是一个链表头指针
+        std::vector<node_base *> buckets_;       /// 哈希函数桶，每个桶存放桶中第一个节点的前驱
         size_type num_elements_;                /// 当前元素的个数
         node_allocator_type node_alloc_;        /// 节点分配器
         allocator_type value_alloc_;            /// 值分配器
         rehash_policy rehash_policy_;           /// 重哈希策略
+        node_base before_begin_;                /// 链表头哨兵，before_begin_.next 就是 begin()
     };
 
 /// 恒等函数对象---将输入直接原样返回
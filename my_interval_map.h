@@ -0,0 +1,345 @@
+/**
+ * @file      my_interval_map.h
+ * @brief     [区间树：在红黑树节点上维护子树中最大的右端点，支持区间重叠查询、点查询和有序输入的批量建树]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_rbtree.h"
+#include "my_sorted_tag.h"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+/**
+ * interval_map
+ * 元素是 (闭区间 [low, high], 值)，按 (low, high) 排序放在 ::RBTree 中，区间可以重复（与 multimap 相同）
+ * 每个节点额外维护子树中所有区间的最大右端点 _max（interval_max_augment），由红黑树自己维护：
+ *      插入：新节点到根的路径上取 max，O(log n)
+ *      删除：被摘掉的位置到根的路径上由孩子重新计算
+ *      旋转：RotateL / RotateR 中先下后上重新计算两个节点
+ * 查询 [lo, hi] 的重叠区间（low <= hi 且 high >= lo）时：
+ *      子树的 _max < lo 说明整棵子树都在 lo 左边，直接跳过
+ *      节点的 low > hi 说明它和它右子树中的区间都在 hi 右边，后面也不会再有
+ * 第一个结果 O(log n)，之后按 low 的顺序逐个给出，k 个结果共 O(min(n, k log n))；点查询就是 lo == hi
+ */
+
+namespace my {
+
+    /// 闭区间 [low, high]，要求 !(high < low)
+    template<typename K>
+    struct interval {
+        K low;
+        K high;
+
+        bool operator==(const interval &rhs) const { return low == rhs.low && high == rhs.high; }
+
+        bool operator!=(const interval &rhs) const { return !(*this == rhs); }
+    };
+
+    /// 附加信息策略（接口见 my_rbtree.h 中的 RBTreeNoAugment）：子树中最大的右端点
+    /// 右端点用 interval_map 自己的比较器比较，策略对象由树保存，构造时从 interval_map 传入
+    template<typename K, typename Compare>
+    struct interval_max_augment {
+        struct NodeData {
+            K _max{};
+        };
+        static constexpr bool enabled = true;
+        static constexpr bool order_statistic = false;
+
+        [[no_unique_address]] Compare comp;
+
+        template<class Node>
+        void Update(Node *pNode) const {
+            const K *pMax = &pNode->_val.first.high;
+            if (pNode->_pLeft && comp(*pMax, pNode->_pLeft->_aug._max))
+                pMax = &pNode->_pLeft->_aug._max;
+            if (pNode->_pRight && comp(*pMax, pNode->_pRight->_aug._max))
+                pMax = &pNode->_pRight->_aug._max;
+            pNode->_aug._max = *pMax;
+        }
+
+        template<class Node>
+        void Grow(Node *pNode, const Node *pNew) const {
+            if (comp(pNode->_aug._max, pNew->_aug._max))
+                pNode->_aug._max = pNew->_aug._max;
+        }
+
+        /// 摘掉的区间可能正好是最大值，只能由孩子重新计算
+        template<class Node>
+        void Shrink(Node *pNode, const Node *) const {
+            Update(pNode);
+        }
+    };
+
+    namespace detail {
+
+        /// 按 (low, high) 比较元素；也能直接和 interval 比较，供树的 Find / LowerBound 使用
+        template<typename K, typename T, typename Compare>
+        struct interval_value_compare {
+            using interval_type = interval<K>;
+            using value_type = std::pair<const interval_type, T>;
+
+            Compare comp;
+
+            bool less(const interval_type &a, const interval_type &b) const {
+                return comp(a.low, b.low) || (!comp(b.low, a.low) && comp(a.high, b.high));
+            }
+
+            bool operator()(const value_type &a, const value_type &b) const { return less(a.first, b.first); }
+
+            bool operator()(const value_type &a, const interval_type &b) const { return less(a.first, b); }
+
+            bool operator()(const interval_type &a, const value_type &b) const { return less(a, b.first); }
+        };
+    }
+
+    template<typename K,
+            typename T,
+            typename Compare = std::less<K>,
+            typename Alloc = MyAlloc<std::pair<const interval<K>, T>>>
+    class interval_map {
+        using value_compare_type = detail::interval_value_compare<K, T, Compare>;
+        using augment_type = interval_max_augment<K, Compare>;
+        using tree_type = ::RBTree<std::pair<const interval<K>, T>, value_compare_type, Alloc, augment_type>;
+        using node_pointer = typename tree_type::node_pointer;
+    public:
+        using key_type = interval<K>;
+        using point_type = K;
+        using mapped_type = T;
+        using value_type = std::pair<const interval<K>, T>;
+        using size_type = size_t;
+        using key_compare = Compare;
+        using allocator_type = Alloc;
+        using iterator = typename tree_type::iterator;
+
+        /// 按 low 的顺序给出与查询区间重叠的元素；base() 是对应的普通迭代器，可以用来 erase
+        class overlap_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = interval_map::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = value_type *;
+            using reference = value_type &;
+
+            overlap_iterator() = default;
+
+            reference operator*() const { return pNode_->_val; }
+
+            pointer operator->() const { return &pNode_->_val; }
+
+            overlap_iterator &operator++() {
+                pNode_ = interval_map::next_overlap_(pNode_, pHead_, low_, high_, comp_);
+                return *this;
+            }
+
+            overlap_iterator operator++(int) {
+                overlap_iterator temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            bool operator==(const overlap_iterator &rhs) const { return pNode_ == rhs.pNode_; }
+
+            bool operator!=(const overlap_iterator &rhs) const { return pNode_ != rhs.pNode_; }
+
+            iterator base() const { return iterator(pNode_, pHead_); }
+
+        private:
+            friend class interval_map;
+
+            overlap_iterator(node_pointer pNode, node_pointer pHead, const K &low, const K &high, const Compare &comp)
+                    : pNode_(pNode), pHead_(pHead), low_(low), high_(high), comp_(comp) {}
+
+            node_pointer pNode_ = nullptr;
+            node_pointer pHead_ = nullptr;
+            K low_{};
+            K high_{};
+            Compare comp_{};
+        };
+
+        /// 可以直接用于范围 for 的一对 overlap_iterator
+        struct overlap_range {
+            overlap_iterator first;
+            overlap_iterator last;
+
+            overlap_iterator begin() const { return first; }
+
+            overlap_iterator end() const { return last; }
+
+            bool empty() const { return first == last; }
+        };
+
+        interval_map() = default;
+
+        explicit interval_map(const Compare &comp, const Alloc &alloc = Alloc())
+                : tree_(value_compare_type{comp}, alloc, augment_type{comp}), comp_(comp) {}
+
+        template<typename InputIt>
+        interval_map(InputIt first, InputIt last, const Compare &comp = Compare()) : interval_map(comp) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        interval_map(std::initializer_list<value_type> ilist, const Compare &comp = Compare())
+                : interval_map(ilist.begin(), ilist.end(), comp) {}
+
+        /// 输入已按 (low, high) 升序排列（可以有重复）：O(n) 直接建成平衡的树，_max 在建树时自底向上算好
+        template<typename InputIt>
+        interval_map(sorted_equivalent_t, InputIt first, InputIt last,
+                     const Compare &comp = Compare(), const Alloc &alloc = Alloc()) : interval_map(comp, alloc) {
+            size_ = tree_.BuildSorted(first, last, false);
+        }
+
+        interval_map(sorted_equivalent_t tag, std::initializer_list<value_type> ilist,
+                     const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+                : interval_map(tag, ilist.begin(), ilist.end(), comp, alloc) {}
+
+        /// 批量插入有序区间，O(min(size() + n, n log size()))
+        template<typename InputIt>
+        void insert_sorted(InputIt first, InputIt last) {
+            size_ += tree_.InsertSorted(first, last, false, size_);
+        }
+
+        iterator begin() { return tree_.begin(); }
+
+        iterator end() { return tree_.end(); }
+
+        bool empty() const { return size_ == 0; }
+
+        size_type size() const { return size_; }
+
+        iterator insert(const value_type &val) {
+            iterator it = tree_.EmplaceMulti(val);
+            ++size_;
+            return it;
+        }
+
+        iterator insert(const K &low, const K &high, const T &value) {
+            return emplace(key_type{low, high}, value);
+        }
+
+        template<typename... Args>
+        iterator emplace(Args &&... args) {
+            iterator it = tree_.EmplaceMulti(std::forward<Args>(args)...);
+            ++size_;
+            return it;
+        }
+
+        iterator erase(iterator pos) {
+            --size_;
+            return tree_.Erase(pos);
+        }
+
+        /// 删除所有与 key 相同的区间
+        size_type erase(const key_type &key) {
+            size_type n = tree_.Erase(key);
+            size_ -= n;
+            return n;
+        }
+
+        void clear() {
+            tree_.Clear();
+            size_ = 0;
+        }
+
+        void swap(interval_map &other) {
+            tree_.Swap(other.tree_);
+            std::swap(size_, other.size_);
+            std::swap(comp_, other.comp_);
+        }
+
+        key_compare key_comp() const { return comp_; }
+
+        /// 与 key 完全相同的区间
+        iterator find(const key_type &key) { return tree_.Find(key); }
+
+        size_type count(const key_type &key) { return tree_.Count(key); }
+
+        /// 与 [low, high] 重叠的所有区间
+        overlap_range overlapping(const K &low, const K &high) {
+            node_pointer pHead = tree_.HeadNode();
+            node_pointer pFirst = first_overlap_(tree_.RootNode(), pHead, low, high, comp_);
+            return {overlap_iterator(pFirst, pHead, low, high, comp_),
+                    overlap_iterator(pHead, pHead, low, high, comp_)};
+        }
+
+        overlap_range overlapping(const key_type &key) { return overlapping(key.low, key.high); }
+
+        /// 包含 point 的所有区间（点查询）
+        overlap_range stabbing(const K &point) { return overlapping(point, point); }
+
+        /// 按 low 的顺序第一个与 [low, high] 重叠的区间，没有时返回 end()，O(log n)
+        iterator find_overlap(const K &low, const K &high) { return overlapping(low, high).begin().base(); }
+
+        bool overlaps(const K &low, const K &high) { return !overlapping(low, high).empty(); }
+
+        /// 所有区间的最大右端点，容器不能为空
+        const K &max_high() const { return tree_.RootNode()->_aug._max; }
+
+    private:
+        /**
+         *  子树 pNode 中按中序第一个与 [low, high] 重叠的节点，没有时返回 pHead
+         *  向左走的条件是左子树的 _max >= low：左子树中有右端点够得着 low 的区间 m，
+         *  如果左子树中找不到结果，说明 m.low > high，那么中序在 m 之后的所有节点的 low 都大于 high，整个查询已经结束，
+         *  所以下降过程中永远不需要回头，O(log n)
+         * */
+        static node_pointer first_overlap_(node_pointer pNode, node_pointer pHead,
+                                           const K &low, const K &high, const Compare &comp) {
+            while (pNode) {
+                if (comp(pNode->_aug._max, low))
+                    return pHead;
+                if (pNode->_pLeft && !comp(pNode->_pLeft->_aug._max, low)) {
+                    pNode = pNode->_pLeft;
+                    continue;
+                }
+                if (comp(high, pNode->_val.first.low))
+                    return pHead;
+                if (!comp(pNode->_val.first.high, low))
+                    return pNode;
+                pNode = pNode->_pRight;
+            }
+            return pHead;
+        }
+
+        /**
+         *  中序在 pNode 之后的下一个重叠节点：先在右子树中找，右子树整体够不着 low 时沿父指针上行，
+         *  每遇到一个从左边上来的祖先就检查它本身，再到它的右子树中找
+         *  在某棵子树中找不到结果时（它的 _max >= low），由 first_overlap_ 中同样的理由整个查询结束
+         * */
+        static node_pointer next_overlap_(node_pointer pNode, node_pointer pHead,
+                                          const K &low, const K &high, const Compare &comp) {
+            node_pointer pRight = pNode->_pRight;
+            if (pRight && !comp(pRight->_aug._max, low))
+                return first_overlap_(pRight, pHead, low, high, comp);
+            for (;;) {
+                node_pointer pParent = pNode->_pParent;
+                while (pParent != pHead && pNode == pParent->_pRight) {
+                    pNode = pParent;
+                    pParent = pParent->_pParent;
+                }
+                if (pParent == pHead)
+                    return pHead;
+                pNode = pParent;
+                if (comp(high, pNode->_val.first.low))
+                    return pHead;
+                if (!comp(pNode->_val.first.high, low))
+                    return pNode;
+                pRight = pNode->_pRight;
+                if (pRight && !comp(pRight->_aug._max, low))
+                    return first_overlap_(pRight, pHead, low, high, comp);
+            }
+        }
+
+    private:
+        tree_type tree_;
+        size_type size_ = 0;
+        Compare comp_;
+    };
+}
@@ -0,0 +1,82 @@
+/**
+ * @file      my_intrusive_hook.h
+ * @brief     [侵入式容器的公共部分：元素与嵌在元素中的钩子之间的互相转换（基类钩子 / 成员钩子）]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 侵入式容器
+ * 普通容器为每个元素分配一个节点并把元素拷贝进去；侵入式容器的链接字段（钩子）直接嵌在用户的对象里，
+ * 容器只把已有的对象串起来：插入不分配内存、不拷贝，对象的地址不变，拿到对象的指针就能 O(1) 找到它在容器中的位置
+ * 代价是对象的生命周期由用户管理：对象必须先从容器中删除再销毁，容器析构时只把还在容器中的钩子复位
+ *
+ * 钩子特性（HookTraits）描述对象 T 和钩子节点之间如何互相转换：
+ *      node_type                           容器实际链接的节点类型
+ *      static node_type *to_node(T *)      取出对象中的钩子
+ *      static T *to_value(node_type *)     由钩子找回所在的对象
+ * 一个对象想同时放进几个容器，就需要几个钩子：基类钩子用不同的 Tag 区分，成员钩子用不同的成员区分
+ */
+
+namespace my {
+    namespace intrusive {
+
+        /// 默认的钩子标签
+        struct default_tag {};
+
+        /// 基类钩子：T 从 Hook 派生
+        template<typename T, typename Hook>
+        struct base_hook {
+            using value_type = T;
+            using hook_type = Hook;
+            using node_type = typename Hook::node_type;
+
+            static node_type *to_node(T *value) { return static_cast<Hook *>(value); }
+
+            static const node_type *to_node(const T *value) { return static_cast<const Hook *>(value); }
+
+            static T *to_value(node_type *node) { return static_cast<T *>(static_cast<Hook *>(node)); }
+
+            static const T *to_value(const node_type *node) {
+                return static_cast<const T *>(static_cast<const Hook *>(node));
+            }
+        };
+
+        /// 成员钩子：Hook 是 T 的数据成员 Member
+        template<typename T, typename Hook, Hook T::*Member>
+        struct member_hook {
+            using value_type = T;
+            using hook_type = Hook;
+            using node_type = typename Hook::node_type;
+
+            static node_type *to_node(T *value) { return &(value->*Member); }
+
+            static const node_type *to_node(const T *value) { return &(value->*Member); }
+
+            static T *to_value(node_type *node) {
+                return reinterpret_cast<T *>(reinterpret_cast<char *>(static_cast<Hook *>(node)) - offset_());
+            }
+
+            static const T *to_value(const node_type *node) {
+                return reinterpret_cast<const T *>(
+                        reinterpret_cast<const char *>(static_cast<const Hook *>(node)) - offset_());
+            }
+
+        private:
+            /// 成员在 T 中的字节偏移：GCC/Clang（Itanium ABI）和 MSVC 都用这个偏移表示指向数据成员的指针
+            static std::ptrdiff_t offset_() {
+                if constexpr (sizeof(Hook T::*) == sizeof(std::ptrdiff_t)) {
+                    return std::bit_cast<std::ptrdiff_t>(Member);
+                } else {
+                    return std::bit_cast<std::int32_t>(Member);
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,320 @@
+/**
+ * @file      my_intrusive_list.h
+ * @brief     [侵入式双向链表：节点是嵌在用户对象中的钩子，插入不分配内存，拿到对象即可 O(1) 删除或移动]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_intrusive_hook.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+/**
+ * intrusive::list
+ * 与 my::list 相同的带哨兵的循环双向链表，只是节点就是用户对象里的 list_hook，容器本身只有一个哨兵节点
+ *      push / insert / erase 都只改几个指针，不分配也不释放内存
+ *      erase(value) 直接按对象删除，O(1)
+ *      splice 把元素从一个位置（可以是另一个链表）挪到另一个位置，O(1)：LRU 的“移到最前面”就是
+ *          lru.splice(lru.begin(), lru, lru.iterator_to(entry));
+ *
+ * 用法：
+ *      struct Entry : my::intrusive::list_hook<> { ... };                             基类钩子
+ *      my::intrusive::list<Entry> lru;
+ *
+ *      struct Entry { my::intrusive::list_hook<> lruHook; ... };                      成员钩子
+ *      my::intrusive::list<Entry, my::intrusive::member_hook<Entry, my::intrusive::list_hook<>, &Entry::lruHook>> lru;
+ */
+
+namespace my {
+    namespace intrusive {
+
+        /// 双向链表钩子的链接字段，字段名与 ListNode 相同
+        struct list_node {
+            list_node *prev_ = nullptr;
+            list_node *next_ = nullptr;     /// 不在链表中时为 nullptr
+        };
+
+        /**
+         *  嵌入用户对象的钩子，可以作为基类或者成员；Tag 用于区分同一个类的多个基类钩子
+         *  拷贝对象时不拷贝链接：新对象的钩子总是不在任何链表中，赋值也不改变钩子
+         * */
+        template<typename Tag = default_tag>
+        class list_hook : public list_node {
+        public:
+            using node_type = list_node;
+
+            list_hook() = default;
+
+            list_hook(const list_hook &) : list_node() {}
+
+            list_hook &operator=(const list_hook &) { return *this; }
+
+            bool is_linked() const { return next_ != nullptr; }
+        };
+
+        template<typename T, typename HookTraits, bool Const>
+        class list_iterator {
+            using node = list_node;
+
+            template<typename, typename>
+            friend class list;
+
+            template<typename, typename, bool>
+            friend class list_iterator;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T *, T *>;
+            using reference = std::conditional_t<Const, const T &, T &>;
+
+            list_iterator() : node_(nullptr) {}
+
+            explicit list_iterator(node *n) : node_(n) {}
+
+            /// iterator 可以转换成 const_iterator
+            template<bool C = Const, typename = std::enable_if_t<C>>
+            list_iterator(const list_iterator<T, HookTraits, false> &other) : node_(other.node_) {}
+
+            reference operator*() const { return *HookTraits::to_value(node_); }
+
+            pointer operator->() const { return HookTraits::to_value(node_); }
+
+            list_iterator &operator++() {
+                node_ = node_->next_;
+                return *this;
+            }
+
+            list_iterator &operator--() {
+                node_ = node_->prev_;
+                return *this;
+            }
+
+            list_iterator operator++(int) {
+                list_iterator temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            list_iterator operator--(int) {
+                list_iterator temp = *this;
+                --*this;
+                return temp;
+            }
+
+            bool operator==(const list_iterator &other) const { return node_ == other.node_; }
+
+            bool operator!=(const list_iterator &other) const { return node_ != other.node_; }
+
+        private:
+            node *node_;
+        };
+
+        /**
+         *  HookTraits 见 my_intrusive_hook.h，默认 T 从 list_hook<> 派生
+         *  容器不拥有元素：析构 / clear() 只把链表中元素的钩子复位，不销毁元素
+         * */
+        template<typename T, typename HookTraits = base_hook<T, list_hook<>>>
+        class list {
+            using node = list_node;
+
+        public:
+            using value_type = T;
+            using hook_traits = HookTraits;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using iterator = list_iterator<T, HookTraits, false>;
+            using const_iterator = list_iterator<T, HookTraits, true>;
+
+            list() {
+                reset_head_();
+            }
+
+            list(const list &) = delete;
+
+            list &operator=(const list &) = delete;
+
+            /// 首尾元素指向哨兵，移动时要让它们重新指向新的哨兵
+            list(list &&other) noexcept {
+                reset_head_();
+                swap(other);
+            }
+
+            list &operator=(list &&other) noexcept {
+                if (this != &other) {
+                    clear();
+                    swap(other);
+                }
+                return *this;
+            }
+
+            ~list() {
+                clear();
+            }
+
+            iterator begin() { return iterator(head_.next_); }
+
+            iterator end() { return iterator(&head_); }
+
+            const_iterator begin() const { return const_iterator(head_.next_); }
+
+            const_iterator end() const { return const_iterator(const_cast<node *>(&head_)); }
+
+            const_iterator cbegin() const { return begin(); }
+
+            const_iterator cend() const { return end(); }
+
+            bool empty() const { return size_ == 0; }
+
+            size_type size() const { return size_; }
+
+            T &front() { return *HookTraits::to_value(head_.next_); }
+
+            const T &front() const { return *HookTraits::to_value(head_.next_); }
+
+            T &back() { return *HookTraits::to_value(head_.prev_); }
+
+            const T &back() const { return *HookTraits::to_value(head_.prev_); }
+
+            /// value 的钩子不能已经在某个链表中
+            void push_back(T &value) { link_before_(&head_, HookTraits::to_node(&value)); }
+
+            void push_front(T &value) { link_before_(head_.next_, HookTraits::to_node(&value)); }
+
+            /// 摘下并返回首 / 尾元素，链表不能为空
+            T &pop_front() {
+                node *n = head_.next_;
+                unlink_(n);
+                return *HookTraits::to_value(n);
+            }
+
+            T &pop_back() {
+                node *n = head_.prev_;
+                unlink_(n);
+                return *HookTraits::to_value(n);
+            }
+
+            /// 在 pos 之前插入 value，返回指向 value 的迭代器
+            iterator insert(const_iterator pos, T &value) {
+                node *n = HookTraits::to_node(&value);
+                link_before_(pos.node_, n);
+                return iterator(n);
+            }
+
+            /// 删除 pos 指向的元素，返回下一个位置；元素本身不受影响，只是钩子被复位
+            iterator erase(const_iterator pos) {
+                node *next = pos.node_->next_;
+                unlink_(pos.node_);
+                return iterator(next);
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                while (first != last) {
+                    first = erase(first);
+                }
+                return iterator(last.node_);
+            }
+
+            /// 直接按对象删除，O(1)；value 必须在这个链表中
+            void erase(T &value) {
+                unlink_(HookTraits::to_node(&value));
+            }
+
+            /// 把 other 中 it 指向的元素挪到 pos 之前，O(1)；other 可以就是 *this
+            void splice(const_iterator pos, list &other, const_iterator it) {
+                node *n = it.node_;
+                if (n == pos.node_ || n->next_ == pos.node_) {
+                    return;
+                }
+                other.unlink_(n);
+                link_before_(pos.node_, n);
+            }
+
+            /// 把 other 的全部元素挪到 pos 之前，O(1)
+            void splice(const_iterator pos, list &other) {
+                if (&other == this || other.empty()) {
+                    return;
+                }
+                node *first = other.head_.next_;
+                node *last = other.head_.prev_;
+                node *next = pos.node_;
+                node *prev = next->prev_;
+                prev->next_ = first;
+                first->prev_ = prev;
+                last->next_ = next;
+                next->prev_ = last;
+                size_ += other.size_;
+                other.reset_head_();
+            }
+
+            /// 对象在链表中的位置，O(1)
+            iterator iterator_to(T &value) { return iterator(HookTraits::to_node(&value)); }
+
+            const_iterator iterator_to(const T &value) const {
+                return const_iterator(const_cast<node *>(HookTraits::to_node(&value)));
+            }
+
+            /// 复位所有元素的钩子，O(n)
+            void clear() {
+                node *n = head_.next_;
+                while (n != &head_) {
+                    node *next = n->next_;
+                    n->prev_ = n->next_ = nullptr;
+                    n = next;
+                }
+                reset_head_();
+            }
+
+            void swap(list &other) noexcept {
+                std::swap(head_, other.head_);
+                std::swap(size_, other.size_);
+                fix_head_();
+                other.fix_head_();
+            }
+
+        private:
+            void reset_head_() {
+                head_.prev_ = head_.next_ = &head_;
+                size_ = 0;
+            }
+
+            /// 哨兵被整体拷贝之后，首尾元素还指向原来的哨兵
+            void fix_head_() {
+                if (size_ == 0) {
+                    head_.prev_ = head_.next_ = &head_;
+                } else {
+                    head_.next_->prev_ = &head_;
+                    head_.prev_->next_ = &head_;
+                }
+            }
+
+            void link_before_(node *pos, node *n) {
+                node *prev = pos->prev_;
+                n->prev_ = prev;
+                n->next_ = pos;
+                prev->next_ = n;
+                pos->prev_ = n;
+                ++size_;
+            }
+
+            void unlink_(node *n) {
+                n->prev_->next_ = n->next_;
+                n->next_->prev_ = n->prev_;
+                n->prev_ = n->next_ = nullptr;
+                --size_;
+            }
+
+        private:
+            node head_;             /// 哨兵，只有链接字段，不对应任何元素
+            size_type size_ = 0;
+        };
+    }
+}
@@ -0,0 +1,394 @@
+/**
+ * @file      my_intrusive_rbtree.h
+ * @brief     [侵入式红黑树：节点是嵌在用户对象中的钩子，插入不分配内存，旋转与修复复用 my_rbtree.h 的 RBTreeAlgo]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_intrusive_hook.h"
+#include "my_rbtree.h"
+#include "my_type_traits.h"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+/**
+ * intrusive::rbtree
+ * 与 RBTree 相同的哨兵布局（_head._pParent 是根，_pLeft / _pRight 是最小 / 最大节点），
+ * 插入时的修复、删除时的摘除与修复、旋转都直接调用 RBTreeAlgo<rbtree_node>，只有“元素在哪里”不同：
+ *      RBTree 的节点由容器分配，元素存放在节点里
+ *      intrusive::rbtree 的节点就是用户对象里的 rbtree_hook，容器本身只有一个哨兵节点，不分配任何内存
+ * 拿到对象就能直接删除（erase(value)）：不需要先按 key 查找，摊还 O(1)（修复最多 3 次旋转，变色可能沿路径向上）
+ *
+ * 用法：
+ *      struct Timer : my::intrusive::rbtree_hook<> { ... };                           基类钩子
+ *      my::intrusive::rbtree<Timer, ByDeadline> timers;
+ *
+ *      struct Conn { my::intrusive::rbtree_hook<> byId; ... };                        成员钩子
+ *      my::intrusive::rbtree<Conn, ById, my::intrusive::member_hook<Conn, my::intrusive::rbtree_hook<>, &Conn::byId>> conns;
+ */
+
+namespace my {
+    namespace intrusive {
+
+        /// 红黑树钩子的链接字段，字段名与 RBTreeNode 相同，RBTreeAlgo 直接在它上面工作
+        struct rbtree_node {
+            rbtree_node *_pLeft = nullptr;
+            rbtree_node *_pRight = nullptr;
+            rbtree_node *_pParent = nullptr;   /// 不在树中时为 nullptr
+            Color _color = RED;
+        };
+
+        /**
+         *  嵌入用户对象的钩子，可以作为基类或者成员；Tag 用于区分同一个类的多个基类钩子
+         *  拷贝对象时不拷贝链接：新对象的钩子总是不在任何树中，赋值也不改变钩子
+         * */
+        template<typename Tag = default_tag>
+        class rbtree_hook : public rbtree_node {
+        public:
+            using node_type = rbtree_node;
+
+            rbtree_hook() = default;
+
+            rbtree_hook(const rbtree_hook &) : rbtree_node() {}
+
+            rbtree_hook &operator=(const rbtree_hook &) { return *this; }
+
+            bool is_linked() const { return _pParent != nullptr; }
+        };
+
+        template<typename T, typename HookTraits, bool Const>
+        class rbtree_iterator {
+            using node = rbtree_node;
+            using algo = RBTreeAlgo<node>;
+
+            template<typename, typename, typename>
+            friend class rbtree;
+
+            template<typename, typename, bool>
+            friend class rbtree_iterator;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T *, T *>;
+            using reference = std::conditional_t<Const, const T &, T &>;
+
+            rbtree_iterator() : node_(nullptr), head_(nullptr) {}
+
+            rbtree_iterator(node *n, const node *head) : node_(n), head_(head) {}
+
+            /// iterator 可以转换成 const_iterator
+            template<bool C = Const, typename = std::enable_if_t<C>>
+            rbtree_iterator(const rbtree_iterator<T, HookTraits, false> &other)
+                    : node_(other.node_), head_(other.head_) {}
+
+            reference operator*() const { return *HookTraits::to_value(node_); }
+
+            pointer operator->() const { return HookTraits::to_value(node_); }
+
+            /// 最大节点的下一个是哨兵（end()）
+            rbtree_iterator &operator++() {
+                node_ = node_ == head_->_pRight ? const_cast<node *>(head_) : algo::Successor(node_);
+                return *this;
+            }
+
+            /// end() 的前一个是最大节点
+            rbtree_iterator &operator--() {
+                node_ = node_ == head_ ? head_->_pRight : algo::Predecessor(node_);
+                return *this;
+            }
+
+            rbtree_iterator operator++(int) {
+                rbtree_iterator temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            rbtree_iterator operator--(int) {
+                rbtree_iterator temp = *this;
+                --*this;
+                return temp;
+            }
+
+            bool operator==(const rbtree_iterator &other) const { return node_ == other.node_; }
+
+            bool operator!=(const rbtree_iterator &other) const { return node_ != other.node_; }
+
+        private:
+            node *node_;
+            const node *head_;
+        };
+
+        /**
+         *  Compare 比较两个 T（声明了 is_transparent 时也可以比较 T 和其他 key 类型）
+         *  HookTraits 见 my_intrusive_hook.h，默认 T 从 rbtree_hook<> 派生
+         *  容器不拥有元素：析构 / clear() 只把树中元素的钩子复位，不销毁元素
+         * */
+        template<typename T, typename Compare = std::less<T>, typename HookTraits = base_hook<T, rbtree_hook<>>>
+        class rbtree {
+            using node = rbtree_node;
+            using algo = RBTreeAlgo<node>;
+
+        public:
+            using value_type = T;
+            using key_compare = Compare;
+            using hook_traits = HookTraits;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using iterator = rbtree_iterator<T, HookTraits, false>;
+            using const_iterator = rbtree_iterator<T, HookTraits, true>;
+
+            explicit rbtree(const Compare &comp = Compare()) : comp_(comp) {
+                reset_head_();
+            }
+
+            rbtree(const rbtree &) = delete;
+
+            rbtree &operator=(const rbtree &) = delete;
+
+            /// 元素的钩子都指向哨兵，移动时要让根重新指向新的哨兵
+            rbtree(rbtree &&other) noexcept: comp_(other.comp_) {
+                reset_head_();
+                swap(other);
+            }
+
+            rbtree &operator=(rbtree &&other) noexcept {
+                if (this != &other) {
+                    clear();
+                    swap(other);
+                }
+                return *this;
+            }
+
+            ~rbtree() {
+                clear();
+            }
+
+            iterator begin() { return iterator(head_._pLeft, &head_); }
+
+            iterator end() { return iterator(&head_, &head_); }
+
+            const_iterator begin() const { return const_iterator(const_cast<node *>(head_._pLeft), &head_); }
+
+            const_iterator end() const { return const_iterator(const_cast<node *>(&head_), &head_); }
+
+            const_iterator cbegin() const { return begin(); }
+
+            const_iterator cend() const { return end(); }
+
+            bool empty() const { return size_ == 0; }
+
+            size_type size() const { return size_; }
+
+            /// 最小 / 最大元素，容器不能为空
+            T &front() { return *HookTraits::to_value(head_._pLeft); }
+
+            const T &front() const { return *HookTraits::to_value(head_._pLeft); }
+
+            T &back() { return *HookTraits::to_value(head_._pRight); }
+
+            const T &back() const { return *HookTraits::to_value(head_._pRight); }
+
+            /// 插入 value（它的钩子不能已经在某棵树中），等价的元素排在已有元素之后，O(log n)，不分配内存
+            iterator insert_equal(T &value) {
+                node *pNew = HookTraits::to_node(&value);
+                node *pCur = root_();
+                node *pParent = &head_;
+                bool insertLeft = true;
+                while (pCur) {
+                    pParent = pCur;
+                    insertLeft = comp_(value, *HookTraits::to_value(pCur));
+                    pCur = insertLeft ? pCur->_pLeft : pCur->_pRight;
+                }
+                return link_(pNew, pParent, insertLeft);
+            }
+
+            /// 已有等价元素时不插入，返回那个元素
+            std::pair<iterator, bool> insert_unique(T &value) {
+                node *pCur = root_();
+                node *pParent = &head_;
+                bool insertLeft = true;
+                while (pCur) {
+                    pParent = pCur;
+                    insertLeft = comp_(value, *HookTraits::to_value(pCur));
+                    pCur = insertLeft ? pCur->_pLeft : pCur->_pRight;
+                }
+                /// 与 RBTree::_FindUniquePos 相同：只需要再和落点的前驱比较一次
+                node *pPrev = pParent;
+                if (insertLeft) {
+                    if (pParent == head_._pLeft) {
+                        return {link_(HookTraits::to_node(&value), pParent, insertLeft), true};
+                    }
+                    pPrev = algo::Predecessor(pParent);
+                }
+                if (comp_(*HookTraits::to_value(pPrev), value)) {
+                    return {link_(HookTraits::to_node(&value), pParent, insertLeft), true};
+                }
+                return {iterator(pPrev, &head_), false};
+            }
+
+            /// 删除 pos 指向的元素，返回下一个位置；元素本身不受影响，只是钩子被复位
+            iterator erase(const_iterator pos) {
+                iterator next(pos.node_, &head_);
+                ++next;
+                unlink_(pos.node_);
+                return next;
+            }
+
+            /// 直接按对象删除，不需要查找；value 必须在这棵树中
+            void erase(T &value) {
+                unlink_(HookTraits::to_node(&value));
+            }
+
+            /// 摘下并返回最小元素，容器不能为空（定时器：取出最早到期的一个）
+            T &pop_front() {
+                node *pNode = head_._pLeft;
+                unlink_(pNode);
+                return *HookTraits::to_value(pNode);
+            }
+
+            /// 对象在树中的位置，O(1)
+            iterator iterator_to(T &value) { return iterator(HookTraits::to_node(&value), &head_); }
+
+            const_iterator iterator_to(const T &value) const {
+                return const_iterator(const_cast<node *>(HookTraits::to_node(&value)), &head_);
+            }
+
+            /// 复位所有元素的钩子，O(n)
+            void clear() {
+                clear_(root_());
+                reset_head_();
+            }
+
+            void swap(rbtree &other) noexcept {
+                std::swap(head_, other.head_);
+                std::swap(size_, other.size_);
+                std::swap(comp_, other.comp_);
+                fix_head_();
+                other.fix_head_();
+            }
+
+            key_compare key_comp() const { return comp_; }
+
+            /// 查找：所有比较都通过 Compare 进行，每层只比较一次；Compare 声明了 is_transparent 时支持异构 key
+            iterator find(const T &key) { return find_(key); }
+
+            const_iterator find(const T &key) const { return const_cast<rbtree *>(this)->find_(key); }
+
+            template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator find(const K &key) { return find_(key); }
+
+            template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            const_iterator find(const K &key) const { return const_cast<rbtree *>(this)->find_(key); }
+
+            iterator lower_bound(const T &key) { return iterator(lower_bound_(key), &head_); }
+
+            template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator lower_bound(const K &key) { return iterator(lower_bound_(key), &head_); }
+
+            iterator upper_bound(const T &key) { return iterator(upper_bound_(key), &head_); }
+
+            template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            iterator upper_bound(const K &key) { return iterator(upper_bound_(key), &head_); }
+
+            std::pair<iterator, iterator> equal_range(const T &key) { return {lower_bound(key), upper_bound(key)}; }
+
+            bool contains(const T &key) const { return find(key) != end(); }
+
+            template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+            bool contains(const K &key) const { return find(key) != end(); }
+
+        private:
+            node *root_() const { return head_._pParent; }
+
+            void reset_head_() {
+                head_._pParent = nullptr;
+                head_._pLeft = head_._pRight = &head_;
+                head_._color = RED;
+                size_ = 0;
+            }
+
+            /// 哨兵被整体拷贝之后，根和空树时的最小 / 最大指针还指向原来的哨兵
+            void fix_head_() {
+                if (root_()) {
+                    root_()->_pParent = &head_;
+                } else {
+                    head_._pLeft = head_._pRight = &head_;
+                }
+            }
+
+            iterator link_(node *pNew, node *pParent, bool insertLeft) {
+                algo::LinkAndRebalance(pNew, pParent, insertLeft, &head_);
+                ++size_;
+                return iterator(pNew, &head_);
+            }
+
+            void unlink_(node *pNode) {
+                algo::RebalanceForErase(pNode, &head_);
+                pNode->_pLeft = pNode->_pRight = pNode->_pParent = nullptr;
+                --size_;
+            }
+
+            static void clear_(node *pNode) {
+                while (pNode) {
+                    clear_(pNode->_pRight);
+                    node *pLeft = pNode->_pLeft;
+                    pNode->_pLeft = pNode->_pRight = pNode->_pParent = nullptr;
+                    pNode = pLeft;
+                }
+            }
+
+            template<typename K>
+            node *lower_bound_(const K &key) {
+                node *pCur = root_();
+                node *pRes = &head_;
+                while (pCur) {
+                    if (!comp_(*HookTraits::to_value(pCur), key)) {
+                        pRes = pCur;
+                        pCur = pCur->_pLeft;
+                    } else {
+                        pCur = pCur->_pRight;
+                    }
+                }
+                return pRes;
+            }
+
+            template<typename K>
+            node *upper_bound_(const K &key) {
+                node *pCur = root_();
+                node *pRes = &head_;
+                while (pCur) {
+                    if (comp_(key, *HookTraits::to_value(pCur))) {
+                        pRes = pCur;
+                        pCur = pCur->_pLeft;
+                    } else {
+                        pCur = pCur->_pRight;
+                    }
+                }
+                return pRes;
+            }
+
+            template<typename K>
+            iterator find_(const K &key) {
+                node *pNode = lower_bound_(key);
+                if (pNode == &head_ || comp_(key, *HookTraits::to_value(pNode))) {
+                    return end();
+                }
+                return iterator(pNode, &head_);
+            }
+
+        private:
+            node head_;             /// 哨兵，只有链接字段，不对应任何元素
+            size_type size_ = 0;
+            Compare comp_;
+        };
+    }
+}
@@ -11,6 +11,17 @@
 #include "my_initializer_list.h"
 #include "my_iterator.h"
 #include "my_utility.h"
+#include "my_vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace my {
     /// 定义链表节点
@@ -113,6 +124,116 @@ namespace my {
         return lhs.operator!=(rhs);
     }
 
+    /// list::sort 的排序方式
+    enum class list_sort_mode {
+        merge,      /// 经典的 carry/counter[64] 归并排序，只改指针，不需要额外空间
+        gather,     /// 把节点指针收集到 my::vector 里排好序，再一趟重新串起来
+        parallel    /// 同 gather，分块排序、归并和重新串链交给多个线程
+    };
+
+    namespace detail {
+        /// 提前把 p 所在的缓存行取进缓存；只是提示，p 指向哪里都不会出错
+        inline void list_prefetch(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+            (void) p;
+#endif
+        }
+
+        /// gather 排序时把较小的、可平凡拷贝的元素连同节点指针一起收集，排序时只访问连续内存
+        template<typename T, typename Node>
+        struct list_sort_item {
+            T key;
+            Node *node;
+
+            /// std::stable_sort 通过 ADL 调用 swap，不提供的话 my::swap 和 std::swap 会有二义性
+            friend void swap(list_sort_item &a, list_sort_item &b) noexcept {
+                list_sort_item tmp = a;
+                a = b;
+                b = tmp;
+            }
+        };
+
+        /// 元素不适合拷贝时只收集节点指针，包一层同样是为了 swap
+        template<typename Node>
+        struct list_sort_ref {
+            Node *node;
+
+            friend void swap(list_sort_ref &a, list_sort_ref &b) noexcept {
+                Node *tmp = a.node;
+                a.node = b.node;
+                b.node = tmp;
+            }
+        };
+
+        /**
+         * 整数键的 LSD 基数排序，每趟按 8 位分桶，稳定
+         *      1、一趟遍历同时统计所有字节的直方图
+         *      2、所有元素在某个字节上都相同（比如值域很小时的高位）就跳过这一趟
+         *      3、有符号整数把符号位取反，负数排在前面
+         *  buffer 至少能放下 last - first 个元素，结果总是写回 [first, last)
+         * */
+        template<typename Item>
+        void radix_sort_items(Item *first, Item *last, Item *buffer) {
+            using key_type = decltype(Item::key);
+            using unsigned_key = std::make_unsigned_t<key_type>;
+            constexpr size_t kBytes = sizeof(key_type);
+            constexpr unsigned_key kFlip = std::is_signed_v<key_type>
+                                           ? static_cast<unsigned_key>(unsigned_key(1) << (kBytes * 8 - 1)) : 0;
+            const size_t n = static_cast<size_t>(last - first);
+            if (n < 2) {
+                return;
+            }
+            auto digit = [](const Item &item, size_t byte) {
+                return static_cast<size_t>((static_cast<unsigned_key>(item.key) ^ kFlip) >> (byte * 8) & 0xff);
+            };
+
+            size_t counts[kBytes][256] = {};
+            for (Item *p = first; p != last; ++p) {
+                for (size_t b = 0; b < kBytes; ++b) {
+                    ++counts[b][digit(*p, b)];
+                }
+            }
+
+            Item *src = first;
+            Item *dst = buffer;
+            for (size_t b = 0; b < kBytes; ++b) {
+                if (counts[b][digit(*first, b)] == n) {
+                    continue;
+                }
+                size_t offset = 0;
+                for (size_t &c: counts[b]) {
+                    size_t count = c;
+                    c = offset;
+                    offset += count;
+                }
+                for (Item *p = src; p != src + n; ++p) {
+                    dst[counts[b][digit(*p, b)]++] = *p;
+                }
+                std::swap(src, dst);
+            }
+            if (src != first) {
+                std::copy(src, src + n, first);
+            }
+        }
+
+        /// 在 count 个线程上执行 f(0) ... f(count - 1)，f(0) 在当前线程执行
+        template<typename Function>
+        void list_run_parallel(size_t count, Function &f) {
+            std::unique_ptr<std::thread[]> workers(new std::thread[count]);
+            for (size_t i = 1; i < count; ++i) {
+                workers[i] = std::thread([&f, i] { f(i); });
+            }
+            f(0);
+            for (size_t i = 1; i < count; ++i) {
+                workers[i].join();
+            }
+        }
+    }
+
     /// 以下是list标准实现
     template<typename T, typename Alloc = MyAlloc<T>>
     class list {
@@ -247,7 +368,7 @@ namespace my {
             link_type prev_node = pos.node_->prev_;
             link_type next_node = pos.node_->next_;
 
-#if 1
+#if 0
             /// debug
             std::cout << "\nerase called with pos.node_: " << pos.node_ << std::endl;
             if (pos.node_ != nullptr) {
@@ -394,27 +515,36 @@ namespace my {
          *  1、假设*this和other都是升序排列
          *  2、每次比较*first2 < *first1，把 first2 插到 first1 前面。
          *  3、如果当前链表到末尾，直接将 other 剩下的元素全部接到后面。
+         *  4、两个当前节点已经在缓存里，比较之前先预取它们的后继，比较和搬移的同时后继节点在路上
          *  ***/
         void merge(list &other) {
-            iterator first1 = begin();
-            iterator last1 = end();
-            iterator first2 = other.begin();
-            iterator last2 = other.end();
+            merge(other, std::less<>());
+        }
 
-            while (first1 != last1 && first2 != last2) {
-                if (*first2 < *first1) {
-                    iterator next = first2;
-                    ++next;
-                    transfer(first1, first2, next);
-                    first2 = next;
+        /// 按 comp 合并，comp(a, b) 为 true 表示 a 应排在 b 前面
+        template<typename Compare>
+        void merge(list &other, Compare comp) {
+            if (this == &other) {
+                return;
+            }
+            link_type first1 = node_->next_;
+            link_type first2 = other.node_->next_;
+
+            while (first1 != node_ && first2 != other.node_) {
+                detail::list_prefetch(first1->next_);
+                detail::list_prefetch(first2->next_);
+                if (comp(first2->data_, first1->data_)) {
+                    link_type next2 = first2->next_;
+                    transfer(iterator(first1), iterator(first2), iterator(next2));
+                    first2 = next2;
                 } else {
-                    ++first1;
+                    first1 = first1->next_;
                 }
             }
 
             /// 如果一个链表还有空余，直接插入到前一个链表后面
-            if (first2 != last2) {
-                transfer(last1, first2, last2);
+            if (first2 != other.node_) {
+                transfer(end(), iterator(first2), other.end());
             }
         }
 
@@ -424,22 +554,24 @@ namespace my {
          *  关键点：
          *      1、只去除相邻相等的元素
          *      2、遍历过程中跳过不同的值，遇到连续相同的就删掉
+         *      3、比较当前节点之前先预取再下一个节点，直接摘链释放，不走 erase()
          * */
         void unique() {
-            iterator first = begin();
-            iterator last = end();
-            if (first == last) {
+            link_type first = node_->next_;
+            if (first == node_) {
                 return;
             }
-            iterator next = first;
-            while (++next != last) {
+            link_type next = first->next_;
+            while (next != node_) {
+                link_type after = next->next_;
+                detail::list_prefetch(after);
                 /// 如果当前相邻的节点元素相等的话就删
-                if (*first == *next) {
-                    erase(next);
+                if (first->data_ == next->data_) {
+                    unlink_and_destroy_(next);
                 } else {
                     first = next;
                 }
-                next = first;
+                next = after;
             }
         }
 
@@ -450,16 +582,7 @@ namespace my {
         *      1、遍历时需要提前保存next，防止erase之后失效
         * */
         void remove(const value_type &value) {
-            iterator first = begin();
-            iterator last = end();
-            while (first != last) {
-                iterator next = first;
-                ++next;
-                if (*first == value) {
-                    erase(first);
-                }
-                first = next;
-            }
+            remove_if([&value](const value_type &x) { return x == value; });
         }
 
         /**
@@ -467,18 +590,18 @@ namespace my {
        *      删除所有满足条件的元素的节点。
        *  关键点：
        *      1、传入一个函数、lambda 表达式或函数对象，返回 true 则删除。
+       *      2、判断当前节点之前先预取下一个节点，谓词和释放节点的开销可以盖住下一次取节点的缓存未命中
        * */
         template<typename UnaryPredicate>
         void remove_if(UnaryPredicate p) {
-            iterator first = begin();
-            iterator last = end();
-            while (first != last) {
-                iterator next = first;
-                ++next;
-                if (p(*first)) {
-                    erase(first);
+            link_type cur = node_->next_;
+            while (cur != node_) {
+                link_type next = cur->next_;
+                detail::list_prefetch(next);
+                if (p(cur->data_)) {
+                    unlink_and_destroy_(cur);
                 }
-                first = next;
+                cur = next;
             }
         }
 
@@ -544,6 +667,11 @@ namespace my {
          *      一旦 counter[i] 有值，就 merge 合并形成更大的链表（2, 4, 8...）
          * */
         void sort() {
+            sort(std::less<>());
+        }
+
+        template<typename Compare>
+        void sort(Compare comp) {
             if (node_->next_ == node_ || node_->next_->next_ == node_) {
                 // 链表为空或者只有一个元素
                 return;
@@ -561,7 +689,7 @@ namespace my {
                 carry.splice(carry.begin(), *this, begin());           /// 取出一个元素到carry
                 int i = 0;
                 while (i < fill && !counter[i].empty()) {
-                    counter[i].merge(carry);       /// 合并已有 counter[i] 和 carry
+                    counter[i].merge(carry, comp); /// 合并已有 counter[i] 和 carry
                     carry.swap(counter[i++]);      /// carry 接替位置，准备继续合并更高位
                 }
                 carry.swap(counter[i]);            /// 最终 carry 放入空的 counter[i]
@@ -573,12 +701,47 @@ namespace my {
             ///  最终合并所有 counter 中的链表
             for (int i = 1; i < fill; ++i) {
                 /// 从 counter[0] 开始，依次 merge 到 counter[fill - 1]
-                counter[i].merge(counter[i - 1]);
+                counter[i].merge(counter[i - 1], comp);
             }
             /// 通过 swap 将其放入当前链表中。
             swap(counter[fill - 1]);        /// 最终结果放入当前 list 中
         }
 
+        /**
+         * sort(list_sort_mode mode)
+         *      merge 节点散落在堆里时，归并的每一步都是一次缓存未命中；gather 先把节点收集到连续的 my::vector 里：
+         *  1、元素小且可平凡拷贝（int、double、指针等）时连同值一起收集，排序只访问连续内存，
+         *     默认比较的整数用基数排序，其余用 std::stable_sort；否则只收集节点指针，按 comp(a->data_, b->data_) 稳定排序
+         *  2、按排好的顺序一趟重新串起 prev_/next_，串链时预取后面的节点
+         *  3、排序过程中不动链表，comp 抛异常时链表保持原样
+         *  parallel 在 gather 的基础上分块排序、两两归并、分段串链，线程数取 hardware_concurrency()；
+         *  链表较短时退化为 gather。并行时 comp 会被多个线程同时调用，且不能抛异常
+         * */
+        void sort(list_sort_mode mode) {
+            sort(mode, std::less<>());
+        }
+
+        template<typename Compare>
+        void sort(list_sort_mode mode, Compare comp) {
+            switch (mode) {
+                case list_sort_mode::merge:
+                    sort(comp);
+                    break;
+                case list_sort_mode::gather:
+                    gather_sort_(comp, 1);
+                    break;
+                case list_sort_mode::parallel:
+                    gather_sort_(comp, std::max(1u, std::thread::hardware_concurrency()));
+                    break;
+            }
+        }
+
+        /// 指定线程数的并行排序
+        template<typename Compare = std::less<>>
+        void parallel_sort(unsigned threads, Compare comp = Compare()) {
+            gather_sort_(comp, std::max(1u, threads));
+        }
+
 
         ////-------------size()
         size_type size() {
@@ -607,6 +770,105 @@ namespace my {
         }
 
     private:
+        /// 并行排序时每块至少这么多元素，块太小时线程的开销比排序本身还大
+        static constexpr size_type kParallelMinChunk_ = size_type(1) << 15;
+
+        /// 摘下节点 p 并释放
+        void unlink_and_destroy_(link_type p) {
+            p->prev_->next_ = p->next_;
+            p->next_->prev_ = p->prev_;
+            destroy_node_(p);
+        }
+
+        template<typename Compare>
+        void gather_sort_(Compare comp, unsigned threads) {
+            if (node_->next_ == node_ || node_->next_->next_ == node_) {
+                return;
+            }
+            if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 16) {
+                using item = detail::list_sort_item<T, list_node>;
+                constexpr bool radix = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                       (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+                my::vector<item> items;
+                for (link_type p = node_->next_; p != node_; p = p->next_) {
+                    items.emplace_back(item{p->data_, p});
+                }
+                sort_items_<radix>(items, [&comp](const item &a, const item &b) { return comp(a.key, b.key); },
+                                   threads);
+            } else {
+                using item = detail::list_sort_ref<list_node>;
+                my::vector<item> items;
+                for (link_type p = node_->next_; p != node_; p = p->next_) {
+                    items.emplace_back(item{p});
+                }
+                sort_items_<false>(items, [&comp](const item &a, const item &b) {
+                    return comp(a.node->data_, b.node->data_);
+                }, threads);
+            }
+        }
+
+        /**
+         *  对收集好的 items 稳定排序并按顺序重新串链
+         *      1、切成 parts 块（2 的幂，不超过 threads，每块不少于 kParallelMinChunk_），每块各自排序
+         *      2、相邻的块两两 std::merge，在 items 和 buffer 之间来回倒，每一轮的归并互不相干可以并行
+         *      3、每个节点的 prev_/next_ 只由它在数组中的邻居决定，分段串链也互不相干
+         * */
+        template<bool Radix, typename Item, typename Less>
+        void sort_items_(my::vector<Item> &items, Less less, unsigned threads) {
+            const size_type n = items.size();
+            size_type parts = 1;
+            while (parts * 2 <= threads && n / (parts * 2) >= kParallelMinChunk_) {
+                parts *= 2;
+            }
+            my::vector<Item> buffer;
+            if (Radix || parts > 1) {
+                buffer.resize(n);
+            }
+            Item *src = items.data();
+            Item *dst = buffer.data();
+            auto bound = [n, parts](size_type i) { return n / parts * i + std::min(i, n % parts); };
+
+            auto sort_chunk = [&](size_type i) {
+                if constexpr (Radix) {
+                    detail::radix_sort_items(src + bound(i), src + bound(i + 1), dst + bound(i));
+                } else {
+                    std::stable_sort(src + bound(i), src + bound(i + 1), less);
+                }
+            };
+            detail::list_run_parallel(parts, sort_chunk);
+
+            for (size_type width = 1; width < parts; width *= 2) {
+                auto merge_pair = [&](size_type j) {
+                    size_type lo = bound(2 * width * j);
+                    size_type mid = bound(2 * width * j + width);
+                    size_type hi = bound(2 * width * (j + 1));
+                    std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+                };
+                detail::list_run_parallel(parts / (2 * width), merge_pair);
+                std::swap(src, dst);
+            }
+
+            auto relink = [&](size_type i) {
+                relink_range_(src, n, bound(i), bound(i + 1));
+            };
+            detail::list_run_parallel(parts, relink);
+            node_->next_ = src[0].node;
+            node_->prev_ = src[n - 1].node;
+        }
+
+        /// 按 items[first, last) 的顺序重新设置这些节点的 prev_/next_，首尾接到哨兵
+        template<typename Item>
+        void relink_range_(const Item *items, size_type n, size_type first, size_type last) {
+            constexpr size_type kPrefetchDistance = 8;
+            for (size_type i = first; i < last; ++i) {
+                if (i + kPrefetchDistance < last) {
+                    detail::list_prefetch(items[i + kPrefetchDistance].node);
+                }
+                link_type p = items[i].node;
+                p->prev_ = i == 0 ? node_ : items[i - 1].node;
+                p->next_ = i + 1 == n ? node_ : items[i + 1].node;
+            }
+        }
 
         /// 在迭代器范围内初始化
         template<typename InputIterator>
@@ -0,0 +1,492 @@
+/**
+ * @file      my_lockfree_stack.h
+ * @brief     [Treiber 无锁栈：带版本号的指针防止 ABA，节点池保证节点内存不被释放，高竞争时的消除回退，预先链接好的一串元素一次入栈]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_futex.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * lockfree_stack<T>
+ * Treiber 栈：栈顶是一个原子字，push / pop 都是“读栈顶 -> 准备新栈顶 -> CAS”
+ * ABA：线程 1 读到栈顶 A、A->next == B 后被挂起；其他线程弹出 A、弹出 B、再压回 A，栈顶又是 A，
+ *      线程 1 的 CAS 会成功并把已经不在栈里的 B 设成栈顶。解决办法是栈顶字里除了指针还带一个版本号，
+ *      每次修改栈顶版本号加一，上面的 CAS 因版本号不同而失败
+ *      64 位平台上用户态地址只占低 48 位，高 16 位放版本号；32 位平台上指针和 32 位版本号拼成一个 64 位字
+ *      这样整个栈顶仍然是一个 64 位原子变量，不依赖 16 字节 CAS（很多平台需要额外链接 libatomic，且不一定无锁）
+ *      48 位不是语言保证（例如开启 5 级页表时用户态地址可以超过 48 位），所以每分配一块节点都检查地址，
+ *      放不下时抛出 std::bad_alloc，而不是只在调试版本里 assert
+ *      剩余的窗口：版本号只有 16 位，一个线程读到栈顶之后被挂起，期间其他线程恰好修改了 65536 的整数倍次栈顶
+ *      并且栈顶又回到同一个节点，它的 CAS 仍会误判成功。实际中这需要在两条指令之间被挂起足够久，这里接受这个概率
+ * 内存回收：pop 在 CAS 之前要读 top->next，此时节点可能已经被别的线程弹出。如果节点已经被 delete 就是释放后使用，
+ *      所以节点从不还给操作系统：弹出的节点进入栈自己的节点池（同样是带版本号的 Treiber 栈），
+ *      节点按块分配，lockfree_stack 析构时整块释放。读到的 next 可能已经过时，但那时版本号一定变了，CAS 会失败
+ *      这正是对象空闲链表需要的性质：稳定运行之后 push / pop 不再调用分配器
+ * 消除回退（elimination backoff，Hendler、Shavit、Yerushalmi 2004）：CAS 失败说明栈顶竞争激烈，
+ *      push 把节点挂到一个消除槽上等一小会儿，同一时间 CAS 失败的 pop 从槽上直接取走，两者互相抵消，都不碰栈顶
+ *      没有配对成功就收回节点，继续在栈顶上重试；无竞争时不会走到这条路径
+ * 批量：chain 是线程私有的、预先链接好的一串元素，push_chain 用一次 CAS 整串入栈；pop_all 用一次交换整栈取走
+ */
+
+namespace my {
+
+    template<typename T>
+    class lockfree_stack {
+        struct node;
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+
+        /**
+         * 线程私有的一串元素，节点来自所属的 lockfree_stack 的节点池
+         * 自己是一个普通的（非线程安全的）栈：push 的元素放在链头，push_chain 之后链头就是新的栈顶
+         * 备用节点用完时一次 CAS 从节点池取走至多 kSpareBatch_ 个节点，之后的 kSpareBatch_ 次构造没有任何原子操作，
+         *      节点池里其余的节点仍然留给其他线程；
+         *      try_pop 腾出的节点也先留在备用节点里，clear / 析构 / push_chain 时一次性还给节点池
+         * 不能比所属的 lockfree_stack 活得更久
+         */
+        class chain {
+        public:
+            explicit chain(lockfree_stack &owner) : owner_(&owner) {}
+
+            chain(chain &&other) noexcept
+                    : owner_(other.owner_), first_(other.first_), last_(other.last_), spare_(other.spare_),
+                      size_(other.size_) {
+                other.first_ = other.last_ = other.spare_ = nullptr;
+                other.size_ = 0;
+            }
+
+            chain &operator=(chain &&other) noexcept {
+                if (this != &other) {
+                    clear();
+                    owner_ = other.owner_;
+                    first_ = other.first_;
+                    last_ = other.last_;
+                    spare_ = other.spare_;
+                    size_ = other.size_;
+                    other.first_ = other.last_ = other.spare_ = nullptr;
+                    other.size_ = 0;
+                }
+                return *this;
+            }
+
+            chain(const chain &) = delete;
+
+            chain &operator=(const chain &) = delete;
+
+            ~chain() { clear(); }
+
+            template<typename... Args>
+            void emplace(Args &&... args) {
+                node *n = take_spare_();
+                try {
+                    std::construct_at(reinterpret_cast<T *>(n->storage_), std::forward<Args>(args)...);
+                } catch (...) {
+                    put_spare_(n);
+                    throw;
+                }
+                n->next_.store(first_, std::memory_order_relaxed);
+                first_ = n;
+                if (last_ == nullptr) {
+                    last_ = n;
+                }
+                ++size_;
+            }
+
+            void push(const T &value) { emplace(value); }
+
+            void push(T &&value) { emplace(std::move(value)); }
+
+            /// 从链头取出一个元素，链为空时返回 false
+            bool try_pop(T &out) {
+                if (first_ == nullptr) {
+                    return false;
+                }
+                node *n = first_;
+                first_ = n->next_.load(std::memory_order_relaxed);
+                if (first_ == nullptr) {
+                    last_ = nullptr;
+                }
+                --size_;
+                out = std::move(*n->value());
+                std::destroy_at(n->value());
+                put_spare_(n);
+                return true;
+            }
+
+            size_type size() const noexcept { return size_; }
+
+            bool empty() const noexcept { return size_ == 0; }
+
+            /// 析构所有元素，元素节点和备用节点整串还给节点池
+            void clear() {
+                for (node *n = first_; n != nullptr; n = n->next_.load(std::memory_order_relaxed)) {
+                    std::destroy_at(n->value());
+                }
+                if (first_ != nullptr) {
+                    last_->next_.store(spare_, std::memory_order_relaxed);
+                    spare_ = first_;
+                    first_ = last_ = nullptr;
+                    size_ = 0;
+                }
+                release_spares_();
+            }
+
+        private:
+            friend class lockfree_stack;
+
+            chain(lockfree_stack &owner, node *first, node *last, size_type size)
+                    : owner_(&owner), first_(first), last_(last), size_(size) {}
+
+            node *take_spare_() {
+                if (spare_ == nullptr) {
+                    spare_ = owner_->take_pool_(kSpareBatch_);
+                    if (spare_ == nullptr) {
+                        return owner_->allocate_node_();
+                    }
+                }
+                node *n = spare_;
+                spare_ = n->next_.load(std::memory_order_relaxed);
+                return n;
+            }
+
+            void put_spare_(node *n) {
+                n->next_.store(spare_, std::memory_order_relaxed);
+                spare_ = n;
+            }
+
+            /// 备用节点此时只属于本 chain，可以放心地走到链尾
+            void release_spares_() {
+                if (spare_ == nullptr) {
+                    return;
+                }
+                node *last = spare_;
+                while (node *next = last->next_.load(std::memory_order_relaxed)) {
+                    last = next;
+                }
+                push_list_(owner_->pool_, spare_, last);
+                spare_ = nullptr;
+            }
+
+            lockfree_stack *owner_;
+            node *first_ = nullptr;
+            node *last_ = nullptr;
+            node *spare_ = nullptr;      /// 私有的备用节点，未构造元素
+            size_type size_ = 0;
+        };
+
+        lockfree_stack() = default;
+
+        lockfree_stack(const lockfree_stack &) = delete;
+
+        lockfree_stack &operator=(const lockfree_stack &) = delete;
+
+        /// 析构时不能再有其他线程访问，也不能还有未销毁的 chain
+        ~lockfree_stack() {
+            for (node *n = ptr_(top_.load(std::memory_order_relaxed)); n != nullptr;
+                 n = n->next_.load(std::memory_order_relaxed)) {
+                std::destroy_at(n->value());
+            }
+            block *b = blocks_.load(std::memory_order_relaxed);
+            while (b != nullptr) {
+                block *next = b->next_;
+                delete b;
+                b = next;
+            }
+        }
+
+        template<typename... Args>
+        void emplace(Args &&... args) {
+            node *n = construct_node_(std::forward<Args>(args)...);
+            uint64_t old = top_.load(std::memory_order_relaxed);
+            for (;;) {
+                n->next_.store(ptr_(old), std::memory_order_relaxed);
+                if (top_.compare_exchange_weak(old, pack_(n, tag_(old) + 1), std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                    return;
+                }
+                if (eliminate_push_(n)) {
+                    return;
+                }
+                old = top_.load(std::memory_order_relaxed);
+            }
+        }
+
+        void push(const T &value) { emplace(value); }
+
+        void push(T &&value) { emplace(std::move(value)); }
+
+        /// 栈为空时返回 false
+        bool try_pop(T &out) {
+            uint64_t old = top_.load(std::memory_order_acquire);
+            node *n;
+            for (;;) {
+                n = ptr_(old);
+                if (n == nullptr) {
+                    return false;
+                }
+                node *next = n->next_.load(std::memory_order_relaxed);
+                if (top_.compare_exchange_weak(old, pack_(next, tag_(old) + 1), std::memory_order_acquire,
+                                               std::memory_order_acquire)) {
+                    break;
+                }
+                if ((n = eliminate_pop_()) != nullptr) {
+                    break;
+                }
+                old = top_.load(std::memory_order_acquire);
+            }
+            out = std::move(*n->value());
+            destroy_node_(n);
+            return true;
+        }
+
+        /// 一次 CAS 把整串元素压入栈，chain 的链头成为新的栈顶，之后 chain 为空
+        void push_chain(chain &&c) {
+            assert(c.owner_ == this);
+            if (c.first_ == nullptr) {
+                return;
+            }
+            push_list_(top_, c.first_, c.last_);
+            c.first_ = c.last_ = nullptr;
+            c.size_ = 0;
+            c.release_spares_();
+        }
+
+        /// 一次交换取走整个栈，返回的 chain 保持原来的顺序（链头是原来的栈顶）
+        chain pop_all() {
+            uint64_t old = top_.load(std::memory_order_relaxed);
+            while (!top_.compare_exchange_weak(old, pack_(nullptr, tag_(old) + 1), std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+            }
+            node *first = ptr_(old);
+            node *last = nullptr;
+            size_type size = 0;
+            for (node *n = first; n != nullptr; n = n->next_.load(std::memory_order_relaxed)) {
+                last = n;
+                ++size;
+            }
+            return chain(*this, first, last, size);
+        }
+
+        /// 创建一个属于本栈的空 chain
+        chain make_chain() { return chain(*this); }
+
+        bool empty_approx() const noexcept { return ptr_(top_.load(std::memory_order_relaxed)) == nullptr; }
+
+    private:
+        struct node {
+            std::atomic<node *> next_{nullptr};       /// 可能被 pop 在 CAS 之前并发读取，所以是原子变量
+            alignas(T) unsigned char storage_[sizeof(T)];
+
+            T *value() { return std::launder(reinterpret_cast<T *>(storage_)); }
+        };
+
+        /// 节点按块分配，块只在析构时释放
+        static constexpr size_type kBlockNodes_ = 64;
+
+        struct block {
+            block *next_ = nullptr;
+            node nodes_[kBlockNodes_];
+        };
+
+        /// chain 每次从节点池取走的节点数上限
+        static constexpr size_type kSpareBatch_ = 16;
+
+        // ---------------- 带版本号的指针 ----------------
+
+        static constexpr unsigned kPtrBits_ = sizeof(void *) == 8 ? 48 : 32;
+        static constexpr uint64_t kPtrMask_ = (uint64_t(1) << kPtrBits_) - 1;
+
+        /// 地址在 [first, last) 内的节点都能装进 kPtrBits_ 位
+        static bool fits_ptr_bits_(const void *first, const void *last) noexcept {
+            if constexpr (sizeof(uintptr_t) * 8 <= kPtrBits_) {
+                return true;
+            } else {
+                auto end = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(last));
+                return reinterpret_cast<uintptr_t>(first) <= end && end <= kPtrMask_ + 1;
+            }
+        }
+
+        /// 节点地址在分配时已经检查过，这里只留调试断言
+        static uint64_t pack_(node *p, uint64_t tag) noexcept {
+            auto bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+            assert((bits & ~kPtrMask_) == 0);
+            return bits | (tag << kPtrBits_);
+        }
+
+        static node *ptr_(uint64_t word) noexcept {
+            return reinterpret_cast<node *>(static_cast<uintptr_t>(word & kPtrMask_));
+        }
+
+        /// 版本号只占高位，加一之后在 pack_ 里自然截断回绕
+        static uint64_t tag_(uint64_t word) noexcept { return word >> kPtrBits_; }
+
+        /// 把 first..last 这一串挂到 head 上
+        static void push_list_(std::atomic<uint64_t> &head, node *first, node *last) {
+            uint64_t old = head.load(std::memory_order_relaxed);
+            do {
+                last->next_.store(ptr_(old), std::memory_order_relaxed);
+            } while (!head.compare_exchange_weak(old, pack_(first, tag_(old) + 1), std::memory_order_release,
+                                                 std::memory_order_relaxed));
+        }
+
+        static node *pop_list_(std::atomic<uint64_t> &head) {
+            uint64_t old = head.load(std::memory_order_acquire);
+            for (;;) {
+                node *n = ptr_(old);
+                if (n == nullptr) {
+                    return nullptr;
+                }
+                node *next = n->next_.load(std::memory_order_relaxed);
+                if (head.compare_exchange_weak(old, pack_(next, tag_(old) + 1), std::memory_order_acquire,
+                                               std::memory_order_acquire)) {
+                    return n;
+                }
+            }
+        }
+
+        // ---------------- 节点池 ----------------
+
+        node *allocate_node_() {
+            if (node *n = pop_list_(pool_)) {
+                return n;
+            }
+            /// 池空了：分配一整块，第一个节点自己用，其余节点整串放进池里
+            auto *b = new block;
+            if (!fits_ptr_bits_(b->nodes_, b->nodes_ + kBlockNodes_)) {
+                delete b;
+                throw std::bad_alloc();
+            }
+            b->next_ = blocks_.load(std::memory_order_relaxed);
+            while (!blocks_.compare_exchange_weak(b->next_, b, std::memory_order_relaxed)) {
+            }
+            for (size_type i = 1; i + 1 < kBlockNodes_; ++i) {
+                b->nodes_[i].next_.store(&b->nodes_[i + 1], std::memory_order_relaxed);
+            }
+            push_list_(pool_, &b->nodes_[1], &b->nodes_[kBlockNodes_ - 1]);
+            return &b->nodes_[0];
+        }
+
+        /**
+         * 一次 CAS 从节点池取走至多 max 个节点，返回链头（链尾的 next 为空），池空时返回 nullptr
+         * 先沿着 next 走到第 max 个节点，再把池顶 CAS 成它后面的节点。走的过程中读到的 next 可能已经过时
+         * （节点从不释放，读本身是安全的），但只要池顶被改过版本号就变了，CAS 失败重来；
+         * CAS 成功说明这期间没有节点离开过池子，池中节点的 next 也就没有被改过，走过的这一段就是池顶的前 max 个节点
+         */
+        node *take_pool_(size_type max) {
+            uint64_t old = pool_.load(std::memory_order_acquire);
+            for (;;) {
+                node *first = ptr_(old);
+                if (first == nullptr) {
+                    return nullptr;
+                }
+                node *last = first;
+                for (size_type i = 1; i < max; ++i) {
+                    node *next = last->next_.load(std::memory_order_relaxed);
+                    if (next == nullptr) {
+                        break;
+                    }
+                    last = next;
+                }
+                node *rest = last->next_.load(std::memory_order_relaxed);
+                if (pool_.compare_exchange_weak(old, pack_(rest, tag_(old) + 1), std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+                    last->next_.store(nullptr, std::memory_order_relaxed);
+                    return first;
+                }
+            }
+        }
+
+        template<typename... Args>
+        node *construct_node_(Args &&... args) {
+            node *n = allocate_node_();
+            try {
+                std::construct_at(reinterpret_cast<T *>(n->storage_), std::forward<Args>(args)...);
+            } catch (...) {
+                push_list_(pool_, n, n);
+                throw;
+            }
+            return n;
+        }
+
+        void destroy_node_(node *n) {
+            std::destroy_at(n->value());
+            push_list_(pool_, n, n);
+        }
+
+        // ---------------- 消除回退 ----------------
+
+        static constexpr size_type kEliminationSlots_ = 4;
+        static constexpr unsigned kEliminationSpins_ = 256;
+
+        /// 槽位里也是带版本号的指针：空槽是 (nullptr, tag)，有节点在等时是 (node, tag)
+        struct alignas(detail::cache_line_size) exchange_slot {
+            std::atomic<uint64_t> word_{0};
+        };
+
+        /// 每个线程随机挑一个槽位（xorshift），减少多个线程挤在同一个槽位上
+        static exchange_slot &pick_slot_(exchange_slot (&slots)[kEliminationSlots_]) {
+            thread_local uint32_t state = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&state)) | 1u;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return slots[state % kEliminationSlots_];
+        }
+
+        /// push 在栈顶 CAS 失败之后：把节点挂到槽位上等一会儿，被 pop 取走返回 true，没人来就收回节点返回 false
+        bool eliminate_push_(node *n) {
+            exchange_slot &slot = pick_slot_(elimination_);
+            uint64_t empty = slot.word_.load(std::memory_order_relaxed);
+            if (ptr_(empty) != nullptr) {
+                return false;
+            }
+            uint64_t offered = pack_(n, tag_(empty) + 1);
+            if (!slot.word_.compare_exchange_strong(empty, offered, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                return false;
+            }
+            for (unsigned spin = 0; spin < kEliminationSpins_; ++spin) {
+                if (slot.word_.load(std::memory_order_relaxed) != offered) {
+                    return true;
+                }
+                detail::cpu_relax();
+            }
+            /// 收回失败说明恰好在这期间被 pop 取走了
+            return !slot.word_.compare_exchange_strong(offered, pack_(nullptr, tag_(offered) + 1),
+                                                       std::memory_order_relaxed, std::memory_order_relaxed);
+        }
+
+        /// pop 在栈顶 CAS 失败之后：看看槽位上有没有正在等待的 push，有就直接取走它的节点
+        node *eliminate_pop_() {
+            exchange_slot &slot = pick_slot_(elimination_);
+            uint64_t offered = slot.word_.load(std::memory_order_relaxed);
+            node *n = ptr_(offered);
+            if (n == nullptr) {
+                return nullptr;
+            }
+            if (slot.word_.compare_exchange_strong(offered, pack_(nullptr, tag_(offered) + 1),
+                                                   std::memory_order_acquire, std::memory_order_relaxed)) {
+                return n;
+            }
+            return nullptr;
+        }
+
+        /// 栈顶、节点池、块链表各自放在独立的缓存行上
+        alignas(detail::cache_line_size) std::atomic<uint64_t> top_{0};
+        alignas(detail::cache_line_size) std::atomic<uint64_t> pool_{0};
+        alignas(detail::cache_line_size) std::atomic<block *> blocks_{nullptr};
+        exchange_slot elimination_[kEliminationSlots_];
+    };
+}
@@ -8,21 +8,41 @@
 #pragma once
 
 #include "my_rbtree_map.h"
+#include "my_sorted_tag.h"
+#include "my_type_traits.h"
+#include <tuple>
 #include <utility>
 #include <initializer_list>
 
 namespace my {
 
 // ============================ my::map ============================
-    template<typename K, typename V>
+    /// Compare 比较 key（默认 std::less<K>），Alloc 分配元素 pair<const K, V>，节点内存也经由它分配
+    /// Augment 为红黑树节点的附加信息策略：默认不维护；::RBTreeSizeAugment 维护子树大小，提供 select / rank
+    template<typename K,
+            typename V,
+            typename Compare = std::less<K>,
+            typename Alloc = MyAlloc<std::pair<const K, V>>,
+            typename Augment = ::RBTreeNoAugment>
     class map {
+        using tree_type = RBTree<K, V, Compare, Alloc, Augment>;
     public:
+        using key_type = K;
+        using mapped_type = V;
         using value_type = std::pair<K, V>;
         using node_value_type = std::pair<K, V>;
-        using iterator = typename RBTree<K, V>::iterator;
+        using key_compare = Compare;
+        using allocator_type = Alloc;
+        using iterator = typename tree_type::iterator;
+        using node_type = typename tree_type::node_type;
+        using insert_return_type = node_insert_return<iterator, node_type>;
 
         map() = default;
 
+        explicit map(const Compare &comp, const Alloc &alloc = Alloc()) : _tree(comp, alloc) {}
+
+        explicit map(const Alloc &alloc) : _tree(Compare(), alloc) {}
+
         template<typename InputIt>
         map(InputIt first, InputIt last) {
             for (; first != last; ++first) {
@@ -32,30 +52,281 @@ namespace my {
 
         map(std::initializer_list<value_type> ilist) : map(ilist.begin(), ilist.end()) {}
 
+        /// 输入已按 key 升序排列且没有重复：O(n) 直接建成一棵完全平衡的红黑树，不做比较之外的任何调整
+        template<typename InputIt>
+        map(sorted_unique_t, InputIt first, InputIt last,
+            const Compare &comp = Compare(), const Alloc &alloc = Alloc()) : _tree(comp, alloc) {
+            _tree.BuildSorted(first, last, true);
+        }
+
+        map(sorted_unique_t tag, std::initializer_list<value_type> ilist,
+            const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+                : map(tag, ilist.begin(), ilist.end(), comp, alloc) {}
+
+        /// 插入只下降一次：key 已存在时不构造元素，返回的迭代器直接来自这次下降
         std::pair<iterator, bool> insert(const value_type &val) {
-            return _tree.InsertUnique(val);
+            return _tree.EmplaceUniqueKey(val.first, val);
         }
 
-        void insert_or_assign(const K& key, const V& val) {
-            auto [it, inserted] = _tree.InsertUnique({key, val});
-            if (!inserted)
-                (*it).second = val;
+        std::pair<iterator, bool> insert(value_type &&val) {
+            return _tree.EmplaceUniqueKey(val.first, std::move(val));
         }
 
+        /// 带提示的插入：新 key 紧挨在 hint 之前或之后时均摊 O(1)，按 key 递增追加时用 end() 作提示即可
+        iterator insert(iterator hint, const value_type &val) {
+            return _tree.EmplaceUniqueKeyHint(hint, val.first, val);
+        }
+
+        iterator insert(iterator hint, value_type &&val) {
+            return _tree.EmplaceUniqueKeyHint(hint, val.first, std::move(val));
+        }
 
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return _tree.EmplaceUnique(std::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(iterator hint, Args &&... args) {
+            return _tree.EmplaceUniqueHint(hint, std::forward<Args>(args)...);
+        }
+
+        /// key 不存在时才用 args 构造 mapped
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const K &key, Args &&... args) {
+            return _tree.EmplaceUniqueKey(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(K &&key, Args &&... args) {
+            return _tree.EmplaceUniqueKey(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        iterator try_emplace(iterator hint, const K &key, Args &&... args) {
+            return _tree.EmplaceUniqueKeyHint(hint, key, std::piecewise_construct, std::forward_as_tuple(key),
+                                              std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        iterator try_emplace(iterator hint, K &&key, Args &&... args) {
+            return _tree.EmplaceUniqueKeyHint(hint, key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                              std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        /// 批量插入按 key 升序排列的区间（可以有重复 key，只保留第一个），O(min(size() + n, n log size()))：
+        /// 现有节点和新元素归并之后整棵树重建（n 很小时改为逐个带提示插入），现有元素的节点和地址都不变
+        template<typename InputIt>
+        void insert_sorted(InputIt first, InputIt last) {
+            _tree.InsertSorted(first, last, true);
+        }
+
+        /// key 已存在时给 mapped 赋值，否则插入；返回值与 std::map 一致
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj) {
+            auto res = try_emplace(key, std::forward<M>(obj));
+            if (!res.second) {
+                (*res.first).second = std::forward<M>(obj);
+            }
+            return res;
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(K &&key, M &&obj) {
+            auto res = try_emplace(std::move(key), std::forward<M>(obj));
+            if (!res.second) {
+                (*res.first).second = std::forward<M>(obj);
+            }
+            return res;
+        }
+
+        template<typename M>
+        iterator insert_or_assign(iterator hint, const K &key, M &&obj) {
+            size_t old_size = size();
+            iterator it = try_emplace(hint, key, std::forward<M>(obj));
+            if (size() == old_size) {
+                (*it).second = std::forward<M>(obj);
+            }
+            return it;
+        }
+
+        template<typename M>
+        iterator insert_or_assign(iterator hint, K &&key, M &&obj) {
+            size_t old_size = size();
+            iterator it = try_emplace(hint, std::move(key), std::forward<M>(obj));
+            if (size() == old_size) {
+                (*it).second = std::forward<M>(obj);
+            }
+            return it;
+        }
+
+
+        /// 查找接口：Compare 声明了 is_transparent（如 std::less<>）时支持异构 key，
+        /// 例如 map<std::string, V, std::less<>> 可以直接 find("abc")，不构造临时 std::string
         iterator find(const K &key) {
             return _tree.Find(key);
         }
 
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator find(const KeyArg &key) {
+            return _tree.Find(key);
+        }
+
+        size_t count(const K &key) {
+            return _tree.Count(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_t count(const KeyArg &key) {
+            return _tree.Count(key);
+        }
+
+        bool contains(const K &key) {
+            return _tree.Contains(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        bool contains(const KeyArg &key) {
+            return _tree.Contains(key);
+        }
+
+        iterator lower_bound(const K &key) {
+            return _tree.LowerBound(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator lower_bound(const KeyArg &key) {
+            return _tree.LowerBound(key);
+        }
+
+        iterator upper_bound(const K &key) {
+            return _tree.UpperBound(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator upper_bound(const KeyArg &key) {
+            return _tree.UpperBound(key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const K &key) {
+            return _tree.EqualRange(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        std::pair<iterator, iterator> equal_range(const KeyArg &key) {
+            return _tree.EqualRange(key);
+        }
+
+        /// 顺序统计（Augment 为 ::RBTreeSizeAugment 时可用），O(log n)，不需要从 begin() 走 k 步
+        /// select(k)：第 k 小的元素（从 0 开始），k >= size() 时返回 end()
+        iterator select(size_t k) {
+            return _tree.Select(k);
+        }
+
+        /// rank(key)：key 小于 key 的元素个数；rank(pos)：pos 的下标
+        size_t rank(const K &key) const {
+            return _tree.Rank(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_t rank(const KeyArg &key) const {
+            return _tree.Rank(key);
+        }
+
+        size_t rank(iterator pos) const {
+            return _tree.Rank(pos);
+        }
+
+        iterator erase(iterator pos) {
+            return _tree.Erase(pos);
+        }
+
+        /// 整段拆下后一次释放，两边只合并一次，O(k + log n)
+        iterator erase(iterator first, iterator last) {
+            return _tree.Erase(first, last);
+        }
+
+        size_t erase(const K &key) {
+            return _tree.Erase(key);
+        }
+
+        /// 把 key 不小于 key 的元素拆出来作为一个新的 map 返回，O(log n)，不分配也不拷贝元素
+        /// 拆分后只数较小的一侧来维护 size()（order_statistic 版本直接读子树大小）
+        map split(const K &key) {
+            map result(key_comp(), _tree.GetAllocator());
+            _tree.Split(key, result._tree);
+            return result;
+        }
+
+        /// 把 other 的全部元素接过来，other 变为空
+        /// other 的 key 整体在本容器之后（或之前）时 O(log n)；范围有重叠时等同于 merge（逐个转移）
+        void join(map &other) {
+            _tree.Join(other._tree, true);
+        }
+
+        void join(map &&other) {
+            _tree.Join(other._tree, true);
+        }
+
+        /// 节点操作：摘下的节点可以原样插入另一个 map，不重新分配也不拷贝元素
+        node_type extract(iterator pos) {
+            return _tree.MakeHandle(_tree.Extract(pos));
+        }
+
+        node_type extract(const K &key) {
+            iterator it = _tree.Find(key);
+            if (it == end()) return node_type();
+            return extract(it);
+        }
+
+        /// key 已存在时插入失败，节点原样留在返回值的 node 中
+        insert_return_type insert(node_type &&nh) {
+            if (nh.empty()) return {end(), false, node_type()};
+            auto [it, inserted] = _tree.InsertUniqueNode(tree_type::node_traits::get(nh));
+            if (!inserted) return {it, false, std::move(nh)};
+            tree_type::node_traits::release(nh);
+            return {it, true, node_type()};
+        }
+
+        /// 把 source 中本容器没有的 key 的节点全部转移过来
+        void merge(map &source) {
+            _tree.Merge(source._tree, true);
+        }
+
+        void swap(map &other) {
+            _tree.Swap(other._tree);
+        }
+
         V &operator[](const K &key) {
-            auto [it, inserted] = _tree.InsertUnique({key, V()});
-            return (*it).second;
+            return (*try_emplace(key).first).second;
+        }
+
+        V &operator[](K &&key) {
+            return (*try_emplace(std::move(key)).first).second;
         }
 
         size_t size() const {
             return _tree.Size();
         }
 
+        bool empty() const {
+            return _tree.Empty();
+        }
+
+        void clear() {
+            _tree.Clear();
+        }
+
+        key_compare key_comp() const {
+            return _tree.KeyComp();
+        }
+
+        allocator_type get_allocator() const {
+            return _tree.GetAllocator();
+        }
+
         iterator begin() { return _tree.begin(); }
 
         iterator end() { return _tree.end(); }
@@ -65,18 +336,32 @@ namespace my {
         }
 
     private:
-        RBTree<K, V> _tree;
+        tree_type _tree;
     };
 
 // ============================ my::multimap ============================
-    template<typename K, typename V>
+    template<typename K,
+            typename V,
+            typename Compare = std::less<K>,
+            typename Alloc = MyAlloc<std::pair<const K, V>>,
+            typename Augment = ::RBTreeNoAugment>
     class multimap {
+        using tree_type = RBTree<K, V, Compare, Alloc, Augment>;
     public:
+        using key_type = K;
+        using mapped_type = V;
         using value_type = std::pair<const K, V>;
-        using iterator = typename RBTree<K, V>::iterator;
+        using key_compare = Compare;
+        using allocator_type = Alloc;
+        using iterator = typename tree_type::iterator;
+        using node_type = typename tree_type::node_type;
 
         multimap() = default;
 
+        explicit multimap(const Compare &comp, const Alloc &alloc = Alloc()) : _tree(comp, alloc) {}
+
+        explicit multimap(const Alloc &alloc) : _tree(Compare(), alloc) {}
+
         template<typename InputIt>
         multimap(InputIt first, InputIt last) {
             for (; first != last; ++first) {
@@ -86,22 +371,198 @@ namespace my {
 
         multimap(std::initializer_list<value_type> ilist) : multimap(ilist.begin(), ilist.end()) {}
 
+        /// 输入已按 key 升序排列（可以有重复）：O(n) 直接建成一棵完全平衡的红黑树
+        template<typename InputIt>
+        multimap(sorted_equivalent_t, InputIt first, InputIt last,
+                 const Compare &comp = Compare(), const Alloc &alloc = Alloc()) : _tree(comp, alloc) {
+            _tree.BuildSorted(first, last, false);
+        }
+
+        multimap(sorted_equivalent_t tag, std::initializer_list<value_type> ilist,
+                 const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+                : multimap(tag, ilist.begin(), ilist.end(), comp, alloc) {}
+
         iterator insert(const value_type &val) {
-            return _tree.InsertMulti(val);
+            return _tree.EmplaceMulti(val);
         }
 
+        iterator insert(value_type &&val) {
+            return _tree.EmplaceMulti(std::move(val));
+        }
+
+        /// 带提示的插入：尽量放在紧挨着 hint 的位置，按 key 递增追加时均摊 O(1)
+        iterator insert(iterator hint, const value_type &val) {
+            return _tree.EmplaceMultiHint(hint, val);
+        }
+
+        template<typename... Args>
+        iterator emplace(Args &&... args) {
+            return _tree.EmplaceMulti(std::forward<Args>(args)...);
+        }
+
+        /// 批量插入按 key 升序排列的区间，O(min(size() + n, n log size()))，新元素排在已有的等价 key 之后
+        template<typename InputIt>
+        void insert_sorted(InputIt first, InputIt last) {
+            _tree.InsertSorted(first, last, false);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(iterator hint, Args &&... args) {
+            return _tree.EmplaceMultiHint(hint, std::forward<Args>(args)...);
+        }
+
+        /// 查找接口：Compare 声明了 is_transparent（如 std::less<>）时支持异构 key，
+        /// 例如 map<std::string, V, std::less<>> 可以直接 find("abc")，不构造临时 std::string
         iterator find(const K &key) {
             return _tree.Find(key);
         }
 
-        size_t count(const K &key) const {
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator find(const KeyArg &key) {
+            return _tree.Find(key);
+        }
+
+        size_t count(const K &key) {
+            return _tree.Count(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_t count(const KeyArg &key) {
             return _tree.Count(key);
         }
 
+        bool contains(const K &key) {
+            return _tree.Contains(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        bool contains(const KeyArg &key) {
+            return _tree.Contains(key);
+        }
+
+        iterator lower_bound(const K &key) {
+            return _tree.LowerBound(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator lower_bound(const KeyArg &key) {
+            return _tree.LowerBound(key);
+        }
+
+        iterator upper_bound(const K &key) {
+            return _tree.UpperBound(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator upper_bound(const KeyArg &key) {
+            return _tree.UpperBound(key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const K &key) {
+            return _tree.EqualRange(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        std::pair<iterator, iterator> equal_range(const KeyArg &key) {
+            return _tree.EqualRange(key);
+        }
+
+        /// 顺序统计（Augment 为 ::RBTreeSizeAugment 时可用），O(log n)，不需要从 begin() 走 k 步
+        /// select(k)：第 k 小的元素（从 0 开始），k >= size() 时返回 end()
+        iterator select(size_t k) {
+            return _tree.Select(k);
+        }
+
+        /// rank(key)：key 小于 key 的元素个数；rank(pos)：pos 的下标
+        size_t rank(const K &key) const {
+            return _tree.Rank(key);
+        }
+
+        template<typename KeyArg, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_t rank(const KeyArg &key) const {
+            return _tree.Rank(key);
+        }
+
+        size_t rank(iterator pos) const {
+            return _tree.Rank(pos);
+        }
+
+        iterator erase(iterator pos) {
+            return _tree.Erase(pos);
+        }
+
+        /// 整段拆下后一次释放，两边只合并一次，O(k + log n)
+        iterator erase(iterator first, iterator last) {
+            return _tree.Erase(first, last);
+        }
+
+        size_t erase(const K &key) {
+            return _tree.Erase(key);
+        }
+
+        /// 把 key 不小于 key 的元素拆出来作为一个新的 multimap 返回，O(log n)，不分配也不拷贝元素
+        /// 拆分后只数较小的一侧来维护 size()（order_statistic 版本直接读子树大小）
+        multimap split(const K &key) {
+            multimap result(key_comp(), _tree.GetAllocator());
+            _tree.Split(key, result._tree);
+            return result;
+        }
+
+        /// 把 other 的全部元素接过来，other 变为空
+        /// other 的 key 整体在本容器之后（或之前）时 O(log n)；范围有重叠时等同于 merge（逐个转移）
+        void join(multimap &other) {
+            _tree.Join(other._tree, false);
+        }
+
+        void join(multimap &&other) {
+            _tree.Join(other._tree, false);
+        }
+
+        /// 节点操作：摘下的节点可以原样插入另一个 multimap，不重新分配也不拷贝元素
+        node_type extract(iterator pos) {
+            return _tree.MakeHandle(_tree.Extract(pos));
+        }
+
+        node_type extract(const K &key) {
+            iterator it = _tree.Find(key);
+            if (it == end()) return node_type();
+            return extract(it);
+        }
+
+        iterator insert(node_type &&nh) {
+            if (nh.empty()) return end();
+            return _tree.InsertMultiNode(tree_type::node_traits::release(nh));
+        }
+
+        /// 把 source 的节点全部转移过来
+        void merge(multimap &source) {
+            _tree.Merge(source._tree, false);
+        }
+
+        void swap(multimap &other) {
+            _tree.Swap(other._tree);
+        }
+
         size_t size() const {
             return _tree.Size();
         }
 
+        bool empty() const {
+            return _tree.Empty();
+        }
+
+        void clear() {
+            _tree.Clear();
+        }
+
+        key_compare key_comp() const {
+            return _tree.KeyComp();
+        }
+
+        allocator_type get_allocator() const {
+            return _tree.GetAllocator();
+        }
+
         iterator begin() { return _tree.begin(); }
 
         iterator end() { return _tree.end(); }
@@ -111,7 +572,19 @@ namespace my {
         }
 
     private:
-        RBTree<K, V> _tree;
+        tree_type _tree;
     };
 
+    /// 维护子树大小的 map / multimap：按名次的查询为 O(log n)，代价是每个节点多一个计数、每次插入删除都要更新到根
+    template<typename K,
+            typename V,
+            typename Compare = std::less<K>,
+            typename Alloc = MyAlloc<std::pair<const K, V>>>
+    using order_statistic_map = map<K, V, Compare, Alloc, ::RBTreeSizeAugment>;
+
+    template<typename K,
+            typename V,
+            typename Compare = std::less<K>,
+            typename Alloc = MyAlloc<std::pair<const K, V>>>
+    using order_statistic_multimap = multimap<K, V, Compare, Alloc, ::RBTreeSizeAugment>;
 }
@@ -0,0 +1,281 @@
+/**
+ * @file      my_mpmc_queue.h
+ * @brief     [多生产者多消费者的有界无锁队列（Vyukov 算法）：每个槽位带序号，快速路径只有一次 CAS，可选的先自旋后睡眠的阻塞接口]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_futex.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * mpmc_queue<T, Blocking>
+ * 槽位数组大小是 2 的幂，每个槽位有一个序号 seq，入队计数 enqueue_ 和出队计数 dequeue_ 都单调递增
+ *      槽位 i 初始 seq = i
+ *      入队：看 pos = enqueue_ 对应的槽位，seq == pos 表示空闲，CAS 抢到 pos 之后构造元素，再把 seq 置为 pos + 1（release）
+ *      出队：看 pos = dequeue_ 对应的槽位，seq == pos + 1 表示已写好，CAS 抢到 pos 之后取走元素，再把 seq 置为 pos + 槽位数
+ *            —— 也就是下一圈入队时这个槽位该有的序号
+ *      seq 比期望的小：入队时表示队列满（上一圈的元素还没被取走），出队时表示队列空
+ *      seq 比期望的大：别的线程已经抢走了这个位置，重新读计数再试
+ * 生产者之间只竞争 enqueue_，消费者之间只竞争 dequeue_，生产者和消费者之间只通过各个槽位的 seq 交接，快速路径上没有锁
+ * 两个计数分别放在独立的缓存行上，避免生产者和消费者互相拉扯同一条缓存行
+ * 阻塞等待（Blocking = true）：push / pop 先自旋，仍然满 / 空时在 futex 上睡眠；
+ *      每次入队 / 出队之后检查对面有没有睡眠的线程，没有就不进内核，协议与 spsc_queue 相同，只是“在等”的标志换成了等待者计数
+ * 异常：CAS 占住位置之后就无法退回，所以占位之后的操作都不能抛异常
+ *      构造可能抛异常时 try_emplace 先在栈上构造好元素再去抢位置，抛出时队列没有任何变化，抢到之后再移动进槽位；
+ *      因此要求 T 的移动构造和移动赋值（try_pop 取出元素时用）是 noexcept，构造本身可以抛
+ */
+
+namespace my {
+
+    template<typename T, bool Blocking = false>
+    class mpmc_queue {
+        static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                      "mpmc_queue requires T to be nothrow move constructible and assignable");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+
+        static constexpr bool is_blocking = Blocking;
+
+        /// 槽位数向上取 2 的幂（至少为 2），capacity() 返回实际的槽位数
+        explicit mpmc_queue(size_type capacity) {
+            if (capacity == 0) {
+                throw std::invalid_argument("mpmc_queue capacity must be positive");
+            }
+            mask_ = std::bit_ceil(capacity < 2 ? size_type(2) : capacity) - 1;
+            cells_ = std::allocator<cell>().allocate(mask_ + 1);
+            for (size_type i = 0; i <= mask_; ++i) {
+                std::construct_at(&cells_[i].seq_, i);
+            }
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+
+        mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+        ~mpmc_queue() {
+            size_type head = dequeue_.pos_.load(std::memory_order_relaxed);
+            size_type tail = enqueue_.pos_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::destroy_at(cells_[head & mask_].value());
+            }
+            for (size_type i = 0; i <= mask_; ++i) {
+                std::destroy_at(&cells_[i].seq_);
+            }
+            std::allocator<cell>().deallocate(cells_, mask_ + 1);
+        }
+
+        size_type capacity() const noexcept { return mask_ + 1; }
+
+        /// 元素个数的近似值：包括已经占位但还没写完 / 还没取完的槽位，只在没有并发修改时精确
+        size_type size_approx() const noexcept {
+            size_type head = dequeue_.pos_.load(std::memory_order_acquire);
+            size_type tail = enqueue_.pos_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty_approx() const noexcept { return size_approx() == 0; }
+
+        /// 队列已满时返回 false，不构造元素（构造可能抛异常时会先构造一个临时对象，满了再丢掉）
+        template<typename... Args>
+        bool try_emplace(Args &&... args) {
+            if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+                return claim_and_construct_(std::forward<Args>(args)...);
+            } else {
+                T value(std::forward<Args>(args)...);
+                return claim_and_construct_(std::move(value));
+            }
+        }
+
+        bool try_push(const T &value) { return try_emplace(value); }
+
+        bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+        /// 队列为空时返回 false
+        bool try_pop(T &out) {
+            size_type pos = dequeue_.pos_.load(std::memory_order_relaxed);
+            cell *c;
+            for (;;) {
+                c = &cells_[pos & mask_];
+                size_type seq = c->seq_.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+                if (diff == 0) {
+                    if (dequeue_.pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeue_.pos_.load(std::memory_order_relaxed);
+                }
+            }
+            T *slot = c->value();
+            out = std::move(*slot);
+            std::destroy_at(slot);
+            c->seq_.store(pos + mask_ + 1, std::memory_order_release);
+            notify_(wait_.spaceSeq_, wait_.producerWaiters_);
+            return true;
+        }
+
+        // ---------------- 阻塞接口（仅 Blocking = true） ----------------
+
+        /// 与 try_emplace 一样，构造可能抛异常时只在开始等待之前构造一次，之后每次重试都移动同一个对象
+        template<typename... Args>
+        void emplace(Args &&... args) requires Blocking {
+            if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+                wait_and_construct_(std::forward<Args>(args)...);
+            } else {
+                T value(std::forward<Args>(args)...);
+                wait_and_construct_(std::move(value));
+            }
+        }
+
+        void push(const T &value) requires Blocking { emplace(value); }
+
+        void push(T &&value) requires Blocking { emplace(std::move(value)); }
+
+        void pop(T &out) requires Blocking {
+            for (unsigned spin = 0;; ++spin) {
+                if (try_pop(out)) {
+                    return;
+                }
+                if (spin < kSpinBeforePark_) {
+                    detail::spin_backoff(spin);
+                } else {
+                    park_(wait_.dataSeq_, wait_.consumerWaiters_, [this] { return has_data_(); });
+                }
+            }
+        }
+
+    private:
+        /// 抢占一个入队位置并在槽位上构造元素；调用方保证这里的构造不会抛异常
+        template<typename... Args>
+        bool claim_and_construct_(Args &&... args) noexcept {
+            size_type pos = enqueue_.pos_.load(std::memory_order_relaxed);
+            cell *c;
+            for (;;) {
+                c = &cells_[pos & mask_];
+                size_type seq = c->seq_.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0) {
+                    if (enqueue_.pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_.pos_.load(std::memory_order_relaxed);
+                }
+            }
+            std::construct_at(c->value(), std::forward<Args>(args)...);
+            c->seq_.store(pos + 1, std::memory_order_release);
+            notify_(wait_.dataSeq_, wait_.consumerWaiters_);
+            return true;
+        }
+
+        /// 自旋 / 睡眠直到抢到位置；失败的尝试不会构造元素，所以 args 可以反复转发
+        template<typename... Args>
+        void wait_and_construct_(Args &&... args) {
+            for (unsigned spin = 0;; ++spin) {
+                if (claim_and_construct_(std::forward<Args>(args)...)) {
+                    return;
+                }
+                if (spin < kSpinBeforePark_) {
+                    detail::spin_backoff(spin);
+                } else {
+                    park_(wait_.spaceSeq_, wait_.producerWaiters_, [this] { return has_space_(); });
+                }
+            }
+        }
+
+        /// 槽位：序号 + 未初始化的元素存储
+        struct cell {
+            std::atomic<size_type> seq_;
+            alignas(T) unsigned char storage_[sizeof(T)];
+
+            T *value() { return std::launder(reinterpret_cast<T *>(storage_)); }
+        };
+
+        static constexpr unsigned kSpinBeforePark_ = 128;
+
+        /// 下一个入队位置对应的槽位已经空闲
+        bool has_space_() const {
+            size_type pos = enqueue_.pos_.load(std::memory_order_relaxed);
+            return cells_[pos & mask_].seq_.load(std::memory_order_relaxed) == pos;
+        }
+
+        /// 下一个出队位置对应的槽位已经写好
+        bool has_data_() const {
+            size_type pos = dequeue_.pos_.load(std::memory_order_relaxed);
+            return cells_[pos & mask_].seq_.load(std::memory_order_relaxed) == pos + 1;
+        }
+
+        /**
+         * 睡眠：先登记为等待者，seq_cst 栅栏之后再检查一次条件，仍不满足才在 futex 上睡
+         * 通知方在写完槽位的 seq 之后也有一个 seq_cst 栅栏再读等待者计数：要么这里的检查看到了新的 seq，要么通知方看到了等待者
+         * 条件检查只是为了决定睡不睡，醒来之后调用方总会重新 try，多醒一次没有关系
+         */
+        template<typename Ready>
+        void park_(std::atomic<uint32_t> &word, std::atomic<uint32_t> &waiters, Ready ready) {
+            uint32_t seq = word.load(std::memory_order_acquire);
+            waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!ready()) {
+                detail::futex_wait(word, seq);
+            }
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /// 每次入队 / 出队只产生一个元素 / 空位，唤醒一个等待者即可；被唤醒的线程抢不到会再次睡下，之后的操作会继续唤醒
+        void notify_(std::atomic<uint32_t> &word, std::atomic<uint32_t> &waiters) {
+            if constexpr (Blocking) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiters.load(std::memory_order_relaxed) != 0) {
+                    word.fetch_add(1, std::memory_order_release);
+                    detail::futex_wake_one(word);
+                }
+            }
+        }
+
+        struct alignas(detail::cache_line_size) position {
+            std::atomic<size_type> pos_{0};
+        };
+
+        /// Blocking = false 时 notify_ 什么都不做，这些字段只是占位
+        struct wait_state_off {
+            std::atomic<uint32_t> dataSeq_;
+            std::atomic<uint32_t> spaceSeq_;
+            std::atomic<uint32_t> consumerWaiters_;
+            std::atomic<uint32_t> producerWaiters_;
+        };
+
+        struct alignas(detail::cache_line_size) wait_state_on {
+            std::atomic<uint32_t> dataSeq_{0};
+            std::atomic<uint32_t> spaceSeq_{0};
+            std::atomic<uint32_t> consumerWaiters_{0};
+            std::atomic<uint32_t> producerWaiters_{0};
+        };
+
+        /// 只读的共享数据单独占一条缓存行
+        alignas(detail::cache_line_size) cell *cells_ = nullptr;
+        size_type mask_ = 0;
+        position enqueue_;
+        position dequeue_;
+        std::conditional_t<Blocking, wait_state_on, wait_state_off> wait_;
+    };
+}
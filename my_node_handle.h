@@ -0,0 +1,127 @@
+/**
+ * @file      my_node_handle.h
+ * @brief     [节点句柄：容器之间转移节点而不重新分配内存]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+/**
+ * node_handle
+ * extract() 把节点从容器中摘下来交给 node_handle 持有，insert(node_handle&&) 再把它挂到另一个容器上
+ * 整个过程中节点的内存和里面的元素都不会被拷贝、移动或重新分配
+ * 句柄析构时如果仍然持有节点，就负责把节点销毁
+ *
+ * NodeTraits 描述节点的种类（哈希表节点、红黑树节点……），需要提供：
+ *      node_pointer / value_type 两个类型
+ *      static value_type &value(node_pointer)      取节点中存储的元素
+ *      void destroy(node_pointer)                  销毁节点（析构元素并释放内存），可以携带分配器等状态
+ * 只有 NodeTraits 能构造非空句柄或取走句柄中的节点（friend），容器通过它的 make / release 使用
+ */
+
+namespace my {
+
+    template<typename NodeTraits>
+    class node_handle {
+    public:
+        using node_pointer = typename NodeTraits::node_pointer;
+        using value_type = typename NodeTraits::value_type;
+
+        node_handle() noexcept: node_(nullptr), traits_() {}
+
+        node_handle(const node_handle &) = delete;
+
+        node_handle &operator=(const node_handle &) = delete;
+
+        node_handle(node_handle &&other) noexcept
+                : node_(other.node_), traits_(std::move(other.traits_)) {
+            other.node_ = nullptr;
+        }
+
+        node_handle &operator=(node_handle &&other) noexcept {
+            if (this != &other) {
+                reset_();
+                node_ = other.node_;
+                traits_ = std::move(other.traits_);
+                other.node_ = nullptr;
+            }
+            return *this;
+        }
+
+        ~node_handle() {
+            reset_();
+        }
+
+        bool empty() const noexcept {
+            return node_ == nullptr;
+        }
+
+        explicit operator bool() const noexcept {
+            return node_ != nullptr;
+        }
+
+        /// set 类容器：直接访问元素
+        value_type &value() const {
+            return NodeTraits::value(node_);
+        }
+
+        /// map 类容器：访问 key 和 mapped
+        /// 返回非 const 的 key 引用，允许在重新插入前修改 key（节点不在任何容器中，修改是安全的）
+        template<typename V = value_type>
+        std::remove_const_t<typename V::first_type> &key() const {
+            return const_cast<std::remove_const_t<typename V::first_type> &>(NodeTraits::value(node_).first);
+        }
+
+        template<typename V = value_type>
+        typename V::second_type &mapped() const {
+            return NodeTraits::value(node_).second;
+        }
+
+        void swap(node_handle &other) noexcept {
+            std::swap(node_, other.node_);
+            std::swap(traits_, other.traits_);
+        }
+
+    private:
+        friend NodeTraits;
+
+        node_handle(node_pointer node, const NodeTraits &traits)
+                : node_(node), traits_(traits) {}
+
+        /// 交出节点的所有权，句柄变为空
+        node_pointer release_() noexcept {
+            node_pointer node = node_;
+            node_ = nullptr;
+            return node;
+        }
+
+        void reset_() {
+            if (node_) {
+                traits_.destroy(node_);
+                node_ = nullptr;
+            }
+        }
+
+    private:
+        node_pointer node_;     /// 持有的节点，空句柄为 nullptr
+        NodeTraits traits_;     /// 销毁节点所需的状态（如分配器）
+    };
+
+    template<typename NodeTraits>
+    void swap(node_handle<NodeTraits> &lhs, node_handle<NodeTraits> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    /// 唯一键容器 insert(node_handle&&) 的返回值
+    /// inserted 为 false 时，node 中是没有插入成功的节点（原样交还给调用者），position 指向已有的等价元素
+    template<typename Iterator, typename NodeHandle>
+    struct node_insert_return {
+        Iterator position;
+        bool inserted;
+        NodeHandle node;
+    };
+}
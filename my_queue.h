@@ -21,6 +21,13 @@ namespace my {
         using const_reference = typename Sequence::const_reference;
         using container_type = Sequence;
 
+        queue() = default;
+
+        /// 用已有的底层容器构造，例如指定了容量的 circular_buffer
+        explicit queue(const Sequence &container) : container_(container) {}
+
+        explicit queue(Sequence &&container) : container_(std::move(container)) {}
+
         /// queue是去调用底层的deque实现
         bool empty() const {
             return container_.empty();
@@ -46,18 +53,40 @@ namespace my {
             return container_.back();
         }
 
-        void push(const value_type &v) {
-            container_.push_back(v);
+        /// 返回底层 push_back 的结果：reject 策略的环形缓冲满了时返回 false，deque 时为 void
+        decltype(auto) push(const value_type &v) {
+            return container_.push_back(v);
+        }
+
+        decltype(auto) push(value_type &&v) {
+            return container_.push_back(std::move(v));
         }
 
         void pop() {
             container_.pop_front();
         }
 
-        /// 高端push
+        /// 批量入队：底层容器一次预留空间、按块拷贝（需要 Sequence 提供 append），返回 append 的结果
+        template<typename InputIt>
+        decltype(auto) push_range(InputIt first, InputIt last) {
+            return container_.append(first, last);
+        }
+
+        template<typename Range>
+        decltype(auto) push_range(Range &&range) {
+            return container_.append(std::begin(range), std::end(range));
+        }
+
+        /// 批量出队：把队头的 n 个元素依次移动到 out，返回写完之后的 out（需要 Sequence 提供 pop_front_n）
+        template<typename OutputIt>
+        OutputIt pop_n(size_type n, OutputIt out) {
+            return container_.pop_front_n(n, out);
+        }
+
+        /// 高端push，返回值同 push
         template<typename ...Args>
-        void emplace_back(Args &&... args) {
-            container_.emplace_back(std::forward<Args>(args)...);
+        decltype(auto) emplace_back(Args &&... args) {
+            return container_.emplace_back(std::forward<Args>(args)...);
         }
 
         void swap(queue &other) {
@@ -8,30 +8,109 @@
 #pragma once
 
 #include <iostream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "my_node_handle.h"
+#include "my_type_traits.h"
+#include "memory_/my_allocator.h"
 
 using namespace std;
 enum Color {
     RED, BLACK
 };
 
+/**
+ *  节点附加信息（augmentation）策略：每个节点多存一份由“自己 + 左右子树”决定的信息
+ *      NodeData                            节点中附加存放的数据
+ *      enabled                             为 false 时树跳过所有维护代码，不增加任何开销
+ *      order_statistic                     为 true 时树提供 Select / Rank
+ *      static void Update(Node*)           由左右孩子（已经是最新的）重新计算本节点，RotateL/RotateR 和批量建树时调用
+ *      static void Grow(Node*, const Node*)    祖先的子树中新挂入了一个节点
+ *      static void Shrink(Node*, const Node*)  祖先的子树中摘掉了一个节点
+ *  插入/删除后沿路径向上只调用 Grow / Shrink：能增量修改的信息（比如子树大小）不需要去读路径旁边的兄弟节点
+ *  策略对象由 RBTree 保存并传给 RBTreeAlgo，需要状态的策略（比如 interval_map 的比较器）把三个函数写成 const 成员即可
+ * */
+
+// 默认策略：不维护附加信息
+struct RBTreeNoAugment {
+    struct NodeData {
+    };
+    static constexpr bool enabled = false;
+    static constexpr bool order_statistic = false;
+
+    template<class Node>
+    static void Update(Node *) {}
+
+    template<class Node>
+    static void Grow(Node *, const Node *) {}
+
+    template<class Node>
+    static void Shrink(Node *, const Node *) {}
+};
+
+// 顺序统计：维护子树大小，支持 O(log n) 的按名次取元素（Select）和求名次（Rank）
+struct RBTreeSizeAugment {
+    struct NodeData {
+        size_t _size;   // 以本节点为根的子树中的节点个数
+    };
+    static constexpr bool enabled = true;
+    static constexpr bool order_statistic = true;
+
+    template<class Node>
+    static size_t Size(const Node *pNode) {
+        return pNode ? pNode->_aug._size : 0;
+    }
+
+    template<class Node>
+    static void Update(Node *pNode) {
+        pNode->_aug._size = 1 + Size(pNode->_pLeft) + Size(pNode->_pRight);
+    }
+
+    template<class Node>
+    static void Grow(Node *pNode, const Node *) {
+        ++pNode->_aug._size;
+    }
+
+    template<class Node>
+    static void Shrink(Node *pNode, const Node *) {
+        --pNode->_aug._size;
+    }
+};
+
 // 节点结构体模板
-template<class V>
+template<class V, class Augment = RBTreeNoAugment>
 struct RBTreeNode {
     RBTreeNode(const V &val = V(), Color color = RED)
             : _pLeft(nullptr), _pRight(nullptr), _pParent(nullptr), _val(val), _color(color) {}
 
-    RBTreeNode<V> *_pLeft;
-    RBTreeNode<V> *_pRight;
-    RBTreeNode<V> *_pParent;
+    RBTreeNode *_pLeft;
+    RBTreeNode *_pRight;
+    RBTreeNode *_pParent;
     V _val;
     Color _color;
+    [[no_unique_address]] typename Augment::NodeData _aug;  // 附加信息，默认策略下不占空间
 };
 
+template<class V, class Compare = std::less<V>, class Alloc = MyAlloc<V>, class Augment = RBTreeNoAugment>
+class RBTree;
+
+namespace my {
+    // map / multimap 的红黑树（见 my_rbtree_map.h），按 key 比较，节点和迭代器与 RBTree 共用
+    template<class K, class V, class Compare, class Alloc, class Augment>
+    class RBTree;
+}
+
 // STL 迭代器
-template<class V>
+template<class V, class Augment = RBTreeNoAugment>
 class RBTreeIterator {
-    typedef RBTreeNode<V> Node;
-    typedef RBTreeIterator<V> Self;
+    template<class, class, class, class>
+    friend class RBTree;        // 红黑树需要从迭代器中取出节点（erase / extract）
+    template<class, class, class, class, class>
+    friend class my::RBTree;
+    typedef RBTreeNode<V, Augment> Node;
+    typedef RBTreeIterator Self;
 public:
     RBTreeIterator(Node *pNode = nullptr, Node *head = nullptr)
             : _pNode(pNode), _pHead(head) {}
@@ -154,14 +233,998 @@ private:
     Node *_pHead; /// 用于判断 end()、--end()
 };
 
-template<class V>
+// 红黑树节点的 node_handle 描述：节点由 NodeAlloc 分配，元素由 ValueAlloc 构造
+template<class V, class NodeAlloc, class ValueAlloc, class Augment = RBTreeNoAugment>
+struct RBTreeNodeTraits {
+    typedef RBTreeNode<V, Augment> *node_pointer;
+    typedef V value_type;
+    typedef my::node_handle<RBTreeNodeTraits> handle_type;
+
+    static value_type &value(node_pointer pNode) {
+        return pNode->_val;
+    }
+
+    void destroy(node_pointer pNode) {
+        std::allocator_traits<ValueAlloc>::destroy(valueAlloc, std::addressof(pNode->_val));
+        nodeAlloc.deallocate(pNode, 1);
+    }
+
+    static handle_type make(node_pointer pNode, const NodeAlloc &na, const ValueAlloc &va) {
+        return handle_type(pNode, RBTreeNodeTraits{na, va});
+    }
+
+    static node_pointer get(const handle_type &nh) {
+        return nh.node_;
+    }
+
+    static node_pointer release(handle_type &nh) {
+        return nh.release_();
+    }
+
+    NodeAlloc nodeAlloc;
+    ValueAlloc valueAlloc;
+};
+
+// 从元素中取出参与比较的部分（RBTreeAlgo 的查找与建树使用）：set 类容器比较元素本身
+struct RBTreeIdentity {
+    template<class T>
+    const T &operator()(const T &val) const {
+        return val;
+    }
+};
+
+// map 类容器只比较 pair 的 first
+struct RBTreeSelect1st {
+    template<class P>
+    const typename P::first_type &operator()(const P &val) const {
+        return val.first;
+    }
+};
+
+/**
+ *  红黑树的结构操作：旋转、插入后的修复、删除时的摘除与修复、中序前驱/后继、split / join
+ *  只用到节点的 _pLeft / _pRight / _pParent / _color（以及 Augment 维护的 _aug），不涉及元素和比较；
+ *  查找、带提示的插入位置和有序建树只额外读取节点的 _val，通过调用者给出的 Compare 和 KeyOf 比较
+ *  RBTree（set / multiset / interval_map）、my::RBTree（map / multimap，见 my_rbtree_map.h）
+ *  和 my::intrusive::rbtree（节点是嵌在用户对象里的钩子）共用这一份实现
+ *  pHead 为哨兵：pHead->_pParent 是根，pHead->_pLeft / pHead->_pRight 是最小 / 最大节点，根的 _pParent 是 pHead
+ * */
+template<class Node, class Augment = RBTreeNoAugment>
+struct RBTreeAlgo {
+    /**
+     *  把 pNew 挂到 pParent 的 insertLeft 一侧（pParent 为 pHead 表示空树），然后修复红黑性质
+     *  最小/最大节点只可能是新节点本身：挂在最左节点的左边或最右节点的右边时 O(1) 更新，不需要重新沿树查找
+     * */
+    static void LinkAndRebalance(Node *pNew, Node *pParent, bool insertLeft, Node *pHead, const Augment &aug = Augment()) {
+        Node *&pRoot = pHead->_pParent;
+        pNew->_pLeft = pNew->_pRight = nullptr;
+        pNew->_pParent = pParent;
+        pNew->_color = RED;
+        // 空树的情况
+        if (pParent == pHead) {
+            pRoot = pNew;
+            pHead->_pLeft = pHead->_pRight = pNew;
+        } else if (insertLeft) {
+            pParent->_pLeft = pNew;
+            if (pParent == pHead->_pLeft)
+                pHead->_pLeft = pNew;
+        } else {
+            pParent->_pRight = pNew;
+            if (pParent == pHead->_pRight)
+                pHead->_pRight = pNew;
+        }
+        // 先把新节点到根的路径上的附加信息补上，之后修复过程中的旋转会自己维护
+        GrowToRoot(pNew, pHead, aug);
+        FixInsert(pNew, pHead, pRoot, aug);
+        /// 根节点的固有性质，染色为黑色
+        pRoot->_color = BLACK;
+    }
+
+    /**
+     *  红色节点 pCur 与红色父节点相连时向上修复（不允许连续红色节点出现）
+     *  pTop 为子树根的父节点：整棵树时是 pHead，独立的子树（见 Join3）时是 nullptr；旋转到子树根时更新 pRoot
+     *  结束时不给根染色，调用者据此判断黑高是否增加
+     * */
+    static void FixInsert(Node *pCur, Node *pTop, Node *&pRoot, const Augment &aug) {
+        Node *pParent = pCur->_pParent;
+        //pParent的颜色是红色，一定违反红黑树的性质
+        while (pParent != pTop && RED == pParent->_color) {
+            Node *grandFather = pParent->_pParent;
+            if (pParent == grandFather->_pLeft) {
+                Node *uncle = grandFather->_pRight;
+                /***
+                 * 情况一：叔叔节点存在且为红色
+                 * 将parent与uncle节点改为黑色，并且将grandfater节点改为红色
+                 * 更新pcur = pgrandfather, pParent = pCur->_pParent;
+                 * 继续向上修复
+                 *
+                 * */
+                if (uncle && RED == uncle->_color) {
+                    pParent->_color = BLACK;
+                    uncle->_color = BLACK;
+                    grandFather->_color = RED;
+                    pCur = grandFather;
+                    pParent = pCur->_pParent;
+                } else {
+                    //情况二：叔叔节点不存在或者存在且为黑色
+                    //情况三：pCur是pParent的右孩子
+                    if (pCur == pParent->_pRight) {
+                        RotateL(pParent, pTop, pRoot, aug);
+                        swap(pParent, pCur);
+                    }
+
+                    //情况二：
+                    grandFather->_color = RED;
+                    pParent->_color = BLACK;
+                    RotateR(grandFather, pTop, pRoot, aug);
+                }
+            } else  // pParent == grandFather->_pRight  与 pParent == grandFather->_pLeft是对称的
+            {
+                Node *uncle = grandFather->_pLeft;
+                if (uncle && RED == uncle->_color) {
+                    pParent->_color = BLACK;
+                    uncle->_color = BLACK;
+                    grandFather->_color = RED;
+                    pCur = grandFather;
+                    pParent = pCur->_pParent;
+                } else {
+                    if (pCur == pParent->_pLeft) {
+                        RotateR(pParent, pTop, pRoot, aug);
+                        swap(pParent, pCur);
+                    }
+
+                    pParent->_color = BLACK;
+                    grandFather->_color = RED;
+                    RotateL(grandFather, pTop, pRoot, aug);
+
+                }
+            }
+
+        }
+    }
+
+    // 新挂入的叶子 pNew 的每个祖先都多了一个后代；不维护附加信息时什么也不做
+    static void GrowToRoot(Node *pNew, Node *pHead, const Augment &aug) {
+        if constexpr (Augment::enabled) {
+            aug.Update(pNew);
+            for (Node *pCur = pNew->_pParent; pCur != pHead; pCur = pCur->_pParent)
+                aug.Grow(pCur, pNew);
+        }
+    }
+
+    // 从 pNode 开始到根的每个节点都少了一个后代 pRemoved
+    static void ShrinkToRoot(Node *pNode, const Node *pRemoved, Node *pHead, const Augment &aug) {
+        if constexpr (Augment::enabled) {
+            for (; pNode != pHead; pNode = pNode->_pParent)
+                aug.Shrink(pNode, pRemoved);
+        }
+    }
+
+    // 中序前驱，pNode 不能是最小节点
+    static Node *Predecessor(Node *pNode) {
+        if (pNode->_pLeft) {
+            pNode = pNode->_pLeft;
+            while (pNode->_pRight)
+                pNode = pNode->_pRight;
+            return pNode;
+        }
+        Node *pParent = pNode->_pParent;
+        while (pNode == pParent->_pLeft) {
+            pNode = pParent;
+            pParent = pParent->_pParent;
+        }
+        return pParent;
+    }
+
+    // 中序后继，pNode 不能是最大节点
+    static Node *Successor(Node *pNode) {
+        if (pNode->_pRight) {
+            pNode = pNode->_pRight;
+            while (pNode->_pLeft)
+                pNode = pNode->_pLeft;
+            return pNode;
+        }
+        Node *pParent = pNode->_pParent;
+        while (pNode == pParent->_pRight) {
+            pNode = pParent;
+            pParent = pParent->_pParent;
+        }
+        return pParent;
+    }
+
+    /**
+     *  把节点 z 从树中摘下并恢复红黑性质（与 SGI STL 的 _Rb_tree_rebalance_for_erase 相同）
+     *  z 有两个孩子时，用它的后继 y 顶替 z 的位置（交换的是链接和颜色，不搬动元素），
+     *  这样除了 z 之外所有节点的地址都不变，其他迭代器不会失效
+     *  如果删掉的是黑色节点，从替代节点 x 开始向上修复“双黑”
+     * */
+    static void RebalanceForErase(Node *z, Node *pHead, const Augment &aug = Augment()) {
+        Node *&pRoot = pHead->_pParent;
+        Node *&pLeftMost = pHead->_pLeft;
+        Node *&pRightMost = pHead->_pRight;
+        Node *y = z;
+        Node *x = nullptr;
+        Node *xParent = nullptr;
+
+        if (nullptr == y->_pLeft) {
+            x = y->_pRight;
+        } else if (nullptr == y->_pRight) {
+            x = y->_pLeft;
+        } else {
+            y = y->_pRight;
+            while (y->_pLeft)
+                y = y->_pLeft;
+            x = y->_pRight;
+        }
+
+        if (y != z) {
+            // y 是 z 的后继，用 y 顶替 z
+            z->_pLeft->_pParent = y;
+            y->_pLeft = z->_pLeft;
+            if (y != z->_pRight) {
+                xParent = y->_pParent;
+                if (x)
+                    x->_pParent = y->_pParent;
+                y->_pParent->_pLeft = x;
+                y->_pRight = z->_pRight;
+                z->_pRight->_pParent = y;
+            } else {
+                xParent = y;
+            }
+            if (pRoot == z)
+                pRoot = y;
+            else if (z->_pParent->_pLeft == z)
+                z->_pParent->_pLeft = y;
+            else
+                z->_pParent->_pRight = y;
+            y->_pParent = z->_pParent;
+            swap(y->_color, z->_color);
+            if constexpr (Augment::enabled)
+                y->_aug = z->_aug;  // y 接管 z 的子树，下面沿路径向上时再减掉 y 原来的位置
+            y = z;  // y 现在指向真正被摘掉的节点
+        } else {
+            // z 最多只有一个孩子 x，直接用 x 顶替
+            xParent = y->_pParent;
+            if (x)
+                x->_pParent = y->_pParent;
+            if (pRoot == z)
+                pRoot = x;
+            else if (z->_pParent->_pLeft == z)
+                z->_pParent->_pLeft = x;
+            else
+                z->_pParent->_pRight = x;
+            if (pLeftMost == z) {
+                if (nullptr == z->_pRight) {
+                    pLeftMost = z->_pParent;    // 树为空时恰好是 pHead
+                } else {
+                    pLeftMost = x;
+                    while (pLeftMost->_pLeft)
+                        pLeftMost = pLeftMost->_pLeft;
+                }
+            }
+            if (pRightMost == z) {
+                if (nullptr == z->_pLeft) {
+                    pRightMost = z->_pParent;
+                } else {
+                    pRightMost = x;
+                    while (pRightMost->_pRight)
+                        pRightMost = pRightMost->_pRight;
+                }
+            }
+        }
+
+        // 被摘掉的位置往上的每个祖先都少了一个后代，修复过程中的旋转会自己维护
+        ShrinkToRoot(xParent, z, pHead, aug);
+
+        if (RED == y->_color)
+            return;
+
+        // 删掉的是黑色节点，x 所在的路径少了一个黑色节点
+        while (x != pRoot && (nullptr == x || BLACK == x->_color)) {
+            if (x == xParent->_pLeft) {
+                Node *w = xParent->_pRight;
+                if (RED == w->_color) {
+                    // 兄弟是红色：转成兄弟为黑色的情况
+                    w->_color = BLACK;
+                    xParent->_color = RED;
+                    RotateL(xParent, pHead, aug);
+                    w = xParent->_pRight;
+                }
+                if ((nullptr == w->_pLeft || BLACK == w->_pLeft->_color) &&
+                    (nullptr == w->_pRight || BLACK == w->_pRight->_color)) {
+                    // 兄弟的两个孩子都是黑色：兄弟染红，问题上移
+                    w->_color = RED;
+                    x = xParent;
+                    xParent = xParent->_pParent;
+                } else {
+                    if (nullptr == w->_pRight || BLACK == w->_pRight->_color) {
+                        // 兄弟的近侄子红、远侄子黑：先旋转兄弟
+                        w->_pLeft->_color = BLACK;
+                        w->_color = RED;
+                        RotateR(w, pHead, aug);
+                        w = xParent->_pRight;
+                    }
+                    // 远侄子红：旋转父节点后结束
+                    w->_color = xParent->_color;
+                    xParent->_color = BLACK;
+                    if (w->_pRight)
+                        w->_pRight->_color = BLACK;
+                    RotateL(xParent, pHead, aug);
+                    break;
+                }
+            } else {
+                // 与上面对称
+                Node *w = xParent->_pLeft;
+                if (RED == w->_color) {
+                    w->_color = BLACK;
+                    xParent->_color = RED;
+                    RotateR(xParent, pHead, aug);
+                    w = xParent->_pLeft;
+                }
+                if ((nullptr == w->_pRight || BLACK == w->_pRight->_color) &&
+                    (nullptr == w->_pLeft || BLACK == w->_pLeft->_color)) {
+                    w->_color = RED;
+                    x = xParent;
+                    xParent = xParent->_pParent;
+                } else {
+                    if (nullptr == w->_pLeft || BLACK == w->_pLeft->_color) {
+                        w->_pRight->_color = BLACK;
+                        w->_color = RED;
+                        RotateL(w, pHead, aug);
+                        w = xParent->_pLeft;
+                    }
+                    w->_color = xParent->_color;
+                    xParent->_color = BLACK;
+                    if (w->_pLeft)
+                        w->_pLeft->_color = BLACK;
+                    RotateR(xParent, pHead, aug);
+                    break;
+                }
+            }
+        }
+        if (x)
+            x->_color = BLACK;
+    }
+
+    /**
+     *  下面的查找与建树只依赖比较：Compare 比较 key 和 keyOf(元素)，
+     *  set 类容器用 RBTreeIdentity 比较元素本身，map 类容器用 RBTreeSelect1st 比较 pair 的 first
+     *  key 可以是任何能和 keyOf(元素) 比较的类型（Compare 声明了 is_transparent 时的异构查找）
+     * */
+
+    // 可重复插入的下降：每层只比较一次，等价的元素放到右边，保持插入顺序
+    template<class K, class Compare, class KeyOf>
+    static Node *FindMultiPos(Node *pHead, const K &key, const Compare &comp, KeyOf keyOf, bool &insertLeft) {
+        Node *pCur = pHead->_pParent;
+        Node *pParent = pHead;
+        insertLeft = true;
+        while (pCur) {
+            pParent = pCur;
+            insertLeft = comp(key, keyOf(pCur->_val));
+            pCur = insertLeft ? pCur->_pLeft : pCur->_pRight;
+        }
+        return pParent;
+    }
+
+    /**
+     *  唯一插入的下降（与 SGI STL 的 insert_unique 相同）：每层只比较一次，
+     *  落点确定后只需要再和落点的前驱比较一次：前驱 < key 说明没有等价元素，否则前驱就是等价元素
+     *  找到等价元素时返回它的节点，否则返回 nullptr，pParent / insertLeft 为新节点的挂载位置
+     * */
+    template<class K, class Compare, class KeyOf>
+    static Node *FindUniquePos(Node *pHead, const K &key, const Compare &comp, KeyOf keyOf,
+                               Node *&pParent, bool &insertLeft) {
+        Node *pCur = pHead->_pParent;
+        pParent = pHead;
+        insertLeft = true;
+        while (pCur) {
+            pParent = pCur;
+            insertLeft = comp(key, keyOf(pCur->_val));
+            pCur = insertLeft ? pCur->_pLeft : pCur->_pRight;
+        }
+        Node *pPrev = pParent;
+        if (insertLeft) {
+            if (pParent == pHead->_pLeft)      // 比最小元素还小（或者空树）
+                return nullptr;
+            pPrev = Predecessor(pParent);
+        }
+        if (comp(keyOf(pPrev->_val), key))
+            return nullptr;
+        return pPrev;
+    }
+
+    /**
+     *  带提示的唯一插入位置（与 libstdc++ 的 _M_get_insert_hint_unique_pos 相同）
+     *  key 落在 (hint 的前驱, hint) 或 (hint, hint 的后继) 之间时，新节点挂在两者中没有相应孩子的那一个下面
+     * */
+    template<class K, class Compare, class KeyOf>
+    static Node *FindUniqueHintPos(Node *pHead, Node *pHint, const K &key, const Compare &comp, KeyOf keyOf,
+                                   Node *&pParent, bool &insertLeft) {
+        Node *pLeftMost = pHead->_pLeft;
+        Node *pRightMost = pHead->_pRight;
+        if (pHint == pHead) {
+            // 提示为 end()：比最大元素还大就直接挂到最右边
+            if (pHead->_pParent && comp(keyOf(pRightMost->_val), key)) {
+                pParent = pRightMost;
+                insertLeft = false;
+                return nullptr;
+            }
+            return FindUniquePos(pHead, key, comp, keyOf, pParent, insertLeft);
+        }
+        if (comp(key, keyOf(pHint->_val))) {
+            if (pHint == pLeftMost) {
+                pParent = pHint;
+                insertLeft = true;
+                return nullptr;
+            }
+            Node *pBefore = Predecessor(pHint);
+            if (comp(keyOf(pBefore->_val), key)) {
+                // 前驱有右孩子时，hint 一定是前驱右子树的最左节点，左孩子为空
+                if (nullptr == pBefore->_pRight) {
+                    pParent = pBefore;
+                    insertLeft = false;
+                } else {
+                    pParent = pHint;
+                    insertLeft = true;
+                }
+                return nullptr;
+            }
+            return FindUniquePos(pHead, key, comp, keyOf, pParent, insertLeft);
+        }
+        if (comp(keyOf(pHint->_val), key)) {
+            if (pHint == pRightMost) {
+                pParent = pHint;
+                insertLeft = false;
+                return nullptr;
+            }
+            Node *pAfter = Successor(pHint);
+            if (comp(key, keyOf(pAfter->_val))) {
+                if (nullptr == pHint->_pRight) {
+                    pParent = pHint;
+                    insertLeft = false;
+                } else {
+                    pParent = pAfter;
+                    insertLeft = true;
+                }
+                return nullptr;
+            }
+            return FindUniquePos(pHead, key, comp, keyOf, pParent, insertLeft);
+        }
+        // 与 hint 等价
+        return pHint;
+    }
+
+    // 带提示的可重复插入位置：尽量挂在紧挨着 hint 的位置，提示不对时退化成普通下降
+    template<class K, class Compare, class KeyOf>
+    static Node *FindMultiHintPos(Node *pHead, Node *pHint, const K &key, const Compare &comp, KeyOf keyOf,
+                                  bool &insertLeft) {
+        Node *pLeftMost = pHead->_pLeft;
+        Node *pRightMost = pHead->_pRight;
+        if (pHint == pHead) {
+            if (pHead->_pParent && !comp(key, keyOf(pRightMost->_val))) {
+                insertLeft = false;
+                return pRightMost;
+            }
+            return FindMultiPos(pHead, key, comp, keyOf, insertLeft);
+        }
+        if (!comp(keyOf(pHint->_val), key)) {
+            // key <= hint：尝试放在 hint 之前
+            if (pHint == pLeftMost) {
+                insertLeft = true;
+                return pHint;
+            }
+            Node *pBefore = Predecessor(pHint);
+            if (!comp(key, keyOf(pBefore->_val))) {
+                if (nullptr == pBefore->_pRight) {
+                    insertLeft = false;
+                    return pBefore;
+                }
+                insertLeft = true;
+                return pHint;
+            }
+            return FindMultiPos(pHead, key, comp, keyOf, insertLeft);
+        }
+        // key > hint：尝试放在 hint 之后
+        if (pHint == pRightMost) {
+            insertLeft = false;
+            return pHint;
+        }
+        Node *pAfter = Successor(pHint);
+        if (!comp(keyOf(pAfter->_val), key)) {
+            if (nullptr == pHint->_pRight) {
+                insertLeft = false;
+                return pHint;
+            }
+            insertLeft = true;
+            return pAfter;
+        }
+        return FindMultiPos(pHead, key, comp, keyOf, insertLeft);
+    }
+
+    // 第一个不小于 key 的节点，没有时返回 pHead
+    template<class K, class Compare, class KeyOf>
+    static Node *LowerBound(Node *pHead, const K &key, const Compare &comp, KeyOf keyOf) {
+        Node *pCur = pHead->_pParent;
+        Node *pRes = pHead;
+        while (pCur) {
+            if (!comp(keyOf(pCur->_val), key)) {
+                pRes = pCur;
+                pCur = pCur->_pLeft;
+            } else {
+                pCur = pCur->_pRight;
+            }
+        }
+        return pRes;
+    }
+
+    // 第一个大于 key 的节点，没有时返回 pHead
+    template<class K, class Compare, class KeyOf>
+    static Node *UpperBound(Node *pHead, const K &key, const Compare &comp, KeyOf keyOf) {
+        Node *pCur = pHead->_pParent;
+        Node *pRes = pHead;
+        while (pCur) {
+            if (comp(key, keyOf(pCur->_val))) {
+                pRes = pCur;
+                pCur = pCur->_pLeft;
+            } else {
+                pCur = pCur->_pRight;
+            }
+        }
+        return pRes;
+    }
+
+    /**
+     *  按中序把整棵树摊平成一条链表（借用 _pLeft 指向中序后继），返回最小节点，树变为空树
+     *  求后继只会读取还没访问过的节点的 _pLeft，以及祖先的 _pRight / _pParent，所以边走边改写 _pLeft 是安全的
+     * */
+    static Node *Flatten(Node *pHead) {
+        if (nullptr == pHead->_pParent)
+            return nullptr;
+        Node *pFirst = pHead->_pLeft;
+        Node *pLast = pHead->_pRight;
+        for (Node *pCur = pFirst; pCur != pLast;) {
+            Node *pNext = Successor(pCur);
+            pCur->_pLeft = pNext;
+            pCur = pNext;
+        }
+        pLast->_pLeft = nullptr;
+        pHead->_pParent = nullptr;
+        pHead->_pLeft = pHead->_pRight = pHead;
+        return pFirst;
+    }
+
+    /**
+     *  用 _pLeft 串起来的 n 个有序节点重建一棵完全平衡的红黑树，O(n)
+     *  每棵子树都取中点作根，左右子树大小最多差 1，所以除了最深的一层之外都是满的：
+     *  最深一层不满时把这一层染红，其余全部染黑，每条路径的黑色节点数都相同，也不会有相连的红色节点
+     * */
+    static void BuildFromList(Node *pFirst, Node *pLast, size_t n, Node *pHead, const Augment &aug = Augment()) {
+        if (0 == n) {
+            pHead->_pParent = nullptr;
+            pHead->_pLeft = pHead->_pRight = pHead;
+            return;
+        }
+        Node *pList = pFirst;
+        pHead->_pParent = Build(pList, n, pHead, 0, RedDepth(n), aug);
+        pHead->_pLeft = pFirst;
+        pHead->_pRight = pLast;
+    }
+
+    // n 个节点的完全平衡树中，最深且不满的那一层的深度：floor(log2(n + 1))
+    static size_t RedDepth(size_t n) {
+        size_t depth = 0;
+        while ((size_t(2) << depth) <= n + 1)
+            ++depth;
+        return depth;
+    }
+
+    // 按中序消耗链表中的 n 个节点建成子树，返回子树的根
+    static Node *Build(Node *&pList, size_t n, Node *pParent, size_t depth, size_t redDepth, const Augment &aug = Augment()) {
+        if (0 == n)
+            return nullptr;
+        size_t nLeft = (n - 1) / 2;
+        Node *pLeft = Build(pList, nLeft, nullptr, depth + 1, redDepth, aug);
+        Node *pNode = pList;
+        pList = pList->_pLeft;
+        pNode->_pParent = pParent;
+        pNode->_pLeft = pLeft;
+        if (pLeft)
+            pLeft->_pParent = pNode;
+        pNode->_color = depth == redDepth ? RED : BLACK;
+        pNode->_pRight = Build(pList, n - 1 - nLeft, pNode, depth + 1, redDepth, aug);
+        aug.Update(pNode);
+        return pNode;
+    }
+
+    /**
+     *  与 Build 相同的形状，但节点由 make() 按中序逐个创建（make 读取下一个输入元素并分配节点）
+     *  创建失败时用 destroy(子树根) 释放本层已经建好的部分，然后把异常继续抛出
+     * */
+    template<class Make, class Destroy>
+    static Node *BuildSorted(size_t n, Node *pParent, size_t depth, size_t redDepth, Make &make, Destroy &destroy, const Augment &aug = Augment()) {
+        if (0 == n)
+            return nullptr;
+        size_t nLeft = (n - 1) / 2;
+        Node *pLeft = BuildSorted(nLeft, nullptr, depth + 1, redDepth, make, destroy, aug);
+        Node *pNode = nullptr;
+        try {
+            pNode = make();
+        } catch (...) {
+            destroy(pLeft);
+            throw;
+        }
+        pNode->_pParent = pParent;
+        pNode->_pLeft = pLeft;
+        if (pLeft)
+            pLeft->_pParent = pNode;
+        pNode->_pRight = nullptr;
+        pNode->_color = depth == redDepth ? RED : BLACK;
+        try {
+            pNode->_pRight = BuildSorted(n - 1 - nLeft, pNode, depth + 1, redDepth, make, destroy, aug);
+        } catch (...) {
+            destroy(pNode);
+            throw;
+        }
+        aug.Update(pNode);
+        return pNode;
+    }
+
+    /**
+     *  批量插入有序区间 [first, last)（必须已按 Compare 升序排列），O(n + m)，不做任何旋转：
+     *  1. 把现有的 n 个节点按中序摊平成一条链表，不分配内存
+     *  2. 和输入做一次归并，只为真正插入的元素调用 make(元素) 分配节点；unique 为 true 时跳过等价元素，
+     *     可重复插入时新元素排在现有的等价元素之后
+     *  3. 从链表按中序重建一棵完全平衡的红黑树
+     *  inserted 累计实际插入的元素个数；分配失败时已经归并的部分加上剩下的现有节点仍然重建成一棵合法的树
+     * */
+    template<class InputIt, class Compare, class KeyOf, class Make>
+    static void MergeSorted(Node *pHead, InputIt first, InputIt last, bool unique, const Compare &comp, KeyOf keyOf,
+                            Make &make, size_t &inserted, const Augment &aug = Augment()) {
+        Node *pPending = Flatten(pHead);    // 还没有归并的现有节点
+        Node *pFirst = nullptr;
+        Node *pLast = nullptr;
+        size_t total = 0;
+        auto append = [&](Node *pNode) {
+            if (pLast)
+                pLast->_pLeft = pNode;
+            else
+                pFirst = pNode;
+            pLast = pNode;
+            ++total;
+        };
+        try {
+            for (; first != last; ++first) {
+                const auto &val = *first;
+                const auto &key = keyOf(val);
+                while (pPending && (unique ? comp(keyOf(pPending->_val), key)
+                                           : !comp(key, keyOf(pPending->_val)))) {
+                    Node *pNext = pPending->_pLeft;
+                    append(pPending);
+                    pPending = pNext;
+                }
+                if (unique) {
+                    if (pPending && !comp(key, keyOf(pPending->_val)))
+                        continue;   // 与现有元素等价
+                    if (pLast && !comp(keyOf(pLast->_val), key))
+                        continue;   // 与上一个输入等价
+                }
+                append(make(val));
+                ++inserted;
+            }
+        } catch (...) {
+            for (; pPending; pPending = pPending->_pLeft)
+                append(pPending);
+            BuildFromList(pFirst, pLast, total, pHead, aug);
+            throw;
+        }
+        while (pPending) {
+            Node *pNext = pPending->_pLeft;
+            append(pPending);
+            pPending = pNext;
+        }
+        BuildFromList(pFirst, pLast, total, pHead, aug);
+    }
+
+    /**
+     *  有序批量插入选哪条路：归并重建 O(n + m)，逐个带提示插入 O(m log n)
+     *  m * log2(n) < n（往大树里补少量元素）时逐个插入更快；只有前向迭代器才能预先知道 m，否则总是归并
+     * */
+    template<class InputIt>
+    static bool PreferHintedInsert(InputIt first, InputIt last, size_t n) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            size_t log2n = 0;
+            while ((n >> log2n) > 1)
+                ++log2n;
+            return static_cast<size_t>(std::distance(first, last)) * log2n < n;
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     *  逐个插入有序区间 [first, last)，用上一个元素的位置作提示：
+     *  输入有序，key 落在上一个元素和它的后继之间时直接挂在两者之一的下面，不从根开始下降；否则退化成普通下降
+     *  unique 为 true 时跳过等价元素，可重复插入时新元素排在现有的等价元素之后，返回实际插入的元素个数
+     * */
+    template<class InputIt, class Compare, class KeyOf, class Make>
+    static size_t InsertHinted(Node *pHead, InputIt first, InputIt last, bool unique, const Compare &comp,
+                               KeyOf keyOf, Make &make, const Augment &aug = Augment()) {
+        size_t inserted = 0;
+        Node *pPrev = nullptr;      // 上一个输入元素所在（或与之等价）的节点
+        for (; first != last; ++first) {
+            const auto &val = *first;
+            const auto &key = keyOf(val);
+            Node *pParent = pHead;
+            bool insertLeft = true;
+            Node *pNext = nullptr;
+            if (pPrev)
+                pNext = pPrev == pHead->_pRight ? pHead : Successor(pPrev);
+            if (pPrev && (pNext == pHead || comp(key, keyOf(pNext->_val)))) {
+                if (unique && !comp(keyOf(pPrev->_val), key))
+                    continue;   // 与上一个元素等价
+                // 后继有左孩子时 pPrev 一定是它左子树的最右节点，右孩子为空
+                if (nullptr == pPrev->_pRight) {
+                    pParent = pPrev;
+                    insertLeft = false;
+                } else {
+                    pParent = pNext;
+                    insertLeft = true;
+                }
+            } else if (unique) {
+                if (Node *pExist = FindUniquePos(pHead, key, comp, keyOf, pParent, insertLeft)) {
+                    pPrev = pExist;
+                    continue;
+                }
+            } else {
+                pParent = FindMultiPos(pHead, key, comp, keyOf, insertLeft);
+            }
+            Node *pNew = make(val);
+            LinkAndRebalance(pNew, pParent, insertLeft, pHead, aug);
+            pPrev = pNew;
+            ++inserted;
+        }
+        return inserted;
+    }
+
+    /**
+     *  split / join 的基础：带中间节点的合并 Join3(l, k, r)（l 中的元素都不大于 k，r 中的都不小于 k）
+     *      沿黑高较大的那棵树的右脊（或左脊）下降到黑高与另一棵树相同的黑色节点，把 k 染红挂在那里，
+     *      再像插入一样沿下降的路径向上修复，O(两棵树的黑高差 + 1)
+     *  SplitAround 从节点沿父指针走到根，把沿途落在左边和右边的子树分别合并起来，
+     *      相邻两次合并的黑高差之和是伸缩的，整个拆分 O(log n)
+     *  只改链接和颜色（以及 Augment 维护的附加信息），不分配、不拷贝元素，也不做任何比较
+     * */
+    // 一棵独立的子树（根的父指针为 nullptr，根为黑色或空）和它的黑高（空树为 0，含根）
+    struct Subtree {
+        Node *_root = nullptr;
+        size_t _blackHeight = 0;
+    };
+
+    // pNode 的黑高：沿任意一条向下的路径数黑色节点（含 pNode）
+    static size_t BlackHeight(const Node *pNode) {
+        size_t height = 0;
+        for (; pNode; pNode = pNode->_pLeft) {
+            if (BLACK == pNode->_color)
+                ++height;
+        }
+        return height;
+    }
+
+    // 把黑高为 blackHeight 的子树 pNode 摘成独立的子树，根是红色时染黑，黑高加 1
+    static Subtree Detach(Node *pNode, size_t blackHeight) {
+        if (nullptr == pNode)
+            return Subtree();
+        pNode->_pParent = nullptr;
+        if (RED == pNode->_color) {
+            pNode->_color = BLACK;
+            ++blackHeight;
+        }
+        return {pNode, blackHeight};
+    }
+
+    // 合并 l、k、r（中序依次排列），返回根为黑色的独立子树
+    static Subtree Join3(Subtree l, Node *k, Subtree r, const Augment &aug = Augment()) {
+        if (l._blackHeight == r._blackHeight) {
+            k->_pLeft = l._root;
+            k->_pRight = r._root;
+            if (l._root)
+                l._root->_pParent = k;
+            if (r._root)
+                r._root->_pParent = k;
+            k->_pParent = nullptr;
+            k->_color = BLACK;
+            aug.Update(k);
+            return {k, l._blackHeight + 1};
+        }
+        bool leftTaller = l._blackHeight > r._blackHeight;
+        Subtree &tall = leftTaller ? l : r;
+        Subtree &low = leftTaller ? r : l;
+        // 沿高树靠近矮树的一侧下降，直到黑高与矮树相同的黑色节点（或空）
+        Node *pParent = nullptr;
+        Node *x = tall._root;
+        size_t height = tall._blackHeight;
+        while (x && (RED == x->_color || height > low._blackHeight)) {
+            if (BLACK == x->_color)
+                --height;
+            pParent = x;
+            x = leftTaller ? x->_pRight : x->_pLeft;
+        }
+        // k 顶替 x，x 和矮树成为 k 的两个孩子
+        k->_pLeft = leftTaller ? x : low._root;
+        k->_pRight = leftTaller ? low._root : x;
+        if (k->_pLeft)
+            k->_pLeft->_pParent = k;
+        if (k->_pRight)
+            k->_pRight->_pParent = k;
+        k->_pParent = pParent;
+        (leftTaller ? pParent->_pRight : pParent->_pLeft) = k;
+        k->_color = RED;
+        // 下降路径上的每个节点都多了 k 和矮树，先下后上重新计算，之后修复过程中的旋转会自己维护
+        if constexpr (Augment::enabled) {
+            for (Node *pCur = k; pCur; pCur = pCur->_pParent)
+                aug.Update(pCur);
+        }
+        Node *pRoot = tall._root;
+        FixInsert(k, nullptr, pRoot, aug);
+        size_t blackHeight = tall._blackHeight;
+        if (RED == pRoot->_color) {
+            pRoot->_color = BLACK;
+            ++blackHeight;
+        }
+        return {pRoot, blackHeight};
+    }
+
+    /**
+     *  以 pos 为界拆开 pos 所在的树（pTop 为这棵树的根的父节点）：中序在 pos 之前的进入 left，之后的进入 right，
+     *  pos 本身被摘下。从 pos 向上走，每个祖先连同它另一侧的子树合并到对应的一边；
+     *  当前节点 cur 的黑高 height 沿路径累加，兄弟子树的黑高与 cur 相同，不需要再去数
+     * */
+    static void SplitAround(Node *pos, Node *pTop, Subtree &left, Subtree &right, const Augment &aug = Augment()) {
+        size_t height = BlackHeight(pos);
+        size_t childHeight = height - (BLACK == pos->_color ? 1 : 0);
+        left = Detach(pos->_pLeft, childHeight);
+        right = Detach(pos->_pRight, childHeight);
+        Node *pCur = pos;
+        Node *pParent = pos->_pParent;
+        while (pParent != pTop) {
+            Node *pNext = pParent->_pParent;
+            bool parentBlack = BLACK == pParent->_color;
+            if (pCur == pParent->_pLeft)
+                right = Join3(right, pParent, Detach(pParent->_pRight, height), aug);
+            else
+                left = Join3(Detach(pParent->_pLeft, height), pParent, left, aug);
+            if (parentBlack)
+                ++height;
+            pCur = pParent;
+            pParent = pNext;
+        }
+        pos->_pLeft = pos->_pRight = pos->_pParent = nullptr;
+    }
+
+    // 把整棵树摘成独立的子树，树变为空树
+    static Subtree TakeAll(Node *pHead) {
+        Node *pRoot = pHead->_pParent;
+        pHead->_pParent = nullptr;
+        pHead->_pLeft = pHead->_pRight = pHead;
+        return Detach(pRoot, BlackHeight(pRoot));
+    }
+
+    // 用独立的子树替换树的内容，O(log n) 更新最小 / 最大节点
+    static void Install(Subtree tree, Node *pHead) {
+        pHead->_pParent = tree._root;
+        if (tree._root)
+            tree._root->_pParent = pHead;
+        UpdateHead(pHead);
+    }
+
+    // 沿左右脊重新找最小 / 最大节点
+    static void UpdateHead(Node *pHead) {
+        Node *pRoot = pHead->_pParent;
+        if (nullptr == pRoot) {
+            pHead->_pLeft = pHead->_pRight = pHead;
+            return;
+        }
+        Node *pLeft = pRoot;
+        Node *pRight = pRoot;
+        while (pLeft->_pLeft)
+            pLeft = pLeft->_pLeft;
+        while (pRight->_pRight)
+            pRight = pRight->_pRight;
+        pHead->_pLeft = pLeft;
+        pHead->_pRight = pRight;
+    }
+
+    /**
+     *  RotateL左旋，和右旋RotateR是对称操作
+     *  每次旋转都有三次断开和三次重连，要注意其中的一些空节点的判断
+     * */
+    static void RotateL(Node *pParent, Node *pHead, const Augment &aug) {
+        RotateL(pParent, pHead, pHead->_pParent, aug);
+    }
+
+    // pTop 为子树根的父节点（独立的子树时是 nullptr），旋转到子树根时更新 pRoot
+    static void RotateL(Node *pParent, Node *pTop, Node *&pRoot, const Augment &aug) {
+        Node *pSubR = pParent->_pRight;
+        Node *pSubRL = pSubR->_pLeft;
+
+        pParent->_pRight = pSubRL;
+        if (pSubRL)
+            pSubRL->_pParent = pParent;
+
+        pSubR->_pLeft = pParent;
+        Node *pPParent = pParent->_pParent;
+        pParent->_pParent = pSubR;
+        pSubR->_pParent = pPParent;
+
+        // 如果nparent已经是根节点，则左旋之后，pSubR成为新的根节点
+        if (pPParent == pTop) {
+            pRoot = pSubR;
+        } else {
+            // 如果pParent不是根节点，则新的pSubR就会取代原始的nParent的位置
+            if (pParent == pPParent->_pLeft)
+                pPParent->_pLeft = pSubR;
+            else
+                pPParent->_pRight = pSubR;
+        }
+        // 旋转只改变 pParent 和 pSubR 两棵子树的组成，先下后上重新计算
+        aug.Update(pParent);
+        aug.Update(pSubR);
+    }
+
+    // 左右旋是对称的
+    static void RotateR(Node *pParent, Node *pHead, const Augment &aug) {
+        RotateR(pParent, pHead, pHead->_pParent, aug);
+    }
+
+    static void RotateR(Node *pParent, Node *pTop, Node *&pRoot, const Augment &aug) {
+        Node *pSubL = pParent->_pLeft;
+        Node *pSubLR = pSubL->_pRight;
+
+        pParent->_pLeft = pSubLR;
+        if (pSubLR)
+            pSubLR->_pParent = pParent;
+
+        pSubL->_pRight = pParent;
+        Node *pPParent = pParent->_pParent;
+        pParent->_pParent = pSubL;
+        pSubL->_pParent = pPParent;
+
+        if (pTop == pPParent) {
+            pRoot = pSubL;
+        } else {
+            if (pParent == pPParent->_pLeft)
+                pPParent->_pLeft = pSubL;
+            else
+                pPParent->_pRight = pSubL;
+        }
+        aug.Update(pParent);
+        aug.Update(pSubL);
+    }
+};
+
+/**
+ *  Compare：元素的严格弱序比较器，所有比较都通过它进行，下降时每层只比较一次
+ *  Alloc：元素的分配器，节点内存由它 rebind 出来的节点分配器分配，元素用它构造
+ *  Augment：节点附加信息策略（见 RBTreeNoAugment），默认不维护；RBTreeSizeAugment 提供顺序统计
+ * */
+template<class V, class Compare, class Alloc, class Augment>
 class RBTree {
-    typedef RBTreeNode<V> Node;
+    typedef RBTreeNode<V, Augment> Node;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node> NodeAlloc;
+    typedef RBTreeAlgo<Node, Augment> Algo;
 public:
-    typedef RBTreeIterator<V> iterator;
+    typedef RBTreeIterator<V, Augment> iterator;
+    typedef Compare value_compare;
+    typedef Alloc allocator_type;
+    typedef Augment augment_type;
+    typedef RBTreeNodeTraits<V, NodeAlloc, Alloc, Augment> node_traits;
+    typedef typename node_traits::handle_type node_type;
+    typedef Node *node_pointer;
 
 public:
-    RBTree() {
+    explicit RBTree(const Compare &comp = Compare(), const Alloc &alloc = Alloc(), const Augment &augment = Augment())
+            : _comp(comp), _valueAlloc(alloc), _nodeAlloc(alloc), _augment(augment) {
         /**
          * 这里是构建一个PHead_哨兵节点
          *              字段                  含义
@@ -169,18 +1232,69 @@ public:
          *       _pHead->_pLeft         指向红黑树的最小节点，用于 begin()
          *       _pHead->_pRight        指向红黑树的最大节点，用于 --end()
          *       _pHead                 本身  表示 end()，即遍历的边界
+         * 哨兵节点只分配内存、不构造元素，因此 V 不需要默认构造
          * */
-        _pHead = new Node;
-        _pHead->_pLeft = _pHead;
-        _pHead->_pRight = _pHead;
+        _CreateHead();
+    }
+
+    RBTree(const RBTree &other)
+            : _comp(other._comp),
+              _valueAlloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other._valueAlloc)),
+              _nodeAlloc(_valueAlloc), _augment(other._augment) {
+        _CreateHead();
+        if (other.GetRoot()) {
+            GetRoot() = _Copy(other.GetRoot(), _pHead);
+            _pHead->_pLeft = LeftMost();
+            _pHead->_pRight = RightMost();
+        }
+    }
+
+    // 移动之后 other 仍然是一棵合法的空树
+    RBTree(RBTree &&other)
+            : _comp(other._comp), _valueAlloc(other._valueAlloc), _nodeAlloc(other._nodeAlloc),
+              _augment(other._augment) {
+        _CreateHead();
+        Swap(other);
+    }
+
+    RBTree &operator=(RBTree other) {
+        Swap(other);
+        return *this;
     }
 
     ~RBTree() {
         _Destroy(GetRoot()); // 释放整棵树节点（不包含 _pHead）
-        delete _pHead;       // 释放哨兵节点
+        _nodeAlloc.deallocate(_pHead, 1);   // 释放哨兵节点
         _pHead = nullptr;
     }
 
+    void Swap(RBTree &other) {
+        std::swap(_pHead, other._pHead);
+        std::swap(_comp, other._comp);
+        std::swap(_valueAlloc, other._valueAlloc);
+        std::swap(_nodeAlloc, other._nodeAlloc);
+        std::swap(_augment, other._augment);
+    }
+
+    void Clear() {
+        _Destroy(GetRoot());
+        GetRoot() = nullptr;
+        _pHead->_pLeft = _pHead->_pRight = _pHead;
+    }
+
+    value_compare ValueComp() const {
+        return _comp;
+    }
+
+    allocator_type GetAllocator() const {
+        return _valueAlloc;
+    }
+
+    // 摘下的节点交给 node_handle 时，连同分配器一起交出去，句柄析构时用它们释放节点
+    node_type MakeHandle(Node *pNode) const {
+        return node_traits::make(pNode, _nodeAlloc, _valueAlloc);
+    }
+
     iterator begin() {
         // 最左节点
         return iterator(_pHead->_pLeft, _pHead); /// 最小节点
@@ -191,102 +1305,281 @@ public:
         return iterator(_pHead, _pHead);  /// 哨兵节点
     }
 
-    void Insert(const V &val) {
-        Node *&pRoot = _pHead->_pParent;
-        // 空树的情况
-        if (nullptr == pRoot) {
-            pRoot = new Node(val, BLACK);
-            pRoot->_pParent = _pHead;
-        } else {
-            //按照二叉搜索树得性质插入结点
-            //找待插入节点在二叉搜索树中的位置
-            // 这里采用两个指针的方式，一个指针cur找到新节点需要插入的位置，
-            // 然后另一个指针parent一直跟着当前节点，待找到位置后， 新创建节点的父节点即刚刚跟着的节点parent
-            Node *pCur = pRoot;
-            Node *pParent = _pHead;
-            while (pCur) {
-                pParent = pCur;
-                if (val < pCur->_val)
-                    pCur = pCur->_pLeft;
-                else if (val > pCur->_val)
-                    pCur = pCur->_pRight;
-                else {
-                    /// 在这里进行重复值的插入，如果等于就插入到右边子树上
-                    pCur = pCur->_pRight;
-                }
+    // 插入（允许重复），返回指向新节点的迭代器
+    iterator Insert(const V &val) {
+        return InsertNode(_CreateNode(val));
+    }
 
-            }
+    // 把一个已经存在的节点（例如从另一棵树中摘下的节点）挂到树中，不分配内存
+    iterator InsertNode(Node *pNew) {
+        bool insertLeft = true;
+        Node *pParent = _FindMultiPos(pNew->_val, insertLeft);
+        return _LinkNode(pNew, pParent, insertLeft);
+    }
 
-            //插入新节点
-            pCur = new Node(val);
-            if (val < pParent->_val)
-                pParent->_pLeft = pCur;
-            else
-                pParent->_pRight = pCur;
-            pCur->_pParent = pParent;
-
-            //pParent的颜色是红色，一定违反红黑树的性质
-            // 红黑树的性质：不允许连续红色节点出现
-            while (pParent != _pHead && RED == pParent->_color) {
-                Node *grandFather = pParent->_pParent;
-                if (pParent == grandFather->_pLeft) {
-                    Node *uncle = grandFather->_pRight;
-                    /***
-                     * 情况一：叔叔节点存在且为红色
-                     * 将parent与uncle节点改为黑色，并且将grandfater节点改为红色
-                     * 更新pcur = pgrandfather, pParent = pCur->_pParent;
-                     * 继续向上修复
-                     *
-                     * */
-                    if (uncle && RED == uncle->_color) {
-                        pParent->_color = BLACK;
-                        uncle->_color = BLACK;
-                        grandFather->_color = RED;
-                        pCur = grandFather;
-                        pParent = pCur->_pParent;
-                    } else {
-                        //情况二：叔叔节点不存在或者存在且为黑色
-                        //情况三：pCur是pParent的右孩子
-                        if (pCur == pParent->_pRight) {
-                            RotateL(pParent);
-                            swap(pParent, pCur);
-                        }
-
-                        //情况二：
-                        grandFather->_color = RED;
-                        pParent->_color = BLACK;
-                        RotateR(grandFather);
-                    }
-                } else  // pParent == grandFather->_pRight  与 pParent == grandFather->_pLeft是对称的
-                {
-                    Node *uncle = grandFather->_pLeft;
-                    if (uncle && RED == uncle->_color) {
-                        pParent->_color = BLACK;
-                        uncle->_color = BLACK;
-                        grandFather->_color = RED;
-                        pCur = grandFather;
-                        pParent = pCur->_pParent;
-                    } else {
-                        if (pCur == pParent->_pLeft) {
-                            RotateR(pParent);
-                            swap(pParent, pCur);
-                        }
-
-                        pParent->_color = BLACK;
-                        grandFather->_color = RED;
-                        RotateL(grandFather);
+    /**
+     *  唯一插入：一次下降既判断元素是否已经存在，又确定新节点的挂载位置，
+     *  返回的迭代器直接来自这次下降，不需要插入之后再 Find 一遍
+     *  已经存在等价元素时不分配节点，返回 {已有元素, false}
+     * */
+    template<class Arg>
+    pair<iterator, bool> InsertUnique(Arg &&val) {
+        Node *pParent = _pHead;
+        bool insertLeft = true;
+        if (Node *pExist = _FindUniquePos(val, pParent, insertLeft))
+            return {iterator(pExist, _pHead), false};
+        return {_LinkNode(_CreateNode(std::forward<Arg>(val)), pParent, insertLeft), true};
+    }
 
-                    }
-                }
+    // 节点版本的唯一插入，已经存在等价元素时返回 false，节点仍归调用者所有
+    pair<iterator, bool> InsertUniqueNode(Node *pNew) {
+        Node *pParent = _pHead;
+        bool insertLeft = true;
+        if (Node *pExist = _FindUniquePos(pNew->_val, pParent, insertLeft))
+            return {iterator(pExist, _pHead), false};
+        return {_LinkNode(pNew, pParent, insertLeft), true};
+    }
 
-            }
+    /**
+     *  把 source 中本树没有等价元素的节点转移过来，返回转移的个数
+     *  每个节点只下降一次：没找到等价元素时这次下降同时给出了挂载位置，再把节点从 source 摘下直接挂上去
+     * */
+    size_t MergeUnique(RBTree &source) {
+        if (&source == this)
+            return 0;
+        size_t moved = 0;
+        for (iterator it = source.begin(); it != source.end();) {
+            iterator cur = it++;
+            Node *pParent = _pHead;
+            bool insertLeft = true;
+            if (_FindUniquePos(cur._pNode->_val, pParent, insertLeft))
+                continue;
+            _LinkNode(source.Extract(cur), pParent, insertLeft);
+            ++moved;
+        }
+        return moved;
+    }
+
+    // emplace 需要先构造出元素才能比较，元素已经存在时再把节点销毁
+    template<class... Args>
+    pair<iterator, bool> EmplaceUnique(Args &&... args) {
+        Node *pNew = _CreateNode(std::forward<Args>(args)...);
+        auto res = InsertUniqueNode(pNew);
+        if (!res.second)
+            _DestroyNode(pNew);
+        return res;
+    }
 
+    template<class... Args>
+    iterator EmplaceMulti(Args &&... args) {
+        return InsertNode(_CreateNode(std::forward<Args>(args)...));
+    }
+
+    /**
+     *  带提示位置的插入：新元素恰好应该放在 hint 之前（或 hint 之后）时，直接挂在 hint 或它的前驱下面，
+     *  只需要和相邻的一两个元素比较，不从根开始下降；提示不对时退化成普通插入
+     *  按顺序追加（hint 为 end() 或上一次插入返回的迭代器）时均摊 O(1)
+     * */
+    template<class Arg>
+    pair<iterator, bool> InsertUniqueHint(iterator hint, Arg &&val) {
+        Node *pParent = _pHead;
+        bool insertLeft = true;
+        if (Node *pExist = _FindUniqueHintPos(hint._pNode, val, pParent, insertLeft))
+            return {iterator(pExist, _pHead), false};
+        return {_LinkNode(_CreateNode(std::forward<Arg>(val)), pParent, insertLeft), true};
+    }
+
+    template<class... Args>
+    pair<iterator, bool> EmplaceUniqueHint(iterator hint, Args &&... args) {
+        Node *pNew = _CreateNode(std::forward<Args>(args)...);
+        Node *pParent = _pHead;
+        bool insertLeft = true;
+        if (Node *pExist = _FindUniqueHintPos(hint._pNode, pNew->_val, pParent, insertLeft)) {
+            _DestroyNode(pNew);
+            return {iterator(pExist, _pHead), false};
         }
+        return {_LinkNode(pNew, pParent, insertLeft), true};
+    }
+
+    template<class... Args>
+    iterator EmplaceMultiHint(iterator hint, Args &&... args) {
+        Node *pNew = _CreateNode(std::forward<Args>(args)...);
+        bool insertLeft = true;
+        Node *pParent = _FindMultiHintPos(hint._pNode, pNew->_val, insertLeft);
+        return _LinkNode(pNew, pParent, insertLeft);
+    }
+
+    /**
+     *  批量插入有序区间 [first, last)（必须已按 Compare 升序排列），O(n + m)，不做任何旋转：
+     *  1. 把现有的 n 个节点按中序摊平成一条链表，不分配内存
+     *  2. 和输入做一次归并，只为真正插入的元素分配节点；unique 为 true 时跳过等价元素，
+     *     可重复插入时新元素排在现有的等价元素之后
+     *  3. 从链表按中序重建一棵完全平衡的红黑树
+     *  size 为树中现有的元素个数（由外层容器维护）：往大树里补少量元素（m * log2(n) < n）时
+     *  摊平重建反而更慢，改为用上一个元素的位置作提示逐个插入，见 RBTreeAlgo::InsertHinted
+     *  返回实际插入的元素个数
+     * */
+    template<class InputIt>
+    size_t InsertSorted(InputIt first, InputIt last, bool unique, size_t size) {
+        auto make = [this](const V &val) { return _CreateNode(val); };
+        if (Algo::PreferHintedInsert(first, last, size))
+            return Algo::InsertHinted(_pHead, first, last, unique, _comp, RBTreeIdentity(), make, _augment);
+        size_t inserted = 0;
+        Algo::MergeSorted(_pHead, first, last, unique, _comp, RBTreeIdentity(), make, inserted, _augment);
+        return inserted;
+    }
+
+    /**
+     *  空树从有序区间直接建树（有序容器的 sorted_unique / sorted_equivalent 构造函数使用），一遍完成：
+     *  按中序递归，边读输入边分配节点并挂到最终位置，不需要中间链表
+     *  唯一键容器要求输入没有等价元素；不是前向迭代器时无法预先知道个数，退化为 InsertSorted
+     * */
+    template<class InputIt>
+    size_t BuildSorted(InputIt first, InputIt last, bool unique) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if (GetRoot() || !std::is_base_of<std::forward_iterator_tag, category>::value)
+            return InsertSorted(first, last, unique, 0);     // 不知道现有元素个数，总是归并
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        if (0 == n)
+            return 0;
+        auto make = [&]() {
+            Node *pNode = _CreateNode(*first);
+            ++first;
+            return pNode;
+        };
+        auto destroy = [this](Node *pRoot) { _Destroy(pRoot); };
+        GetRoot() = Algo::BuildSorted(n, _pHead, 0, Algo::RedDepth(n), make, destroy, _augment);
         _pHead->_pLeft = LeftMost();
         _pHead->_pRight = RightMost();
-        /// 根节点的固有性质，染色为黑色
-        pRoot->_color = BLACK;
+        return n;
+    }
+
+    // 删除 pos 指向的节点，返回下一个位置
+    iterator Erase(iterator pos) {
+        iterator next = pos;
+        ++next;
+        _DestroyNode(Extract(pos));
+        return next;
+    }
+
+    // 删除所有与 key 等价的节点，返回删除的个数
+    template<class K>
+    size_t Erase(const K &key) {
+        size_t count = 0;
+        for (iterator it = LowerBound(key), last = UpperBound(key); it != last; ++count)
+            it = Erase(it);
+        return count;
+    }
+
+    // 把 pos 指向的节点从树中摘下（不释放），交给调用者
+    Node *Extract(iterator pos) {
+        Node *pNode = pos._pNode;
+        RebalanceForErase(pNode);
+        pNode->_pLeft = pNode->_pRight = pNode->_pParent = nullptr;
+        return pNode;
+    }
+
+    /**
+     *  查找相关接口：所有比较都通过 Compare 进行，每层只比较一次
+     *  模板参数 K 由外层容器决定：Compare 声明了 is_transparent 时可以是任何能和 V 比较的类型，否则就是 V
+     * */
+    template<class K>
+    iterator Find(const K &key) {
+        Node *pNode = _LowerBound(key);
+        if (pNode != _pHead && !_comp(key, pNode->_val))
+            return iterator(pNode, _pHead);
+        return end();
+    }
 
+    template<class K>
+    size_t Count(const K &key) {
+        if constexpr (Augment::order_statistic)
+            return _RankLessEqual(key) - Rank(key);     // 维护了子树大小时不需要逐个数
+        size_t count = 0;
+        for (iterator it = LowerBound(key), last = UpperBound(key); it != last; ++it)
+            ++count;
+        return count;
+    }
+
+    // 第一个不小于 key 的位置
+    template<class K>
+    iterator LowerBound(const K &key) {
+        return iterator(_LowerBound(key), _pHead);
+    }
+
+    // 第一个大于 key 的位置
+    template<class K>
+    iterator UpperBound(const K &key) {
+        return iterator(_UpperBound(key), _pHead);
+    }
+
+    template<class K>
+    pair<iterator, iterator> EqualRange(const K &key) {
+        return {LowerBound(key), UpperBound(key)};
+    }
+
+    /**
+     *  顺序统计（Augment 为 RBTreeSizeAugment 时可用），都是一次从根开始的下降，O(log n)
+     *  Select(k)：第 k 小的元素（从 0 开始），k 超出范围时返回 end()
+     *  Rank(key)：小于 key 的元素个数，即 LowerBound(key) 的下标
+     *  Rank(pos)：pos 的下标，end() 的下标为元素个数
+     * */
+    iterator Select(size_t k) {
+        static_assert(Augment::order_statistic, "Select requires an order-statistic augmented tree");
+        Node *pCur = GetRoot();
+        while (pCur) {
+            size_t leftSize = Augment::Size(pCur->_pLeft);
+            if (k < leftSize) {
+                pCur = pCur->_pLeft;
+            } else if (k == leftSize) {
+                return iterator(pCur, _pHead);
+            } else {
+                k -= leftSize + 1;
+                pCur = pCur->_pRight;
+            }
+        }
+        return end();
+    }
+
+    template<class K>
+    size_t Rank(const K &key) const {
+        static_assert(Augment::order_statistic, "Rank requires an order-statistic augmented tree");
+        const Node *pCur = GetRoot();
+        size_t rank = 0;
+        while (pCur) {
+            if (_comp(pCur->_val, key)) {
+                rank += Augment::Size(pCur->_pLeft) + 1;
+                pCur = pCur->_pRight;
+            } else {
+                pCur = pCur->_pLeft;
+            }
+        }
+        return rank;
+    }
+
+    size_t Rank(iterator pos) const {
+        static_assert(Augment::order_statistic, "Rank requires an order-statistic augmented tree");
+        const Node *pNode = pos._pNode;
+        if (pNode == _pHead)
+            return Augment::Size(GetRoot());
+        size_t rank = Augment::Size(pNode->_pLeft);
+        for (; pNode->_pParent != _pHead; pNode = pNode->_pParent) {
+            if (pNode == pNode->_pParent->_pRight)
+                rank += Augment::Size(pNode->_pParent->_pLeft) + 1;
+        }
+        return rank;
+    }
+
+    /**
+     *  供利用附加信息剪枝的查询（比如 my::interval_map 的区间重叠查询）直接沿树结构下降：
+     *  根节点（空树为 nullptr）和哨兵（end() 所在的节点），节点可以用 iterator(pNode, HeadNode()) 转成迭代器
+     * */
+    Node *RootNode() const {
+        return _pHead->_pParent;
+    }
+
+    Node *HeadNode() const {
+        return _pHead;
     }
 
     void Inorder() const {
@@ -325,11 +1618,114 @@ public:
     }
 
 private:
+    // 查找与插入位置都转给 RBTreeAlgo，元素本身就是比较的 key
+    Node *_FindMultiPos(const V &val, bool &insertLeft) {
+        return Algo::FindMultiPos(_pHead, val, _comp, RBTreeIdentity(), insertLeft);
+    }
+
+    // 找到等价元素时返回它的节点，否则返回 nullptr，pParent / insertLeft 为新节点的挂载位置
+    template<class K>
+    Node *_FindUniquePos(const K &val, Node *&pParent, bool &insertLeft) {
+        return Algo::FindUniquePos(_pHead, val, _comp, RBTreeIdentity(), pParent, insertLeft);
+    }
+
+    template<class K>
+    Node *_FindUniqueHintPos(Node *pHint, const K &val, Node *&pParent, bool &insertLeft) {
+        return Algo::FindUniqueHintPos(_pHead, pHint, val, _comp, RBTreeIdentity(), pParent, insertLeft);
+    }
+
+    Node *_FindMultiHintPos(Node *pHint, const V &val, bool &insertLeft) {
+        return Algo::FindMultiHintPos(_pHead, pHint, val, _comp, RBTreeIdentity(), insertLeft);
+    }
+
+    /**
+     *  把 pNew 挂到 pParent 的 insertLeft 一侧（pParent 为 _pHead 表示空树），然后修复红黑性质
+     *  最小/最大节点只可能是新节点本身：挂在最左节点的左边或最右节点的右边时 O(1) 更新，不需要重新沿树查找
+     * */
+    iterator _LinkNode(Node *pNew, Node *pParent, bool insertLeft) {
+        Algo::LinkAndRebalance(pNew, pParent, insertLeft, _pHead, _augment);
+        return iterator(pNew, _pHead);
+    }
+
+    // 小于等于 key 的元素个数，即 UpperBound(key) 的下标
+    template<class K>
+    size_t _RankLessEqual(const K &key) const {
+        const Node *pCur = GetRoot();
+        size_t rank = 0;
+        while (pCur) {
+            if (_comp(key, pCur->_val)) {
+                pCur = pCur->_pLeft;
+            } else {
+                rank += Augment::Size(pCur->_pLeft) + 1;
+                pCur = pCur->_pRight;
+            }
+        }
+        return rank;
+    }
+
+    // 中序前驱，pNode 不能是最小节点
+    static Node *Predecessor(Node *pNode) {
+        return Algo::Predecessor(pNode);
+    }
+
+    // 中序后继，pNode 不能是最大节点
+    static Node *Successor(Node *pNode) {
+        return Algo::Successor(pNode);
+    }
+
+    void _CreateHead() {
+        _pHead = _nodeAlloc.allocate(1);
+        _pHead->_pParent = nullptr;
+        _pHead->_pLeft = _pHead;
+        _pHead->_pRight = _pHead;
+        _pHead->_color = RED;
+    }
+
+    // 节点内存由节点分配器分配，元素用元素分配器原地构造
+    template<class... Args>
+    Node *_CreateNode(Args &&... args) {
+        Node *pNode = _nodeAlloc.allocate(1);
+        try {
+            std::allocator_traits<Alloc>::construct(_valueAlloc, std::addressof(pNode->_val),
+                                                    std::forward<Args>(args)...);
+        } catch (...) {
+            _nodeAlloc.deallocate(pNode, 1);
+            throw;
+        }
+        pNode->_pLeft = pNode->_pRight = pNode->_pParent = nullptr;
+        pNode->_color = RED;
+        pNode->_aug = typename Augment::NodeData();
+        return pNode;
+    }
+
+    void _DestroyNode(Node *pNode) {
+        std::allocator_traits<Alloc>::destroy(_valueAlloc, std::addressof(pNode->_val));
+        _nodeAlloc.deallocate(pNode, 1);
+    }
+
     void _Destroy(Node *root) {
         if (!root) return;
         _Destroy(root->_pLeft);
         _Destroy(root->_pRight);
-        delete root;
+        _DestroyNode(root);
+    }
+
+    // 复制以 src 为根的子树（结构和颜色都保持不变），新子树的父节点为 pParent
+    Node *_Copy(const Node *src, Node *pParent) {
+        Node *pNode = _CreateNode(src->_val);
+        pNode->_color = src->_color;
+        pNode->_aug = src->_aug;
+        pNode->_pParent = pParent;
+        try {
+            if (src->_pLeft)
+                pNode->_pLeft = _Copy(src->_pLeft, pNode);
+            if (src->_pRight)
+                pNode->_pRight = _Copy(src->_pRight, pNode);
+        } catch (...) {
+            _Destroy(pNode);
+            throw;
+        }
+        return pNode;
     }
 
     bool _IsValidRBTree(Node *pRoot, size_t blackCount, size_t pathCount) {
@@ -358,6 +1754,21 @@ private:
                _IsValidRBTree(pRoot->_pRight, blackCount, pathCount);
     }
 
+    // 把节点 z 从树中摘下并恢复红黑性质，见 RBTreeAlgo::RebalanceForErase
+    void RebalanceForErase(Node *z) {
+        Algo::RebalanceForErase(z, _pHead, _augment);
+    }
+
+    template<class K>
+    Node *_LowerBound(const K &key) const {
+        return Algo::LowerBound(_pHead, key, _comp, RBTreeIdentity());
+    }
+
+    template<class K>
+    Node *_UpperBound(const K &key) const {
+        return Algo::UpperBound(_pHead, key, _comp, RBTreeIdentity());
+    }
+
     /**
      *  找到红黑树中的最左边的节点（最小的节点）
      * */
@@ -386,60 +1797,6 @@ private:
     }
 
 
-    /**
-     *  RotateL左旋，和右旋RotateR是对称操作
-     *  每次旋转都有三次断开和三次重连，要注意其中的一些空节点的判断
-     * */
-    void RotateL(Node *pParent) {
-        Node *pSubR = pParent->_pRight;
-        Node *pSubRL = pSubR->_pLeft;
-
-        pParent->_pRight = pSubRL;
-        if (pSubRL)
-            pSubRL->_pParent = pParent;
-
-        pSubR->_pLeft = pParent;
-        Node *pPParent = pParent->_pParent;
-        pParent->_pParent = pSubR;
-        pSubR->_pParent = pPParent;
-
-        // 如果nparent已经是根节点，则左旋之后，新的根节点pSubR的父节点是哨兵节点
-        if (pPParent == _pHead) {
-            _pHead->_pParent = pSubR;
-        } else {
-            // 如果pParent不是根节点，则新的pSubR就会取代原始的nParent的位置
-            if (pParent == pPParent->_pLeft)
-                pPParent->_pLeft = pSubR;
-            else
-                pPParent->_pRight = pSubR;
-        }
-
-    }
-
-    // 左右旋是对称的
-    void RotateR(Node *pParent) {
-        Node *pSubL = pParent->_pLeft;
-        Node *pSubLR = pSubL->_pRight;
-
-        pParent->_pLeft = pSubLR;
-        if (pSubLR)
-            pSubLR->_pParent = pParent;
-
-        pSubL->_pRight = pParent;
-        Node *pPParent = pParent->_pParent;
-        pParent->_pParent = pSubL;
-        pSubL->_pParent = pPParent;
-
-        if (_pHead == pPParent) {
-            _pHead->_pParent = pSubL;
-        } else {
-            if (pParent == pPParent->_pLeft)
-                pPParent->_pLeft = pSubL;
-            else
-                pPParent->_pRight = pSubL;
-        }
-    }
-
     // 中序遍历
     void _Inorder(Node *pRoot) {
         if (pRoot) {
@@ -469,4 +1826,8 @@ private:
 
 private:
     Node *_pHead;
+    Compare _comp;
+    Alloc _valueAlloc;
+    NodeAlloc _nodeAlloc;
+    [[no_unique_address]] Augment _augment;     // 附加信息策略，见 RBTreeNoAugment
 };
@@ -8,192 +8,456 @@
 
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include "my_rbtree.h"
+#include "my_node_handle.h"
+#include "memory_/my_allocator.h"
 
 namespace my {
 
-    enum Color {
-        RED, BLACK
-    };
-
-// 节点结构体模板
-    template<class K, class V>
-    struct RBTreeNode {
-        RBTreeNode(const std::pair<const K, V> &val = std::pair<const K, V>(), Color color = RED)
-                : _pLeft(nullptr), _pRight(nullptr), _pParent(nullptr), _val(val), _color(color) {}
-
-        RBTreeNode<K, V> *_pLeft;
-        RBTreeNode<K, V> *_pRight;
-        RBTreeNode<K, V> *_pParent;
-        std::pair<const K, V> _val;
-        Color _color;
-    };
+    template<class K, class V,
+            class Compare = std::less<K>,
+            class Alloc = MyAlloc<std::pair<const K, V>>,
+            class Augment = ::RBTreeNoAugment>
+    class RBTree;
 
-// 迭代器模板
-    template<class K, class V>
-    class RBTreeIterator {
-        using Node = RBTreeNode<K, V>;
-        using value_type = std::pair<const K, V>;  /// 封装只读类型
-        using Self = RBTreeIterator<K, V>;
+// 红黑树模板
+    /// Compare 比较 key，所有比较都通过它进行；Alloc 是元素 pair<const K, V> 的分配器，节点分配器由它 rebind 得到
+    /// 节点、迭代器和旋转 / 修复 / 查找 / 有序建树 / split / join 都来自 my_rbtree.h 的 RBTreeAlgo，
+    /// 这里只负责按 key（pair 的 first）比较、分配与释放节点以及维护元素个数
+    /// Augment 为节点附加信息策略：默认不维护，插入只做修复和计数；::RBTreeSizeAugment 记录子树大小，提供 Select / Rank
+    template<class K, class V, class Compare, class Alloc, class Augment>
+    class RBTree {
+        using value_type = std::pair<const K, V>;
+        using Node = ::RBTreeNode<value_type, Augment>;
+        using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+        using Algo = ::RBTreeAlgo<Node, Augment>;
+        using KeyOf = ::RBTreeSelect1st;
+        using _Subtree = typename Algo::Subtree;
     public:
-        RBTreeIterator(Node *pNode = nullptr, Node *head = nullptr)
-                : _pNode(pNode), _pHead(head) {}
-
-        /// std::map 中底层通常使用 pair<K, V>，然后通过自定义比较器保证 K 不被修改，而不是直接用 const K。
-        std::pair<const K, V> &operator*() { return _pNode->_val; }
+        using iterator = ::RBTreeIterator<value_type, Augment>;
+        using key_compare = Compare;
+        using allocator_type = Alloc;
+        using augment_type = Augment;
+        using node_traits = ::RBTreeNodeTraits<value_type, NodeAlloc, Alloc, Augment>;
+        using node_type = typename node_traits::handle_type;
+
+        explicit RBTree(const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+                : _size(0), _comp(comp), _valueAlloc(alloc), _nodeAlloc(alloc) {
+            _CreateHead();
+        }
 
-        std::pair<const K, V> *operator->() { return &(_pNode->_val); }
+        RBTree(const RBTree &other)
+                : _size(other._size), _comp(other._comp),
+                  _valueAlloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other._valueAlloc)),
+                  _nodeAlloc(_valueAlloc) {
+            _CreateHead();
+            if (other.GetRoot()) {
+                GetRoot() = _Copy(other.GetRoot(), _pHead);
+                Algo::UpdateHead(_pHead);
+            }
+        }
 
-//        value_type& operator*() {
-//            return *reinterpret_cast<value_type*>(&_pNode->_val);
-//        }
-//        value_type* operator->() {
-//            return reinterpret_cast<value_type*>(&_pNode->_val);
-//        }
+        /// 移动之后 other 仍然是一棵合法的空树
+        RBTree(RBTree &&other)
+                : _size(0), _comp(other._comp), _valueAlloc(other._valueAlloc), _nodeAlloc(other._nodeAlloc) {
+            _CreateHead();
+            Swap(other);
+        }
 
-        Self &operator++() {
-            InCreament();
+        RBTree &operator=(RBTree other) {
+            Swap(other);
             return *this;
         }
 
-        Self operator++(int) {
-            Self tmp(*this);
-            InCreament();
-            return tmp;
+        ~RBTree() {
+            _Destroy(GetRoot());
+            _nodeAlloc.deallocate(_pHead, 1);
         }
 
-        bool operator!=(const Self &rhs) const { return _pNode != rhs._pNode; }
+        void Swap(RBTree &other) {
+            std::swap(_pHead, other._pHead);
+            std::swap(_size, other._size);
+            std::swap(_comp, other._comp);
+            std::swap(_valueAlloc, other._valueAlloc);
+            std::swap(_nodeAlloc, other._nodeAlloc);
+        }
 
-        bool operator==(const Self &rhs) const { return _pNode == rhs._pNode; }
+        void Clear() {
+            _Destroy(GetRoot());
+            GetRoot() = nullptr;
+            _pHead->_pLeft = _pHead->_pRight = _pHead;
+            _size = 0;
+        }
 
-    private:
-        void InCreament() {
-            if (_pNode->_pRight) {
-                _pNode = _pNode->_pRight;
-                while (_pNode->_pLeft) _pNode = _pNode->_pLeft;
-            } else {
-                Node *p = _pNode->_pParent;
-                while (_pNode == p->_pRight) {
-                    _pNode = p;
-                    p = p->_pParent;
-                }
-                if (_pNode->_pRight != p)
-                    _pNode = p;
-            }
+        key_compare KeyComp() const { return _comp; }
+
+        allocator_type GetAllocator() const { return _valueAlloc; }
+
+        /// 摘下的节点交给 node_handle 时连同分配器一起交出去，句柄析构时用它们释放节点
+        node_type MakeHandle(Node *node) const {
+            return node_traits::make(node, _nodeAlloc, _valueAlloc);
         }
 
-    private:
-        Node *_pNode;
-        Node *_pHead;
-    };
+        std::pair<iterator, bool> InsertUnique(const std::pair<const K, V> &kv) {
+            return EmplaceUniqueKey(kv.first, kv);
+        }
 
-// 红黑树模板
-    template<class K, class V>
-    class RBTree {
-        using Node = RBTreeNode<K, V>;
-    public:
-        using iterator = RBTreeIterator<K, V>;
+        iterator InsertMulti(const std::pair<const K, V> &kv) {
+            return EmplaceMulti(kv);
+        }
 
-        RBTree() : _size(0) {
-            _pHead = new Node();
-            _pHead->_pLeft = _pHead->_pRight = _pHead;
-            _pHead->_color = RED;
+        /// 唯一插入：先用 key 下降，一次下降既判断 key 是否存在，又确定挂载位置；
+        /// key 不存在时才用 args 构造元素（insert / try_emplace / operator[] 都走这里），返回的迭代器直接来自这次下降
+        template<class... Args>
+        std::pair<iterator, bool> EmplaceUniqueKey(const K &key, Args &&... args) {
+            Node *parent = _pHead;
+            bool insertLeft = true;
+            if (Node *exist = _FindUniquePos(key, parent, insertLeft)) {
+                return {iterator(exist, _pHead), false};
+            }
+            return {_LinkNode(_CreateNode(std::forward<Args>(args)...), parent, insertLeft), true};
         }
 
-        ~RBTree() {
-            _Destroy(GetRoot());
-            delete _pHead;
+        /// emplace 需要先构造出元素才知道 key，key 已存在时再把节点销毁
+        template<class... Args>
+        std::pair<iterator, bool> EmplaceUnique(Args &&... args) {
+            Node *node = _CreateNode(std::forward<Args>(args)...);
+            auto res = InsertUniqueNode(node);
+            if (!res.second) _DestroyNode(node);
+            return res;
         }
 
-        std::pair<iterator, bool> InsertUnique(const std::pair<const K, V> &kv) {
-            Node *&pRoot = _pHead->_pParent;
-            if (!pRoot) {
-                pRoot = new Node(kv, BLACK);
-                pRoot->_pParent = _pHead;
-                _UpdateHead();
-                ++_size;
-                return {iterator(pRoot, _pHead), true};
+        template<class... Args>
+        iterator EmplaceMulti(Args &&... args) {
+            return InsertMultiNode(_CreateNode(std::forward<Args>(args)...));
+        }
+
+        /// 带提示位置的插入：key 恰好落在 hint 和它的前驱（或后继）之间时直接挂到相邻节点下面，不从根开始下降；
+        /// 提示不对时退化成普通插入。按顺序追加（hint 为 end() 或上一次插入的位置）时均摊 O(1)
+        template<class... Args>
+        iterator EmplaceUniqueKeyHint(iterator hint, const K &key, Args &&... args) {
+            Node *parent = _pHead;
+            bool insertLeft = true;
+            if (Node *exist = _FindUniqueHintPos(hint._pNode, key, parent, insertLeft)) {
+                return iterator(exist, _pHead);
             }
+            return _LinkNode(_CreateNode(std::forward<Args>(args)...), parent, insertLeft);
+        }
 
-            Node *cur = pRoot;
+        template<class... Args>
+        iterator EmplaceUniqueHint(iterator hint, Args &&... args) {
+            Node *node = _CreateNode(std::forward<Args>(args)...);
             Node *parent = _pHead;
-            while (cur) {
-                parent = cur;
-                if (kv.first < cur->_val.first) cur = cur->_pLeft;
-                else if (kv.first > cur->_val.first) cur = cur->_pRight;
-                else return {iterator(cur, _pHead), false};
+            bool insertLeft = true;
+            if (Node *exist = _FindUniqueHintPos(hint._pNode, node->_val.first, parent, insertLeft)) {
+                _DestroyNode(node);
+                return iterator(exist, _pHead);
             }
+            return _LinkNode(node, parent, insertLeft);
+        }
 
-            Node *newNode = new Node(kv);
-            if (kv.first < parent->_val.first) parent->_pLeft = newNode;
-            else parent->_pRight = newNode;
-            newNode->_pParent = parent;
+        template<class... Args>
+        iterator EmplaceMultiHint(iterator hint, Args &&... args) {
+            Node *node = _CreateNode(std::forward<Args>(args)...);
+            bool insertLeft = true;
+            Node *parent = _FindMultiHintPos(hint._pNode, node->_val.first, insertLeft);
+            return _LinkNode(node, parent, insertLeft);
+        }
 
-            _FixInsert(newNode);
-            _UpdateHead();
-            ++_size;
-            return {iterator(newNode, _pHead), true};
+        /// 节点版本：挂入一个已经存在的节点（例如从另一棵树摘下的节点），不分配内存
+        /// key 已存在时返回 false，节点仍归调用者所有
+        std::pair<iterator, bool> InsertUniqueNode(Node *node) {
+            Node *parent = _pHead;
+            bool insertLeft = true;
+            if (Node *exist = _FindUniquePos(node->_val.first, parent, insertLeft)) {
+                return {iterator(exist, _pHead), false};
+            }
+            return {_LinkNode(node, parent, insertLeft), true};
         }
 
-        iterator InsertMulti(const std::pair<const K, V> &kv) {
-            Node *&pRoot = _pHead->_pParent;
-            if (!pRoot) {
-                pRoot = new Node(kv, BLACK);
-                pRoot->_pParent = _pHead;
-                _UpdateHead();
+        iterator InsertMultiNode(Node *node) {
+            bool insertLeft = true;
+            Node *parent = _FindMultiPos(node->_val.first, insertLeft);
+            return _LinkNode(node, parent, insertLeft);
+        }
+
+        /**
+         *  批量插入按 key 升序排列的区间 [first, last)，O(n + m)，不做任何旋转：
+         *  现有节点按中序摊平成链表 -> 和输入归并（只为真正插入的元素分配节点）-> 重建成完全平衡的红黑树
+         *  unique 为 true 时跳过等价的 key；可重复插入时新元素排在现有的等价元素之后。返回实际插入的个数
+         *  往大树里补少量元素（m * log2(n) < n）时摊平重建反而更慢，改为用上一个元素的位置作提示逐个插入
+         * */
+        template<class InputIt>
+        size_t InsertSorted(InputIt first, InputIt last, bool unique) {
+            /// 两条路径都在 make 之后立即把节点挂进树（或者在异常时连同已归并的节点重建），所以在这里计数
+            auto make = [this](const auto &val) {
+                Node *node = _CreateNode(val);
                 ++_size;
-                return iterator(pRoot, _pHead);
+                return node;
+            };
+            if (Algo::PreferHintedInsert(first, last, Size())) {
+                return Algo::InsertHinted(_pHead, first, last, unique, _comp, KeyOf(), make);
             }
+            size_t inserted = 0;
+            Algo::MergeSorted(_pHead, first, last, unique, _comp, KeyOf(), make, inserted);
+            return inserted;
+        }
 
-            Node *cur = pRoot;
-            Node *parent = _pHead;
-            while (cur) {
-                parent = cur;
-                if (kv.first < cur->_val.first) cur = cur->_pLeft;
-                else cur = cur->_pRight;
+        /// 空树从有序区间直接建树（sorted_unique / sorted_equivalent 构造函数使用），一遍完成：
+        /// 按中序递归，边读输入边分配节点并挂到最终位置。唯一键要求输入没有重复 key；
+        /// 不是前向迭代器时无法预先知道个数，退化为 InsertSorted
+        template<class InputIt>
+        size_t BuildSorted(InputIt first, InputIt last, bool unique) {
+            using category = typename std::iterator_traits<InputIt>::iterator_category;
+            if (GetRoot() || !std::is_base_of<std::forward_iterator_tag, category>::value) {
+                return InsertSorted(first, last, unique);
             }
+            size_t n = static_cast<size_t>(std::distance(first, last));
+            if (n == 0) return 0;
+            auto make = [&]() {
+                Node *node = _CreateNode(*first);
+                ++first;
+                return node;
+            };
+            auto destroy = [this](Node *root) { _Destroy(root); };
+            GetRoot() = Algo::BuildSorted(n, _pHead, 0, Algo::RedDepth(n), make, destroy);
+            _size = n;
+            Algo::UpdateHead(_pHead);
+            return n;
+        }
 
-            Node *newNode = new Node(kv);
-            if (kv.first < parent->_val.first) parent->_pLeft = newNode;
-            else parent->_pRight = newNode;
-            newNode->_pParent = parent;
+        /// 删除 pos 指向的节点，返回下一个位置
+        iterator Erase(iterator pos) {
+            iterator next = pos;
+            ++next;
+            _DestroyNode(Extract(pos));
+            return next;
+        }
 
-            _FixInsert(newNode);
-            _UpdateHead();
-            ++_size;
-            return iterator(newNode, _pHead);
+        /// 删除所有与 key 等价的节点，返回删除的个数
+        template<class KeyArg>
+        size_t Erase(const KeyArg &key) {
+            size_t count = 0;
+            for (iterator it = LowerBound(key), last = UpperBound(key); it != last; ++count) {
+                it = Erase(it);
+            }
+            return count;
+        }
+
+        /// 把 pos 指向的节点从树中摘下（不释放），交给调用者
+        Node *Extract(iterator pos) {
+            Node *node = pos._pNode;
+            Algo::RebalanceForErase(node, _pHead);
+            node->_pLeft = node->_pRight = node->_pParent = nullptr;
+            --_size;
+            return node;
+        }
+
+        /// 把 source 中的节点转移到本树，unique 为 true 时跳过本树中已存在的 key
+        void Merge(RBTree &source, bool unique) {
+            if (&source == this) return;
+            for (iterator it = source.begin(); it != source.end();) {
+                iterator cur = it++;
+                Node *parent = _pHead;
+                bool insertLeft = true;
+                if (unique) {
+                    if (_FindUniquePos(cur->first, parent, insertLeft)) continue;
+                } else {
+                    parent = _FindMultiPos(cur->first, insertLeft);
+                }
+                _LinkNode(source.Extract(cur), parent, insertLeft);
+            }
+        }
+
+        /**
+         *  split / join / 区间删除：都建立在 RBTreeAlgo::Join3 / SplitAround 上，见 my_rbtree.h
+         *  只改链接和颜色，不分配、不拷贝元素，也不调用 Compare 之外的用户代码，所有迭代器（被删除的除外）都保持有效
+         *  拆分之后两边的元素个数：记录了子树大小（RBTreeSizeAugment）时直接读根，O(1)；
+         *  否则从拆分点同时向两头数，先走到头的一侧就是较小的一侧，只数它，O(min(k, n - k))，插入不为此付出任何代价
+         * */
+        /// 把 key 不小于 key 的元素移到 other（other 原有的元素被释放），O(log n)（不维护子树大小时再加上数较小一侧的时间）
+        template<class KeyArg>
+        void Split(const KeyArg &key, RBTree &other) {
+            other.Clear();
+            Node *pos = _LowerBound(key);
+            if (pos == _pHead) return;
+            if (pos == _pHead->_pLeft) {
+                std::swap(_pHead, other._pHead);
+                std::swap(_size, other._size);
+                return;
+            }
+            size_t moved = 0;
+            if constexpr (!Augment::order_statistic) moved = _CountFrom(pos);
+            _Subtree left, right;
+            Algo::SplitAround(pos, _pHead, left, right);
+            Algo::Install(left, _pHead);
+            Algo::Install(Algo::Join3(_Subtree(), pos, right), other._pHead);
+            if constexpr (Augment::order_statistic) moved = Augment::Size(other.GetRoot());
+            other._size = moved;
+            _size -= moved;
         }
 
-        iterator Find(const K &key) {
-            Node *cur = GetRoot();
-            while (cur) {
-                if (key < cur->_val.first) cur = cur->_pLeft;
-                else if (key > cur->_val.first) cur = cur->_pRight;
-                else return iterator(cur, _pHead);
+        /**
+         *  把 other 的全部元素接到本树，other 变为空
+         *  other 的 key 都大于本树的 key（unique 为 false 时可以等于）或者都小于本树的 key 时 O(log n)：
+         *  摘下 other 的最小（最大）节点作为中间节点直接合并；key 的范围有重叠时退化成逐个转移的 Merge
+         * */
+        void Join(RBTree &other, bool unique) {
+            if (&other == this || !other.GetRoot()) return;
+            if (!GetRoot()) {
+                std::swap(_pHead, other._pHead);
+                std::swap(_size, other._size);
+                return;
+            }
+            const K &otherMin = other._pHead->_pLeft->_val.first;
+            const K &otherMax = other._pHead->_pRight->_val.first;
+            bool append = unique ? _comp(_pHead->_pRight->_val.first, otherMin)
+                                 : !_comp(otherMin, _pHead->_pRight->_val.first);
+            bool prepend = !append && _comp(otherMax, _pHead->_pLeft->_val.first);
+            if (!append && !prepend) {
+                Merge(other, unique);
+                return;
             }
+            Node *pivot = append ? other._pHead->_pLeft : other._pHead->_pRight;
+            other.Extract(iterator(pivot, other._pHead));
+            _Subtree mine = Algo::TakeAll(_pHead);
+            _Subtree theirs = Algo::TakeAll(other._pHead);
+            Algo::Install(append ? Algo::Join3(mine, pivot, theirs) : Algo::Join3(theirs, pivot, mine), _pHead);
+            _size += other._size + 1;
+            other._size = 0;
+        }
+
+        /// 删除 [first, last)：拆出中间一段整体释放，再把两边合并，O(k + log n)，只做 O(log n) 次调整
+        /// 很短的区间（kShortRange 个以内）拆分合并的固定开销比逐个删除还大，仍然逐个删除
+        iterator Erase(iterator first, iterator last) {
+            if (first == last) return last;
+            if (first == begin() && last == end()) {
+                Clear();
+                return last;
+            }
+            iterator probe = first;
+            for (size_t i = 0; i < kShortRange && probe != last; ++i) ++probe;
+            if (probe == last) {
+                while (first != last) first = Erase(first);
+                return last;
+            }
+            Node *pFirst = first._pNode;
+            Node *pLast = last._pNode;
+            _Subtree left, right;
+            Algo::SplitAround(pFirst, _pHead, left, right);
+            Node *removed = right._root;
+            if (pLast != _pHead) {
+                _Subtree middle, rest;
+                Algo::SplitAround(pLast, nullptr, middle, rest);
+                removed = middle._root;
+                left = Algo::Join3(left, pLast, rest);
+            }
+            size_t count = 1 + _DestroyCount(removed);
+            _DestroyNode(pFirst);
+            Algo::Install(left, _pHead);
+            _size -= count;
+            return last;
+        }
+
+        /// 查找相关接口都通过 Compare 比较，每层只比较一次
+        /// KeyArg 由外层容器决定：Compare 声明了 is_transparent 时可以是 const char*、string_view 等异构类型，否则就是 K
+        template<class KeyArg>
+        iterator Find(const KeyArg &key) {
+            Node *node = _LowerBound(key);
+            if (node != _pHead && !_comp(key, node->_val.first)) return iterator(node, _pHead);
             return end();
         }
 
-        size_t Count(const K &key) const {
-            const Node *cur = GetRoot();
+        template<class KeyArg>
+        size_t Count(const KeyArg &key) {
             size_t count = 0;
-            while (cur) {
-                if (key < cur->_val.first) {
-                    cur = cur->_pLeft;
-                } else {
-                    if (!(key < cur->_val.first)) {
-                        ++count;
-                    }
-                    cur = cur->_pRight;
-                }
+            for (auto range = EqualRange(key); range.first != range.second; ++range.first) {
+                ++count;
             }
             return count;
         }
 
+        template<class KeyArg>
+        bool Contains(const KeyArg &key) {
+            return Find(key) != end();
+        }
+
+        /// 第一个不小于 key 的位置
+        template<class KeyArg>
+        iterator LowerBound(const KeyArg &key) {
+            return iterator(_LowerBound(key), _pHead);
+        }
+
+        /// 第一个大于 key 的位置
+        template<class KeyArg>
+        iterator UpperBound(const KeyArg &key) {
+            return iterator(_UpperBound(key), _pHead);
+        }
+
+        template<class KeyArg>
+        std::pair<iterator, iterator> EqualRange(const KeyArg &key) {
+            return {LowerBound(key), UpperBound(key)};
+        }
 
         size_t Size() const { return _size; }
 
+        bool Empty() const { return GetRoot() == nullptr; }
+
+        /**
+         *  顺序统计（Augment 为 ::RBTreeSizeAugment 时可用），都是一次从根开始的下降，O(log n)
+         *  Select(k)：第 k 小的元素（从 0 开始），k 超出范围时返回 end()
+         *  Rank(key)：key 小于 key 的元素个数，即 LowerBound(key) 的下标；Rank(pos)：pos 的下标
+         * */
+        iterator Select(size_t k) {
+            static_assert(Augment::order_statistic, "Select requires an order-statistic augmented tree");
+            Node *node = GetRoot();
+            while (node) {
+                size_t leftSize = Augment::Size(node->_pLeft);
+                if (k < leftSize) {
+                    node = node->_pLeft;
+                } else if (k == leftSize) {
+                    return iterator(node, _pHead);
+                } else {
+                    k -= leftSize + 1;
+                    node = node->_pRight;
+                }
+            }
+            return end();
+        }
+
+        template<class KeyArg>
+        size_t Rank(const KeyArg &key) const {
+            static_assert(Augment::order_statistic, "Rank requires an order-statistic augmented tree");
+            const Node *node = GetRoot();
+            size_t rank = 0;
+            while (node) {
+                if (_comp(node->_val.first, key)) {
+                    rank += Augment::Size(node->_pLeft) + 1;
+                    node = node->_pRight;
+                } else {
+                    node = node->_pLeft;
+                }
+            }
+            return rank;
+        }
+
+        size_t Rank(iterator pos) const {
+            static_assert(Augment::order_statistic, "Rank requires an order-statistic augmented tree");
+            const Node *node = pos._pNode;
+            if (node == _pHead) return _size;
+            size_t rank = Augment::Size(node->_pLeft);
+            for (; node->_pParent != _pHead; node = node->_pParent) {
+                if (node == node->_pParent->_pRight) rank += Augment::Size(node->_pParent->_pLeft) + 1;
+            }
+            return rank;
+        }
+
         iterator begin() { return iterator(_pHead->_pLeft, _pHead); }
 
         iterator end() { return iterator(_pHead, _pHead); }
@@ -203,117 +467,149 @@ namespace my {
             std::cout << "\n";
         }
 
-    private:
-        void _FixInsert(Node *node) {
-            Node *parent = node->_pParent;
-
-            while (parent != _pHead && parent->_color == RED) {
-                Node *grandparent = parent->_pParent;
-
-                if (parent == grandparent->_pLeft) {
-                    Node *uncle = grandparent->_pRight;
-
-                    if (uncle && uncle->_color == RED) {
-                        // Case 1 - recoloring
-                        parent->_color = BLACK;
-                        uncle->_color = BLACK;
-                        grandparent->_color = RED;
-                        node = grandparent;
-                        parent = node->_pParent;
-                    } else {
-                        if (node == parent->_pRight) {
-                            // Case 2 - Left rotate
-                            _RotateLeft(parent);
-                            std::swap(node, parent);
-                        }
-                        // Case 3 - Right rotate
-                        parent->_color = BLACK;
-                        grandparent->_color = RED;
-                        _RotateRight(grandparent);
-                    }
-                } else {
-                    Node *uncle = grandparent->_pLeft;
-
-                    if (uncle && uncle->_color == RED) {
-                        parent->_color = BLACK;
-                        uncle->_color = BLACK;
-                        grandparent->_color = RED;
-                        node = grandparent;
-                        parent = node->_pParent;
-                    } else {
-                        if (node == parent->_pLeft) {
-                            _RotateRight(parent);
-                            std::swap(node, parent);
-                        }
-                        parent->_color = BLACK;
-                        grandparent->_color = RED;
-                        _RotateLeft(grandparent);
-                    }
-                }
-            }
+        /// 检查红黑性质、中序有序、父指针和最小/最大节点是否正确（测试用）
+        bool IsValidRBTree() const {
+            const Node *root = GetRoot();
+            if (!root) return _pHead->_pLeft == _pHead && _pHead->_pRight == _pHead && Size() == 0;
+            if (root->_color != BLACK || root->_pParent != _pHead) return false;
+            const Node *left = root, *right = root;
+            while (left->_pLeft) left = left->_pLeft;
+            while (right->_pRight) right = right->_pRight;
+            if (_pHead->_pLeft != left || _pHead->_pRight != right) return false;
+            size_t count = 0;
+            return _CheckSubtree(root, count) >= 0 && count == Size();
+        }
 
-            GetRoot()->_color = BLACK;
+    private:
+        /// 查找与插入位置都转给 RBTreeAlgo，比较的是 pair 的 first
+        template<class KeyArg>
+        Node *_FindUniquePos(const KeyArg &key, Node *&parent, bool &insertLeft) {
+            return Algo::FindUniquePos(_pHead, key, _comp, KeyOf(), parent, insertLeft);
         }
 
-        void _RotateLeft(Node *x) {
-            Node *y = x->_pRight;
-            x->_pRight = y->_pLeft;
-            if (y->_pLeft) y->_pLeft->_pParent = x;
+        Node *_FindMultiPos(const K &key, bool &insertLeft) {
+            return Algo::FindMultiPos(_pHead, key, _comp, KeyOf(), insertLeft);
+        }
 
-            y->_pParent = x->_pParent;
-            if (x == x->_pParent->_pLeft) {
-                x->_pParent->_pLeft = y;
-            } else if (x == x->_pParent->_pRight) {
-                x->_pParent->_pRight = y;
-            } else {
-                _pHead->_pParent = y; // x 是根节点
-            }
+        Node *_FindUniqueHintPos(Node *hint, const K &key, Node *&parent, bool &insertLeft) {
+            return Algo::FindUniqueHintPos(_pHead, hint, key, _comp, KeyOf(), parent, insertLeft);
+        }
 
-            y->_pLeft = x;
-            x->_pParent = y;
+        Node *_FindMultiHintPos(Node *hint, const K &key, bool &insertLeft) {
+            return Algo::FindMultiHintPos(_pHead, hint, key, _comp, KeyOf(), insertLeft);
         }
 
-        void _RotateRight(Node *x) {
-            Node *y = x->_pLeft;
-            x->_pLeft = y->_pRight;
-            if (y->_pRight) y->_pRight->_pParent = x;
+        template<class KeyArg>
+        Node *_LowerBound(const KeyArg &key) const {
+            return Algo::LowerBound(_pHead, key, _comp, KeyOf());
+        }
 
-            y->_pParent = x->_pParent;
-            if (x == x->_pParent->_pLeft) {
-                x->_pParent->_pLeft = y;
-            } else if (x == x->_pParent->_pRight) {
-                x->_pParent->_pRight = y;
-            } else {
-                _pHead->_pParent = y;
-            }
+        template<class KeyArg>
+        Node *_UpperBound(const KeyArg &key) const {
+            return Algo::UpperBound(_pHead, key, _comp, KeyOf());
+        }
 
-            y->_pRight = x;
-            x->_pParent = y;
+        /// 把 node 挂到 parent 的 insertLeft 一侧（parent 为 _pHead 表示空树），然后修复红黑性质
+        iterator _LinkNode(Node *node, Node *parent, bool insertLeft) {
+            Algo::LinkAndRebalance(node, parent, insertLeft, _pHead);
+            ++_size;
+            return iterator(node, _pHead);
         }
 
         Node *&GetRoot() { return _pHead->_pParent; }
 
         const Node *GetRoot() const { return _pHead->_pParent; }
 
-        void _UpdateHead() {
-            Node *root = GetRoot();
-            if (!root) {
-                _pHead->_pLeft = _pHead->_pRight = _pHead;
-                return;
+        void _CreateHead() {
+            _pHead = _nodeAlloc.allocate(1);
+            _pHead->_pParent = nullptr;
+            _pHead->_pLeft = _pHead->_pRight = _pHead;
+            _pHead->_color = RED;
+        }
+
+        /// 节点内存由节点分配器分配，元素用元素分配器原地构造；哨兵节点不构造元素
+        template<class... Args>
+        Node *_CreateNode(Args &&... args) {
+            Node *node = _nodeAlloc.allocate(1);
+            try {
+                std::allocator_traits<Alloc>::construct(_valueAlloc, std::addressof(node->_val),
+                                                        std::forward<Args>(args)...);
+            } catch (...) {
+                _nodeAlloc.deallocate(node, 1);
+                throw;
             }
-            Node *left = root, *right = root;
-            while (left->_pLeft) left = left->_pLeft;
-            while (right->_pRight) right = right->_pRight;
-            _pHead->_pLeft = left;
-            _pHead->_pRight = right;
+            node->_pLeft = node->_pRight = node->_pParent = nullptr;
+            node->_color = RED;
+            return node;
         }
 
+        void _DestroyNode(Node *node) {
+            std::allocator_traits<Alloc>::destroy(_valueAlloc, std::addressof(node->_val));
+            _nodeAlloc.deallocate(node, 1);
+        }
 
         void _Destroy(Node *node) {
             if (!node) return;
             _Destroy(node->_pLeft);
             _Destroy(node->_pRight);
-            delete node;
+            _DestroyNode(node);
+        }
+
+        /// 释放整棵子树，返回释放的节点个数
+        size_t _DestroyCount(Node *node) {
+            if (!node) return 0;
+            size_t count = 1 + _DestroyCount(node->_pLeft) + _DestroyCount(node->_pRight);
+            _DestroyNode(node);
+            return count;
+        }
+
+        /// 从 pos 到末尾的元素个数（pos 不是第一个元素）：一个迭代器从 pos 往后、一个往前同时走，
+        /// 先走到头的一侧元素较少，另一侧用 _size 减出来，O(min(两侧元素个数))
+        size_t _CountFrom(Node *pos) {
+            iterator fwd(pos, _pHead), bwd(pos, _pHead);
+            iterator first = begin(), last = end();
+            for (size_t steps = 0;; ++steps) {
+                if (++fwd == last) return steps + 1;
+                if (bwd == first) return _size - steps;
+                --bwd;
+            }
+        }
+
+        /// 按原样（结构和颜色）复制子树
+        Node *_Copy(const Node *src, Node *parent) {
+            Node *node = _CreateNode(src->_val);
+            node->_color = src->_color;
+            node->_aug = src->_aug;
+            node->_pParent = parent;
+            try {
+                if (src->_pLeft) node->_pLeft = _Copy(src->_pLeft, node);
+                if (src->_pRight) node->_pRight = _Copy(src->_pRight, node);
+            } catch (...) {
+                _Destroy(node);
+                throw;
+            }
+            return node;
+        }
+
+        /// 返回子树的黑高，不合法时返回 -1
+        int _CheckSubtree(const Node *node, size_t &count) const {
+            if (!node) return 0;
+            ++count;
+            if constexpr (Augment::order_statistic) {
+                if (node->_aug._size != 1 + Augment::Size(node->_pLeft) + Augment::Size(node->_pRight))
+                    return -1;
+            }
+            if (node->_color == RED && ((node->_pLeft && node->_pLeft->_color == RED) ||
+                                        (node->_pRight && node->_pRight->_color == RED)))
+                return -1;
+            if (node->_pLeft && (node->_pLeft->_pParent != node || _comp(node->_val.first, node->_pLeft->_val.first)))
+                return -1;
+            if (node->_pRight && (node->_pRight->_pParent != node || _comp(node->_pRight->_val.first, node->_val.first)))
+                return -1;
+            int lh = _CheckSubtree(node->_pLeft, count);
+            int rh = _CheckSubtree(node->_pRight, count);
+            if (lh < 0 || rh < 0 || lh != rh) return -1;
+            return lh + (node->_color == BLACK ? 1 : 0);
         }
 
         void _Inorder(const Node *node) const {
@@ -324,8 +620,13 @@ namespace my {
         }
 
     private:
+        static constexpr size_t kShortRange = 32;                           /// 区间删除逐个进行的最大长度
+
         Node *_pHead;
         size_t _size;
+        Compare _comp;
+        Alloc _valueAlloc;
+        NodeAlloc _nodeAlloc;
     };
 
 } // namespace my
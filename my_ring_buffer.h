@@ -0,0 +1,529 @@
+/**
+ * @file      my_ring_buffer.h
+ * @brief     [定长环形缓冲区：ring_buffer<T, N>（编译期容量）和 circular_buffer<T, Alloc>（运行期容量），2 的幂掩码取下标，满时覆盖或拒绝]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * ring_buffer / circular_buffer
+ * 有界队列用 deque 时每次访问都要先查 map 再进块，多一次指针跳转；环形缓冲区就是一块连续内存：
+ *      槽位数取不小于容量的 2 的幂，head_ / tail_ 是一直递增、不回绕的计数，元素个数 = tail_ - head_，
+ *      计数 & mask 就是槽位下标，不需要取模，也不会分不清“空”和“满”
+ *      元素在槽位中按需构造，T 不需要默认构造
+ * 满了再 push_back 时的行为由 ring_overflow 决定：
+ *      reject      不插入，push_back 返回 false
+ *      overwrite   丢掉最旧的元素（队头）再插入，返回 true
+ * as_spans() 按顺序给出元素所在的（最多）两段连续内存，可以直接交给 write / send 之类的接口，不需要先拷贝成一段；
+ * 元素是平凡可拷贝类型时还可以用 free_spans() 拿到空闲的两段，直接 read / recv 进去之后 commit(n)
+ * 提供 push_back / pop_front / front / back / size / empty / emplace_back / swap，可以作为 my::queue 的 Sequence，
+ * append / pop_front_n 对应 queue 的 push_range / pop_n
+ */
+
+namespace my {
+
+    /// 满了之后再插入的处理方式
+    enum class ring_overflow {
+        reject,         /// 不插入，返回 false
+        overwrite       /// 丢掉最旧的元素
+    };
+
+    namespace detail {
+
+        /// 按逻辑位置（距队头的偏移）访问的随机访问迭代器
+        template<typename Ring, bool Const>
+        class ring_iterator {
+            template<typename, bool>
+            friend class ring_iterator;
+
+            using ring_pointer = std::conditional_t<Const, const Ring *, Ring *>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename Ring::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+            using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+            ring_iterator() = default;
+
+            ring_iterator(ring_pointer ring, size_t index) : ring_(ring), index_(index) {}
+
+            /// iterator 可以转换成 const_iterator
+            template<bool C = Const, typename = std::enable_if_t<C>>
+            ring_iterator(const ring_iterator<Ring, false> &other) : ring_(other.ring_), index_(other.index_) {}
+
+            reference operator*() const { return (*ring_)[index_]; }
+
+            pointer operator->() const { return &(*ring_)[index_]; }
+
+            reference operator[](difference_type n) const { return (*ring_)[index_ + n]; }
+
+            ring_iterator &operator++() {
+                ++index_;
+                return *this;
+            }
+
+            ring_iterator operator++(int) {
+                ring_iterator temp = *this;
+                ++index_;
+                return temp;
+            }
+
+            ring_iterator &operator--() {
+                --index_;
+                return *this;
+            }
+
+            ring_iterator operator--(int) {
+                ring_iterator temp = *this;
+                --index_;
+                return temp;
+            }
+
+            ring_iterator &operator+=(difference_type n) {
+                index_ += n;
+                return *this;
+            }
+
+            ring_iterator &operator-=(difference_type n) {
+                index_ -= n;
+                return *this;
+            }
+
+            ring_iterator operator+(difference_type n) const { return ring_iterator(ring_, index_ + n); }
+
+            friend ring_iterator operator+(difference_type n, const ring_iterator &it) { return it + n; }
+
+            ring_iterator operator-(difference_type n) const { return ring_iterator(ring_, index_ - n); }
+
+            difference_type operator-(const ring_iterator &other) const {
+                return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+            }
+
+            bool operator==(const ring_iterator &other) const { return index_ == other.index_; }
+
+            bool operator!=(const ring_iterator &other) const { return index_ != other.index_; }
+
+            bool operator<(const ring_iterator &other) const { return index_ < other.index_; }
+
+            bool operator>(const ring_iterator &other) const { return other < *this; }
+
+            bool operator<=(const ring_iterator &other) const { return !(other < *this); }
+
+            bool operator>=(const ring_iterator &other) const { return !(*this < other); }
+
+        private:
+            ring_pointer ring_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        /**
+         *  两种缓冲区共同的部分（CRTP）：Derived 提供
+         *      slots_()        槽位数组的首地址
+         *      mask_()         槽位数 - 1（槽位数是 2 的幂）
+         *      capacity()      最多能放的元素个数，不超过槽位数
+         * */
+        template<typename Derived, typename T, ring_overflow Policy>
+        class ring_base {
+        public:
+            using value_type = T;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using reference = T &;
+            using const_reference = const T &;
+            using pointer = T *;
+            using const_pointer = const T *;
+            using iterator = ring_iterator<Derived, false>;
+            using const_iterator = ring_iterator<Derived, true>;
+
+            static constexpr ring_overflow overflow_policy = Policy;
+
+            size_type size() const { return tail_ - head_; }
+
+            bool empty() const { return tail_ == head_; }
+
+            bool full() const { return size() == derived_().capacity(); }
+
+            /// 下标从队头开始算
+            reference operator[](size_type index) { return *slot_(head_ + index); }
+
+            const_reference operator[](size_type index) const { return *slot_(head_ + index); }
+
+            reference at(size_type index) {
+                if (index >= size()) {
+                    throw std::out_of_range("ring buffer index out of range");
+                }
+                return (*this)[index];
+            }
+
+            const_reference at(size_type index) const {
+                if (index >= size()) {
+                    throw std::out_of_range("ring buffer index out of range");
+                }
+                return (*this)[index];
+            }
+
+            reference front() { return *slot_(head_); }
+
+            const_reference front() const { return *slot_(head_); }
+
+            reference back() { return *slot_(tail_ - 1); }
+
+            const_reference back() const { return *slot_(tail_ - 1); }
+
+            iterator begin() { return iterator(&derived_(), 0); }
+
+            iterator end() { return iterator(&derived_(), size()); }
+
+            const_iterator begin() const { return const_iterator(&derived_(), 0); }
+
+            const_iterator end() const { return const_iterator(&derived_(), size()); }
+
+            /// 在队尾构造一个元素；满时按 Policy 拒绝（返回 false）或者先丢掉队头
+            template<typename... Args>
+            bool emplace_back(Args &&... args) {
+                if (full()) {
+                    if constexpr (Policy == ring_overflow::reject) {
+                        return false;
+                    } else {
+                        if (empty()) {
+                            return false;       /// 容量为 0
+                        }
+                        /// 参数可能引用的就是队头（例如 push_back(front())），先构造好再丢掉队头
+                        T value(std::forward<Args>(args)...);
+                        pop_front();
+                        ::new(static_cast<void *>(slot_(tail_))) T(std::move(value));
+                        ++tail_;
+                        return true;
+                    }
+                }
+                ::new(static_cast<void *>(slot_(tail_))) T(std::forward<Args>(args)...);
+                ++tail_;
+                return true;
+            }
+
+            bool push_back(const T &value) { return emplace_back(value); }
+
+            bool push_back(T &&value) { return emplace_back(std::move(value)); }
+
+            void pop_front() {
+                assert(!empty() && "pop_front on empty ring buffer");
+                std::destroy_at(slot_(head_));
+                ++head_;
+            }
+
+            void pop_back() {
+                assert(!empty() && "pop_back on empty ring buffer");
+                --tail_;
+                std::destroy_at(slot_(tail_));
+            }
+
+            /// 依次插入 [first, last)，返回实际插入的个数（reject 时满了就停下）
+            template<typename InputIt>
+            size_type append(InputIt first, InputIt last) {
+                size_type count = 0;
+                for (; first != last; ++first, ++count) {
+                    if (!emplace_back(*first)) {
+                        break;
+                    }
+                }
+                return count;
+            }
+
+            /// 把队头的 n 个元素按两段连续内存移动到 out 并删除，n 不能超过 size()，返回写完之后的 out
+            template<typename OutputIt>
+            OutputIt pop_front_n(size_type n, OutputIt out) {
+                assert(n <= size() && "pop_front_n: n exceeds size()");
+                auto [first, second] = spans_(head_, n);
+                out = std::move(first.begin(), first.end(), out);
+                out = std::move(second.begin(), second.end(), out);
+                consume(n);
+                return out;
+            }
+
+            /// 删除队头的 n 个元素（通常在 as_spans() 给出的数据被处理完之后调用）
+            void consume(size_type n) {
+                assert(n <= size() && "consume: n exceeds size()");
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    auto [first, second] = spans_(head_, n);
+                    std::destroy(first.begin(), first.end());
+                    std::destroy(second.begin(), second.end());
+                }
+                head_ += n;
+            }
+
+            void clear() {
+                consume(size());
+                head_ = tail_ = 0;
+            }
+
+            /// 按顺序给出所有元素所在的两段连续内存，第二段只在元素绕过数组末尾时非空
+            std::pair<std::span<T>, std::span<T>> as_spans() { return spans_(head_, size()); }
+
+            std::pair<std::span<const T>, std::span<const T>> as_spans() const {
+                auto [first, second] = const_cast<ring_base *>(this)->spans_(head_, size());
+                return {std::span<const T>(first), std::span<const T>(second)};
+            }
+
+            /// 队尾之后空闲的两段内存（只对平凡可拷贝类型开放）：写入之后用 commit(n) 把前 n 个加入队尾
+            template<typename U = T, typename = std::enable_if_t<std::is_trivially_copyable_v<U>>>
+            std::pair<std::span<T>, std::span<T>> free_spans() {
+                return spans_(tail_, derived_().capacity() - size());
+            }
+
+            template<typename U = T, typename = std::enable_if_t<std::is_trivially_copyable_v<U>>>
+            void commit(size_type n) {
+                assert(n <= derived_().capacity() - size() && "commit: n exceeds free space");
+                tail_ += n;
+            }
+
+        protected:
+            /// 从计数 from 开始的 n 个槽位，按数组末尾切成两段
+            std::pair<std::span<T>, std::span<T>> spans_(size_type from, size_type n) {
+                T *slots = derived_().slots_();
+                size_type slotCount = derived_().mask_() + 1;
+                size_type begin = from & derived_().mask_();
+                size_type firstLen = std::min(n, slotCount - begin);
+                return {std::span<T>(slots + begin, firstLen), std::span<T>(slots, n - firstLen)};
+            }
+
+            T *slot_(size_type counter) { return derived_().slots_() + (counter & derived_().mask_()); }
+
+            const T *slot_(size_type counter) const {
+                return derived_().slots_() + (counter & derived_().mask_());
+            }
+
+            /// 把 other 的元素按顺序拷贝 / 移动到空的 *this
+            template<typename Other>
+            void copy_from_(Other &&other) {
+                for (size_type i = 0; i < other.size(); ++i) {
+                    if constexpr (std::is_lvalue_reference_v<Other>) {
+                        emplace_back(other[i]);
+                    } else {
+                        emplace_back(std::move(other[i]));
+                    }
+                }
+            }
+
+            Derived &derived_() { return static_cast<Derived &>(*this); }
+
+            const Derived &derived_() const { return static_cast<const Derived &>(*this); }
+
+            size_type head_ = 0;        /// 队头的计数
+            size_type tail_ = 0;        /// 队尾之后的计数
+        };
+    }
+
+    /// 编译期容量 N 的环形缓冲区，槽位直接放在对象里；N 不是 2 的幂时槽位数向上取整到 2 的幂
+    template<typename T, size_t N, ring_overflow Policy = ring_overflow::reject>
+    class ring_buffer : public detail::ring_base<ring_buffer<T, N, Policy>, T, Policy> {
+        using Base = detail::ring_base<ring_buffer<T, N, Policy>, T, Policy>;
+        friend Base;
+
+        static constexpr size_t slot_count_ = std::bit_ceil(N == 0 ? size_t(1) : N);
+
+    public:
+        using typename Base::size_type;
+
+        ring_buffer() = default;
+
+        ring_buffer(const ring_buffer &other) { this->copy_from_(other); }
+
+        ring_buffer(ring_buffer &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            this->copy_from_(std::move(other));
+        }
+
+        ring_buffer &operator=(const ring_buffer &other) {
+            if (this != &other) {
+                this->clear();
+                this->copy_from_(other);
+            }
+            return *this;
+        }
+
+        ring_buffer &operator=(ring_buffer &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this != &other) {
+                this->clear();
+                this->copy_from_(std::move(other));
+            }
+            return *this;
+        }
+
+        ~ring_buffer() { this->clear(); }
+
+        static constexpr size_type capacity() { return N; }
+
+        /// 元素在对象内部，只能逐个交换，O(size())
+        void swap(ring_buffer &other) {
+            ring_buffer temp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+    private:
+        T *slots_() { return std::launder(reinterpret_cast<T *>(storage_)); }
+
+        const T *slots_() const { return std::launder(reinterpret_cast<const T *>(storage_)); }
+
+        static constexpr size_type mask_() { return slot_count_ - 1; }
+
+        alignas(T) unsigned char storage_[sizeof(T) * slot_count_];
+    };
+
+    /// 运行期容量的环形缓冲区，槽位数组由 Alloc 分配，槽位数是不小于容量的 2 的幂
+    template<typename T, typename Alloc = std::allocator<T>, ring_overflow Policy = ring_overflow::reject>
+    class circular_buffer : public detail::ring_base<circular_buffer<T, Alloc, Policy>, T, Policy> {
+        using Base = detail::ring_base<circular_buffer<T, Alloc, Policy>, T, Policy>;
+        using alloc_traits = std::allocator_traits<Alloc>;
+        friend Base;
+
+    public:
+        using typename Base::size_type;
+        using allocator_type = Alloc;
+
+        /// 容量为 0，用 set_capacity 设置容量之后才能插入
+        circular_buffer() = default;
+
+        explicit circular_buffer(size_type capacity, const Alloc &alloc = Alloc()) : alloc_(alloc) {
+            allocate_(capacity);
+        }
+
+        circular_buffer(const circular_buffer &other)
+                : alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+            allocate_(other.capacity_);
+            this->copy_from_(other);
+        }
+
+        circular_buffer(circular_buffer &&other) noexcept : alloc_(std::move(other.alloc_)) {
+            steal_(other);
+        }
+
+        /// 赋值按分配器的传播属性处理：数组总是由分配它的分配器释放
+        circular_buffer &operator=(const circular_buffer &other) {
+            if (this != &other) {
+                constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+                circular_buffer temp(other.capacity_, propagate ? other.alloc_ : alloc_);
+                temp.copy_from_(other);
+                swap_with_alloc_(temp);
+            }
+            return *this;
+        }
+
+        /// 不传播且分配器不相等时不能接管 other 的数组，只能逐个移动元素
+        circular_buffer &operator=(circular_buffer &&other) noexcept(
+                alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+            if (this == &other) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                release_();
+                alloc_ = std::move(other.alloc_);
+                steal_(other);
+            } else {
+                if (alloc_ == other.alloc_) {
+                    release_();
+                    steal_(other);
+                } else {
+                    circular_buffer temp(other.capacity_, alloc_);
+                    temp.copy_from_(std::move(other));
+                    swap_with_alloc_(temp);
+                }
+            }
+            return *this;
+        }
+
+        ~circular_buffer() { release_(); }
+
+        size_type capacity() const { return capacity_; }
+
+        allocator_type get_allocator() const { return alloc_; }
+
+        /// 改变容量，元素按顺序搬到新的数组；新容量小于 size() 时丢掉最旧的元素
+        /// 先把要保留的元素搬进新数组，全部成功之后才交换，丢掉的元素随旧数组一起析构；
+        /// 移动构造可能抛异常时改为拷贝，中途抛出时本对象保持原样
+        void set_capacity(size_type capacity) {
+            circular_buffer temp(capacity, alloc_);
+            size_type size = this->size();
+            for (size_type i = size > capacity ? size - capacity : 0; i < size; ++i) {
+                temp.emplace_back(std::move_if_noexcept((*this)[i]));
+            }
+            swap_with_alloc_(temp);
+        }
+
+        /// 与标准容器相同：分配器不传播时要求两边的分配器相等，否则数组会被另一个分配器释放
+        void swap(circular_buffer &other) noexcept {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                swap_with_alloc_(other);
+            } else {
+                assert(alloc_ == other.alloc_ && "swap of circular_buffers with unequal allocators");
+                swap_storage_(other);
+            }
+        }
+
+    private:
+        T *slots_() { return slots_ptr_; }
+
+        const T *slots_() const { return slots_ptr_; }
+
+        size_type mask_() const { return mask_value_; }
+
+        void allocate_(size_type capacity) {
+            size_type slotCount = std::bit_ceil(capacity == 0 ? size_type(1) : capacity);
+            slots_ptr_ = alloc_traits::allocate(alloc_, slotCount);
+            mask_value_ = slotCount - 1;
+            capacity_ = capacity;
+        }
+
+        void release_() {
+            if (slots_ptr_) {
+                this->clear();
+                alloc_traits::deallocate(alloc_, slots_ptr_, mask_value_ + 1);
+                slots_ptr_ = nullptr;
+            }
+        }
+
+        void swap_storage_(circular_buffer &other) noexcept {
+            using std::swap;
+            swap(slots_ptr_, other.slots_ptr_);
+            swap(mask_value_, other.mask_value_);
+            swap(capacity_, other.capacity_);
+            swap(this->head_, other.head_);
+            swap(this->tail_, other.tail_);
+        }
+
+        /// 数组连同分配它的分配器一起交换，两边的分配器不相等时也安全
+        void swap_with_alloc_(circular_buffer &other) noexcept {
+            using std::swap;
+            swap_storage_(other);
+            swap(alloc_, other.alloc_);
+        }
+
+        void steal_(circular_buffer &other) {
+            slots_ptr_ = std::exchange(other.slots_ptr_, nullptr);
+            mask_value_ = std::exchange(other.mask_value_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            this->head_ = std::exchange(other.head_, 0);
+            this->tail_ = std::exchange(other.tail_, 0);
+        }
+
+        Alloc alloc_;
+        T *slots_ptr_ = nullptr;
+        size_type mask_value_ = 0;
+        size_type capacity_ = 0;
+    };
+}
@@ -8,21 +8,55 @@
 #pragma once
 
 #include "my_rbtree.h"
+#include "my_sorted_tag.h"
+#include <initializer_list>
 
 namespace my {
 
-    template<typename T>
+    /// Compare 为元素的比较器（默认 std::less<T>），Alloc 为元素分配器，节点内存也经由它分配
+    /// Augment 为红黑树节点的附加信息策略：默认不维护；::RBTreeSizeAugment 维护子树大小，提供 select / rank
+    template<typename T,
+            typename Compare = std::less<T>,
+            typename Alloc = MyAlloc<T>,
+            typename Augment = ::RBTreeNoAugment>
     class set {
-        using tree_type = RBTree<T>;
+        using tree_type = ::RBTree<T, Compare, Alloc, Augment>;
     public:
         using key_type = T;
         using value_type = T;
         using size_type = size_t;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using allocator_type = Alloc;
         using iterator = typename tree_type::iterator;
+        using node_type = typename tree_type::node_type;
+        using insert_return_type = my::node_insert_return<iterator, node_type>;
 
         /// 构造函数
         set() = default;
 
+        explicit set(const Compare &comp, const Alloc &alloc = Alloc()) : tree_(comp, alloc) {}
+
+        explicit set(const Alloc &alloc) : tree_(Compare(), alloc) {}
+
+        /// 输入已按 Compare 升序排列（没有重复）：O(n) 直接建成一棵完全平衡的红黑树
+        template<typename InputIt>
+        set(sorted_unique_t, InputIt first, InputIt last,
+            const Compare &comp = Compare(), const Alloc &alloc = Alloc()) : tree_(comp, alloc) {
+            size_ = tree_.BuildSorted(first, last, true);
+        }
+
+        set(sorted_unique_t tag, std::initializer_list<value_type> ilist,
+            const Compare &comp = Compare(), const Alloc &alloc = Alloc())
+                : set(tag, ilist.begin(), ilist.end(), comp, alloc) {}
+
+        /// 批量插入有序区间，O(min(size() + n, n log size()))：现有节点和新元素归并之后整棵树重建
+        /// （n 很小时改为逐个带提示插入），现有元素的地址不变
+        template<typename InputIt>
+        void insert_sorted(InputIt first, InputIt last) {
+            size_ += tree_.InsertSorted(first, last, true, size_);
+        }
+
         template<typename InputIt>
         set(InputIt first, InputIt last) {
             for (; first != last; ++first) {
@@ -41,38 +75,176 @@ namespace my {
         size_type size() const { return size_; }
 
         /// 修改器
+        /// 插入只下降一次：元素已存在时不分配节点，返回的迭代器直接来自这次下降
         std::pair<iterator, bool> insert(const value_type &val) {
-            bool inserted = tree_.Insert(val);
-            if (inserted) ++size_;
-            return {find(val), inserted};
+            auto res = tree_.InsertUnique(val);
+            size_ += res.second;
+            return res;
+        }
+
+        std::pair<iterator, bool> insert(value_type &&val) {
+            auto res = tree_.InsertUnique(std::move(val));
+            size_ += res.second;
+            return res;
+        }
+
+        /// 带提示的插入：新元素紧挨在 hint 之前或之后时均摊 O(1)，按递增顺序追加时用 end() 作提示即可
+        iterator insert(iterator hint, const value_type &val) {
+            auto res = tree_.InsertUniqueHint(hint, val);
+            size_ += res.second;
+            return res.first;
+        }
+
+        iterator insert(iterator hint, value_type &&val) {
+            auto res = tree_.InsertUniqueHint(hint, std::move(val));
+            size_ += res.second;
+            return res.first;
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            auto res = tree_.EmplaceUnique(std::forward<Args>(args)...);
+            size_ += res.second;
+            return res;
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(iterator hint, Args &&... args) {
+            auto res = tree_.EmplaceUniqueHint(hint, std::forward<Args>(args)...);
+            size_ += res.second;
+            return res.first;
         }
 
         void clear() {
-            tree_ = tree_type(); /// 直接重置红黑树
+            tree_.Clear();  /// 释放所有节点，比较器和分配器保持不变
             size_ = 0;
         }
 
         size_type erase(const value_type &val) {
-            /// 目前的红黑树不支持删除，这里先不实现
-            return 0;
+            size_type n = tree_.Erase(val);
+            size_ -= n;
+            return n;
+        }
+
+        iterator erase(iterator pos) {
+            --size_;
+            return tree_.Erase(pos);
+        }
+
+        /// 节点操作：摘下的节点可以原样插入另一个 set，不重新分配也不拷贝元素
+        node_type extract(iterator pos) {
+            --size_;
+            return tree_.MakeHandle(tree_.Extract(pos));
+        }
+
+        node_type extract(const value_type &val) {
+            iterator it = find(val);
+            if (it == end()) return node_type();
+            return extract(it);
+        }
+
+        /// 已存在等价元素时插入失败，节点原样留在返回值的 node 中
+        insert_return_type insert(node_type &&nh) {
+            if (nh.empty()) return {end(), false, node_type()};
+            auto [it, inserted] = tree_.InsertUniqueNode(tree_type::node_traits::get(nh));
+            if (!inserted) return {it, false, std::move(nh)};
+            tree_type::node_traits::release(nh);
+            ++size_;
+            return {it, true, node_type()};
+        }
+
+        /// 把 source 中本容器没有的元素的节点全部转移过来
+        /// 每个节点只下降一次：查找等价元素的同一次下降给出挂载位置
+        void merge(set &source) {
+            size_t moved = tree_.MergeUnique(source.tree_);
+            source.size_ -= moved;
+            size_ += moved;
         }
 
         void swap(set &other) {
-            std::swap(tree_, other.tree_);
+            tree_.Swap(other.tree_);
             std::swap(size_, other.size_);
         }
 
-        /// 查找
-        iterator find(const value_type &val) {
-            for (auto it = begin(); it != end(); ++it) {
-                if (*it == val)
-                    return it;
-            }
-            return end();
+        key_compare key_comp() const { return tree_.ValueComp(); }
+
+        value_compare value_comp() const { return tree_.ValueComp(); }
+
+        allocator_type get_allocator() const { return tree_.GetAllocator(); }
+
+        /// 查找：在红黑树上二分下降，O(log n)；Compare 声明了 is_transparent（如 std::less<>）时支持异构 key
+        iterator find(const key_type &key) {
+            return tree_.Find(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator find(const K &key) {
+            return tree_.Find(key);
+        }
+
+        size_type count(const key_type &key) {
+            return tree_.Count(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_type count(const K &key) {
+            return tree_.Count(key);
+        }
+
+        bool contains(const key_type &key) {
+            return tree_.Find(key) != end();
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        bool contains(const K &key) {
+            return tree_.Find(key) != end();
+        }
+
+        iterator lower_bound(const key_type &key) {
+            return tree_.LowerBound(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator lower_bound(const K &key) {
+            return tree_.LowerBound(key);
+        }
+
+        iterator upper_bound(const key_type &key) {
+            return tree_.UpperBound(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        iterator upper_bound(const K &key) {
+            return tree_.UpperBound(key);
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type &key) {
+            return tree_.EqualRange(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        std::pair<iterator, iterator> equal_range(const K &key) {
+            return tree_.EqualRange(key);
+        }
+
+        /// 顺序统计（Augment 为 ::RBTreeSizeAugment 时可用），O(log n)，不需要从 begin() 走 k 步
+        /// select(k)：第 k 小的元素（从 0 开始），k >= size() 时返回 end()
+        iterator select(size_type k) {
+            return tree_.Select(k);
+        }
+
+        /// rank(key)：小于 key 的元素个数；rank(pos)：pos 的下标
+        size_type rank(const key_type &key) const {
+            return tree_.Rank(key);
+        }
+
+        template<typename K, typename C = Compare, typename = my::enable_if_t<has_is_transparent_v<C>>>
+        size_type rank(const K &key) const {
+            return tree_.Rank(key);
         }
 
-        size_type count(const value_type &val) {
-            return find(val) != end() ? 1 : 0;
+        size_type rank(iterator pos) const {
+            return tree_.Rank(pos);
         }
 
         /// 比较
@@ -102,4 +274,9 @@ namespace my {
         size_type size_ = 0;
     };
 
+    /// 维护子树大小的 set：percentile / 排行榜这类按名次的查询为 O(log n)
+    template<typename T,
+            typename Compare = std::less<T>,
+            typename Alloc = MyAlloc<T>>
+    using order_statistic_set = set<T, Compare, Alloc, ::RBTreeSizeAugment>;
 }
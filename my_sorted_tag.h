@@ -0,0 +1,25 @@
+/**
+ * @file      my_sorted_tag.h
+ * @brief     [有序输入标签：告诉有序容器输入区间已经排好序，可以线性时间批量构建]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+namespace my {
+
+    /// 输入已按容器的比较器升序排列且没有等价元素（用于 map / set 等唯一键容器）
+    struct sorted_unique_t {
+        explicit sorted_unique_t() = default;
+    };
+
+    inline constexpr sorted_unique_t sorted_unique{};
+
+    /// 输入已按容器的比较器升序排列，可以有等价元素（用于 multimap / multiset 等可重复键容器）
+    struct sorted_equivalent_t {
+        explicit sorted_equivalent_t() = default;
+    };
+
+    inline constexpr sorted_equivalent_t sorted_equivalent{};
+}
@@ -0,0 +1,345 @@
+/**
+ * @file      my_spsc_queue.h
+ * @brief     [单生产者单消费者的无等待有界队列：缓存行隔离的头尾下标、缓存的对端下标、批量入队出队、可选的 futex 阻塞等待]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_futex.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * spsc_queue<T, Blocking>
+ * 只允许一个线程入队（生产者）、一个线程出队（消费者），每个操作都是固定步数完成的（wait-free），不需要任何锁
+ * 下标：tail_ 只由生产者写，head_ 只由消费者写，两个都是单调递增的计数，槽位是 计数 & mask_
+ *      tail_ - head_ 就是元素个数，计数溢出回绕时差值仍然正确
+ * 伪共享：生产者用到的 tail_ 和消费者用到的 head_ 分别放在独立的缓存行上
+ * 缓存的对端下标：生产者保存一份上次读到的 head_（headCache_），只有按缓存看起来已满时才重新读 head_；
+ *      消费者同理保存 tailCache_。队列不满不空时，一次操作只碰自己这一侧的缓存行，对端的缓存行不会被来回拉扯
+ * 内存序：生产者先构造元素，再以 release 写 tail_；消费者以 acquire 读 tail_ 之后才读元素；出队方向对称
+ * 批量操作：try_push_n / try_pop_n 一次搬运多个元素，最后只发布一次下标
+ * 阻塞等待（Blocking = true）：push / pop 先自旋一段时间，仍然满 / 空时在 futex 上睡眠，具体协议见 wait_for_data_ 的注释
+ *      Blocking = false 时完全不包含等待相关的成员和开销，调用方自己决定如何等待
+ */
+
+namespace my {
+
+    template<typename T, bool Blocking = false>
+    class spsc_queue {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+
+        static constexpr bool is_blocking = Blocking;
+
+        /// 至少能容纳 capacity 个元素；内部槽位数向上取 2 的幂，满的判断仍按 capacity 进行
+        explicit spsc_queue(size_type capacity)
+                : capacity_(capacity),
+                  mask_(std::bit_ceil(capacity) - 1) {
+            if (capacity == 0) {
+                throw std::invalid_argument("spsc_queue capacity must be positive");
+            }
+            slots_ = std::allocator<T>().allocate(mask_ + 1);
+        }
+
+        spsc_queue(const spsc_queue &) = delete;
+
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        ~spsc_queue() {
+            size_type head = consumer_.head_.load(std::memory_order_relaxed);
+            size_type tail = producer_.tail_.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::destroy_at(slots_ + (head & mask_));
+            }
+            std::allocator<T>().deallocate(slots_, mask_ + 1);
+        }
+
+        size_type capacity() const noexcept { return capacity_; }
+
+        /// 元素个数的近似值：两个下标不是同时读到的，只在没有并发修改时精确
+        size_type size_approx() const noexcept {
+            size_type head = consumer_.head_.load(std::memory_order_acquire);
+            size_type tail = producer_.tail_.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        bool empty_approx() const noexcept { return size_approx() == 0; }
+
+        // ---------------- 生产者 ----------------
+
+        /// 队列已满时返回 false，不构造元素
+        template<typename... Args>
+        bool try_emplace(Args &&... args) {
+            size_type tail = producer_.tail_.load(std::memory_order_relaxed);
+            if (tail - producer_.headCache_ == capacity_) {
+                producer_.headCache_ = consumer_.head_.load(std::memory_order_acquire);
+                if (tail - producer_.headCache_ == capacity_) {
+                    return false;
+                }
+            }
+            std::construct_at(slots_ + (tail & mask_), std::forward<Args>(args)...);
+            producer_.tail_.store(tail + 1, std::memory_order_release);
+            notify_consumer_();
+            return true;
+        }
+
+        bool try_push(const T &value) { return try_emplace(value); }
+
+        bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+        /// 从 first 开始最多入队 n 个元素，返回实际入队的个数（受剩余空间限制），所有元素一次性发布
+        template<typename InputIt>
+        size_type try_push_n(InputIt first, size_type n) {
+            return push_some_(first, n);
+        }
+
+        // ---------------- 消费者 ----------------
+
+        /// 队列为空时返回 false
+        bool try_pop(T &out) {
+            T *slot = front();
+            if (slot == nullptr) {
+                return false;
+            }
+            out = std::move(*slot);
+            pop_front();
+            return true;
+        }
+
+        /// 队首元素的地址，队列为空时返回 nullptr；元素留在队列里直到 pop_front，可以就地读取，省去一次移动
+        T *front() {
+            size_type head = consumer_.head_.load(std::memory_order_relaxed);
+            if (head == consumer_.tailCache_) {
+                consumer_.tailCache_ = producer_.tail_.load(std::memory_order_acquire);
+                if (head == consumer_.tailCache_) {
+                    return nullptr;
+                }
+            }
+            return slots_ + (head & mask_);
+        }
+
+        /// 丢弃队首元素，调用前 front() 必须返回过非空
+        void pop_front() {
+            size_type head = consumer_.head_.load(std::memory_order_relaxed);
+            std::destroy_at(slots_ + (head & mask_));
+            consumer_.head_.store(head + 1, std::memory_order_release);
+            notify_producer_();
+        }
+
+        /// 最多出队 max 个元素依次写入 out，返回实际出队的个数；腾出的空间一次性还给生产者
+        template<typename OutputIt>
+        size_type try_pop_n(OutputIt out, size_type max) {
+            size_type head = consumer_.head_.load(std::memory_order_relaxed);
+            size_type avail = consumer_.tailCache_ - head;
+            if (avail < max) {
+                consumer_.tailCache_ = producer_.tail_.load(std::memory_order_acquire);
+                avail = consumer_.tailCache_ - head;
+            }
+            size_type count = max < avail ? max : avail;
+            for (size_type i = 0; i < count; ++i, ++out) {
+                T *slot = slots_ + ((head + i) & mask_);
+                *out = std::move(*slot);
+                std::destroy_at(slot);
+            }
+            if (count != 0) {
+                consumer_.head_.store(head + count, std::memory_order_release);
+                notify_producer_();
+            }
+            return count;
+        }
+
+        // ---------------- 阻塞接口（仅 Blocking = true） ----------------
+
+        /// 队列满时等待空间
+        template<typename... Args>
+        void emplace(Args &&... args) requires Blocking {
+            for (unsigned spin = 0;; ++spin) {
+                if (try_emplace(std::forward<Args>(args)...)) {
+                    return;
+                }
+                wait_for_space_(spin);
+            }
+        }
+
+        void push(const T &value) requires Blocking { emplace(value); }
+
+        void push(T &&value) requires Blocking { emplace(std::move(value)); }
+
+        /// 队列空时等待数据
+        void pop(T &out) requires Blocking {
+            for (unsigned spin = 0;; ++spin) {
+                if (try_pop(out)) {
+                    return;
+                }
+                wait_for_data_(spin);
+            }
+        }
+
+        /// 入队全部 n 个元素，空间不够时分批进行，中间等待消费者腾出空间
+        template<typename InputIt>
+        void push_n(InputIt first, size_type n) requires Blocking {
+            unsigned spin = 0;
+            while (n != 0) {
+                size_type pushed = push_some_(first, n);
+                if (pushed == 0) {
+                    wait_for_space_(spin++);
+                    continue;
+                }
+                n -= pushed;
+                spin = 0;
+            }
+        }
+
+        /// 等到至少有一个元素，然后最多出队 max 个，返回出队的个数
+        template<typename OutputIt>
+        size_type pop_n(OutputIt out, size_type max) requires Blocking {
+            if (max == 0) {
+                return 0;
+            }
+            for (unsigned spin = 0;; ++spin) {
+                size_type popped = try_pop_n(out, max);
+                if (popped != 0) {
+                    return popped;
+                }
+                wait_for_data_(spin);
+            }
+        }
+
+    private:
+        /// try_push_n 的实现；first 按引用传入并前进到最后一个入队元素之后，push_n 分批时可以接着用（也支持单遍输入迭代器）
+        template<typename InputIt>
+        size_type push_some_(InputIt &first, size_type n) {
+            size_type tail = producer_.tail_.load(std::memory_order_relaxed);
+            size_type room = capacity_ - (tail - producer_.headCache_);
+            if (room < n) {
+                producer_.headCache_ = consumer_.head_.load(std::memory_order_acquire);
+                room = capacity_ - (tail - producer_.headCache_);
+            }
+            size_type count = n < room ? n : room;
+            size_type i = 0;
+            try {
+                for (; i < count; ++i, ++first) {
+                    std::construct_at(slots_ + ((tail + i) & mask_), *first);
+                }
+            } catch (...) {
+                /// 还没有发布，消费者看不到这些元素，直接析构
+                for (size_type j = 0; j < i; ++j) {
+                    std::destroy_at(slots_ + ((tail + j) & mask_));
+                }
+                throw;
+            }
+            if (count != 0) {
+                producer_.tail_.store(tail + count, std::memory_order_release);
+                notify_consumer_();
+            }
+            return count;
+        }
+
+        /// 阻塞模式下先自旋这么多轮再睡眠；自旋到 64 轮之后 spin_backoff 会让出时间片
+        static constexpr unsigned kSpinBeforePark_ = 128;
+
+        /// 等待状态，Blocking = false 时是空结构体，不占空间
+        struct wait_state_off {
+        };
+
+        /// 两个 futex 字（事件计数）和两个“有人在睡”的标志；只在真的有人睡眠时才会被写，放在单独的缓存行上
+        struct alignas(detail::cache_line_size) wait_state_on {
+            std::atomic<uint32_t> dataSeq_{0};
+            std::atomic<uint32_t> spaceSeq_{0};
+            std::atomic<uint32_t> consumerWaiting_{0};
+            std::atomic<uint32_t> producerWaiting_{0};
+        };
+
+        /**
+         * 睡眠协议（Dekker 式的“先宣告、再检查”）：
+         *      消费者：seq = dataSeq_; consumerWaiting_ = 1; seq_cst 栅栏; 再看一次队列，仍为空才 futex_wait(dataSeq_, seq)
+         *      生产者：发布 tail_; seq_cst 栅栏; 看到 consumerWaiting_ 才 dataSeq_ += 1 并唤醒
+         * 两个栅栏保证：要么消费者的再次检查看到了新的 tail_，要么生产者看到了等待标志；
+         *      生产者递增 dataSeq_ 发生在消费者读 seq 之后，futex_wait 发现值已变化会立即返回，不会丢失唤醒
+         * 等待空间的方向完全对称
+         */
+        void wait_for_data_(unsigned spin) {
+            if (spin < kSpinBeforePark_) {
+                detail::spin_backoff(spin);
+                return;
+            }
+            uint32_t seq = wait_.dataSeq_.load(std::memory_order_acquire);
+            wait_.consumerWaiting_.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (producer_.tail_.load(std::memory_order_relaxed) ==
+                consumer_.head_.load(std::memory_order_relaxed)) {
+                detail::futex_wait(wait_.dataSeq_, seq);
+            }
+            wait_.consumerWaiting_.store(0, std::memory_order_relaxed);
+        }
+
+        void wait_for_space_(unsigned spin) {
+            if (spin < kSpinBeforePark_) {
+                detail::spin_backoff(spin);
+                return;
+            }
+            uint32_t seq = wait_.spaceSeq_.load(std::memory_order_acquire);
+            wait_.producerWaiting_.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (producer_.tail_.load(std::memory_order_relaxed) -
+                consumer_.head_.load(std::memory_order_relaxed) == capacity_) {
+                detail::futex_wait(wait_.spaceSeq_, seq);
+            }
+            wait_.producerWaiting_.store(0, std::memory_order_relaxed);
+        }
+
+        void notify_consumer_() {
+            if constexpr (Blocking) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (wait_.consumerWaiting_.load(std::memory_order_relaxed)) {
+                    wait_.dataSeq_.fetch_add(1, std::memory_order_release);
+                    detail::futex_wake_one(wait_.dataSeq_);
+                }
+            }
+        }
+
+        void notify_producer_() {
+            if constexpr (Blocking) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (wait_.producerWaiting_.load(std::memory_order_relaxed)) {
+                    wait_.spaceSeq_.fetch_add(1, std::memory_order_release);
+                    detail::futex_wake_one(wait_.spaceSeq_);
+                }
+            }
+        }
+
+        /// 生产者一侧：自己写的 tail_ 和缓存的 head_
+        struct alignas(detail::cache_line_size) producer_side {
+            std::atomic<size_type> tail_{0};
+            size_type headCache_ = 0;
+        };
+
+        /// 消费者一侧：自己写的 head_ 和缓存的 tail_
+        struct alignas(detail::cache_line_size) consumer_side {
+            std::atomic<size_type> head_{0};
+            size_type tailCache_ = 0;
+        };
+
+        /// 只读的共享数据单独占一条缓存行，不和任何一侧的写热点放在一起
+        alignas(detail::cache_line_size) T *slots_ = nullptr;
+        size_type capacity_;
+        size_type mask_;
+        producer_side producer_;
+        consumer_side consumer_;
+        [[no_unique_address]] std::conditional_t<Blocking, wait_state_on, wait_state_off> wait_;
+    };
+}
@@ -0,0 +1,256 @@
+/**
+ * @file      my_static_search_index.h
+ * @brief     [静态有序查找索引：Eytzinger（BFS）布局 + 预取 + 无分支的 lower_bound/upper_bound，支持批量查找]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/**
+ * static_search_index
+ * 对一个建好之后不再修改的有序数组做大量查找时，普通二分有两个问题：
+ *      每一步的比较结果是随机的，分支预测一半失败
+ *      前几步访问的位置彼此相距很远，每一步都是一次缓存未命中，而且下一步的地址要等这一步的比较结果
+ * Eytzinger 布局把有序数组按完全二叉树的层序（BFS）重新排列：下标 k 的左右孩子是 2k 和 2k+1（下标从 1 开始）
+ *      查找就是从 k = 1 开始每层 k = 2k + (b[k] < x)，没有分支，只有一个固定次数的循环
+ *      树的前几层集中在数组开头，总是在缓存中
+ *      k 往下 4 层的 16 个后代 [16k, 16k + 16) 是连续的，数组按缓存行对齐时恰好是一条缓存行（int），
+ *      每一步都把 4 层之后要用的缓存行预取进来，内存延迟和比较重叠
+ *      查找结束时 k 多走了一段“向右”的路径，去掉末尾连续的 1 和最后一个 0 就是答案节点
+ * 查找结果用原有序数组中的下标（名次）表示，可以直接作为调用者原来的 my::vector（或与它平行的其他数组）的下标，
+ * 名次由 Eytzinger 下标用位运算 O(1) 算出，不需要额外存一份名次数组
+ *
+ * 批量查找：一次同时推进 kBatch 个查找，每层对这一组各走一步，它们的缓存未命中互相重叠
+ *
+ * 要求 K 可以默认构造（数组开头用于对齐的空位）和拷贝；只做了 Eytzinger 布局，没有做 vEB 布局
+ */
+
+namespace my {
+
+    template<typename K, typename Compare = std::less<K>>
+    class static_search_index {
+    public:
+        using key_type = K;
+        using key_compare = Compare;
+        using size_type = size_t;
+
+        /// 批量查找时同时推进的查找个数
+        static constexpr size_type kBatch = 16;
+
+        static_search_index() = default;
+
+        /// 从已按 comp 升序排列的数组（允许有重复）建立索引，O(n)
+        explicit static_search_index(const my::vector<K> &sorted, const Compare &comp = Compare())
+                : static_search_index(sorted.begin(), sorted.end(), comp) {}
+
+        template<typename RandomIt>
+        static_search_index(RandomIt first, RandomIt last, const Compare &comp = Compare()) : comp_(comp) {
+            allocate_(static_cast<size_type>(last - first));
+            build_(first, 0, 1);
+        }
+
+        /// 拷贝时重新对齐
+        static_search_index(const static_search_index &other) : comp_(other.comp_) {
+            allocate_(other.n_);
+            std::copy(other.base_() + 1, other.base_() + n_ + 1, base_() + 1);
+        }
+
+        static_search_index(static_search_index &&other) noexcept {
+            swap(other);
+        }
+
+        static_search_index &operator=(static_search_index other) {
+            swap(other);
+            return *this;
+        }
+
+        void swap(static_search_index &other) noexcept {
+            storage_.swap(other.storage_);
+            std::swap(offset_, other.offset_);
+            std::swap(n_, other.n_);
+            std::swap(depth_, other.depth_);
+            std::swap(comp_, other.comp_);
+        }
+
+        size_type size() const { return n_; }
+
+        bool empty() const { return n_ == 0; }
+
+        /// 第一个不小于 key 的名次（原有序数组中的下标），都小于 key 时为 size()
+        size_type lower_bound(const K &key) const {
+            return rank_of_(descend_(key, [this](const K &node, const K &x) { return comp_(node, x); }));
+        }
+
+        /// 第一个大于 key 的名次
+        size_type upper_bound(const K &key) const {
+            return rank_of_(descend_(key, [this](const K &node, const K &x) { return !comp_(x, node); }));
+        }
+
+        std::pair<size_type, size_type> equal_range(const K &key) const {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        bool contains(const K &key) const {
+            return find(key) != nullptr;
+        }
+
+        /// 返回索引中与 key 等价的一个元素，不存在时返回 nullptr
+        const K *find(const K &key) const {
+            size_type k = descend_(key, [this](const K &node, const K &x) { return comp_(node, x); });
+            return k != 0 && !comp_(key, base_()[k]) ? base_() + k : nullptr;
+        }
+
+        /// 批量 lower_bound：对 [first, last) 中的每个 key 依次把名次写到 out，返回写完之后的 out
+        template<typename InputIt, typename OutputIt>
+        OutputIt lower_bound(InputIt first, InputIt last, OutputIt out) const {
+            return batch_(first, last, out, [this](const K &node, const K &x) { return comp_(node, x); });
+        }
+
+        /// 批量 upper_bound
+        template<typename InputIt, typename OutputIt>
+        OutputIt upper_bound(InputIt first, InputIt last, OutputIt out) const {
+            return batch_(first, last, out, [this](const K &node, const K &x) { return !comp_(x, node); });
+        }
+
+    private:
+        /// 每条缓存行能放下的元素个数；元素大于一条缓存行或者不能整除时不预取
+        static constexpr size_type kLine = 64;
+        static constexpr size_type kPerLine = sizeof(K) <= kLine && kLine % sizeof(K) == 0 ? kLine / sizeof(K) : 0;
+
+        const K *base_() const { return storage_.data() + offset_; }
+
+        K *base_() { return storage_.data() + offset_; }
+
+        /// 分配 n + 1 个槽位（下标 0 不用），并让下标 0 落在缓存行的开头：16k 开始的一组后代才正好是一条缓存行
+        void allocate_(size_type n) {
+            n_ = n;
+            depth_ = n == 0 ? 0 : static_cast<size_type>(std::bit_width(n)) - 1;
+            storage_ = my::vector<K>(n + 1 + kPerLine);
+            offset_ = 0;
+            if (kPerLine != 0) {
+                auto addr = reinterpret_cast<std::uintptr_t>(storage_.data());
+                offset_ = ((kLine - addr % kLine) % kLine) / sizeof(K);
+            }
+        }
+
+        /// 按中序把有序输入填进 Eytzinger 布局：中序遍历这棵隐式树，依次取下一个输入，返回下一个输入的下标
+        template<typename RandomIt>
+        size_type build_(RandomIt sorted, size_type i, size_type k) {
+            if (k <= n_) {
+                i = build_(sorted, i, 2 * k);
+                base_()[k] = sorted[i++];
+                i = build_(sorted, i, 2 * k + 1);
+            }
+            return i;
+        }
+
+        static void prefetch_(const void *addr) {
+#if defined(_MSC_VER)
+            _mm_prefetch(static_cast<const char *>(addr), _MM_HINT_T0);
+#else
+            __builtin_prefetch(addr);
+#endif
+        }
+
+        /// k 往下 4 层（int 的情况）的后代所在的缓存行；地址可能超出数组，按整数计算，预取本身不会出错
+        void prefetch_descendants_(size_type k) const {
+            if constexpr (kPerLine != 0) {
+                prefetch_(reinterpret_cast<const void *>(
+                                  reinterpret_cast<std::uintptr_t>(base_()) + k * kPerLine * sizeof(K)));
+            }
+        }
+
+        /**
+         *  goRight(b[k], x) 为 true 表示答案在 k 的右边
+         *  深度 0 .. depth_-1 的各层都是满的（depth_ 是最深一层的深度），这些层不用判断越界，循环次数固定；
+         *  最深一层不满，只在最后一步判断一次 k <= n
+         *  返回答案节点的 Eytzinger 下标，0 表示所有元素都在 key 的左边
+         * */
+        template<typename GoRight>
+        size_type descend_(const K &key, GoRight goRight) const {
+            if (n_ == 0) {
+                return 0;
+            }
+            const K *b = base_();
+            size_type k = 1;
+            for (size_type level = 0; level < depth_; ++level) {
+                prefetch_descendants_(k);
+                k = 2 * k + (goRight(b[k], key) ? 1 : 0);
+            }
+            if (k <= n_) {
+                k = 2 * k + (goRight(b[k], key) ? 1 : 0);
+            }
+            /// 最后一次“向左”的位置就是答案：去掉末尾连续的 1 和它们前面的那个 0
+            return k >> (std::countr_one(k) + 1);
+        }
+
+        /**
+         *  Eytzinger 下标 -> 名次
+         *  先按深度为 depth_ 的满二叉树算出中序位置：深度 d 的节点 k 是第 k - 2^d 个，
+         *  它在满树中的中序位置是 (2(k - 2^d) + 1) * 2^(depth_ - d) - 1（最深一层的节点占偶数位置）
+         *  最深一层实际只有 2^depth_ .. n_ 这些节点，缺少的叶子占据从 missingFrom = 2(n_ + 1 - 2^depth_) 开始的偶数位置，
+         *  再减去排在前面的缺少的叶子个数
+         * */
+        size_type rank_of_(size_type k) const {
+            if (k == 0) {
+                return n_;
+            }
+            size_type d = static_cast<size_type>(std::bit_width(k)) - 1;
+            size_type pos = ((2 * (k - (size_type(1) << d)) + 1) << (depth_ - d)) - 1;
+            size_type missingFrom = 2 * (n_ + 1 - (size_type(1) << depth_));
+            return pos > missingFrom ? pos - (pos - missingFrom + 1) / 2 : pos;
+        }
+
+        template<typename InputIt, typename OutputIt, typename GoRight>
+        OutputIt batch_(InputIt first, InputIt last, OutputIt out, GoRight goRight) const {
+            K keys[kBatch];
+            size_type ks[kBatch];
+            const K *b = base_();
+            while (first != last) {
+                size_type count = 0;
+                for (; count < kBatch && first != last; ++count, ++first) {
+                    keys[count] = *first;
+                    ks[count] = 1;
+                }
+                if (n_ != 0) {
+                    for (size_type level = 0; level < depth_; ++level) {
+                        for (size_type j = 0; j < count; ++j) {
+                            prefetch_descendants_(ks[j]);
+                            ks[j] = 2 * ks[j] + (goRight(b[ks[j]], keys[j]) ? 1 : 0);
+                        }
+                    }
+                    for (size_type j = 0; j < count; ++j) {
+                        if (ks[j] <= n_) {
+                            ks[j] = 2 * ks[j] + (goRight(b[ks[j]], keys[j]) ? 1 : 0);
+                        }
+                    }
+                }
+                for (size_type j = 0; j < count; ++j) {
+                    *out++ = n_ == 0 ? 0 : rank_of_(ks[j] >> (std::countr_one(ks[j]) + 1));
+                }
+            }
+            return out;
+        }
+
+    private:
+        my::vector<K> storage_;     /// Eytzinger 数组，base_()[1..n_] 为元素
+        size_type offset_ = 0;      /// base_() 在 storage_ 中的偏移，让 base_() 按缓存行对齐
+        size_type n_ = 0;
+        size_type depth_ = 0;       /// 最深一层的深度 floor(log2(n))
+        Compare comp_;
+    };
+}
@@ -11,6 +11,8 @@
 #include <assert.h>
 #include <limits.h>
 #include <cstring>
+#include <functional>
+#include <string_view>
 #include "memory_/my_allocator.h"
 #include "utility_/my_move.h"
 #include "my_algorithm.h"
@@ -677,4 +679,58 @@ namespace my {
         return !(lhs == rhs);
     }
 
+
+    /// 重载 <，按字典序比较，使 my::string 可以作为有序容器的 key
+    inline bool operator<(const my::string& lhs, const my::string& rhs) {
+        return std::string_view(lhs.data(), lhs.size()) < std::string_view(rhs.data(), rhs.size());
+    }
+
+    inline bool operator<(const my::string& lhs, const char* rhs) {
+        return std::string_view(lhs.data(), lhs.size()) < std::string_view(rhs);
+    }
+
+    inline bool operator<(const char* lhs, const my::string& rhs) {
+        return std::string_view(lhs) < std::string_view(rhs.data(), rhs.size());
+    }
+
+    namespace detail {
+        inline std::string_view as_string_view(const my::string& s) { return std::string_view(s.data(), s.size()); }
+
+        inline std::string_view as_string_view(const char* s) { return std::string_view(s); }
+
+        inline std::string_view as_string_view(std::string_view s) { return s; }
+    }
+
+    /**
+     * 透明的哈希 / 相等 / 小于函数对象（带 is_transparent 标记）
+     * 例如 my::unordered_map<my::string, int, my::string_hash, my::string_equal> 可以直接用
+     * const char* 或 std::string_view 调用 find/count/contains，不需要先构造一个临时的 my::string
+     * 三种参数都先转成 string_view，保证同一段字符得到相同的哈希值
+     */
+    struct string_hash {
+        using is_transparent = void;
+
+        template<typename S>
+        size_t operator()(const S& s) const {
+            return std::hash<std::string_view>()(detail::as_string_view(s));
+        }
+    };
+
+    struct string_equal {
+        using is_transparent = void;
+
+        template<typename L, typename R>
+        bool operator()(const L& lhs, const R& rhs) const {
+            return detail::as_string_view(lhs) == detail::as_string_view(rhs);
+        }
+    };
+
+    struct string_less {
+        using is_transparent = void;
+
+        template<typename L, typename R>
+        bool operator()(const L& lhs, const R& rhs) const {
+            return detail::as_string_view(lhs) < detail::as_string_view(rhs);
+        }
+    };
 }
\ No newline at end of file
@@ -52,3 +52,4 @@
 #include "mytype_traits/my_is_union.h"
 #include "mytype_traits/my_is_class.h"
 #include "mytype_traits/my_is_convertible.h"
+#include "mytype_traits/my_has_is_transparent.h"
@@ -42,7 +42,7 @@ ForwardIterator uninitialized_fill_n_a(ForwardIterator first, Size n, const T &v
     try {
         for (;n > 0; --n, ++cur) {
             /// 调用分配构造函数，用指定值构造对象
-            alloc.construct(std::addressof(*cur), value);
+            std::allocator_traits<Alloc>::construct(alloc, std::addressof(*cur), value);
         }
         return cur;  /// 返回下一个未初始化的位置
     } catch (...) {
@@ -60,8 +60,9 @@ ForwardIterator uninitialized_fill_a(ForwardIterator first, ForwardIterator last
     try {
         for (;first != last; ++first) {
             /// 调用分配构造函数，用指定值构造对象
-            alloc.construct(std::addressof(*first), value);
+            std::allocator_traits<Alloc>::construct(alloc, std::addressof(*first), value);
         }
+        return first;
     } catch (...) {
         /// 异常发生时，回滚 [cur, first) 区间，即已经成功构造的对象，防止内存泄漏
         destroy_(cur, first, alloc);
@@ -76,7 +77,7 @@ ForwardIterator uninitalized_default_n_a(ForwardIterator first, Size n, Alloc& a
     ForwardIterator cur = first;    /// 记录构造进度
     try{
         for(; n > 0; --n, ++cur) {
-            alloc.construct(std::addressof(*cur));
+            std::allocator_traits<Alloc>::construct(alloc, std::addressof(*cur));
         }
         return cur;     /// 返回下一个未初始化的位置
     } catch (...) {
@@ -112,7 +113,7 @@ ForwordIterator uninitialized_copy_a(InputIterator first, InputIterator last, Fo
     ForwordIterator cur = result;
     try {
         for (; first != last; ++first, ++cur) {
-            alloc.construct(std::addressof(*cur), *first);
+            std::allocator_traits<Alloc>::construct(alloc, std::addressof(*cur), *first);
         }
         return cur;
     } catch(...) {
@@ -130,7 +131,7 @@ ForwordIterator uninitialized_move_a(InputIterator first, InputIterator last, Fo
             /// 使用move将源对象转移构造到目标对象
 //            alloc.construct(std::addressof(*cur), std::move(*first));
             /// 使用自己手写的address和move，但是一般都是推荐使用std:;addressof()
-            alloc.construct(std::addressof(*cur), my::move(*first));
+            std::allocator_traits<Alloc>::construct(alloc, std::addressof(*cur), my::move(*first));
         }
         return cur;
     } catch(...) {
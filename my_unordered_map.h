@@ -13,6 +13,9 @@
 #include "my_initializer_list.h"
 
 namespace my {
+    template<typename Key, typename T, typename Hash, typename Pred, typename Alloc>
+    class unordered_multimap;
+
     /// 基于hashTable封装unordered_map
     template<typename Key,
             typename T,
@@ -30,6 +33,8 @@ namespace my {
         using difference_type = typename hash_table::difference_type;
         using iterator = typename hash_table::iterator;
         using const_iterator = typename hash_table::const_iterator;
+        using node_type = typename hash_table::node_handle_type;
+        using insert_return_type = typename hash_table::insert_return_type;
     public:
         /// 主要成员方法
         /// 构造函数  rules of five
@@ -79,10 +84,124 @@ namespace my {
             return table_.insert(value);
         }
 
+        /// 右值版本：key 不存在时才把 value 移动进新节点
+        std::pair<iterator, bool> insert(value_type &&value) {
+            return table_.insert(my::move(value));
+        }
+
+        /// 带位置提示的插入，哈希表中提示会被忽略
+        iterator insert(const_iterator hint, const value_type &value) {
+            return table_.insert(hint, value);
+        }
+
+        iterator insert(const_iterator hint, value_type &&value) {
+            return table_.insert(hint, my::move(value));
+        }
+
+        /// 就地构造 value_type，key 已存在时新构造的节点会被销毁
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return table_.emplace(my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            return table_.emplace_hint(hint, my::forward<Args>(args)...);
+        }
+
+        /// key 不存在时才构造 key 和 mapped，存在时 args 不会被移动
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+            return table_.try_emplace(key, my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type &&key, Args &&... args) {
+            return table_.try_emplace(my::move(key), my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator try_emplace(const_iterator, const key_type &key, Args &&... args) {
+            return table_.try_emplace(key, my::forward<Args>(args)...).first;
+        }
+
+        template<typename... Args>
+        iterator try_emplace(const_iterator, key_type &&key, Args &&... args) {
+            return table_.try_emplace(my::move(key), my::forward<Args>(args)...).first;
+        }
+
+        /// key 存在时赋值，不存在时插入
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+            return table_.insert_or_assign(key, my::forward<M>(obj));
+        }
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj) {
+            return table_.insert_or_assign(my::move(key), my::forward<M>(obj));
+        }
+
+        template<typename M>
+        iterator insert_or_assign(const_iterator, const key_type &key, M &&obj) {
+            return table_.insert_or_assign(key, my::forward<M>(obj)).first;
+        }
+
+        template<typename M>
+        iterator insert_or_assign(const_iterator, key_type &&key, M &&obj) {
+            return table_.insert_or_assign(my::move(key), my::forward<M>(obj)).first;
+        }
+
         iterator find(const key_type &key) {
             return table_.find(key);
         }
 
+        const_iterator find(const key_type &key) const {
+            return table_.find(key);
+        }
+
+        /// 异构查找：Hash 和 Pred 都声明 is_transparent 时，可以用 const char*、string_view 等直接查找，不构造临时 key
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        iterator find(const K &key) {
+            return table_.find(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        const_iterator find(const K &key) const {
+            return table_.find(key);
+        }
+
+        size_type count(const key_type &key) const {
+            return table_.count(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        size_type count(const K &key) const {
+            return table_.count(key);
+        }
+
+        bool contains(const key_type &key) const {
+            return table_.contains(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        bool contains(const K &key) const {
+            return table_.contains(key);
+        }
+
+        my::pair<iterator, iterator> equal_range(const key_type &key) {
+            return table_.equal_range(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        my::pair<iterator, iterator> equal_range(const K &key) {
+            return table_.equal_range(key);
+        }
+
         size_type erase(const key_type &key) {
             return table_.erase(key);
         }
@@ -91,6 +210,45 @@ namespace my {
             return table_.erase(it);
         }
 
+        /// 节点操作：在容器之间转移元素，不重新分配节点，也不拷贝/移动元素
+        node_type extract(const_iterator pos) {
+            return table_.extract(pos);
+        }
+
+        node_type extract(const key_type &key) {
+            return table_.extract(key);
+        }
+
+        insert_return_type insert(node_type &&nh) {
+            return table_.insert(my::move(nh));
+        }
+
+        iterator insert(const_iterator hint, node_type &&nh) {
+            return table_.insert(hint, my::move(nh));
+        }
+
+        /// 把 source 中的节点全部转移过来（本容器中已存在的 key 留在 source 中）
+        template<typename H2, typename P2>
+        void merge(unordered_map<Key, T, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_map<Key, T, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
+        /// 来自 unordered_multimap 的节点：每个 key 只转移第一个，重复的留在 source 中
+        template<typename H2, typename P2>
+        void merge(unordered_multimap<Key, T, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_multimap<Key, T, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
         void clear() {
             table_.clear();
         }
@@ -108,9 +266,15 @@ namespace my {
         }
 
         /// 重载[]
+        /// 通过 try_emplace 实现：key 已存在时只做一次查找，不会构造临时 pair 或拷贝 key
         T &operator[](const key_type &key) {
-            /// 由于insert()返回std::pair<iterator, bool>，所以这里使用auto [it, inserted]分别接收插入返回的新迭代器，和是否插入成功
-            auto [it, inserted] = table_.insert(std::make_pair(key, mapped_type()));
+            /// 由于try_emplace()返回std::pair<iterator, bool>，所以这里使用auto [it, inserted]分别接收插入返回的新迭代器，和是否插入成功
+            auto [it, inserted] = table_.try_emplace(key);
+            return it->second;
+        }
+
+        T &operator[](key_type &&key) {
+            auto [it, inserted] = table_.try_emplace(my::move(key));
             return it->second;
         }
 
@@ -135,6 +299,13 @@ namespace my {
         }
 
     private:
+        /// merge 需要访问其他实例化的底层哈希表
+        template<typename, typename, typename, typename, typename>
+        friend class unordered_map;
+
+        template<typename, typename, typename, typename, typename>
+        friend class unordered_multimap;
+
         /// 成员变量主要还是哈希表
         hash_table table_;
     };
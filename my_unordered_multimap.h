@@ -13,6 +13,9 @@
 
 /// 我的hashtable已经实现了重复插入键值，所以这里基于hashtable和unordered_multimap稍加修改为unodered_multimap
 namespace my {
+    template<typename Key, typename T, typename Hash, typename Pred, typename Alloc>
+    class unordered_map;
+
     /// 基于hashTable封装unordered_multimap
     template<typename Key,
             typename T,
@@ -30,6 +33,7 @@ namespace my {
         using difference_type = typename hash_table::difference_type;
         using iterator = typename hash_table::iterator;
         using const_iterator = typename hash_table::const_iterator;
+        using node_type = typename hash_table::node_handle_type;
     public:
         /// 主要成员方法
         /// 构造函数  rules of five
@@ -100,6 +104,29 @@ namespace my {
             return table_.insert(value);
         }
 
+        iterator insert(value_type &&value) {
+            return table_.insert(my::move(value));
+        }
+
+        /// 带位置提示的插入，哈希表中提示会被忽略
+        iterator insert(const_iterator hint, const value_type &value) {
+            return table_.insert(hint, value);
+        }
+
+        iterator insert(const_iterator hint, value_type &&value) {
+            return table_.insert(hint, my::move(value));
+        }
+
+        template<typename... Args>
+        iterator emplace(Args &&... args) {
+            return table_.emplace(my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            return table_.emplace_hint(hint, my::forward<Args>(args)...);
+        }
+
         /// equal_range()函数
         my::pair<iterator, iterator> equal_range(const key_type &key) {
             return table_.equal_range(key);
@@ -110,11 +137,34 @@ namespace my {
             return table_.equal_range(key);
         }
 
+        /// 异构查找版本，要求 Hash 和 Pred 都声明 is_transparent
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        my::pair<iterator, iterator> equal_range(const K &key) {
+            return table_.equal_range(key);
+        }
+
 
         iterator find(const key_type &key) {
             return table_.find(key);
         }
 
+        const_iterator find(const key_type &key) const {
+            return table_.find(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        iterator find(const K &key) {
+            return table_.find(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        const_iterator find(const K &key) const {
+            return table_.find(key);
+        }
+
         size_type erase(const key_type &key) {
             return table_.erase(key);
         }
@@ -123,24 +173,68 @@ namespace my {
             return table_.erase(it);
         }
 
+        /// 节点操作：在容器之间转移元素，不重新分配节点，也不拷贝/移动元素
+        node_type extract(const_iterator pos) {
+            return table_.extract(pos);
+        }
+
+        node_type extract(const key_type &key) {
+            return table_.extract(key);
+        }
+
+        iterator insert(node_type &&nh) {
+            return table_.insert(my::move(nh));
+        }
+
+        iterator insert(const_iterator hint, node_type &&nh) {
+            return table_.insert(hint, my::move(nh));
+        }
+
+        /// 把 source 中的节点全部转移过来
+        template<typename H2, typename P2>
+        void merge(unordered_multimap<Key, T, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_multimap<Key, T, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_map<Key, T, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_map<Key, T, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
         void clear() {
             table_.clear();
         }
 
         /// 相同的键有多少个
         size_type count(const key_type &key) const {
-            auto range = table_.equal_range(key);
-            size_type cnt = 0;
-            for (auto it = range.first; it != range.second; ++it) {
-                ++cnt;
-            }
-            return cnt;
+            return table_.count(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        size_type count(const K &key) const {
+            return table_.count(key);
         }
 
         /// 是否包含 contains
         bool contains(const key_type &key) const {
-            /// 如果找到key的迭代器不等于尾迭代器则表示包含
-            return table_.find(key) != table_.end();
+            return table_.contains(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        bool contains(const K &key) const {
+            return table_.contains(key);
         }
 
         void swap(unordered_multimap &other) {
@@ -156,6 +250,13 @@ namespace my {
         }
 
     private:
+        /// merge 需要访问其他实例化的底层哈希表
+        template<typename, typename, typename, typename, typename>
+        friend class unordered_multimap;
+
+        template<typename, typename, typename, typename, typename>
+        friend class unordered_map;
+
         /// 成员变量主要还是哈希表
         hash_table table_;
     };
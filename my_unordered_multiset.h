@@ -10,6 +10,9 @@
 #include "my_hashtable.h"
 
 namespace my {
+    template<typename Key, typename Hash, typename Pred, typename Alloc>
+    class unordered_set;
+
     template<typename Key,
             typename Hash = std::hash<Key>,
             typename Pred = std::equal_to<Key>,
@@ -27,6 +30,7 @@ namespace my {
         using const_pointer = typename hash_table::const_pointer;
         using iterator = typename hash_table::iterator;
         using const_iterator = typename hash_table::const_iterator;
+        using node_type = typename hash_table::node_handle_type;
 
     public:
         explicit unordered_multiset(size_type n = 0) : table_(n) {}
@@ -39,21 +43,55 @@ namespace my {
 
         size_type count(const key_type &key) const { return table_.count(key); }
 
+        /// 异构查找版本，要求 Hash 和 Pred 都声明 is_transparent
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        size_type count(const K &key) const { return table_.count(key); }
+
+        bool contains(const key_type &key) const { return table_.contains(key); }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        bool contains(const K &key) const { return table_.contains(key); }
+
         bool empty() const { return table_.empty(); }
 
         iterator insert(const value_type &value) { return table_.insert(value); }
 
         iterator insert(value_type &&value) { return table_.insert(my::move(value)); }
 
+        iterator insert(const_iterator hint, const value_type &value) { return table_.insert(hint, value); }
+
+        iterator insert(const_iterator hint, value_type &&value) { return table_.insert(hint, my::move(value)); }
+
         template<typename... Args>
         iterator emplace(Args &&... args) {
             return table_.emplace(my::forward<Args>(args)...);
         }
 
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            return table_.emplace_hint(hint, my::forward<Args>(args)...);
+        }
+
         iterator find(const key_type &key) { return table_.find(key); }
 
         const_iterator find(const key_type &key) const { return table_.find(key); }
 
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        iterator find(const K &key) { return table_.find(key); }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        const_iterator find(const K &key) const { return table_.find(key); }
+
+        my::pair<iterator, iterator> equal_range(const key_type &key) { return table_.equal_range(key); }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        my::pair<iterator, iterator> equal_range(const K &key) { return table_.equal_range(key); }
+
         void clear() { table_.clear(); }
 
         size_type erase(const key_type &key) { return table_.erase(key); }
@@ -63,6 +101,44 @@ namespace my {
             return table_.erase(it);
         }
 
+        /// 节点操作：在容器之间转移元素，不重新分配节点，也不拷贝/移动元素
+        node_type extract(const_iterator pos) {
+            return table_.extract(pos);
+        }
+
+        node_type extract(const key_type &key) {
+            return table_.extract(key);
+        }
+
+        iterator insert(node_type &&nh) {
+            return table_.insert(my::move(nh));
+        }
+
+        iterator insert(const_iterator hint, node_type &&nh) {
+            return table_.insert(hint, my::move(nh));
+        }
+
+        /// 把 source 中的节点全部转移过来
+        template<typename H2, typename P2>
+        void merge(unordered_multiset<Key, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_multiset<Key, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_set<Key, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_set<Key, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
         void rehash(size_type n) { table_.rehash(n); }
 
         float load_factor() const { return table_.load_factor(); }
@@ -76,6 +152,13 @@ namespace my {
         bool operator!=(const unordered_multiset &other) const { return table_ != other.table_; }
 
     private:
+        /// merge 需要访问其他实例化的底层哈希表
+        template<typename, typename, typename, typename>
+        friend class unordered_multiset;
+
+        template<typename, typename, typename, typename>
+        friend class unordered_set;
+
         hash_table table_;
     };
 }
\ No newline at end of file
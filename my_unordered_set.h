@@ -10,6 +10,8 @@
 #include "my_hashtable.h"
 
 namespace my {
+    template<typename Key, typename Hash, typename Pred, typename Alloc>
+    class unordered_multiset;
 
 /// unordered_set 基于hash_table实现
     template<typename Key,
@@ -30,6 +32,8 @@ namespace my {
         using const_pointer = typename hash_table::const_pointer;
         using iterator = typename hash_table::iterator;
         using const_iterator = typename hash_table::const_iterator;
+        using node_type = typename hash_table::node_handle_type;
+        using insert_return_type = typename hash_table::insert_return_type;
     public:
         ///rules of five
 //    unordered_set() = default;
@@ -101,6 +105,23 @@ namespace my {
             return table_.count(key);
         }
 
+        /// 异构查找版本，要求 Hash 和 Pred 都声明 is_transparent
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        size_type count(const K &key) const {
+            return table_.count(key);
+        }
+
+        bool contains(const key_type &key) const {
+            return table_.contains(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        bool contains(const K &key) const {
+            return table_.contains(key);
+        }
+
         /// empty
         bool empty() const {
             return table_.empty();
@@ -113,6 +134,30 @@ namespace my {
             return table_.insert(value);
         }
 
+        /// 右值插入：key 不存在时才移动进新节点
+        std::pair<iterator, bool> insert(value_type &&value) {
+            return table_.insert(my::move(value));
+        }
+
+        /// 带位置提示的插入，哈希表中提示会被忽略
+        iterator insert(const_iterator hint, const value_type &value) {
+            return table_.insert(hint, value);
+        }
+
+        iterator insert(const_iterator hint, value_type &&value) {
+            return table_.insert(hint, my::move(value));
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args &&... args) {
+            return table_.emplace(my::forward<Args>(args)...);
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator hint, Args &&... args) {
+            return table_.emplace_hint(hint, my::forward<Args>(args)...);
+        }
+
         /// find
         iterator find(const key_type &key) {
             return table_.find(key);
@@ -122,6 +167,28 @@ namespace my {
             return table_.find(key);
         }
 
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        iterator find(const K &key) {
+            return table_.find(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        const_iterator find(const K &key) const {
+            return table_.find(key);
+        }
+
+        my::pair<iterator, iterator> equal_range(const key_type &key) {
+            return table_.equal_range(key);
+        }
+
+        template<typename K, typename H = Hash, typename P = Pred,
+                typename = my::enable_if_t<has_is_transparent_v<H> && has_is_transparent_v<P>>>
+        my::pair<iterator, iterator> equal_range(const K &key) {
+            return table_.equal_range(key);
+        }
+
         /// erase
         size_type erase(const key_type &key) {
             return table_.erase(key);
@@ -137,6 +204,45 @@ namespace my {
             return table_.erase(it);  /// 直接传到底层 hashtable::erase(iterator)
         }
 
+        /// 节点操作：在容器之间转移元素，不重新分配节点，也不拷贝/移动元素
+        node_type extract(const_iterator pos) {
+            return table_.extract(pos);
+        }
+
+        node_type extract(const key_type &key) {
+            return table_.extract(key);
+        }
+
+        insert_return_type insert(node_type &&nh) {
+            return table_.insert(my::move(nh));
+        }
+
+        iterator insert(const_iterator hint, node_type &&nh) {
+            return table_.insert(hint, my::move(nh));
+        }
+
+        /// 把 source 中的节点全部转移过来（本容器中已存在的 key 留在 source 中）
+        template<typename H2, typename P2>
+        void merge(unordered_set<Key, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_set<Key, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
+        /// 来自 unordered_multiset 的节点：每个 key 只转移第一个，重复的留在 source 中
+        template<typename H2, typename P2>
+        void merge(unordered_multiset<Key, H2, P2, Alloc> &source) {
+            table_.merge(source.table_);
+        }
+
+        template<typename H2, typename P2>
+        void merge(unordered_multiset<Key, H2, P2, Alloc> &&source) {
+            table_.merge(source.table_);
+        }
+
         /// 范围删除
         iterator erase(const_iterator first, const_iterator last) {
             while (first != last) {
@@ -179,6 +285,13 @@ namespace my {
 
 
     private:
+        /// merge 需要访问其他实例化的底层哈希表
+        template<typename, typename, typename, typename>
+        friend class unordered_set;
+
+        template<typename, typename, typename, typename>
+        friend class unordered_multiset;
+
         /// 成员变量
         hash_table table_;
     };
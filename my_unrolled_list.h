@@ -0,0 +1,611 @@
+/**
+ * @file      my_unrolled_list.h
+ * @brief     [展开链表：每个节点连续存放最多 K 个元素，降低 list 每个元素两个指针的开销和遍历时的缓存缺失]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "memory_/my_allocator.h"
+#include "my_initializer_list.h"
+#include "my_iterator.h"
+#include "my_utility.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/**
+ * unrolled_list<T, K>
+ * 双向链表，但每个节点里是一个能放 K 个元素的小数组，元素在节点内连续存放在 [0, count_) 中
+ *      list 的每个元素都单独占一个节点（两个指针 + 一次分配），对 int 这样的小元素，内存是数据的 3 倍以上，
+ *      遍历时每一步都是一次指针跳转；展开之后指针和分配的开销被 K 个元素分摊，遍历在节点内是顺序访问
+ * 插入：节点没满时把插入点之后的元素后移一位（最多 K 个）；节点满了就对半分裂成两个节点再插入
+ *      插入点在节点开头、而前一个节点还有空位时，直接追加到前一个节点末尾，不用移动
+ * 删除：删除点之后的元素前移一位；节点空了就释放；节点少于半满、并且能和后一个节点放进一个节点时，把后一个节点合并进来
+ *      这样除了首尾附近，节点平均至少半满
+ * 迭代器：（节点，节点内下标），双向迭代器；插入 / 删除会移动同一节点（以及分裂 / 合并涉及的节点）里的元素，
+ *      这些元素上的迭代器失效，其他节点上的迭代器不受影响
+ * splice：整个节点在链表之间移动只改指针，O(1)；插入点在节点中间时先把该节点在插入点处分裂（O(K)）
+ * 哨兵节点直接嵌在 unrolled_list 对象里（只有前后指针，不含元素数组），空链表不分配内存
+ */
+
+namespace my {
+
+    /// 默认每个节点的元素个数：让元素数组大约占 256 字节，至少 4 个
+    template<typename T>
+    inline constexpr size_t default_unrolled_capacity = 256 / sizeof(T) < 4 ? 4 : 256 / sizeof(T);
+
+    template<typename T, size_t K, typename Alloc>
+    class unrolled_list;
+
+    namespace detail {
+        struct unrolled_node_base {
+            unrolled_node_base *prev_;
+            unrolled_node_base *next_;
+        };
+
+        template<typename T, size_t K>
+        struct unrolled_node : unrolled_node_base {
+            size_t count_ = 0;
+            alignas(T) unsigned char storage_[K * sizeof(T)];
+
+            T *data() noexcept { return std::launder(reinterpret_cast<T *>(storage_)); }
+        };
+
+        template<typename T, size_t K, bool Const>
+        class unrolled_iterator {
+            using node = unrolled_node<T, K>;
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T *, T *>;
+            using reference = std::conditional_t<Const, const T &, T &>;
+
+            unrolled_iterator() : node_(nullptr), index_(0) {}
+
+            unrolled_iterator(unrolled_node_base *n, size_t index) : node_(n), index_(index) {}
+
+            /// iterator 可以转换为 const_iterator
+            template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            unrolled_iterator(const unrolled_iterator<T, K, OtherConst> &other)
+                    : node_(other.node_), index_(other.index_) {}
+
+            reference operator*() const {
+                return static_cast<node *>(node_)->data()[index_];
+            }
+
+            pointer operator->() const {
+                return &(operator*());
+            }
+
+            /// 节点内前进一个下标，到节点末尾时跳到下一个节点的开头（末节点之后是哨兵，即 end()）
+            unrolled_iterator &operator++() {
+                if (++index_ == static_cast<node *>(node_)->count_) {
+                    node_ = node_->next_;
+                    index_ = 0;
+                }
+                return *this;
+            }
+
+            /// 在节点开头时退到上一个节点的末尾（end() 的上一个节点就是最后一个节点）
+            unrolled_iterator &operator--() {
+                if (index_ == 0) {
+                    node_ = node_->prev_;
+                    index_ = static_cast<node *>(node_)->count_;
+                }
+                --index_;
+                return *this;
+            }
+
+            unrolled_iterator operator++(int) {
+                unrolled_iterator temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            unrolled_iterator operator--(int) {
+                unrolled_iterator temp = *this;
+                --*this;
+                return temp;
+            }
+
+            bool operator==(const unrolled_iterator &other) const {
+                return node_ == other.node_ && index_ == other.index_;
+            }
+
+            bool operator!=(const unrolled_iterator &other) const {
+                return !(*this == other);
+            }
+
+        private:
+            template<typename, size_t, bool> friend
+            class unrolled_iterator;
+
+            template<typename, size_t, typename> friend
+            class my::unrolled_list;
+
+            unrolled_node_base *node_;
+            size_t index_;
+        };
+    }
+
+    template<typename T, size_t K = default_unrolled_capacity<T>, typename Alloc = MyAlloc<T>>
+    class unrolled_list {
+        static_assert(K >= 2, "unrolled_list needs at least 2 elements per node");
+
+        using node_base = detail::unrolled_node_base;
+        using node = detail::unrolled_node<T, K>;
+        using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
+        using node_traits = std::allocator_traits<node_allocator>;
+
+    public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = detail::unrolled_iterator<T, K, false>;
+        using const_iterator = detail::unrolled_iterator<T, K, true>;
+
+        static constexpr size_type node_capacity = K;
+
+        unrolled_list() {
+            empty_initialize_();
+        }
+
+        unrolled_list(std::initializer_list<T> init) : unrolled_list() {
+            append_(init.begin(), init.end());
+        }
+
+        template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        unrolled_list(InputIt first, InputIt last) : unrolled_list() {
+            append_(first, last);
+        }
+
+        unrolled_list(size_type n, const T &value) : unrolled_list() {
+            for (size_type i = 0; i < n; ++i) {
+                push_back(value);
+            }
+        }
+
+        /// 拷贝时把每个节点填满，结果比源链表更紧凑
+        unrolled_list(const unrolled_list &other) : unrolled_list() {
+            append_(other.begin(), other.end());
+        }
+
+        unrolled_list(unrolled_list &&other) noexcept : unrolled_list() {
+            swap(other);
+        }
+
+        unrolled_list &operator=(const unrolled_list &other) {
+            if (this != &other) {
+                unrolled_list temp(other);
+                swap(temp);
+            }
+            return *this;
+        }
+
+        unrolled_list &operator=(unrolled_list &&other) noexcept {
+            if (this != &other) {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~unrolled_list() {
+            clear();
+        }
+
+        ///-------------迭代器
+        iterator begin() noexcept { return iterator(head_.next_, 0); }
+
+        iterator end() noexcept { return iterator(&head_, 0); }
+
+        const_iterator begin() const noexcept { return const_iterator(const_cast<node_base *>(head_.next_), 0); }
+
+        const_iterator end() const noexcept { return const_iterator(const_cast<node_base *>(&head_), 0); }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+
+        const_iterator cend() const noexcept { return end(); }
+
+        ///-------------容量
+        size_type size() const noexcept { return size_; }
+
+        bool empty() const noexcept { return size_ == 0; }
+
+        /// 节点个数，size() / node_count() 就是平均每个节点的元素个数
+        size_type node_count() const noexcept { return nodes_; }
+
+        ///-------------元素访问
+        reference front() { return as_node_(head_.next_)->data()[0]; }
+
+        const_reference front() const { return as_node_(head_.next_)->data()[0]; }
+
+        reference back() {
+            node *last = as_node_(head_.prev_);
+            return last->data()[last->count_ - 1];
+        }
+
+        const_reference back() const {
+            node *last = as_node_(head_.prev_);
+            return last->data()[last->count_ - 1];
+        }
+
+        ///-------------插入
+        template<typename... Args>
+        void emplace_back(Args &&... args) {
+            node *last = head_.prev_ == &head_ ? nullptr : as_node_(head_.prev_);
+            if (last == nullptr || last->count_ == K) {
+                create_node_with_(&head_, std::forward<Args>(args)...);
+                ++size_;
+                return;
+            }
+            std::construct_at(last->data() + last->count_, std::forward<Args>(args)...);
+            ++last->count_;
+            ++size_;
+        }
+
+        void push_back(const T &value) { emplace_back(value); }
+
+        void push_back(T &&value) { emplace_back(std::move(value)); }
+
+        template<typename... Args>
+        void emplace_front(Args &&... args) {
+            emplace(begin(), std::forward<Args>(args)...);
+        }
+
+        void push_front(const T &value) { emplace_front(value); }
+
+        void push_front(T &&value) { emplace_front(std::move(value)); }
+
+        /// 在 pos 之前构造一个元素，返回指向它的迭代器
+        template<typename... Args>
+        iterator emplace(const_iterator pos, Args &&... args) {
+            node_base *n = pos.node_;
+            size_type index = pos.index_;
+            /// 在节点开头（包括 end()）插入时，优先追加到前一个节点的末尾
+            if (index == 0 && n->prev_ != &head_ && as_node_(n->prev_)->count_ < K) {
+                node *prev = as_node_(n->prev_);
+                std::construct_at(prev->data() + prev->count_, std::forward<Args>(args)...);
+                ++size_;
+                return iterator(prev, prev->count_++);
+            }
+            if (n == &head_) {
+                node *fresh = create_node_with_(&head_, std::forward<Args>(args)...);
+                ++size_;
+                return iterator(fresh, 0);
+            }
+            node *target = as_node_(n);
+            if (target->count_ == K) {
+                /// 满了：先构造好新值（参数可能引用着将要搬走的后一半），再把后一半搬到新节点，决定插到哪一半
+                T value(std::forward<Args>(args)...);
+                split_(target, K / 2);
+                if (index > K / 2) {
+                    index -= K / 2;
+                    target = as_node_(target->next_);
+                }
+                insert_in_node_(target, index, std::move(value));
+                ++size_;
+                return iterator(target, index);
+            }
+            insert_in_node_(target, index, std::forward<Args>(args)...);
+            ++size_;
+            return iterator(target, index);
+        }
+
+        iterator insert(const_iterator pos, const T &value) { return emplace(pos, value); }
+
+        iterator insert(const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+        /// 逐个插入，返回指向第一个插入元素的迭代器；插入的元素保持原来的顺序
+        template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            if (first == last) {
+                return iterator(pos.node_, pos.index_);
+            }
+            iterator it = emplace(pos, *first);
+            size_type inserted = 1;
+            for (++first; first != last; ++first, ++inserted) {
+                it = emplace(std::next(it), *first);
+            }
+            /// 后面的插入可能分裂过第一个元素所在的节点，把它搬到了别的节点，所以从最后插入的元素往回数
+            std::advance(it, -static_cast<difference_type>(inserted - 1));
+            return it;
+        }
+
+        ///-------------删除
+        /// 删除 pos 处的元素，返回指向下一个元素的迭代器
+        iterator erase(const_iterator pos) {
+            node *n = as_node_(pos.node_);
+            size_type index = pos.index_;
+            T *data = n->data();
+            std::move(data + index + 1, data + n->count_, data + index);
+            std::destroy_at(data + n->count_ - 1);
+            --n->count_;
+            --size_;
+            if (n->count_ == 0) {
+                node_base *next = n->next_;
+                destroy_node_(n);
+                return iterator(next, 0);
+            }
+            /// 少于半满时尝试把后一个节点整个并进来
+            if (n->count_ < K / 2 && n->next_ != &head_) {
+                node *next = as_node_(n->next_);
+                if (n->count_ + next->count_ <= K) {
+                    merge_next_(n);
+                }
+            }
+            if (index < n->count_) {
+                return iterator(n, index);
+            }
+            return iterator(n->next_, 0);
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            /// 从后往前数剩余个数：删除会移动 last 所在节点里的元素，last 本身不能一直保持有效
+            size_type count = static_cast<size_type>(std::distance(first, last));
+            iterator it(first.node_, first.index_);
+            for (size_type i = 0; i < count; ++i) {
+                it = erase(it);
+            }
+            return it;
+        }
+
+        void pop_back() { erase(std::prev(end())); }
+
+        void pop_front() { erase(begin()); }
+
+        void clear() noexcept {
+            node_base *cur = head_.next_;
+            while (cur != &head_) {
+                node_base *next = cur->next_;
+                node *n = as_node_(cur);
+                std::destroy(n->data(), n->data() + n->count_);
+                deallocate_node_(n);
+                cur = next;
+            }
+            empty_initialize_();
+        }
+
+        void resize(size_type count, const T &value) {
+            while (size_ > count) {
+                pop_back();
+            }
+            while (size_ < count) {
+                push_back(value);
+            }
+        }
+
+        void resize(size_type count) { resize(count, T()); }
+
+        ///-------------splice
+        /// 把 other 的全部元素移到 pos 之前，只移动节点，不移动元素
+        void splice(const_iterator pos, unrolled_list &other) {
+            if (other.empty() || this == &other) {
+                return;
+            }
+            node_base *at = boundary_(pos);
+            node_base *first = other.head_.next_;
+            node_base *last = other.head_.prev_;
+            size_ += other.size_;
+            nodes_ += other.nodes_;
+            other.empty_initialize_();
+            link_range_(at, first, last);
+        }
+
+        void splice(const_iterator pos, unrolled_list &&other) { splice(pos, other); }
+
+        /**
+         * 把 other 中 it 所在的整个节点移到 pos 之前，O(1)（pos 在节点中间时要先分裂，O(K)）
+         * other 可以就是 *this；pos 落在被移动的节点里时什么也不做
+         * 返回指向被移动节点第一个元素的迭代器
+         */
+        iterator splice_node(const_iterator pos, unrolled_list &other, const_iterator it) {
+            node *moved = as_node_(it.node_);
+            if (pos.node_ == moved) {
+                return iterator(moved, 0);
+            }
+            node_base *at = boundary_(pos);
+            if (at == moved->next_) {
+                return iterator(moved, 0);
+            }
+            unlink_(moved);
+            --other.nodes_;
+            other.size_ -= moved->count_;
+            ++nodes_;
+            size_ += moved->count_;
+            link_range_(at, moved, moved);
+            return iterator(moved, 0);
+        }
+
+        ///-------------其他
+        void swap(unrolled_list &other) noexcept {
+            std::swap(head_.prev_, other.head_.prev_);
+            std::swap(head_.next_, other.head_.next_);
+            std::swap(size_, other.size_);
+            std::swap(nodes_, other.nodes_);
+            fix_head_(head_, other.head_);
+            fix_head_(other.head_, head_);
+        }
+
+        /// 重新把元素紧密地排进尽量少的节点里，返回释放的节点数
+        size_type compact() {
+            size_type before = nodes_;
+            unrolled_list packed;
+            for (auto &value : *this) {
+                packed.push_back(std::move(value));
+            }
+            swap(packed);
+            return before - nodes_;
+        }
+
+        bool operator==(const unrolled_list &other) const {
+            return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+        }
+
+        bool operator!=(const unrolled_list &other) const {
+            return !(*this == other);
+        }
+
+    private:
+        static node *as_node_(node_base *p) noexcept { return static_cast<node *>(p); }
+
+        static node *as_node_(const node_base *p) noexcept { return static_cast<node *>(const_cast<node_base *>(p)); }
+
+        void empty_initialize_() noexcept {
+            head_.prev_ = &head_;
+            head_.next_ = &head_;
+            size_ = 0;
+            nodes_ = 0;
+        }
+
+        /// 交换之后哨兵被别的节点引用着，把首尾节点的指针改回自己；空链表指向自己
+        static void fix_head_(node_base &head, node_base &other) noexcept {
+            if (head.next_ == &other) {
+                head.next_ = head.prev_ = &head;
+            } else {
+                head.next_->prev_ = &head;
+                head.prev_->next_ = &head;
+            }
+        }
+
+        template<typename InputIt>
+        void append_(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+
+        /// 分配一个空节点，还没有链接进链表
+        node *allocate_node_() {
+            node *n = node_traits::allocate(allocator_, 1);
+            ::new(static_cast<void *>(n)) node();
+            return n;
+        }
+
+        /// 分配一个空节点并链接到 before 之前
+        node *create_node_(node_base *before) {
+            node *n = allocate_node_();
+            link_range_(before, n, n);
+            ++nodes_;
+            return n;
+        }
+
+        /// 分配一个节点并构造第一个元素，构造成功之后才链接到 before 之前；构造抛异常时释放节点，链表不变
+        template<typename... Args>
+        node *create_node_with_(node_base *before, Args &&... args) {
+            node *n = allocate_node_();
+            try {
+                std::construct_at(n->data(), std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate_node_(n);
+                throw;
+            }
+            n->count_ = 1;
+            link_range_(before, n, n);
+            ++nodes_;
+            return n;
+        }
+
+        void deallocate_node_(node *n) noexcept {
+            n->~node();
+            node_traits::deallocate(allocator_, n, 1);
+        }
+
+        /// 从链表中摘下已经为空的节点并释放
+        void destroy_node_(node *n) noexcept {
+            unlink_(n);
+            --nodes_;
+            deallocate_node_(n);
+        }
+
+        static void unlink_(node_base *n) noexcept {
+            n->prev_->next_ = n->next_;
+            n->next_->prev_ = n->prev_;
+        }
+
+        /// 把 first..last 这一串节点链接到 before 之前
+        static void link_range_(node_base *before, node_base *first, node_base *last) noexcept {
+            node_base *prev = before->prev_;
+            prev->next_ = first;
+            first->prev_ = prev;
+            last->next_ = before;
+            before->prev_ = last;
+        }
+
+        /// 在节点未满的前提下把元素构造到 index 处，后面的元素后移一位
+        template<typename... Args>
+        void insert_in_node_(node *n, size_type index, Args &&... args) {
+            T *data = n->data();
+            if (index == n->count_) {
+                std::construct_at(data + index, std::forward<Args>(args)...);
+            } else {
+                /// 先构造好新值（参数可能引用着本节点里将要移动的元素）
+                T value(std::forward<Args>(args)...);
+                std::construct_at(data + n->count_, std::move(data[n->count_ - 1]));
+                std::move_backward(data + index, data + n->count_ - 1, data + n->count_);
+                data[index] = std::move(value);
+            }
+            ++n->count_;
+        }
+
+        /// 把 n 中 [at, count_) 的元素搬到紧跟在 n 后面的新节点里
+        void split_(node *n, size_type at) {
+            node *fresh = create_node_(n->next_);
+            T *src = n->data();
+            T *dst = fresh->data();
+            for (size_type i = at; i < n->count_; ++i) {
+                std::construct_at(dst + (i - at), std::move(src[i]));
+                std::destroy_at(src + i);
+            }
+            fresh->count_ = n->count_ - at;
+            n->count_ = at;
+        }
+
+        /// 把 n 的后一个节点的全部元素搬到 n 的末尾，释放后一个节点
+        void merge_next_(node *n) {
+            node *next = as_node_(n->next_);
+            T *src = next->data();
+            T *dst = n->data() + n->count_;
+            for (size_type i = 0; i < next->count_; ++i) {
+                std::construct_at(dst + i, std::move(src[i]));
+                std::destroy_at(src + i);
+            }
+            n->count_ += next->count_;
+            next->count_ = 0;
+            destroy_node_(next);
+        }
+
+        /// 返回 pos 之前的节点边界：pos 在节点中间时先在 pos 处分裂，返回分裂出来的后半个节点
+        node_base *boundary_(const_iterator pos) {
+            if (pos.index_ == 0) {
+                return pos.node_;
+            }
+            node *n = as_node_(pos.node_);
+            split_(n, pos.index_);
+            return n->next_;
+        }
+
+        node_base head_;
+        size_type size_ = 0;
+        size_type nodes_ = 0;
+        [[no_unique_address]] node_allocator allocator_;
+    };
+
+    template<typename T, size_t K, typename Alloc>
+    void swap(unrolled_list<T, K, Alloc> &lhs, unrolled_list<T, K, Alloc> &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+}
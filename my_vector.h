@@ -14,6 +14,7 @@
 #include "my_algorithm.h"
 #include "my_iterator.h"
 
+#include <algorithm>
 #include <initializer_list>
 #include <type_traits>
 #include <memory>
@@ -316,6 +317,14 @@ namespace my {
             return pos;
         }
 
+        /// 删除 [first, last)，后面的元素整体前移
+        iterator erase(iterator first, iterator last) {
+            if (first != last) {
+                erase_at_end_(std::move(last, finish_, first));
+            }
+            return first;
+        }
+
         /// emplace_back模板
         template<typename ...Args>
         void emplace_back(Args &&...args) {
@@ -432,9 +441,18 @@ namespace my {
         template<typename... Args>
         void emplace_impl_(iterator pos, Args &&... args) {
             if (finish_ != end_of_storage_) {
-                std::move_backward(pos, finish_, finish_ + 1);
-                std::allocator_traits<Alloc>::construct(alloc_, pos, std::forward<Args>(args)...);
+                if (pos == finish_) {
+                    std::allocator_traits<Alloc>::construct(alloc_, finish_, std::forward<Args>(args)...);
+                    ++finish_;
+                    return;
+                }
+                /// finish_ 处是未构造的内存：先用最后一个元素移动构造它，其余元素再整体后移（移动赋值）
+                /// args 可能引用容器中的元素，所以先构造出临时对象再搬移
+                value_type tmp(std::forward<Args>(args)...);
+                std::allocator_traits<Alloc>::construct(alloc_, finish_, std::move(*(finish_ - 1)));
                 ++finish_;
+                std::move_backward(pos, finish_ - 2, finish_ - 1);
+                *pos = std::move(tmp);
             } else {
                 realloc_emplace_(pos, std::forward<Args>(args)...);
             }
@@ -0,0 +1,172 @@
+/**
+ * @file      my_ws_deque.h
+ * @brief     [Chase-Lev 工作窃取双端队列：所有者在底部无锁 push / pop，其他线程在顶部并发 steal，环形数组可增长，旧数组安全回收]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_futex.h"
+#include "my_optional.h"
+#include "my_vector.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * ws_deque<T>（Chase & Lev 2005，内存序按 Lê、Pop、Cohen、Zappa Nardelli 2013 对 C11 内存模型的证明版本）
+ * 所有者线程（创建任务的工作线程）：push / pop 在底部 bottom_ 操作，后进先出，局部性好
+ * 窃取线程（空闲的其他工作线程）：steal 在顶部 top_ 操作，先进先出，拿走的是最早入队、通常也是最大的任务
+ * 下标 top_ / bottom_ 都是单调变化的 64 位有符号计数，元素个数是 bottom_ - top_，槽位是 计数 & mask
+ * 同步：
+ *      push：写槽位，release 栅栏，再写 bottom_ —— 窃取者 acquire 读到新的 bottom_ 时一定能读到槽位里的值
+ *      pop：先把 bottom_ 减一，seq_cst 栅栏之后再读 top_；steal：读 top_，seq_cst 栅栏之后再读 bottom_
+ *           两个栅栏保证所有者和窃取者不会都以为自己拿到了同一个元素；只剩最后一个元素时双方用 CAS top_ 决胜负
+ * 元素：窃取者读槽位和所有者写槽位可能同时发生（窃取者随后 CAS 失败并丢弃读到的值），
+ *      所以槽位是 std::atomic<T>，T 必须可平凡复制；大对象请存指针（任务调度器里通常就是任务指针）
+ * 增长：空间不够时所有者分配两倍大小的新数组，复制 [top_, bottom_) 后发布新数组
+ *      窃取者可能还在读旧数组，旧数组不能立即释放，放进所有者私有的退休列表，在 ws_deque 析构时统一释放
+ *      数组按 2 倍增长，所有退休数组加起来不超过当前数组的大小，用有界的内存换来不需要 epoch / hazard pointer
+ */
+
+namespace my {
+
+    template<typename T>
+    class ws_deque {
+        static_assert(std::is_trivially_copyable_v<T>, "ws_deque<T> requires a trivially copyable T, store pointers for larger tasks");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+
+        /// 初始槽位数向上取 2 的幂
+        explicit ws_deque(size_type capacity = 64)
+                : top_(0), bottom_(0),
+                  array_(new ring_array(std::bit_ceil(capacity < 2 ? size_type(2) : capacity))) {}
+
+        ws_deque(const ws_deque &) = delete;
+
+        ws_deque &operator=(const ws_deque &) = delete;
+
+        ~ws_deque() {
+            delete array_.load(std::memory_order_relaxed);
+            for (ring_array *old : retired_) {
+                delete old;
+            }
+        }
+
+        /// 只能由所有者线程调用；空间不够时增长
+        void push(T value) {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_acquire);
+            ring_array *a = array_.load(std::memory_order_relaxed);
+            if (b - t > static_cast<int64_t>(a->mask_)) {
+                a = grow_(a, t, b);
+            }
+            a->store(b, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// 只能由所有者线程调用；从底部取出最近 push 的元素，为空时返回空 optional
+        my::optional<T> pop() {
+            int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            ring_array *a = array_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                /// 本来就是空的，恢复 bottom_
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return my::optional<T>();
+            }
+            T value = a->load(b);
+            if (t == b) {
+                /// 只剩最后一个元素，和窃取者竞争
+                bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                if (!won) {
+                    return my::optional<T>();
+                }
+            }
+            return my::optional<T>(value);
+        }
+
+        /// 任何线程都可以调用；从顶部取出最早 push 的元素
+        /// 为空或者和其他窃取者 / 所有者竞争失败时返回空 optional，调用方通常换一个目标队列或稍后重试
+        my::optional<T> steal() {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) {
+                return my::optional<T>();
+            }
+            /// 读到的数组至少和 bottom_ 一样新：所有者先发布新数组（release）再推进 bottom_
+            ring_array *a = array_.load(std::memory_order_acquire);
+            T value = a->load(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return my::optional<T>();
+            }
+            return my::optional<T>(value);
+        }
+
+        /// 元素个数的近似值，并发修改时只能作为参考（例如选择窃取目标）
+        size_type size_approx() const noexcept {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_type>(b - t) : 0;
+        }
+
+        bool empty_approx() const noexcept { return size_approx() == 0; }
+
+        /// 当前数组的槽位数，只应由所有者线程调用
+        size_type capacity() const noexcept { return array_.load(std::memory_order_relaxed)->mask_ + 1; }
+
+    private:
+        /// 环形数组：槽位是原子变量，读写都用 relaxed，顺序由 top_ / bottom_ 上的栅栏和 CAS 保证
+        struct ring_array {
+            explicit ring_array(size_type size) : mask_(size - 1), slots_(new std::atomic<T>[size]) {}
+
+            ~ring_array() { delete[] slots_; }
+
+            ring_array(const ring_array &) = delete;
+
+            ring_array &operator=(const ring_array &) = delete;
+
+            T load(int64_t i) const noexcept {
+                return slots_[static_cast<size_type>(i) & mask_].load(std::memory_order_relaxed);
+            }
+
+            void store(int64_t i, T value) noexcept {
+                slots_[static_cast<size_type>(i) & mask_].store(value, std::memory_order_relaxed);
+            }
+
+            size_type mask_;
+            std::atomic<T> *slots_;
+        };
+
+        /// 分配两倍大小的数组并复制现有元素，发布之后把旧数组放进退休列表
+        /// 退休列表的空间先预留好，新数组分配成功之后就不会再抛异常；任何一步分配失败时双端队列保持原样
+        ring_array *grow_(ring_array *old, int64_t t, int64_t b) {
+            retired_.reserve(retired_.size() + 1);
+            auto *bigger = new ring_array((old->mask_ + 1) * 2);
+            for (int64_t i = t; i < b; ++i) {
+                bigger->store(i, old->load(i));
+            }
+            retired_.push_back(old);
+            array_.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+        /// 所有者写、窃取者读的 bottom_ 和窃取者之间 CAS 的 top_ 分别放在独立的缓存行上
+        alignas(detail::cache_line_size) std::atomic<int64_t> top_;
+        alignas(detail::cache_line_size) std::atomic<int64_t> bottom_;
+        alignas(detail::cache_line_size) std::atomic<ring_array *> array_;
+        my::vector<ring_array *> retired_;       /// 只有所有者线程访问
+    };
+}
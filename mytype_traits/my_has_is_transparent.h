@@ -0,0 +1,25 @@
+/**
+ * @file      my_has_is_transparent.h
+ * @brief     [判断函数对象是否声明了 is_transparent，用于关联容器的异构查找]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#pragma once
+
+#include "my_integral_constant.h"
+#include "my_void_t.h"
+
+namespace my {
+    /// 哈希函数/比较器中定义了 using is_transparent = ... 时，容器允许直接用与 key 可比较的其他类型查找（如 const char* 查 string 键）
+    template<typename T, typename = void>
+    struct has_is_transparent : false_type {
+    };
+
+    template<typename T>
+    struct has_is_transparent<T, void_t<typename T::is_transparent>> : true_type {
+    };
+
+    template<typename T>
+    inline constexpr bool has_is_transparent_v = has_is_transparent<T>::value;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file      my_algorithm_test.cpp
+ * @brief     [测试分段算法：deque 迭代器上的 copy / move / fill / for_each / find / accumulate，以及改用它们之后的 deque 插入删除]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_algorithm.h"
+#include "my_deque.h"
+
+#include <cassert>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/// 每块只有 16 个元素，少量元素就能跨很多块
+struct Big {
+    int value = 0;
+    char pad[252] = {};
+
+    Big() = default;
+
+    Big(int v) : value(v) {}
+
+    bool operator==(const Big &rhs) const { return value == rhs.value; }
+};
+
+/// 拷贝和移动都不是平凡的
+struct Str {
+    std::string s;
+
+    Str(int v = 0) : s(std::to_string(v) + " padding to defeat small string optimization") {}
+
+    bool operator==(const Str &rhs) const { return s == rhs.s; }
+};
+
+int value_of(int x) { return x; }
+
+int value_of(const Big &x) { return x.value; }
+
+int value_of(const Str &x) { return std::stoi(x.s); }
+
+template<typename D>
+std::vector<int> values_of(const D &d) {
+    std::vector<int> out;
+    for (auto it = d.begin(); it != d.end(); ++it) {
+        out.push_back(value_of(*it));
+    }
+    return out;
+}
+
+template<typename T>
+my::deque<T> make_deque(int n) {
+    my::deque<T> d;
+    for (int i = 0; i < n; ++i) {
+        d.push_back(T(i));
+    }
+    return d;
+}
+
+/// 各种起止位置（块内、恰好在块边界、跨多块），与逐个元素的结果对照
+template<typename T>
+void test_copy_and_move() {
+    constexpr int n = 3 * static_cast<int>(my::default_chunk_size<T>) + 7;
+    const int chunk = static_cast<int>(my::default_chunk_size<T>);
+    const int offsets[] = {0, 1, chunk - 1, chunk, chunk + 1, 2 * chunk, n / 2};
+    for (int from : offsets) {
+        for (int len : {0, 1, chunk - 1, chunk, chunk + 3, 2 * chunk + 1}) {
+            if (from + len > n) {
+                continue;
+            }
+            my::deque<T> src = make_deque<T>(n);
+
+            /// deque -> vector
+            std::vector<T> vec(len);
+            auto vend = my::copy(src.begin() + from, src.begin() + from + len, vec.begin());
+            assert(vend == vec.end());
+            for (int i = 0; i < len; ++i) {
+                assert(vec[i] == T(from + i));
+            }
+
+            /// vector -> deque，目标也从各个位置开始
+            for (int to : offsets) {
+                if (to + len > n) {
+                    continue;
+                }
+                my::deque<T> dst(n);
+                auto dend = my::copy(vec.begin(), vec.end(), dst.begin() + to);
+                assert(dend == dst.begin() + to + len);
+                for (int i = 0; i < n; ++i) {
+                    bool inside = i >= to && i < to + len;
+                    assert(dst[i] == (inside ? T(from + i - to) : T()));
+                }
+
+                /// deque -> deque
+                my::deque<T> dst2(n);
+                auto dend2 = my::move(src.begin() + from, src.begin() + from + len, dst2.begin() + to);
+                assert(dend2 == dst2.begin() + to + len);
+                for (int i = 0; i < len; ++i) {
+                    assert(dst2[to + i] == T(from + i));
+                }
+
+                /// copy_backward：目标尾后位置是 to + len
+                my::deque<T> dst3(n);
+                auto dbegin3 = my::copy_backward(src.begin() + from, src.begin() + from + len,
+                                                 dst3.begin() + to + len);
+                assert(dbegin3 == dst3.begin() + to);
+                for (int i = 0; i < len; ++i) {
+                    assert(dst3[to + i] == T(from + i));
+                }
+            }
+        }
+    }
+    std::cout << "test_copy_and_move passed\n";
+}
+
+/// 同一个 deque 内部有重叠的移动（deque 插入删除就是这样用的）
+void test_overlapping_shift() {
+    const int n = 5000;
+    for (int shift : {1, 3, 1023, 1024, 1025}) {
+        my::deque<int> d = make_deque<int>(n);
+        std::vector<int> expect = values_of(d);
+        my::move(d.begin() + shift, d.end(), d.begin());
+        std::move(expect.begin() + shift, expect.end(), expect.begin());
+        assert(values_of(d) == expect);
+
+        my::move_backward(d.begin(), d.end() - shift, d.end());
+        std::move_backward(expect.begin(), expect.end() - shift, expect.end());
+        assert(values_of(d) == expect);
+    }
+    std::cout << "test_overlapping_shift passed\n";
+}
+
+void test_fill_for_each_find_accumulate() {
+    const int n = 5000;
+    my::deque<int> d = make_deque<int>(n);
+
+    long long sum = my::accumulate(d.begin(), d.end(), 0LL);
+    assert(sum == 1LL * n * (n - 1) / 2);
+    assert(my::accumulate(d.begin() + 1000, d.begin() + 1000, 5) == 5);
+    assert(my::accumulate(d.begin() + 10, d.begin() + 3000, 0LL) == 1LL * 2999 * 3000 / 2 - 1LL * 9 * 10 / 2);
+
+    const my::deque<int> &cd = d;
+    for (int key : {0, 1, 1023, 1024, 2047, 2048, 4999}) {
+        auto it = my::find(cd.begin(), cd.end(), key);
+        assert(it != cd.end() && *it == key && it - cd.begin() == key);
+        auto it2 = my::find_if(d.begin(), d.end(), [key](int x) { return x == key; });
+        assert(it2 == d.begin() + key);
+    }
+    assert(my::find(d.begin(), d.end(), -1) == d.end());
+    assert(my::find(d.begin() + 10, d.begin() + 20, 20) == d.begin() + 20);
+
+    int count = 0;
+    my::for_each(d.begin() + 7, d.end() - 7, [&](int x) {
+        assert(x == count + 7);
+        ++count;
+    });
+    assert(count == n - 14);
+
+    my::fill(d.begin() + 1000, d.begin() + 3100, -1);
+    for (int i = 0; i < n; ++i) {
+        assert(d[i] == (i >= 1000 && i < 3100 ? -1 : i));
+    }
+
+    /// 非分段迭代器直接交给 std
+    std::vector<int> v(10, 1);
+    my::fill(v.begin(), v.begin() + 5, 2);
+    assert(my::accumulate(v.begin(), v.end(), 0) == 15);
+    assert(my::find(v.begin(), v.end(), 1) == v.begin() + 5);
+    std::cout << "test_fill_for_each_find_accumulate passed\n";
+}
+
+/// 随机的 insert / erase / resize / 拷贝构造，与 std::deque 对照
+template<typename T>
+void test_deque_ops_against_std() {
+    std::mt19937 rng(41);
+    my::deque<T> d;
+    std::deque<T> expect;
+    for (int round = 0; round < 400; ++round) {
+        size_t size = expect.size();
+        switch (rng() % 6) {
+            case 0: {
+                size_t pos = size == 0 ? 0 : rng() % (size + 1);
+                size_t n = 1 + rng() % 50;
+                int v = static_cast<int>(rng() % 1000);
+                d.insert(d.begin() + pos, n, T(v));
+                expect.insert(expect.begin() + pos, n, T(v));
+                break;
+            }
+            case 1: {
+                if (size == 0) {
+                    break;
+                }
+                size_t pos = rng() % size;
+                d.erase(d.begin() + pos);
+                expect.erase(expect.begin() + pos);
+                break;
+            }
+            case 2: {
+                size_t n = rng() % 300;
+                int v = static_cast<int>(rng() % 1000);
+                d.resize(n, T(v));
+                expect.resize(n, T(v));
+                break;
+            }
+            case 3: {
+                size_t pos = size == 0 ? 0 : rng() % (size + 1);
+                int v = static_cast<int>(rng() % 1000);
+                d.insert(d.begin() + pos, T(v));
+                expect.insert(expect.begin() + pos, T(v));
+                break;
+            }
+            case 4: {
+                for (int i = 0; i < 40; ++i) {
+                    d.push_front(T(i));
+                    expect.push_front(T(i));
+                }
+                break;
+            }
+            default: {
+                my::deque<T> copy(d);
+                d.swap(copy);
+                break;
+            }
+        }
+        assert(d.size() == expect.size());
+        assert(values_of(d) == values_of(expect));
+    }
+    std::cout << "test_deque_ops_against_std passed\n";
+}
+
+int main() {
+    test_copy_and_move<int>();
+    test_copy_and_move<Big>();
+    test_overlapping_shift();
+    test_fill_for_each_find_accumulate();
+    test_deque_ops_against_std<int>();
+    test_deque_ops_against_std<Big>();
+    test_deque_ops_against_std<Str>();
+    return 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file      my_btree_map_test.cpp
+ * @brief     [测试btree_map和btree_multimap]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_btree_map.h"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+void test_btree_map_basic() {
+    my::btree_map<int, std::string> m;
+    m[3] = "three";
+    m[1] = "one";
+    m[2] = "two";
+    assert(m.size() == 3);
+    assert(m.insert({2, "TWO"}).second == false);
+    assert(m[2] == "two");
+    assert(m.find(3)->second == "three");
+    assert(m.find(4) == m.end());
+    assert(m.contains(1) && !m.contains(0));
+    assert(m.at(1) == "one");
+
+    bool thrown = false;
+    try {
+        m.at(100);
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    m.insert_or_assign(2, "TWO");
+    assert(m[2] == "TWO");
+    assert(m.try_emplace(2, "x").second == false);
+    assert(m.emplace(4, "four").second);
+
+    int expect = 1;
+    for (auto &kv: m) {
+        assert(kv.first == expect++);
+    }
+    assert(m.lower_bound(2)->first == 2);
+    assert(m.upper_bound(2)->first == 3);
+    assert(m.erase(2) == 1 && m.size() == 3 && !m.contains(2));
+    assert(m.verify());
+    std::cout << "test_btree_map_basic passed\n";
+}
+
+/// 随机插入/删除，和 std::map 逐步对照，并检查 B 树结构
+void test_btree_map_random_against_std() {
+    my::btree_map<int, int> m;
+    std::map<int, int> ref;
+    std::mt19937 rng(7);
+    for (int round = 0; round < 20000; ++round) {
+        int key = static_cast<int>(rng() % 3000);
+        switch (rng() % 4) {
+            case 0:
+            case 1: {
+                bool a = m.insert({key, round}).second;
+                bool b = ref.insert({key, round}).second;
+                assert(a == b);
+                break;
+            }
+            case 2: {
+                assert(m.erase(key) == ref.erase(key));
+                break;
+            }
+            default: {
+                auto it = m.find(key);
+                auto rit = ref.find(key);
+                assert((it == m.end()) == (rit == ref.end()));
+                if (it != m.end()) {
+                    assert(it->second == rit->second);
+                    /// erase(iterator) 返回的是下一个元素
+                    auto next = m.erase(it);
+                    auto rnext = ref.erase(rit);
+                    assert((next == m.end()) == (rnext == ref.end()));
+                    if (rnext != ref.end()) {
+                        assert(next->first == rnext->first);
+                    }
+                }
+            }
+        }
+        if (round % 1000 == 0) {
+            assert(m.verify());
+        }
+    }
+    assert(m.verify());
+    assert(m.size() == ref.size());
+    auto rit = ref.begin();
+    for (auto it = m.begin(); it != m.end(); ++it, ++rit) {
+        assert(it->first == rit->first && it->second == rit->second);
+    }
+
+    /// 反向遍历
+    auto it = m.end();
+    auto rrit = ref.rbegin();
+    while (it != m.begin()) {
+        --it;
+        assert(it->first == rrit->first);
+        ++rrit;
+    }
+
+    /// 区间删除到空
+    m.erase(m.cbegin(), m.cend());
+    assert(m.empty() && m.verify() && m.begin() == m.end());
+    std::cout << "test_btree_map_random_against_std passed\n";
+}
+
+void test_btree_map_sequential_and_copy() {
+    my::btree_map<int, int> m;
+    for (int i = 0; i < 100000; ++i) {
+        m[i] = i * 2;
+    }
+    assert(m.size() == 100000 && m.verify());
+    /// 顺序插入时节点几乎是满的，树高很低
+    assert(m.height() <= 5);
+
+    my::btree_map<int, int> copy(m);
+    assert(copy == m && copy.verify());
+    my::btree_map<int, int> moved(std::move(copy));
+    assert(moved.size() == 100000 && copy.empty());
+
+    /// 从前往后删除
+    for (int i = 0; i < 100000; i += 2) {
+        m.erase(i);
+    }
+    assert(m.size() == 50000 && m.verify());
+    assert(m.begin()->first == 1);
+    std::cout << "test_btree_map_sequential_and_copy passed\n";
+}
+
+void test_btree_multimap() {
+    my::btree_multimap<std::string, int> mm = {{"a", 1}, {"b", 2}, {"b", 3}, {"c", 4}};
+    for (int i = 0; i < 200; ++i) {
+        mm.insert({"b", 100 + i});
+    }
+    assert(mm.count("b") == 202);
+    /// 等价 key 保持插入顺序
+    auto range = mm.equal_range("b");
+    assert(range.first->second == 2);
+    int prev = 0;
+    for (auto it = range.first; it != range.second; ++it) {
+        assert(it->second > prev);
+        prev = it->second;
+    }
+    assert(mm.erase("b") == 202);
+    assert(mm.size() == 2 && mm.verify());
+    std::cout << "test_btree_multimap passed\n";
+}
+
+void test_btree_map_transparent() {
+    my::btree_map<std::string, int, std::less<>> m;
+    m["apple"] = 1;
+    m["banana"] = 2;
+    assert(m.find("apple")->second == 1);      /// 直接用 const char* 查找
+    assert(m.count("cherry") == 0);
+    assert(m.lower_bound("b")->first == "banana");
+    std::cout << "test_btree_map_transparent passed\n";
+}
+
+void test_btree_map_sorted_construction() {
+    std::vector<std::pair<int, int>> sorted;
+    for (int i = 0; i < 50000; ++i) {
+        sorted.emplace_back(i * 2, i);
+    }
+    my::btree_map<int, int> m(my::sorted_unique, sorted.begin(), sorted.end());
+    assert(m.size() == 50000 && m.verify());
+
+    /// 一部分落在现有元素中间，一部分追加在最后
+    std::vector<std::pair<int, int>> more;
+    for (int i = 90000; i < 110000; ++i) {
+        more.emplace_back(i, -1);
+    }
+    m.insert_sorted(more.begin(), more.end());
+    assert(m.size() == 50000 + 5000 + 10000 && m.verify());
+    assert(m.find(90000)->second == 45000 && m.find(90001)->second == -1);
+
+    my::btree_multimap<int, int> mm(my::sorted_equivalent, sorted.begin(), sorted.begin() + 10);
+    mm.insert_sorted(sorted.begin(), sorted.begin() + 10);
+    assert(mm.size() == 20 && mm.count(0) == 2 && mm.verify());
+    std::cout << "test_btree_map_sorted_construction passed\n";
+}
+
+int main() {
+    test_btree_map_basic();
+    test_btree_map_random_against_std();
+    test_btree_map_sequential_and_copy();
+    test_btree_multimap();
+    test_btree_map_transparent();
+    test_btree_map_sorted_construction();
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file      my_btree_set_test.cpp
+ * @brief     [测试btree_set和btree_multiset]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_btree_set.h"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+
+void test_btree_set_basic() {
+    my::btree_set<int> s = {5, 1, 4, 1, 3};
+    assert(s.size() == 4);
+    assert(s.insert(2).second && !s.insert(2).second);
+    int expect = 1;
+    for (int v: s) {
+        assert(v == expect++);
+    }
+    assert(s.count(3) == 1 && s.count(9) == 0);
+    assert(*s.lower_bound(0) == 1);
+    assert(s.upper_bound(5) == s.end());
+    assert(s.erase(3) == 1 && !s.contains(3));
+    assert(s.verify());
+
+    my::btree_set<std::string> names;
+    names.emplace("bob");
+    names.insert(std::string("alice"));
+    assert(*names.begin() == "alice");
+    std::cout << "test_btree_set_basic passed\n";
+}
+
+/// 随机插入/删除和 std::multiset 对照，覆盖合并、借元素和根降高
+void test_btree_multiset_random_against_std() {
+    my::btree_multiset<int> s;
+    std::multiset<int> ref;
+    std::mt19937 rng(11);
+    for (int round = 0; round < 30000; ++round) {
+        int v = static_cast<int>(rng() % 500);
+        if (rng() % 3 != 0) {
+            s.insert(v);
+            ref.insert(v);
+        } else {
+            auto it = s.find(v);
+            auto rit = ref.find(v);
+            assert((it == s.end()) == (rit == ref.end()));
+            if (it != s.end()) {
+                s.erase(it);
+                ref.erase(rit);
+            }
+        }
+        if (round % 2000 == 0) {
+            assert(s.verify());
+        }
+    }
+    assert(s.verify() && s.size() == ref.size());
+    for (int v = 0; v < 500; ++v) {
+        assert(s.count(v) == ref.count(v));
+    }
+    auto rit = ref.begin();
+    for (int v: s) {
+        assert(v == *rit++);
+    }
+
+    /// 从后往前逐个删除
+    while (!s.empty()) {
+        auto last = s.end();
+        --last;
+        s.erase(last);
+    }
+    assert(s.verify());
+    std::cout << "test_btree_multiset_random_against_std passed\n";
+}
+
+void test_btree_multiset_range_erase() {
+    /// 区间删除整段删叶子上的元素，每段只修复一次：结果和 std::multiset 一致，结构始终合法
+    std::mt19937 rng(9);
+    my::btree_multiset<int> s;
+    std::multiset<int> ref;
+    for (int i = 0; i < 20000; ++i) {
+        int v = static_cast<int>(rng() % 3000);
+        s.insert(v);
+        ref.insert(v);
+    }
+    while (!ref.empty()) {
+        int lo = static_cast<int>(rng() % 3000);
+        int hi = lo + static_cast<int>(rng() % (rng() % 4 == 0 ? 600 : 30));
+        auto next = s.erase(s.lower_bound(lo), s.lower_bound(hi));
+        auto rnext = ref.erase(ref.lower_bound(lo), ref.lower_bound(hi));
+        assert(s.verify() && s.size() == ref.size());
+        assert(rnext == ref.end() ? next == s.end() : *next == *rnext);
+        int key = static_cast<int>(rng() % 3000);
+        assert(s.erase(key) == ref.erase(key));
+        if (ref.size() < 2000 && rng() % 8 == 0) {
+            s.erase(s.begin(), s.end());
+            ref.clear();
+        }
+    }
+    assert(s.empty() && s.verify());
+    std::cout << "test_btree_multiset_range_erase passed\n";
+}
+
+/// 带状态的分配器：所有 rebind 出来的分配器共用同一个计数
+template<typename T>
+struct counting_alloc {
+    using value_type = T;
+
+    long *live;
+
+    explicit counting_alloc(long *counter) : live(counter) {}
+
+    template<typename U>
+    counting_alloc(const counting_alloc<U> &other) : live(other.live) {}
+
+    T *allocate(size_t n) {
+        ++*live;
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t) {
+        --*live;
+        ::operator delete(p);
+    }
+
+    template<typename U>
+    bool operator==(const counting_alloc<U> &other) const { return live == other.live; }
+
+    template<typename U>
+    bool operator!=(const counting_alloc<U> &other) const { return live != other.live; }
+};
+
+void test_btree_set_stateful_allocator() {
+    long live = 0;
+    {
+        using set_type = my::btree_set<int, std::less<int>, counting_alloc<int>>;
+        set_type s{std::less<int>(), counting_alloc<int>(&live)};
+        for (int i = 0; i < 5000; ++i) {
+            s.insert(i * 7 % 5000);
+        }
+        assert(live > 1 && s.get_allocator().live == &live);
+        set_type copy(s);
+        assert(copy.get_allocator().live == &live && copy == s);
+        s.erase(s.begin(), s.find(4000));
+        assert(s.verify() && s.size() == 1000);
+    }
+    assert(live == 0);
+    std::cout << "test_btree_set_stateful_allocator passed\n";
+}
+
+int main() {
+    test_btree_set_basic();
+    test_btree_multiset_random_against_std();
+    test_btree_multiset_range_erase();
+    test_btree_set_stateful_allocator();
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file      my_concurrent_unordered_map_test.cpp
+ * @brief     [concurrent_unordered_map测试]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_concurrent_unordered_map.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test_basic_operations() {
+    my::concurrent_unordered_map<int, std::string> map;
+    assert(map.empty());
+    assert(map.insert_or_assign(1, "one"));
+    assert(map.insert_or_assign(2, "two"));
+    assert(!map.insert_or_assign(1, "ONE"));     /// 覆盖已有值
+    assert(!map.insert(2, "TWO"));               /// 已存在，不插入
+    assert(map.size() == 2);
+
+    auto v = map.find(1);
+    assert(v.has_value() && v.value() == "ONE");
+    assert(!map.find(3).has_value());
+    assert(map.contains(2));
+
+    size_t len = 0;
+    assert(map.find(2, [&](const std::string &s) { len = s.size(); }));
+    assert(len == 3);
+    assert(map.modify(2, [](std::string &s) { s += "!"; }));
+    assert(map.find(2).value() == "two!");
+
+    assert(map.erase(1) == 1);
+    assert(map.erase(1) == 0);
+    assert(map.size() == 1);
+
+    map.clear();
+    assert(map.empty());
+    std::cout << "test_basic_operations passed.\n";
+}
+
+void test_for_each() {
+    my::concurrent_unordered_map<int, int> map(16, 4);
+    assert(map.segment_count() == 4);
+    for (int i = 0; i < 100; ++i) {
+        map.insert_or_assign(i, i * 2);
+    }
+    long sum = 0;
+    size_t cnt = 0;
+    map.for_each([&](const std::pair<const int, int> &kv) {
+        assert(kv.second == kv.first * 2);
+        sum += kv.second;
+        ++cnt;
+    });
+    assert(cnt == 100);
+    assert(sum == 9900);
+    std::cout << "test_for_each passed.\n";
+}
+
+/// 多线程同时插入、查找、删除，最终结果与单线程语义一致
+void test_concurrent_writers() {
+    my::concurrent_unordered_map<int, int> map;
+    const int threads = 8;
+    const int per_thread = 5000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                int key = t * per_thread + i;
+                map.insert_or_assign(key, key);
+                auto v = map.find(key);
+                assert(v.has_value() && v.value() == key);
+                if (i % 2) {
+                    map.erase(key);
+                }
+            }
+        });
+    }
+    for (auto &w: workers) {
+        w.join();
+    }
+
+    assert(map.size() == static_cast<size_t>(threads * per_thread / 2));
+    for (int key = 0; key < threads * per_thread; ++key) {
+        assert(map.contains(key) == (key % 2 == 0));
+    }
+    std::cout << "test_concurrent_writers passed.\n";
+}
+
+/// 多个线程对同一组 key 计数，检验 modify 的原子性
+void test_concurrent_modify() {
+    my::concurrent_unordered_map<int, int> map;
+    for (int k = 0; k < 16; ++k) {
+        map.insert(k, 0);
+    }
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) {
+                map.modify(i % 16, [](int &v) { ++v; });
+            }
+        });
+    }
+    for (auto &w: workers) {
+        w.join();
+    }
+    long total = 0;
+    map.for_each([&](const std::pair<const int, int> &kv) { total += kv.second; });
+    assert(total == 40000);
+    std::cout << "test_concurrent_modify passed.\n";
+}
+
+/// 已经在等的写者挡住新读者：读者释放之后两个写者依次拿到锁，期间到来的读者排在它们后面
+void test_stripe_lock_writer_preference() {
+    my::detail::stripe_lock lock;
+    std::atomic<int> order{0};
+    int writerSlots[2] = {-1, -1};
+    int readerSlot = -1;
+    lock.lock_shared();
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w] {
+            lock.lock();
+            writerSlots[w] = order.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            lock.unlock();
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));    /// 两个写者都已登记为等待者
+    lock.unlock_shared();
+    while (order.load() == 0) {
+        std::this_thread::yield();
+    }
+    std::thread reader([&] {
+        lock.lock_shared();
+        readerSlot = order.fetch_add(1);
+        lock.unlock_shared();
+    });
+    for (auto &t : writers) {
+        t.join();
+    }
+    reader.join();
+    assert(readerSlot == 2 && writerSlots[0] + writerSlots[1] == 1);
+    std::cout << "test_stripe_lock_writer_preference passed.\n";
+}
+
+int main() {
+    test_basic_operations();
+    test_for_each();
+    test_concurrent_writers();
+    test_concurrent_modify();
+    test_stripe_lock_writer_preference();
+    std::cout << "All concurrent_unordered_map tests passed.\n";
+    return 0;
+}
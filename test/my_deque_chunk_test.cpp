@@ -0,0 +1,240 @@
+/**
+ * @file      my_deque_chunk_test.cpp
+ * @brief     [测试deque的块大小模板参数、备用块缓存（稳定的先进先出流量不再调用分配器）和按块进行的批量插入删除]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_deque.h"
+
+#include <cassert>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// 统计分配和释放次数（按块 / map 计）的分配器
+namespace {
+    size_t g_allocs = 0;
+    size_t g_deallocs = 0;
+}
+
+template<typename T>
+struct CountingAlloc {
+    using value_type = T;
+
+    CountingAlloc() = default;
+
+    template<typename U>
+    CountingAlloc(const CountingAlloc<U> &) {}
+
+    T *allocate(size_t n) {
+        ++g_allocs;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, size_t n) {
+        ++g_deallocs;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAlloc<U> &) const { return true; }
+};
+
+/// 块大小可以由模板参数指定，迭代器的运算按指定的块大小进行
+void test_custom_chunk_size() {
+    my::deque<int, std::allocator<int>, 3> d;
+    std::deque<int> expect;
+    static_assert(my::deque<int, std::allocator<int>, 3>::iterator::chunk_size_ == 3);
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            d.push_front(i);
+            expect.push_front(i);
+        } else {
+            d.push_back(i);
+            expect.push_back(i);
+        }
+    }
+    assert(d.size() == expect.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+        assert(d[i] == expect[i]);
+        assert(*(d.begin() + static_cast<ptrdiff_t>(i)) == expect[i]);
+        assert(d.end() - (d.begin() + static_cast<ptrdiff_t>(i)) == static_cast<ptrdiff_t>(expect.size() - i));
+    }
+    d.insert(d.begin() + 50, 10, -1);
+    expect.insert(expect.begin() + 50, 10, -1);
+    d.erase(d.begin() + 7);
+    expect.erase(expect.begin() + 7);
+    d.resize(31, 5);
+    expect.resize(31, 5);
+    my::deque<int, std::allocator<int>, 3> copy(d);
+    size_t i = 0;
+    for (auto it = copy.begin(); it != copy.end(); ++it, ++i) {
+        assert(*it == expect[i]);
+    }
+    assert(i == expect.size());
+    std::cout << "test_custom_chunk_size passed\n";
+}
+
+/// 预热之后一直 push_back / pop_front，队列长度在几个块之间来回变化也不再分配
+void test_fifo_steady_state_does_not_allocate() {
+    using Deque = my::deque<int, CountingAlloc<int>, 16>;
+    {
+        Deque d;
+        std::deque<int> expect;
+        std::mt19937 rng(42);
+        /// 先按同样的流量预热，让 map 和备用块缓存都达到稳定的大小
+        for (int i = 0; i < 64; ++i) {
+            d.push_back(i);
+            expect.push_back(i);
+        }
+        size_t before = 0;
+        int next = 0;
+        for (int round = 0; round < 120000; ++round) {
+            if (round == 20000) {
+                before = g_allocs;
+            }
+            /// 长度在 64 到 87 之间抖动，占用的块数随对齐情况在几个块之间变化
+            int burst = static_cast<int>(rng() % 24);
+            for (int k = 0; k < burst; ++k) {
+                d.push_back(next);
+                expect.push_back(next++);
+            }
+            for (int k = 0; k < burst; ++k) {
+                assert(d.front() == expect.front());
+                d.pop_front();
+                expect.pop_front();
+            }
+        }
+        assert(g_allocs == before);
+        assert(d.size() == expect.size());
+        for (size_t i = 0; i < expect.size(); ++i) {
+            assert(d[i] == expect[i]);
+        }
+
+        /// clear 之后重新填充也从缓存中取块
+        d.clear();
+        before = g_allocs;
+        for (int i = 0; i < 16 * 3; ++i) {
+            d.push_back(i);
+        }
+        assert(g_allocs == before);
+
+        d.shrink_to_fit();
+    }
+    /// 析构时缓存中的块也要还给分配器
+    assert(g_allocs == g_deallocs);
+    std::cout << "test_fifo_steady_state_does_not_allocate passed\n";
+}
+
+/// 交换之后备用块跟着各自的分配器走，两边都能正常析构
+void test_swap_keeps_spares_with_allocator() {
+    using Deque = my::deque<int, CountingAlloc<int>, 4>;
+    {
+        Deque a;
+        Deque b;
+        for (int i = 0; i < 40; ++i) {
+            a.push_back(i);
+        }
+        for (int i = 0; i < 40; ++i) {
+            a.pop_front();
+        }
+        a.swap(b);
+        for (int i = 0; i < 20; ++i) {
+            a.push_back(i);
+            b.push_back(i);
+        }
+        assert(a.size() == 20 && b.size() == 20);
+    }
+    assert(g_allocs == g_deallocs);
+    std::cout << "test_swap_keeps_spares_with_allocator passed\n";
+}
+
+/// 随机位置的 insert(pos, first, last)、append、pop_front_n 与 std::deque 对照，块很小以便跨很多块
+template<typename T, typename MakeValue>
+void test_bulk_ops_against_std(MakeValue make) {
+    std::mt19937 rng(43);
+    my::deque<T, std::allocator<T>, 5> d;
+    std::deque<T> expect;
+    for (int round = 0; round < 600; ++round) {
+        size_t n = 1 + rng() % 40;   /// libstdc++ 的 std::deque 插入空区间时会自移动元素，不作为对照
+        std::vector<T> batch;
+        for (size_t i = 0; i < n; ++i) {
+            batch.push_back(make(static_cast<int>(rng() % 1000)));
+        }
+        switch (rng() % 4) {
+            case 0: {
+                size_t pos = rng() % (expect.size() + 1);
+                auto it = d.insert(d.begin() + pos, batch.begin(), batch.end());
+                expect.insert(expect.begin() + pos, batch.begin(), batch.end());
+                assert(it - d.begin() == static_cast<ptrdiff_t>(pos));
+                break;
+            }
+            case 1: {
+                /// 前向（非随机访问）迭代器
+                std::list<T> lst(batch.begin(), batch.end());
+                size_t pos = rng() % (expect.size() + 1);
+                d.insert(d.begin() + pos, lst.begin(), lst.end());
+                expect.insert(expect.begin() + pos, lst.begin(), lst.end());
+                break;
+            }
+            case 2: {
+                d.append(batch.begin(), batch.end());
+                expect.insert(expect.end(), batch.begin(), batch.end());
+                break;
+            }
+            default: {
+                size_t k = std::min(expect.size(), n * 2);
+                std::vector<T> out;
+                d.pop_front_n(k, std::back_inserter(out));
+                assert(std::equal(out.begin(), out.end(), expect.begin()));
+                expect.erase(expect.begin(), expect.begin() + k);
+                break;
+            }
+        }
+        assert(d.size() == expect.size());
+        assert(std::equal(expect.begin(), expect.end(), d.begin()));
+    }
+    std::cout << "test_bulk_ops_against_std passed\n";
+}
+
+/// 单遍的输入迭代器逐个插入
+void test_insert_input_iterator() {
+    my::deque<int> d;
+    d.push_back(1);
+    d.push_back(5);
+    std::istringstream in("2 3 4");
+    d.insert(d.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+    std::istringstream tail("6 7");
+    d.append(std::istream_iterator<int>(tail), std::istream_iterator<int>());
+    int expect = 1;
+    for (auto it = d.begin(); it != d.end(); ++it) {
+        assert(*it == expect++);
+    }
+    assert(expect == 8);
+
+    /// 整数参数仍然是 insert(pos, n, value)
+    d.insert(d.begin(), 3, 0);
+    assert(d.size() == 10 && d[0] == 0 && d[2] == 0 && d[3] == 1);
+
+    int arr[] = {8, 9};
+    d.push_back_range(arr);
+    assert(d.size() == 12 && d[11] == 9);
+    std::cout << "test_insert_input_iterator passed\n";
+}
+
+int main() {
+    test_custom_chunk_size();
+    test_fifo_steady_state_does_not_allocate();
+    test_swap_keeps_spares_with_allocator();
+    test_bulk_ops_against_std<int>([](int v) { return v; });
+    test_bulk_ops_against_std<std::string>([](int v) { return std::to_string(v) + " and a long enough suffix"; });
+    test_insert_input_iterator();
+    return 0;
+}
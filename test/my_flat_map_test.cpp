@@ -0,0 +1,154 @@
+/**
+ * @file      my_flat_map_test.cpp
+ * @brief     [测试flat_map]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_flat_map.h"
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+void test_flat_map_basic() {
+    my::flat_map<int, std::string> m;
+    m[3] = "three";
+    m[1] = "one";
+    m[2] = "two";
+    assert(m.size() == 3);
+    assert(m.insert({2, "TWO"}).second == false);
+    assert(m[2] == "two");
+    assert(m.find(3)->second == "three");
+    assert(m.find(4) == m.end());
+    assert(m.contains(1) && !m.contains(0) && m.count(1) == 1);
+    assert(m.at(1) == "one");
+
+    bool thrown = false;
+    try {
+        m.at(100);
+    } catch (const std::out_of_range &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    m.insert_or_assign(2, "TWO");
+    assert(m[2] == "TWO");
+    assert(m.try_emplace(2, "x").second == false);
+    assert(m.emplace(4, "four").second);
+    assert(m.insert(m.end(), {5, "five"})->first == 5);
+    assert(m.insert(m.begin(), {0, "zero"})->first == 0);
+    assert(m.insert(m.begin(), {6, "six"})->first == 6);     /// 提示不对，退化为二分
+
+    int expect = 0;
+    for (auto kv: m) {
+        assert(kv.first == expect++);
+    }
+    assert(m.keys().size() == 7 && m.values()[0] == "zero");
+    assert(m.lower_bound(2)->first == 2 && m.upper_bound(2)->first == 3);
+    auto range = m.equal_range(3);
+    assert(range.first->first == 3 && range.second->first == 4);
+    assert(m.erase(2) == 1 && m.size() == 6 && !m.contains(2));
+    auto it = m.erase(m.find(4));
+    assert(it->first == 5);
+    it = m.erase(m.begin(), m.begin() + 2);
+    assert(it->first == 3 && m.size() == 3);
+
+    const auto &cm = m;
+    my::flat_map<int, std::string>::const_iterator cit = m.begin();
+    assert(cit == cm.begin() && cm.find(3)->second == "three" && cm.at(5) == "five");
+    std::cout << "test_flat_map_basic passed\n";
+}
+
+/// 单个插入/删除与批量插入交替进行，和 std::map 逐步对照
+void test_flat_map_random_against_std() {
+    my::flat_map<int, int> m;
+    std::map<int, int> ref;
+    std::mt19937 rng(11);
+    for (int round = 0; round < 3000; ++round) {
+        int key = static_cast<int>(rng() % 2000);
+        switch (rng() % 5) {
+            case 0:
+            case 1:
+                assert(m.insert({key, round}).second == ref.insert({key, round}).second);
+                break;
+            case 2:
+                assert(m.erase(key) == ref.erase(key));
+                break;
+            case 3: {
+                /// 批量插入：随机、包含重复、和已有元素重叠，等价 key 保留先出现的
+                std::vector<std::pair<int, int>> batch;
+                size_t len = rng() % 40;
+                for (size_t i = 0; i < len; ++i) {
+                    batch.emplace_back(static_cast<int>(rng() % 2000), round * 100 + static_cast<int>(i));
+                }
+                m.insert(batch.begin(), batch.end());
+                ref.insert(batch.begin(), batch.end());
+                break;
+            }
+            default: {
+                /// 有序批量插入：全部大于已有的 key（按顺序追加）或者穿插在中间
+                std::vector<std::pair<int, int>> batch;
+                int base = rng() % 2 ? (ref.empty() ? 0 : ref.rbegin()->first + 1) : key;
+                for (int i = 0; i < 10; ++i) {
+                    batch.emplace_back(base + i * 3, round);
+                }
+                m.insert(my::sorted_unique, batch.begin(), batch.end());
+                ref.insert(batch.begin(), batch.end());
+                break;
+            }
+        }
+        assert(m.size() == ref.size());
+    }
+    auto rit = ref.begin();
+    for (auto kv: m) {
+        assert(kv.first == rit->first && kv.second == rit->second);
+        ++rit;
+    }
+    for (int key = -1; key <= 2100; ++key) {
+        auto lb = m.lower_bound(key);
+        auto rlb = ref.lower_bound(key);
+        assert((lb == m.end()) == (rlb == ref.end()));
+        if (rlb != ref.end()) {
+            assert(lb->first == rlb->first);
+        }
+        auto ub = m.upper_bound(key);
+        auto rub = ref.upper_bound(key);
+        assert((ub == m.end()) == (rub == ref.end()));
+    }
+    std::cout << "test_flat_map_random_against_std passed\n";
+}
+
+void test_flat_map_construction() {
+    my::flat_map<int, std::string> m{{3, "c"}, {1, "a"}, {3, "x"}, {2, "b"}};
+    assert(m.size() == 3 && m[3] == "c");
+
+    my::vector<int> keys = {5, 1, 4, 1};
+    my::vector<std::string> values = {"e", "a", "d", "A"};
+    my::flat_map<int, std::string> fromContainers(std::move(keys), std::move(values));
+    assert(fromContainers.size() == 3 && fromContainers[1] == "a" && fromContainers.begin()->first == 1);
+
+    my::flat_map<int, std::string> sorted(my::sorted_unique, {{1, "a"}, {2, "b"}, {7, "g"}});
+    assert(sorted.size() == 3 && (sorted.end() - 1)->second == "g");
+
+    auto parts = std::move(sorted).extract();
+    assert(parts.keys.size() == 3 && parts.values[2] == "g" && sorted.empty());
+    sorted.replace(std::move(parts.keys), std::move(parts.values));
+    assert(sorted.size() == 3 && sorted.find(2)->second == "b");
+
+    /// 透明比较器：用 string_view 查 string key 不构造临时 string
+    my::flat_map<std::string, int, std::less<>> names;
+    names["alice"] = 1;
+    names["bob"] = 2;
+    assert(names.find(std::string_view("bob"))->second == 2 && names.contains("alice"));
+    std::cout << "test_flat_map_construction passed\n";
+}
+
+int main() {
+    test_flat_map_basic();
+    test_flat_map_random_against_std();
+    test_flat_map_construction();
+    return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file      my_flat_set_test.cpp
+ * @brief     [测试flat_set]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_flat_set.h"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+void test_flat_set_basic() {
+    my::flat_set<int> s{5, 1, 3, 3, 9};
+    assert(s.size() == 4 && *s.begin() == 1 && *(s.end() - 1) == 9);
+    assert(s.insert(3).second == false && s.insert(4).second);
+    assert(*s.insert(s.end(), 10) == 10 && *s.insert(s.begin(), 0) == 0);
+    assert(s.contains(4) && !s.contains(2) && s.count(9) == 1);
+    assert(*s.lower_bound(2) == 3 && *s.upper_bound(3) == 4);
+    assert(s.erase(4) == 1 && s.erase(4) == 0);
+    assert(*s.erase(s.find(5)) == 9);
+    std::vector<int> expect = {0, 1, 3, 9, 10};
+    assert(std::vector<int>(s.begin(), s.end()) == expect);
+
+    my::flat_set<std::string, std::less<>> words{"pear", "apple"};
+    assert(words.contains(std::string_view("pear")) && *words.begin() == "apple");
+    std::cout << "test_flat_set_basic passed\n";
+}
+
+void test_flat_set_bulk_against_std() {
+    my::flat_set<int> s;
+    std::set<int> ref;
+    std::mt19937 rng(5);
+    for (int round = 0; round < 500; ++round) {
+        std::vector<int> batch;
+        size_t len = rng() % 50;
+        for (size_t i = 0; i < len; ++i) {
+            batch.push_back(static_cast<int>(rng() % 5000));
+        }
+        if (round % 3 == 0) {
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+            s.insert(my::sorted_unique, batch.begin(), batch.end());
+        } else {
+            s.insert(batch.begin(), batch.end());
+        }
+        ref.insert(batch.begin(), batch.end());
+        if (round % 7 == 0) {
+            int key = static_cast<int>(rng() % 5000);
+            assert(s.erase(key) == ref.erase(key));
+        }
+        assert(s.size() == ref.size());
+    }
+    assert(std::equal(s.begin(), s.end(), ref.begin()));
+
+    my::flat_set<int> sorted(my::sorted_unique, {1, 2, 3});
+    my::vector<int> keys = std::move(sorted).extract();
+    assert(keys.size() == 3 && sorted.empty());
+    std::cout << "test_flat_set_bulk_against_std passed\n";
+}
+
+int main() {
+    test_flat_set_basic();
+    test_flat_set_bulk_against_std();
+    return 0;
+}
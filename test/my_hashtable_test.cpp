@@ -151,6 +151,97 @@ void test_clear_and_load()
 }
 
 
+/// 大量删除后 begin() 与遍历只和元素个数有关，遍历结果与剩余元素一致
+void test_iterate_after_mass_erase()
+{
+    using Table = my::hashtable<int, int, my::_Identify, std::true_type>;
+    Table ht(10);
+    for (int i = 0; i < 10000; ++i)
+        ht.insert(i);
+    size_t buckets = ht.bucket_count();
+    for (int i = 0; i < 10000; ++i) {
+        if (i != 4242 && i != 77)
+            ht.erase(i);
+    }
+    assert(ht.size() == 2);
+    assert(ht.bucket_count() == buckets);
+
+    int sum = 0, cnt = 0;
+    for (auto it = ht.begin(); it != ht.end(); ++it) {
+        sum += *it;
+        ++cnt;
+    }
+    assert(cnt == 2 && sum == 4242 + 77);
+
+    /// 按迭代器删除返回的是链表中的下一个元素
+    auto it = ht.begin();
+    auto next = it;
+    ++next;
+    assert(ht.erase(it) == next);
+    assert(ht.size() == 1);
+
+    ht.clear();
+    assert(ht.begin() == ht.end());
+    ht.insert(5);
+    assert(*ht.begin() == 5);
+
+    cout << "test_iterate_after_mass_erase passed.\n";
+}
+
+/// 重复键在链表中相邻，rehash 之后依旧相邻
+void test_multi_equal_range_after_rehash()
+{
+    using Table = my::hashtable<int, int, my::_Identify, std::false_type>;
+    Table ht(2);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 500; ++i)
+            ht.insert(i);
+    }
+    assert(ht.size() == 1500);
+    for (int i = 0; i < 500; ++i) {
+        auto range = ht.equal_range(i);
+        int n = 0;
+        for (auto it = range.first_; it != range.second_; ++it) {
+            assert(*it == i);
+            ++n;
+        }
+        assert(n == 3);
+        assert(ht.count(i) == 3);
+    }
+    assert(ht.erase(7) == 3);
+    assert(ht.count(7) == 0);
+    assert(ht.size() == 1497);
+
+    cout << "test_multi_equal_range_after_rehash passed.\n";
+}
+
+/// 拷贝、交换、移动之后链表头哨兵仍然指向正确的对象
+void test_copy_swap_keep_chain()
+{
+    using Table = my::hashtable<int, int, my::_Identify, std::true_type>;
+    Table a(10), b(10);
+    for (int i = 0; i < 100; ++i)
+        a.insert(i);
+    b.insert(-1);
+
+    Table c(a);
+    a.swap(b);
+    assert(a.size() == 1 && b.size() == 100 && c.size() == 100);
+    a.erase(-1);
+    assert(a.empty() && a.begin() == a.end());
+
+    Table d(std::move(b));
+    assert(b.empty() && b.begin() == b.end());
+    for (int i = 0; i < 100; ++i) {
+        assert(d.erase(i) == 1);
+        assert(c.find(i) != c.end());
+    }
+    assert(d.empty() && d.begin() == d.end());
+
+    cout << "test_copy_swap_keep_chain passed.\n";
+}
+
+
 int main()
 {
     test_unique_insert_find();                  /// 过
@@ -162,6 +253,9 @@ int main()
         test_comparison();
     }
     test_clear_and_load();
+    test_iterate_after_mass_erase();
+    test_multi_equal_range_after_rehash();
+    test_copy_swap_keep_chain();
     /// 过
     cout << "All hashtable tests passed.\n";
     /**
@@ -0,0 +1,204 @@
+/**
+ * @file      my_interval_map_test.cpp
+ * @brief     [测试interval_map]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_interval_map.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    /// 暴力求重叠的区间：按 (low, high) 排序后的 id 序列
+    std::vector<int> brute_overlap(const std::vector<std::pair<my::interval<int>, int>> &all, int lo, int hi) {
+        std::vector<std::pair<my::interval<int>, int>> hits;
+        for (auto &e: all) {
+            if (e.first.low <= hi && e.first.high >= lo) {
+                hits.push_back(e);
+            }
+        }
+        std::stable_sort(hits.begin(), hits.end(), [](auto &a, auto &b) {
+            return a.first.low < b.first.low || (a.first.low == b.first.low && a.first.high < b.first.high);
+        });
+        std::vector<int> ids;
+        for (auto &h: hits) {
+            ids.push_back(h.second);
+        }
+        return ids;
+    }
+
+    template<typename Range>
+    std::vector<int> ids_of(Range range) {
+        std::vector<int> ids;
+        for (auto &kv: range) {
+            ids.push_back(kv.second);
+        }
+        return ids;
+    }
+
+    /// 同一个 (low, high) 的多个区间之间的顺序不做比较
+    void sort_ties(std::vector<int> &ids, const std::vector<std::pair<my::interval<int>, int>> &byId) {
+        std::stable_sort(ids.begin(), ids.end(), [&](int a, int b) {
+            auto &x = byId[a].first;
+            auto &y = byId[b].first;
+            if (x.low != y.low) return x.low < y.low;
+            if (x.high != y.high) return x.high < y.high;
+            return a < b;
+        });
+    }
+}
+
+void test_interval_map_basic() {
+    my::interval_map<int, std::string> m;
+    m.insert(10, 20, "a");
+    m.insert(15, 25, "b");
+    m.insert(30, 40, "c");
+    m.insert(5, 8, "d");
+    m.insert({{18, 19}, "e"});
+    assert(m.size() == 5 && m.max_high() == 40);
+
+    std::vector<std::string> hits;
+    for (auto &kv: m.overlapping(19, 30)) {
+        hits.push_back(kv.second);
+    }
+    assert((hits == std::vector<std::string>{"a", "b", "e", "c"}));
+    hits.clear();
+    for (auto &kv: m.stabbing(16)) {
+        hits.push_back(kv.second);
+    }
+    assert((hits == std::vector<std::string>{"a", "b"}));
+    assert(m.stabbing(9).empty() && m.stabbing(41).empty() && !m.overlaps(26, 29));
+    assert(m.find_overlap(0, 5)->second == "d" && m.find_overlap(26, 29) == m.end());
+
+    /// 删除右端点最大的区间之后 max_high 跟着更新
+    m.erase(m.find({30, 40}));
+    assert(m.max_high() == 25 && m.stabbing(35).empty());
+    assert(m.erase({10, 20}) == 1 && m.size() == 3 && m.stabbing(12).empty());
+    std::cout << "test_interval_map_basic passed\n";
+}
+
+void test_interval_map_against_brute_force() {
+    std::mt19937 rng(17);
+    my::interval_map<int, int> m;
+    std::vector<std::pair<my::interval<int>, int>> byId;   /// 下标就是 id
+    std::vector<bool> alive;
+    std::vector<typename my::interval_map<int, int>::iterator> where;
+    for (int round = 0; round < 6000; ++round) {
+        if (rng() % 3 != 0 || m.empty()) {
+            int low = static_cast<int>(rng() % 1000);
+            int high = low + static_cast<int>(rng() % (rng() % 4 == 0 ? 300 : 20));
+            int id = static_cast<int>(byId.size());
+            byId.push_back({{low, high}, id});
+            alive.push_back(true);
+            where.push_back(m.insert(low, high, id));
+        } else {
+            int id = static_cast<int>(rng() % byId.size());
+            if (alive[id]) {
+                m.erase(where[id]);
+                alive[id] = false;
+            }
+        }
+        if (round % 50 == 0) {
+            std::vector<std::pair<my::interval<int>, int>> live;
+            for (size_t i = 0; i < byId.size(); ++i) {
+                if (alive[i]) live.push_back(byId[i]);
+            }
+            assert(m.size() == live.size());
+            for (int q = 0; q < 20; ++q) {
+                int lo = static_cast<int>(rng() % 1400) - 100;
+                int hi = lo + static_cast<int>(rng() % 50);
+                std::vector<int> got = ids_of(m.overlapping(lo, hi));
+                std::vector<int> expect = brute_overlap(live, lo, hi);
+                sort_ties(got, byId);
+                sort_ties(expect, byId);
+                assert(got == expect);
+                std::vector<int> stab = ids_of(m.stabbing(lo));
+                std::vector<int> stabExpect = brute_overlap(live, lo, lo);
+                sort_ties(stab, byId);
+                sort_ties(stabExpect, byId);
+                assert(stab == stabExpect);
+            }
+        }
+    }
+    std::cout << "test_interval_map_against_brute_force passed\n";
+}
+
+void test_interval_map_sorted_build() {
+    std::vector<std::pair<my::interval<int>, int>> sorted;
+    for (int i = 0; i < 10000; ++i) {
+        sorted.push_back({{i * 10, i * 10 + (i % 7) * 5}, i});
+    }
+    my::interval_map<int, int> m(my::sorted_equivalent, sorted.begin(), sorted.end());
+    assert(m.size() == 10000 && m.max_high() == 9999 * 10 + (9999 % 7) * 5);
+    for (int p = 0; p < 100000; p += 37) {
+        std::vector<int> got = ids_of(m.stabbing(p));
+        std::vector<int> expect = brute_overlap(sorted, p, p);
+        assert(got == expect);
+    }
+    /// 建好之后继续插入和删除，_max 仍然正确
+    m.insert(-100, 200000, -1);
+    assert(m.max_high() == 200000 && m.stabbing(123456).begin()->second == -1);
+    m.erase(m.find({-100, 200000}));
+    assert(m.stabbing(123456).empty());
+
+    /// 逐个删除重叠结果：先取下一个再删
+    auto range = m.overlapping(0, 1000);
+    for (auto it = range.begin(); it != range.end();) {
+        auto cur = it++;
+        m.erase(cur.base());
+    }
+    assert(m.overlapping(0, 1000).empty() && m.size() == 10000 - 101);
+    std::cout << "test_interval_map_sorted_build passed\n";
+}
+
+/// 带状态的比较器：descending 为 true 时按从大到小的顺序比较
+struct flag_less {
+    bool descending = false;
+
+    bool operator()(int a, int b) const { return descending ? b < a : a < b; }
+};
+
+void test_interval_map_stateful_compare() {
+    /// 子树最大右端点必须用 interval_map 自己的比较器维护：降序时“最大”的右端点是数值最小的那个
+    std::mt19937 rng(23);
+    my::interval_map<int, int, flag_less> m(flag_less{true});
+    std::vector<std::pair<int, int>> all;   /// 数值上的 [lo, hi]，降序下的区间是 {hi, lo}
+    std::vector<bool> alive;
+    std::vector<typename my::interval_map<int, int, flag_less>::iterator> where;
+    for (int i = 0; i < 2000; ++i) {
+        int lo = static_cast<int>(rng() % 1000);
+        int hi = lo + static_cast<int>(rng() % 40);
+        all.push_back({lo, hi});
+        alive.push_back(true);
+        where.push_back(m.insert(hi, lo, i));
+        int victim = static_cast<int>(rng() % all.size());
+        if (i % 3 == 0 && alive[victim]) {
+            m.erase(where[victim]);
+            alive[victim] = false;
+        }
+    }
+    for (int p = -10; p < 1050; p += 7) {
+        std::vector<int> got = ids_of(m.stabbing(p));
+        std::vector<int> expect;
+        for (int i = 0; i < static_cast<int>(all.size()); ++i) {
+            if (alive[i] && all[i].first <= p && p <= all[i].second) expect.push_back(i);
+        }
+        std::sort(got.begin(), got.end());
+        assert(got == expect);
+    }
+    std::cout << "test_interval_map_stateful_compare passed\n";
+}
+
+int main() {
+    test_interval_map_basic();
+    test_interval_map_against_brute_force();
+    test_interval_map_sorted_build();
+    test_interval_map_stateful_compare();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file      my_intrusive_list_test.cpp
+ * @brief     [测试侵入式链表]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_intrusive_list.h"
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct Item : my::intrusive::list_hook<> {
+        int value;
+
+        explicit Item(int v = 0) : value(v) {}
+    };
+
+    struct HotTag {};
+
+    /// 两个基类钩子，用 Tag 区分：同一个对象同时在两个链表中
+    struct Page : my::intrusive::list_hook<>, my::intrusive::list_hook<HotTag> {
+        int no = 0;
+    };
+
+    using HotList = my::intrusive::list<Page, my::intrusive::base_hook<Page, my::intrusive::list_hook<HotTag>>>;
+
+    template<typename List>
+    std::vector<int> values(const List &l) {
+        std::vector<int> out;
+        for (const auto &x: l) {
+            out.push_back(x.value);
+        }
+        return out;
+    }
+}
+
+void test_intrusive_list_basic() {
+    std::vector<Item> items;
+    for (int i = 0; i < 6; ++i) {
+        items.emplace_back(i);
+    }
+    my::intrusive::list<Item> l;
+    assert(l.empty());
+    l.push_back(items[1]);
+    l.push_back(items[2]);
+    l.push_front(items[0]);
+    l.insert(l.end(), items[4]);
+    auto it = l.insert(l.iterator_to(items[4]), items[3]);
+    assert(it->value == 3 && l.size() == 5);
+    assert((values(l) == std::vector<int>{0, 1, 2, 3, 4}));
+
+    l.erase(items[2]);                      /// 按对象删除，O(1)
+    assert(!items[2].is_linked() && (values(l) == std::vector<int>{0, 1, 3, 4}));
+    assert(l.erase(l.begin())->value == 1);
+    assert(&l.pop_back() == &items[4] && l.back().value == 3);
+
+    /// splice：同一链表内移动，以及整个链表拼接
+    l.push_back(items[5]);
+    l.splice(l.begin(), l, l.iterator_to(items[5]));
+    assert((values(l) == std::vector<int>{5, 1, 3}));
+    my::intrusive::list<Item> other;
+    other.push_back(items[0]);
+    other.push_back(items[2]);
+    l.splice(l.iterator_to(items[3]), other);
+    assert(other.empty() && (values(l) == std::vector<int>{5, 1, 0, 2, 3}) && l.size() == 5);
+
+    my::intrusive::list<Item> moved(std::move(l));
+    assert(l.empty() && moved.size() == 5 && moved.front().value == 5 && moved.back().value == 3);
+    moved.swap(l);
+    assert(moved.empty() && (values(l) == std::vector<int>{5, 1, 0, 2, 3}));
+    l.erase(l.begin(), l.iterator_to(items[2]));
+    assert((values(l) == std::vector<int>{2, 3}));
+    l.clear();
+    for (auto &item: items) {
+        assert(!item.is_linked());
+    }
+    std::cout << "test_intrusive_list_basic passed\n";
+}
+
+void test_intrusive_list_against_std() {
+    std::mt19937 rng(3);
+    std::vector<Item> items;
+    for (int i = 0; i < 200; ++i) {
+        items.emplace_back(i);
+    }
+    my::intrusive::list<Item> l;
+    std::list<int> ref;
+    for (int round = 0; round < 20000; ++round) {
+        Item &item = items[rng() % items.size()];
+        if (!item.is_linked()) {
+            if (rng() % 2) {
+                l.push_back(item);
+                ref.push_back(item.value);
+            } else {
+                l.push_front(item);
+                ref.push_front(item.value);
+            }
+        } else if (rng() % 2) {
+            l.erase(item);
+            ref.remove(item.value);
+        } else {
+            /// LRU 命中：挪到最前面
+            l.splice(l.begin(), l, l.iterator_to(item));
+            ref.remove(item.value);
+            ref.push_front(item.value);
+        }
+    }
+    assert(l.size() == ref.size());
+    assert(values(l) == std::vector<int>(ref.begin(), ref.end()));
+    std::vector<int> backwards;
+    for (auto it = l.end(); it != l.begin();) {
+        backwards.push_back((--it)->value);
+    }
+    assert(backwards == std::vector<int>(ref.rbegin(), ref.rend()));
+    std::cout << "test_intrusive_list_against_std passed\n";
+}
+
+void test_intrusive_list_multiple_base_hooks() {
+    std::vector<Page> pages(4);
+    my::intrusive::list<Page> all;
+    HotList hot;
+    for (int i = 0; i < 4; ++i) {
+        pages[i].no = i;
+        all.push_back(pages[i]);
+    }
+    hot.push_back(pages[2]);
+    hot.push_back(pages[0]);
+    all.erase(pages[2]);
+    assert(all.size() == 3 && hot.size() == 2 && hot.front().no == 2);
+    assert(static_cast<my::intrusive::list_hook<HotTag> &>(pages[2]).is_linked());
+    assert(!static_cast<my::intrusive::list_hook<> &>(pages[2]).is_linked());
+    std::cout << "test_intrusive_list_multiple_base_hooks passed\n";
+}
+
+int main() {
+    test_intrusive_list_basic();
+    test_intrusive_list_against_std();
+    test_intrusive_list_multiple_base_hooks();
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file      my_intrusive_rbtree_test.cpp
+ * @brief     [测试侵入式红黑树]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_intrusive_list.h"
+#include "my_intrusive_rbtree.h"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+    /// 基类钩子：按到期时间排序的定时器
+    struct Timer : my::intrusive::rbtree_hook<> {
+        long deadline;
+        int id;
+
+        Timer(long d = 0, int i = 0) : deadline(d), id(i) {}
+    };
+
+    struct ByDeadline {
+        bool operator()(const Timer &a, const Timer &b) const { return a.deadline < b.deadline; }
+    };
+
+    /// 成员钩子：同一个对象同时在一棵按 id 排序的树和一个链表中
+    struct Conn {
+        int id;
+        my::intrusive::rbtree_hook<> byId;
+        my::intrusive::list_hook<> lru;
+    };
+
+    struct ById {
+        using is_transparent = void;
+
+        bool operator()(const Conn &a, const Conn &b) const { return a.id < b.id; }
+
+        bool operator()(const Conn &a, int b) const { return a.id < b; }
+
+        bool operator()(int a, const Conn &b) const { return a < b.id; }
+    };
+
+    using ConnTree = my::intrusive::rbtree<Conn, ById,
+            my::intrusive::member_hook<Conn, my::intrusive::rbtree_hook<>, &Conn::byId>>;
+    using ConnList = my::intrusive::list<Conn,
+            my::intrusive::member_hook<Conn, my::intrusive::list_hook<>, &Conn::lru>>;
+
+    /// 检查红黑性质和父指针，返回黑高
+    int check_subtree(const my::intrusive::rbtree_node *n, const my::intrusive::rbtree_node *parent) {
+        if (n == nullptr) {
+            return 1;
+        }
+        assert(n->_pParent == parent);
+        if (n->_color == RED) {
+            assert(!n->_pLeft || n->_pLeft->_color == BLACK);
+            assert(!n->_pRight || n->_pRight->_color == BLACK);
+        }
+        int l = check_subtree(n->_pLeft, n);
+        int r = check_subtree(n->_pRight, n);
+        assert(l == r);
+        return l + (n->_color == BLACK ? 1 : 0);
+    }
+
+    template<typename Tree>
+    void check_tree(Tree &tree) {
+        if (tree.empty()) {
+            assert(tree.begin() == tree.end());
+            return;
+        }
+        auto *root = Tree::hook_traits::to_node(&*tree.begin());
+        while (root->_pParent->_pParent != root) {
+            root = root->_pParent;
+        }
+        assert(root->_color == BLACK);
+        check_subtree(root, root->_pParent);
+    }
+}
+
+void test_intrusive_rbtree_against_std() {
+    std::mt19937 rng(7);
+    std::vector<Timer> timers(2000);
+    for (size_t i = 0; i < timers.size(); ++i) {
+        timers[i] = Timer(static_cast<long>(rng() % 500), static_cast<int>(i));
+    }
+    my::intrusive::rbtree<Timer, ByDeadline> tree;
+    std::multiset<std::pair<long, int>> ref;
+    std::vector<bool> in(timers.size(), false);
+    for (int round = 0; round < 20000; ++round) {
+        size_t i = rng() % timers.size();
+        if (!in[i]) {
+            auto it = tree.insert_equal(timers[i]);
+            assert(&*it == &timers[i] && timers[i].is_linked());
+            ref.insert({timers[i].deadline, timers[i].id});
+        } else {
+            tree.erase(timers[i]);              /// 按对象删除，不查找
+            assert(!timers[i].is_linked());
+            ref.erase({timers[i].deadline, timers[i].id});
+        }
+        in[i] = !in[i];
+    }
+    check_tree(tree);
+    assert(tree.size() == ref.size());
+    /// 等价元素保持插入顺序，只比较到期时间
+    auto r = ref.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++r) {
+        assert(it->deadline == r->first);
+    }
+    long last = -1;
+    while (!tree.empty()) {
+        Timer &t = tree.pop_front();
+        assert(t.deadline >= last && !t.is_linked());
+        last = t.deadline;
+    }
+    std::cout << "test_intrusive_rbtree_against_std passed\n";
+}
+
+void test_intrusive_rbtree_unique_and_lookup() {
+    std::vector<Timer> timers;
+    for (int i = 0; i < 100; ++i) {
+        timers.emplace_back(i * 10, i);
+    }
+    my::intrusive::rbtree<Timer, ByDeadline> tree;
+    for (auto &t: timers) {
+        assert(tree.insert_unique(t).second);
+    }
+    Timer dup(500, 999);
+    auto res = tree.insert_unique(dup);
+    assert(!res.second && res.first->id == 50 && !dup.is_linked());
+    check_tree(tree);
+
+    assert(tree.find(Timer(70))->id == 7 && tree.find(Timer(75)) == tree.end());
+    assert(tree.lower_bound(Timer(75))->id == 8 && tree.upper_bound(Timer(80))->id == 9);
+    assert(tree.front().id == 0 && tree.back().id == 99);
+    auto it = tree.iterator_to(timers[42]);
+    assert((--it)->id == 41);
+    assert(tree.erase(tree.iterator_to(timers[41]))->id == 42);
+    assert((--tree.end())->id == 99);
+
+    /// 拷贝对象不拷贝链接
+    Timer copy = timers[10];
+    assert(timers[10].is_linked() && !copy.is_linked());
+
+    /// 移动 / 交换之后元素跟着哨兵走
+    my::intrusive::rbtree<Timer, ByDeadline> moved(std::move(tree));
+    assert(tree.empty() && moved.size() == 99);
+    tree.swap(moved);
+    assert(moved.empty() && tree.size() == 99 && tree.begin()->id == 0);
+    check_tree(tree);
+    tree.clear();
+    for (auto &t: timers) {
+        assert(!t.is_linked());
+    }
+    std::cout << "test_intrusive_rbtree_unique_and_lookup passed\n";
+}
+
+void test_intrusive_member_hooks() {
+    std::vector<Conn> conns(64);
+    ConnTree byId;
+    ConnList lru;
+    for (int i = 0; i < 64; ++i) {
+        conns[i].id = (i * 37) % 64;
+        byId.insert_unique(conns[i]);
+        lru.push_front(conns[i]);
+    }
+    check_tree(byId);
+    int expect = 0;
+    for (Conn &c: byId) {
+        assert(c.id == expect++);
+    }
+    /// 命中：按 id 找到对象后 O(1) 挪到链表最前面
+    Conn &hit = *byId.find(5);
+    lru.splice(lru.begin(), lru, lru.iterator_to(hit));
+    assert(&lru.front() == &hit && lru.size() == 64);
+    /// 淘汰：从链表尾部取出，再按对象从树中删除
+    Conn &victim = lru.pop_back();
+    assert(&victim == &conns[0]);
+    byId.erase(victim);
+    assert(!byId.contains(victim.id) && byId.size() == 63 && !victim.byId.is_linked());
+    check_tree(byId);
+    std::cout << "test_intrusive_member_hooks passed\n";
+}
+
+int main() {
+    test_intrusive_rbtree_against_std();
+    test_intrusive_rbtree_unique_and_lookup();
+    test_intrusive_member_hooks();
+    return 0;
+}
@@ -10,7 +10,10 @@
 // Created on:  2025/6/25.
 //
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <random>
 #include <string>
 #include <vector>
 #include "my_list.h"
@@ -175,6 +178,146 @@ void test_operator_equal_swap() {
     std::cout << "test_operator_equal_swap() success!\n";
 }
 
+/// 只按 key 比较，seq 记录原来的位置，用来检查排序是否稳定
+struct Keyed {
+    int key;
+    int seq;
+
+    bool operator<(const Keyed &other) const { return key < other.key; }
+
+    bool operator==(const Keyed &other) const { return key == other.key && seq == other.seq; }
+};
+
+template<typename T>
+bool same_as(my::list<T> &lst, const std::vector<T> &expected) {
+    if (lst.size() != expected.size()) {
+        return false;
+    }
+    auto it = lst.begin();
+    for (const auto &v : expected) {
+        if (!(*it++ == v)) {
+            return false;
+        }
+    }
+    /// 反向再走一遍，检查 prev_ 也串对了
+    auto rit = lst.end();
+    for (auto e = expected.rbegin(); e != expected.rend(); ++e) {
+        if (!(*--rit == *e)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// 三种排序方式的结果都要和 std::stable_sort 一致
+template<typename T, typename Make, typename Compare>
+void check_sort_modes(int n, Make make, Compare comp) {
+    std::mt19937 rng(50);
+    std::vector<T> values;
+    for (int i = 0; i < n; ++i) {
+        values.push_back(make(rng, i));
+    }
+    std::vector<T> expected = values;
+    std::stable_sort(expected.begin(), expected.end(), comp);
+    for (auto mode : {my::list_sort_mode::merge, my::list_sort_mode::gather, my::list_sort_mode::parallel}) {
+        my::list<T> lst;
+        for (const auto &v : values) {
+            lst.push_back(v);
+        }
+        lst.sort(mode, comp);
+        assert(same_as(lst, expected));
+    }
+}
+
+void test_sort_modes() {
+    /// 整数走基数排序，包括负数和只有一个元素、全部相等的情况
+    auto anyInt = [](std::mt19937 &rng, int) { return static_cast<int>(rng()); };
+    check_sort_modes<int>(5000, anyInt, std::less<>());
+    check_sort_modes<int>(1, anyInt, std::less<>());
+    check_sort_modes<int>(100, [](std::mt19937 &, int) { return -7; }, std::less<int>());
+    check_sort_modes<long long>(5000, [](std::mt19937 &rng, int) { return static_cast<long long>(rng() % 1000) - 500; },
+                                std::less<>());
+    check_sort_modes<unsigned char>(3000, [](std::mt19937 &rng, int) { return static_cast<unsigned char>(rng()); },
+                                    std::less<>());
+    /// 自定义比较和浮点数走 std::stable_sort
+    check_sort_modes<int>(5000, anyInt, std::greater<>());
+    check_sort_modes<double>(5000, [](std::mt19937 &rng, int) { return rng() / 7.0; }, std::less<>());
+    /// 稳定性：相同 key 保持原来的先后顺序
+    check_sort_modes<Keyed>(5000, [](std::mt19937 &rng, int i) { return Keyed{static_cast<int>(rng() % 50), i}; },
+                            std::less<>());
+    /// 不可平凡拷贝的元素只收集节点指针
+    check_sort_modes<std::string>(3000, [](std::mt19937 &rng, int) { return std::to_string(rng() % 500); },
+                                  std::less<>());
+
+    my::list<int> empty;
+    empty.sort(my::list_sort_mode::gather);
+    assert(empty.empty());
+    std::cout << "test_sort_modes() success!\n";
+}
+
+/// 元素足够多时才会真正分块，指定 4 个线程，和机器核数无关
+void test_parallel_sort() {
+    std::mt19937 rng(7);
+    const int n = 300001;
+    std::vector<int> ints;
+    std::vector<Keyed> keyed;
+    my::list<int> a;
+    my::list<Keyed> b;
+    for (int i = 0; i < n; ++i) {
+        ints.push_back(static_cast<int>(rng()));
+        keyed.push_back(Keyed{static_cast<int>(rng() % 1000), i});
+        a.push_back(ints.back());
+        b.push_back(keyed.back());
+    }
+    std::stable_sort(ints.begin(), ints.end());
+    std::stable_sort(keyed.begin(), keyed.end());
+    a.parallel_sort(4);
+    b.parallel_sort(4);
+    assert(same_as(a, ints));
+    assert(same_as(b, keyed));
+
+    /// 块数不是线程数的情况：3 个线程只切成 2 块
+    std::reverse(ints.begin(), ints.end());
+    a.parallel_sort(3, std::greater<>());
+    assert(same_as(a, ints));
+    std::cout << "test_parallel_sort() success!\n";
+}
+
+void test_merge_unique_remove_if() {
+    my::list<int> a;
+    my::list<int> b;
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(i * 2);
+        b.push_back(i * 3);
+        expected.push_back(i * 2);
+        expected.push_back(i * 3);
+    }
+    std::sort(expected.begin(), expected.end());
+    a.merge(b);
+    assert(b.empty() && same_as(a, expected));
+
+    /// 按降序合并
+    my::list<int> c = {9, 5, 1};
+    my::list<int> d = {8, 5, 2, 0};
+    c.merge(d, std::greater<>());
+    assert(same_as(c, std::vector<int>{9, 8, 5, 5, 2, 1, 0}) && d.empty());
+
+    a.unique();
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    assert(same_as(a, expected));
+
+    a.remove_if([](int x) { return x % 4 == 0; });
+    expected.erase(std::remove_if(expected.begin(), expected.end(), [](int x) { return x % 4 == 0; }),
+                   expected.end());
+    assert(same_as(a, expected));
+
+    /// 删掉全部元素之后哨兵也要复位
+    a.remove_if([](int) { return true; });
+    assert(a.empty() && a.size() == 0);
+    std::cout << "test_merge_unique_remove_if() success!\n";
+}
+
 void print_list(const my::list<int>& lst) {
     for (auto it = lst.begin(); it != lst.end(); ++it) {
         std::cout << *it << " ";
@@ -193,6 +336,9 @@ int main() {
     test_resize_clear();
     test_splice_merge();
     test_operator_equal_swap();
+    test_sort_modes();
+    test_parallel_sort();
+    test_merge_unique_remove_if();
     std::cout << "All my::list tests passed!" << std::endl;
 
 #if 0
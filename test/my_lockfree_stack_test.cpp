@@ -0,0 +1,229 @@
+/**
+ * @file      my_lockfree_stack_test.cpp
+ * @brief     [测试lockfree_stack：后进先出语义、chain 批量入栈和 pop_all、多线程下元素不丢不重、作为共享空闲链表反复复用、对象生命周期]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_lockfree_stack.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::atomic<int> g_live(0);
+}
+
+/// 统计存活对象个数，检查构造和析构是否成对
+struct Tracked {
+    int value;
+
+    Tracked(int v = 0) : value(v) { ++g_live; }
+
+    Tracked(const Tracked &other) : value(other.value) { ++g_live; }
+
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++g_live; }
+
+    Tracked &operator=(const Tracked &) = default;
+
+    Tracked &operator=(Tracked &&) = default;
+
+    ~Tracked() { --g_live; }
+};
+
+void test_single_thread() {
+    my::lockfree_stack<std::string> s;
+    assert(s.empty_approx());
+    std::string out;
+    assert(!s.try_pop(out));
+    for (int i = 0; i < 200; ++i) {
+        s.push(std::to_string(i));
+    }
+    s.emplace(3, 'x');
+    assert(s.try_pop(out) && out == "xxx");
+    for (int i = 199; i >= 0; --i) {
+        assert(s.try_pop(out) && out == std::to_string(i));
+    }
+    assert(s.empty_approx() && !s.try_pop(out));
+    std::cout << "test_single_thread passed\n";
+}
+
+void test_chain() {
+    my::lockfree_stack<int> s;
+    s.push(-1);
+    auto c = s.make_chain();
+    for (int i = 0; i < 10; ++i) {
+        c.push(i);
+    }
+    assert(c.size() == 10);
+    s.push_chain(std::move(c));
+    assert(c.empty());
+    /// 链头（最后 push 到 chain 的元素）成为栈顶，chain 之下是原来的元素
+    int v = 0;
+    for (int i = 9; i >= 5; --i) {
+        assert(s.try_pop(v) && v == i);
+    }
+    auto all = s.pop_all();
+    assert(s.empty_approx() && all.size() == 6);
+    for (int i = 4; i >= 0; --i) {
+        assert(all.try_pop(v) && v == i);
+    }
+    assert(all.try_pop(v) && v == -1 && all.empty());
+
+    /// 空 chain 入栈什么也不做；chain 析构时把节点还给栈
+    s.push_chain(s.make_chain());
+    {
+        auto tmp = s.make_chain();
+        tmp.push(1);
+        tmp.push(2);
+    }
+    assert(s.empty_approx());
+
+    /// 节点池里有上百个空闲节点时，chain 分几批取备用节点，栈自己照常从池里取
+    for (int i = 0; i < 200; ++i) {
+        s.push(i);
+    }
+    while (s.try_pop(v)) {
+    }
+    auto batch = s.make_chain();
+    for (int i = 0; i < 40; ++i) {
+        batch.push(i);
+        s.push(1000 + i);
+    }
+    s.push_chain(std::move(batch));
+    for (int i = 39; i >= 0; --i) {
+        assert(s.try_pop(v) && v == i);
+    }
+    for (int i = 39; i >= 0; --i) {
+        assert(s.try_pop(v) && v == 1000 + i);
+    }
+    assert(s.empty_approx());
+    std::cout << "test_chain passed\n";
+}
+
+/// 每个线程压入自己的一段值，同时所有线程都在弹出；最后每个值恰好被弹出一次
+void test_multi_thread_exactly_once() {
+    my::lockfree_stack<int> s;
+    const int threads = 4;
+    const int perThread = 50000;
+    std::vector<std::atomic<int>> seen(threads * perThread);
+    std::atomic<int> remaining(threads * perThread);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            int v = 0;
+            for (int i = 0; i < perThread; ++i) {
+                s.push(t * perThread + i);
+                if (i % 2 && s.try_pop(v)) {
+                    seen[v].fetch_add(1, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+            /// 剩下的元素所有线程一起弹完
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                if (s.try_pop(v)) {
+                    seen[v].fetch_add(1, std::memory_order_relaxed);
+                    remaining.fetch_sub(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+    for (auto &c : seen) {
+        assert(c.load() == 1);
+    }
+    std::cout << "test_multi_thread_exactly_once passed\n";
+}
+
+/// 共享空闲链表：少量对象在很多线程之间反复借出归还，同一个节点被高频复用，最容易暴露 ABA
+/// 对象编号在借出期间归借用者独占，同一个编号同时被两个线程借到就说明栈坏了
+void test_free_list_reuse() {
+    const int objects = 8;
+    my::lockfree_stack<int> freeList;
+    std::vector<std::atomic<int>> owner(objects);
+    for (int i = 0; i < objects; ++i) {
+        freeList.push(i);
+        owner[i].store(-1);
+    }
+    const int threads = 6;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            int id = 0;
+            for (int round = 0; round < 100000; ++round) {
+                if (!freeList.try_pop(id)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                int expected = -1;
+                bool exclusive = owner[id].compare_exchange_strong(expected, t);
+                assert(exclusive);
+                owner[id].store(-1);
+                if (round % 16 == 0) {
+                    /// 偶尔把借到的对象放进 chain 再整串归还
+                    auto c = freeList.make_chain();
+                    c.push(id);
+                    freeList.push_chain(std::move(c));
+                } else {
+                    freeList.push(id);
+                }
+            }
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+    auto all = freeList.pop_all();
+    assert(all.size() == objects);
+    std::vector<int> count(objects, 0);
+    int id = 0;
+    while (all.try_pop(id)) {
+        ++count[id];
+    }
+    for (int c : count) {
+        assert(c == 1);
+    }
+    std::cout << "test_free_list_reuse passed\n";
+}
+
+void test_object_lifetime() {
+    {
+        my::lockfree_stack<Tracked> s;
+        for (int i = 0; i < 100; ++i) {
+            s.emplace(i);
+        }
+        Tracked out;
+        assert(s.try_pop(out) && out.value == 99);
+        assert(g_live == 100);
+        auto c = s.make_chain();
+        c.emplace(7);
+        c.emplace(8);
+        s.push_chain(std::move(c));
+        auto rest = s.pop_all();
+        assert(rest.size() == 101 && g_live == 102);
+        rest.clear();
+        assert(g_live == 1);
+        s.emplace(1);
+        s.emplace(2);
+    }
+    /// 析构时栈中剩余的元素也要析构
+    assert(g_live == 0);
+    std::cout << "test_object_lifetime passed\n";
+}
+
+int main() {
+    test_single_thread();
+    test_chain();
+    test_multi_thread_exactly_once();
+    test_free_list_reuse();
+    test_object_lifetime();
+    return 0;
+}
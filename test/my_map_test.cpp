@@ -9,6 +9,9 @@
 #include <iostream>
 #include <cassert>
 #include <string>
+#include <vector>
+#include <random>
+#include <map>
 
 void test() {
     my::map<int, std::string> m;
@@ -70,6 +73,18 @@ void test_my_map() {
     assert(m3.size() == 3);
     assert(m3.find(20)->second == "twenty");
 
+    // insert_or_assign: 返回 (迭代器, 是否插入)
+    auto ia = m.insert_or_assign(2, "TWO");
+    assert(!ia.second && ia.first->second == "TWO");
+    ia = m.insert_or_assign(7, std::string("seven"));
+    assert(ia.second && ia.first->first == 7 && m.size() == 4);
+    auto hit = m.insert_or_assign(m.end(), 8, "eight");
+    assert(hit->first == 8 && m.size() == 5);
+    hit = m.insert_or_assign(m.end(), 8, "EIGHT");
+    assert(hit->second == "EIGHT" && m.size() == 5);
+    m.erase(7);
+    m.erase(8);
+
     std::cout << "Map in-order traversal:\n";
     m.inorder(); // should print in key order: 1,2,3
 
@@ -117,10 +132,298 @@ void test_my_multimap() {
     std::cout << "my::multimap tests passed.\n";
 }
 
+void test_heterogeneous_lookup() {
+    std::cout << ">>> Testing heterogeneous lookup...\n";
+
+    my::map<std::string, int, std::less<>> m = {{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    /// 透明比较器：直接用 const char* 查找，不构造临时 std::string
+    assert(m.find("banana")->second == 2);
+    assert(m.find("durian") == m.end());
+    assert(m.contains("apple"));
+    assert(m.count("cherry") == 1);
+    assert(m.lower_bound("b")->first == "banana");
+    assert(m.upper_bound("banana")->first == "cherry");
+
+    my::multimap<std::string, int, std::less<>> mm = {{"a", 1}, {"b", 2}, {"b", 3}, {"c", 4}};
+    auto range = mm.equal_range("b");
+    int sum = 0;
+    for (auto it = range.first; it != range.second; ++it) {
+        sum += it->second;
+    }
+    assert(sum == 5);
+    assert(mm.count("b") == 2);
+
+    std::cout << "heterogeneous lookup tests passed.\n";
+}
+
+void test_node_extract_merge() {
+    std::cout << ">>> Testing extract / merge...\n";
+
+    my::map<int, std::string> a;
+    my::map<int, std::string> b;
+    for (int i = 0; i < 100; ++i) {
+        a[i] = std::to_string(i);
+    }
+
+    /// 节点在两棵树之间转移，元素地址不变
+    std::string *addr = &a.find(10)->second;
+    auto nh = a.extract(10);
+    assert(nh.key() == 10 && nh.mapped() == "10" && a.size() == 99);
+    auto res = b.insert(std::move(nh));
+    assert(res.inserted && &res.position->second == addr);
+
+    b[20] = "b20";
+    b.merge(a);     /// 20 已存在，留在 a 中
+    assert(a.size() == 1 && a.find(20)->second == "20");
+    assert(b.size() == 100 && b.find(20)->second == "b20");
+    int expect = 0;
+    for (auto &kv : b) {
+        assert(kv.first == expect++);
+    }
+
+    /// 删除一半之后仍然有序
+    for (int i = 0; i < 100; i += 2) {
+        assert(b.erase(i) == 1);
+    }
+    expect = 1;
+    for (auto &kv : b) {
+        assert(kv.first == expect);
+        expect += 2;
+    }
+
+    my::multimap<int, int> m1 = {{1, 1}, {2, 2}};
+    my::multimap<int, int> m2 = {{1, 10}, {3, 30}};
+    m1.merge(m2);
+    assert(m1.size() == 4 && m2.size() == 0 && m1.count(1) == 2);
+
+    std::cout << "extract / merge tests passed.\n";
+}
+
+/// 统计节点分配次数的分配器，验证节点内存经由 Alloc 分配
+static int g_live_nodes = 0;
+
+template<typename T>
+struct CountingAlloc : MyAlloc<T> {
+    using value_type = T;
+
+    CountingAlloc() = default;
+
+    template<typename U>
+    CountingAlloc(const CountingAlloc<U> &) {}
+
+    T *allocate(size_t n) {
+        ++g_live_nodes;
+        return MyAlloc<T>::allocate(n);
+    }
+
+    void deallocate(T *p, size_t n) {
+        --g_live_nodes;
+        MyAlloc<T>::deallocate(p, n);
+    }
+
+    template<typename U>
+    struct rebind {
+        using other = CountingAlloc<U>;
+    };
+};
+
+void test_compare_and_alloc() {
+    std::cout << ">>> Testing Compare / Alloc parameters...\n";
+
+    /// 降序
+    my::map<int, int, std::greater<int>> desc;
+    for (int i = 0; i < 50; ++i) {
+        desc[i] = i;
+    }
+    int expect = 49;
+    for (auto &kv : desc) {
+        assert(kv.first == expect--);
+    }
+    assert(desc.lower_bound(10)->first == 10 && desc.upper_bound(10)->first == 9);
+    assert(!desc.insert({3, 0}).second);
+
+    {
+        using alloc_map = my::map<int, std::string, std::less<int>, CountingAlloc<std::pair<const int, std::string>>>;
+        alloc_map m;
+        int base = g_live_nodes;        /// 哨兵节点
+        for (int i = 0; i < 100; ++i) {
+            m[i] = std::to_string(i);
+        }
+        assert(g_live_nodes == base + 100);
+
+        /// 拷贝出独立的一棵树，各自析构互不影响
+        alloc_map copy(m);
+        assert(copy.size() == 100 && copy.find(42)->second == "42");
+        copy.erase(42);
+        assert(m.find(42)->second == "42");
+
+        alloc_map moved(std::move(copy));
+        assert(moved.size() == 99 && copy.size() == 0);
+        m.swap(moved);
+        assert(m.size() == 99 && moved.size() == 100);
+        m.clear();
+        assert(m.empty() && m.begin() == m.end());
+
+        my::multimap<int, int, std::greater<int>, CountingAlloc<std::pair<const int, int>>> mm;
+        mm.insert({1, 1});
+        mm.insert({2, 2});
+        mm.insert({1, 3});
+        assert(mm.begin()->first == 2 && mm.count(1) == 2);
+    }
+    assert(g_live_nodes == 0);
+    std::cout << "Compare / Alloc tests passed.\n";
+}
+
+void test_hint_insert() {
+    std::cout << ">>> Testing single-pass / hinted insert...\n";
+
+    /// 按时间戳递增追加，用 end() 作提示
+    my::map<int, int> series;
+    for (int t = 0; t < 10000; ++t) {
+        auto it = series.insert(series.end(), {t, t * 10});
+        assert(it->first == t);
+    }
+    assert(series.size() == 10000 && series.begin()->first == 0);
+
+    /// 提示指向已存在的 key：不插入，返回已有元素
+    auto it = series.insert(series.find(500), {500, -1});
+    assert(it->second == 5000 && series.size() == 10000);
+
+    /// 随机提示（大多是错的）也能得到正确结果
+    my::map<int, int> m;
+    std::map<int, int> ref;
+    std::mt19937 rng(3);
+    for (int i = 0; i < 5000; ++i) {
+        int key = static_cast<int>(rng() % 3000);
+        auto hint = (i % 3 == 0) ? m.end() : m.lower_bound(static_cast<int>(rng() % 3000));
+        m.emplace_hint(hint, key, i);
+        ref.emplace(key, i);
+    }
+    assert(m.size() == ref.size());
+    auto rit = ref.begin();
+    for (auto &kv : m) {
+        assert(kv.first == rit->first && kv.second == rit->second);
+        ++rit;
+    }
+
+    /// try_emplace 只在 key 不存在时构造 mapped
+    my::map<std::string, std::string> names;
+    assert(names.try_emplace("a", 3, 'x').second);
+    assert(!names.try_emplace("a", "ignored").second && names["a"] == "xxx");
+    assert(names.emplace("b", "y").second && !names.emplace("b", "z").second);
+
+    /// multimap：等价 key 按插入顺序排在一起
+    my::multimap<int, int> mm;
+    for (int i = 0; i < 100; ++i) {
+        mm.emplace_hint(mm.end(), i / 10, i);
+    }
+    int prev = -1;
+    for (auto &kv : mm) {
+        assert(kv.second == prev + 1);
+        prev = kv.second;
+    }
+    std::cout << "single-pass / hinted insert tests passed.\n";
+}
+
+void test_sorted_construction() {
+    std::cout << ">>> Testing sorted bulk construction...\n";
+
+    std::vector<std::pair<int, int>> sorted;
+    for (int i = 0; i < 10000; ++i) {
+        sorted.emplace_back(i * 2, i);
+    }
+    my::map<int, int> m(my::sorted_unique, sorted.begin(), sorted.end());
+    assert(m.size() == 10000 && m.begin()->first == 0);
+    assert(m.find(5000)->second == 2500 && m.find(5001) == m.end());
+
+    /// 再合并一批有序的奇数 key
+    std::vector<std::pair<int, int>> odd;
+    for (int i = 0; i < 10000; ++i) {
+        odd.emplace_back(i * 2 + 1, -i);
+    }
+    m.insert_sorted(odd.begin(), odd.end());
+    assert(m.size() == 20000);
+    int expect = 0;
+    for (auto &kv : m) {
+        assert(kv.first == expect++);
+    }
+
+    my::multimap<int, int> mm(my::sorted_equivalent, {{1, 1}, {1, 2}, {2, 3}});
+    assert(mm.count(1) == 2 && mm.size() == 3);
+    std::cout << "sorted bulk construction tests passed.\n";
+}
+
+void test_split_join() {
+    std::cout << ">>> Testing split / join / erase range...\n";
+
+    /// 按时间分片：把 [0, 1000) 拆成两片，再把后面一片接回去
+    my::map<int, std::string> index;
+    for (int t = 0; t < 1000; ++t) {
+        index[t] = std::to_string(t);
+    }
+    auto it500 = index.find(500);
+    my::map<int, std::string> recent = index.split(500);
+    assert(index.size() == 500 && recent.size() == 500);
+    assert(index.contains(499) && !index.contains(500) && recent.begin()->first == 500);
+    assert(&*recent.find(500) == &*it500);     /// 节点原样移动，迭代器仍然有效
+    recent[1000] = "1000";
+    assert(recent.size() == 501);
+    index.join(recent);
+    assert(recent.empty() && index.size() == 1001 && index.find(1000)->second == "1000");
+
+    /// 接到前面
+    my::map<int, std::string> older{{-2, "-2"}, {-1, "-1"}};
+    index.join(std::move(older));
+    assert(index.begin()->first == -2 && index.size() == 1003);
+
+    /// 区间删除
+    auto next = index.erase(index.find(100), index.find(900));
+    assert(next->first == 900 && index.size() == 1003 - 800);
+    assert(!index.contains(100) && !index.contains(899) && index.contains(99));
+    assert(index.erase(index.begin(), index.end()) == index.end() && index.empty());
+
+    my::multimap<int, int> mm{{1, 1}, {2, 2}, {2, 3}, {3, 4}};
+    my::multimap<int, int> tail = mm.split(2);
+    assert(mm.size() == 1 && tail.size() == 3 && tail.count(2) == 2);
+    my::multimap<int, int> more{{3, 5}};
+    tail.join(more);                           /// 等价 key 接在后面
+    std::vector<int> values;
+    for (auto &kv: tail) {
+        values.push_back(kv.second);
+    }
+    assert((values == std::vector<int>{2, 3, 4, 5}));
+    std::cout << "split / join / erase range tests passed.\n";
+}
+
+void test_order_statistic() {
+    std::cout << ">>> Testing order_statistic_map...\n";
+    my::order_statistic_map<int, int> scores;
+    for (int i = 0; i < 100; ++i) {
+        scores.insert(scores.end(), {i * 10, i});
+    }
+    assert(scores.select(0)->first == 0 && scores.select(42)->first == 420 && scores.select(100) == scores.end());
+    assert(scores.rank(425) == 43 && scores.rank(scores.find(990)) == 99 && scores.rank(scores.end()) == 100);
+    my::order_statistic_map<int, int> top = scores.split(700);
+    assert(scores.size() == 70 && top.size() == 30 && top.select(0)->first == 700 && top.rank(990) == 29);
+    scores.join(top);
+    assert(scores.size() == 100 && scores.select(99)->first == 990);
+
+    my::order_statistic_multimap<int, int> mm{{1, 1}, {2, 2}, {2, 3}, {3, 4}};
+    assert(mm.rank(2) == 1 && mm.rank(3) == 3 && mm.select(2)->second == 3);
+    std::cout << "order_statistic_map tests passed.\n";
+}
+
 int main() {
     test();
     test_my_map();
     test_my_multimap();
+    test_heterogeneous_lookup();
+    test_node_extract_merge();
+    test_compare_and_alloc();
+    test_hint_insert();
+    test_sorted_construction();
+    test_split_join();
+    test_order_statistic();
     return 0;
 }
 
@@ -0,0 +1,255 @@
+/**
+ * @file      my_mpmc_queue_test.cpp
+ * @brief     [测试mpmc_queue：单线程语义和绕回、多生产者多消费者下每个元素恰好被取走一次且同一生产者的元素保持顺序、阻塞模式、对象生命周期、构造抛异常时队列不受影响]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_mpmc_queue.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    int g_live = 0;
+}
+
+/// 统计存活对象个数，检查构造和析构是否成对
+struct Tracked {
+    int value;
+
+    Tracked(int v = 0) : value(v) { ++g_live; }
+
+    Tracked(const Tracked &other) : value(other.value) { ++g_live; }
+
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++g_live; }
+
+    Tracked &operator=(const Tracked &) = default;
+
+    Tracked &operator=(Tracked &&) = default;
+
+    ~Tracked() { --g_live; }
+};
+
+void test_single_thread() {
+    /// 槽位数向上取 2 的幂
+    my::mpmc_queue<int> q(5);
+    assert(q.capacity() == 8 && q.empty_approx());
+    int out = -1;
+    assert(!q.try_pop(out));
+    int next = 0;
+    int expect = 0;
+    for (int round = 0; round < 1000; ++round) {
+        while (q.try_push(next)) {
+            ++next;
+        }
+        assert(q.size_approx() == 8);
+        for (int k = 0; k < round % 8 + 1; ++k) {
+            assert(q.try_pop(out) && out == expect++);
+        }
+    }
+    while (q.try_pop(out)) {
+        assert(out == expect++);
+    }
+    assert(expect == next);
+
+    my::mpmc_queue<std::string> s(1);
+    assert(s.capacity() == 2);
+    assert(s.try_emplace(3, 'a'));
+    assert(s.try_push("bb"));
+    assert(!s.try_push("cc"));
+    std::string str;
+    assert(s.try_pop(str) && str == "aaa");
+    std::cout << "test_single_thread passed\n";
+}
+
+/// 每个元素编码为 生产者编号 * kStride + 序号：检查全部元素恰好被取走一次，并且每个消费者看到的同一生产者的序号递增
+template<typename Queue, typename Push, typename Pop>
+void check_mpmc(Queue &q, int producers, int consumers, int perProducer, Push push, Pop pop) {
+    constexpr int kStride = 1 << 20;
+    std::vector<std::atomic<int>> seen(static_cast<size_t>(producers) * perProducer);
+    std::atomic<int> remaining(producers * perProducer);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                push(q, p * kStride + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int> last(producers, -1);
+            int v = 0;
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                if (!pop(q, v)) {
+                    continue;
+                }
+                int p = v / kStride;
+                int i = v % kStride;
+                assert(i > last[p]);
+                last[p] = i;
+                seen[static_cast<size_t>(p) * perProducer + i].fetch_add(1, std::memory_order_relaxed);
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (auto &s : seen) {
+        assert(s.load() == 1);
+    }
+    assert(q.empty_approx());
+}
+
+void test_multi_thread() {
+    my::mpmc_queue<int> q(16);
+    auto push = [](auto &queue, int v) {
+        while (!queue.try_push(v)) {
+            std::this_thread::yield();
+        }
+    };
+    auto pop = [](auto &queue, int &v) {
+        if (queue.try_pop(v)) {
+            return true;
+        }
+        std::this_thread::yield();
+        return false;
+    };
+    check_mpmc(q, 1, 1, 100000, push, pop);
+    check_mpmc(q, 4, 4, 30000, push, pop);
+    check_mpmc(q, 3, 1, 30000, push, pop);
+    check_mpmc(q, 1, 3, 60000, push, pop);
+    std::cout << "test_multi_thread passed\n";
+}
+
+/// 阻塞模式：队列很小，生产者和消费者都经常睡眠；消费者在取到最后一个元素之后不能再 pop，所以按数量分配
+void test_blocking() {
+    my::mpmc_queue<int, true> q(2);
+    const int producers = 3;
+    const int consumers = 3;
+    const int perThread = 20000;
+    std::atomic<long long> sum(0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (int i = 1; i <= perThread; ++i) {
+                q.push(i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            int v = 0;
+            long long local = 0;
+            for (int i = 0; i < perThread; ++i) {
+                q.pop(v);
+                local += v;
+            }
+            sum.fetch_add(local);
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    assert(sum.load() == static_cast<long long>(producers) * perThread * (perThread + 1) / 2);
+
+    /// 多个消费者先睡，生产者晚一些才入队，每个消费者都要被唤醒
+    my::mpmc_queue<std::string, true> late(4);
+    std::atomic<int> woke(0);
+    std::vector<std::thread> sleepers;
+    for (int i = 0; i < 3; ++i) {
+        sleepers.emplace_back([&] {
+            std::string s;
+            late.pop(s);
+            assert(s == "wake");
+            woke.fetch_add(1);
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 0; i < 3; ++i) {
+        late.push("wake");
+    }
+    for (auto &t : sleepers) {
+        t.join();
+    }
+    assert(woke.load() == 3);
+    std::cout << "test_blocking passed\n";
+}
+
+void test_object_lifetime() {
+    {
+        my::mpmc_queue<Tracked> q(8);
+        for (int i = 0; i < 6; ++i) {
+            q.try_emplace(i);
+        }
+        Tracked out;
+        q.try_pop(out);
+        assert(out.value == 0 && g_live == 6);
+    }
+    /// 析构时队列中剩余的元素也要析构
+    assert(g_live == 0);
+    std::cout << "test_object_lifetime passed\n";
+}
+
+/// 构造函数可能抛异常，移动是 noexcept
+struct ThrowOnNegative {
+    int value;
+
+    ThrowOnNegative(int v = 0) : value(v) {
+        if (v < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+
+    ThrowOnNegative(ThrowOnNegative &&) noexcept = default;
+
+    ThrowOnNegative &operator=(ThrowOnNegative &&) noexcept = default;
+};
+
+void test_throwing_constructor() {
+    my::mpmc_queue<ThrowOnNegative> q(2);
+    assert(q.try_emplace(1));
+    bool thrown = false;
+    try {
+        q.try_emplace(-1);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    /// 抛出时没有占住任何位置，之后的入队出队照常进行
+    assert(thrown && q.size_approx() == 1);
+    assert(q.try_emplace(2) && !q.try_emplace(3));
+    ThrowOnNegative out;
+    assert(q.try_pop(out) && out.value == 1);
+    assert(q.try_pop(out) && out.value == 2);
+    assert(!q.try_pop(out));
+
+    /// 阻塞接口同样先构造再等待
+    my::mpmc_queue<ThrowOnNegative, true> b(2);
+    thrown = false;
+    try {
+        b.emplace(-1);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    b.emplace(4);
+    b.pop(out);
+    assert(thrown && out.value == 4 && b.empty_approx());
+    std::cout << "test_throwing_constructor passed\n";
+}
+
+int main() {
+    test_single_thread();
+    test_multi_thread();
+    test_blocking();
+    test_object_lifetime();
+    test_throwing_constructor();
+    return 0;
+}
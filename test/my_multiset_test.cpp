@@ -8,8 +8,31 @@
 #include "my_multiset.h"
 #include <vector>
 #include <iostream>
+#include <cassert>
+
+/// 排行榜：按名次取分数、求某个分数的名次都是 O(log n)
+void test_order_statistic_multiset() {
+    my::order_statistic_multiset<int> scores;
+    for (int s : {70, 90, 85, 70, 100, 60, 85, 85}) {
+        scores.insert(s);
+    }
+    /// 60 70 70 85 85 85 90 100
+    assert(*scores.select(0) == 60 && *scores.select(3) == 85 && *scores.select(7) == 100);
+    assert(scores.select(8) == scores.end());
+    assert(scores.rank(85) == 3 && scores.rank(86) == 6 && scores.rank(0) == 0 && scores.rank(101) == 8);
+    assert(scores.rank(scores.find(90)) == 6 && scores.count(85) == 3);
+
+    /// 中位数（下中位数）
+    assert(*scores.select((scores.size() - 1) / 2) == 85);
+
+    scores.erase(85);
+    assert(scores.size() == 5 && scores.rank(90) == 3 && *scores.select(3) == 90);
+    std::cout << "order statistic multiset passed\n";
+}
 
 int main() {
+    test_order_statistic_multiset();
+
     my::multiset<int> ms;
 
     ms.insert(5);
@@ -6,10 +6,41 @@
  */
 
 #include "my_queue.h"
+#include <cassert>
 #include <iostream>
+#include <vector>
+
+/// 批量入队 / 出队，每批 64 到 4096 个
+void test_push_range_pop_n() {
+    my::queue<int> que;
+    int next = 0;
+    int expect = 0;
+    for (size_t batch : {64, 4096, 1000, 64, 3000}) {
+        std::vector<int> in;
+        for (size_t i = 0; i < batch; ++i) {
+            in.push_back(next++);
+        }
+        que.push_range(in.begin(), in.end());
+        que.push_range(std::vector<int>{next, next + 1});
+        next += 2;
+        std::vector<int> out(batch / 2);
+        auto end = que.pop_n(out.size(), out.begin());
+        assert(end == out.end());
+        for (int v : out) {
+            assert(v == expect++);
+        }
+    }
+    assert(que.size() == static_cast<size_t>(next - expect));
+    assert(que.front() == expect && que.back() == next - 1);
+    std::vector<int> rest;
+    que.pop_n(que.size(), std::back_inserter(rest));
+    assert(que.empty() && rest.size() == static_cast<size_t>(next - expect) && rest.front() == expect);
+    std::cout << "test_push_range_pop_n passed\n";
+}
 
 int main()
 {
+    test_push_range_pop_n();
     my::queue<int> que;
     for (int i = 1; i <= 5; i++) {
         que.push(i);
@@ -8,7 +8,12 @@
 #include <iostream>
 #include "my_rbtree_map.h"
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 void test_map_like_rb_tree() {
     std::cout << "==== 测试 InsertUnique（模拟 map） ====\n";
@@ -71,10 +76,195 @@ void test_multimap_like_rb_tree() {
     }
 }
 
+void test_insert_sorted_rb_tree() {
+    std::cout << "\n==== 测试 InsertSorted（有序输入批量构建） ====\n";
+
+    for (int n = 0; n <= 200; ++n) {
+        std::vector<std::pair<int, int>> kvs;
+        for (int i = 0; i < n; ++i) {
+            kvs.emplace_back(i, i * i);
+        }
+        my::RBTree<int, int> tree;
+        assert(tree.InsertSorted(kvs.begin(), kvs.end(), true) == static_cast<size_t>(n));
+        assert(tree.Size() == static_cast<size_t>(n) && tree.IsValidRBTree());
+        int expect = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it, ++expect) {
+            assert(it->first == expect && it->second == expect * expect);
+        }
+
+        /// 空树一遍建树
+        my::RBTree<int, int> built;
+        assert(built.BuildSorted(kvs.begin(), kvs.end(), true) == static_cast<size_t>(n));
+        assert(built.Size() == static_cast<size_t>(n) && built.IsValidRBTree());
+        expect = 0;
+        for (auto it = built.begin(); it != built.end(); ++it, ++expect) {
+            assert(it->first == expect && it->second == expect * expect);
+        }
+    }
+
+    /// 归并到已有元素中：重复 key 保留原值
+    my::RBTree<int, std::string> tree;
+    for (int i = 0; i < 100; i += 3) {
+        tree.InsertUnique({i, "old"});
+    }
+    std::vector<std::pair<int, std::string>> more;
+    for (int i = 0; i < 100; i += 2) {
+        more.emplace_back(i, "new");
+    }
+    size_t inserted = tree.InsertSorted(more.begin(), more.end(), true);
+    assert(inserted == 50 - 17);    /// 6 的倍数已经存在
+    assert(tree.IsValidRBTree() && tree.Size() == 34 + 33);
+    assert(tree.Find(6)->second == "old" && tree.Find(4)->second == "new");
+
+    /// 可重复：新元素排在已有的等价 key 之后
+    my::RBTree<int, std::string> multi;
+    multi.InsertMulti({1, "a"});
+    multi.InsertMulti({2, "a"});
+    std::vector<std::pair<int, std::string>> dup = {{1, "b"}, {1, "c"}, {3, "b"}};
+    multi.InsertSorted(dup.begin(), dup.end(), false);
+    assert(multi.IsValidRBTree() && multi.Count(1) == 3);
+    auto it = multi.begin();
+    assert(it->second == "a" && (++it)->second == "b" && (++it)->second == "c");
+
+    /// 往大树里补少量元素（m * log2(n) < n）逐个带提示插入，补大量元素归并重建：
+    /// 两条路的结果都和 std::map / std::multimap 一致，等价 key 的新元素都排在已有元素之后
+    std::mt19937 rng(3);
+    for (size_t m : {size_t(8), size_t(3000)}) {
+        my::RBTree<int, int> uniq, equal;
+        std::map<int, int> uniqRef;
+        std::multimap<int, int> equalRef;
+        for (int i = 0; i < 4096; ++i) {
+            uniq.InsertUnique({i * 2, -1});
+            equal.InsertMulti({i * 2, -1});
+            uniqRef.insert({i * 2, -1});
+            equalRef.insert({i * 2, -1});
+        }
+        std::vector<int> keys;
+        for (size_t i = 0; i < m; ++i) {
+            keys.push_back(static_cast<int>(rng() % 8300) - 50);
+        }
+        keys.push_back(keys.front());
+        std::sort(keys.begin(), keys.end());
+        std::vector<std::pair<int, int>> batch;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            batch.emplace_back(keys[i], static_cast<int>(i));
+        }
+        size_t expectInserted = 0;
+        for (auto &kv: batch) {
+            expectInserted += uniqRef.insert(kv).second;
+            equalRef.insert(kv);
+        }
+        assert(uniq.InsertSorted(batch.begin(), batch.end(), true) == expectInserted);
+        assert(equal.InsertSorted(batch.begin(), batch.end(), false) == batch.size());
+        assert(uniq.IsValidRBTree() && uniq.Size() == uniqRef.size());
+        assert(equal.IsValidRBTree() && equal.Size() == equalRef.size());
+        auto u = uniqRef.begin();
+        for (auto &kv: uniq) {
+            assert(kv.first == u->first && kv.second == u->second);
+            ++u;
+        }
+        auto e = equalRef.begin();
+        for (auto &kv: equal) {
+            assert(kv.first == e->first && kv.second == e->second);
+            ++e;
+        }
+    }
+    std::cout << "insert sorted passed\n";
+}
+
+/// 各种大小和拆分位置：拆开后两棵树都合法、元素个数正确，再接回去和原来一样
+/// 不维护子树大小时 Split 数较小的一侧得到个数，维护时直接读根，两种树都要测
+template<class Tree>
+void check_split_join_sizes() {
+    for (int n = 0; n < 200; n += 7) {
+        for (int at = -1; at <= n + 1; at += 3) {
+            Tree tree;
+            for (int i = 0; i < n; ++i) {
+                tree.InsertUnique({i * 2, i});
+            }
+            Tree upper;
+            upper.InsertUnique({-5, 0});        /// 拆分会先清空 upper
+            tree.Split(at * 2, upper);
+            assert(tree.IsValidRBTree() && upper.IsValidRBTree());
+            int lowCount = std::max(0, std::min(at, n));
+            assert(tree.Size() == static_cast<size_t>(lowCount));
+            assert(upper.Size() == static_cast<size_t>(n - lowCount));
+            assert(upper.Empty() || upper.begin()->first == lowCount * 2);
+            tree.Join(upper, true);
+            assert(tree.IsValidRBTree() && upper.Empty() && tree.Size() == static_cast<size_t>(n));
+            int expect = 0;
+            for (auto &kv: tree) {
+                assert(kv.first == expect * 2 && kv.second == expect);
+                ++expect;
+            }
+        }
+    }
+}
+
+void test_split_join_rb_tree() {
+    check_split_join_sizes<my::RBTree<int, int>>();
+    check_split_join_sizes<my::RBTree<int, int, std::less<int>, MyAlloc<std::pair<const int, int>>, RBTreeSizeAugment>>();
+
+    /// 黑高相差很大的两棵树合并，other 在前面时也是 O(log n)
+    my::RBTree<int, int> big, small;
+    for (int i = 0; i < 5000; ++i) {
+        big.InsertUnique({i + 100, i});
+    }
+    for (int i = 0; i < 3; ++i) {
+        small.InsertUnique({i, i});
+    }
+    big.Join(small, true);
+    assert(big.IsValidRBTree() && big.Size() == 5003 && big.begin()->first == 0);
+
+    /// 范围重叠时退化成 Merge：已存在的 key 留在 other 中
+    my::RBTree<int, int> a, b;
+    a.InsertUnique({1, 1});
+    a.InsertUnique({5, 5});
+    b.InsertUnique({3, 3});
+    b.InsertUnique({5, 50});
+    a.Join(b, true);
+    assert(a.IsValidRBTree() && a.Size() == 3 && b.Size() == 1 && b.begin()->second == 50);
+    std::cout << "split and join passed\n";
+}
+
+void test_erase_range_rb_tree() {
+    std::mt19937 rng(11);
+    for (int round = 0; round < 300; ++round) {
+        my::RBTree<int, int> tree;
+        std::multimap<int, int> ref;
+        int n = static_cast<int>(rng() % 300);
+        for (int i = 0; i < n; ++i) {
+            int key = static_cast<int>(rng() % 100);
+            tree.InsertMulti({key, i});
+            ref.insert({key, i});
+        }
+        size_t from = n ? rng() % (n + 1) : 0;
+        size_t to = from + (n ? rng() % (n - from + 1) : 0);
+        auto first = tree.begin();
+        auto refFirst = ref.begin();
+        for (size_t i = 0; i < from; ++i, ++first, ++refFirst) {}
+        auto last = first;
+        auto refLast = refFirst;
+        for (size_t i = from; i < to; ++i, ++last, ++refLast) {}
+        auto next = tree.Erase(first, last);
+        ref.erase(refFirst, refLast);
+        assert(next == last && tree.IsValidRBTree() && tree.Size() == ref.size());
+        auto r = ref.begin();
+        for (auto &kv: tree) {
+            assert(kv.first == r->first && kv.second == r->second);
+            ++r;
+        }
+    }
+    std::cout << "erase range passed\n";
+}
+
 int main() {
     system("chcp 65001");
     test_map_like_rb_tree();
     test_multimap_like_rb_tree();
+    test_insert_sorted_rb_tree();
+    test_split_join_rb_tree();
+    test_erase_range_rb_tree();
     return 0;
 }
 
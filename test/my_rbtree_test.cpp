@@ -7,7 +7,11 @@
 
 #include "my_rbtree.h"
 #include <iostream>
+#include <set>
 #include <vector>
+#include <cassert>
+#include <algorithm>
+#include <random>
 
 void TestInsertAndTraverse()
 {
@@ -43,9 +47,276 @@ void TestInsertAndTraverse()
               << std::endl;
 }
 
+void TestEraseKeepsBalance()
+{
+    RBTree<int> tree;
+    std::vector<int> values;
+    for (int i = 0; i < 2000; ++i)
+        values.push_back(i % 500);   // 每个值出现 4 次
+    std::mt19937 rng(42);
+    std::shuffle(values.begin(), values.end(), rng);
+    for (int val : values)
+        tree.Insert(val);
+
+    // 按随机顺序删除一半的值，每次删除后都检查红黑性质
+    std::vector<int> keys;
+    for (int i = 0; i < 500; ++i)
+        keys.push_back(i);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (int i = 0; i < 250; ++i)
+    {
+        assert(tree.Erase(keys[i]) == 4);
+        assert(tree.IsValidRBTree());
+    }
+
+    // 剩余元素仍然有序，且 begin()/--end() 分别是最小/最大值
+    int prev = -1;
+    size_t n = 0;
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++n)
+    {
+        assert(prev <= *it);
+        prev = *it;
+    }
+    assert(n == 1000);
+    auto last = tree.end();
+    --last;
+    assert(*last == prev);
+
+    // 摘下节点再挂回另一棵树，节点地址不变
+    RBTree<int> other;
+    auto it = tree.Find(keys[300]);
+    int *addr = &*it;
+    auto node = tree.Extract(it);
+    assert(&*other.InsertNode(node) == addr);
+    assert(tree.IsValidRBTree() && other.IsValidRBTree());
+
+    while (tree.begin() != tree.end())
+        tree.Erase(tree.begin());
+    assert(tree.IsValidRBTree());
+    std::cout << "[Erase] erase tests passed" << std::endl;
+}
+
+void TestUniqueAndHintInsert()
+{
+    RBTree<int> tree;
+    std::set<int> ref;
+    std::mt19937 rng(7);
+
+    // 唯一插入：返回的迭代器来自下降本身，重复值不插入
+    for (int i = 0; i < 3000; ++i)
+    {
+        int val = static_cast<int>(rng() % 1000);
+        auto res = tree.InsertUnique(val);
+        assert(*res.first == val);
+        assert(res.second == ref.insert(val).second);
+    }
+    assert(tree.IsValidRBTree());
+
+    // 随机提示：无论提示对不对，结果都和普通插入一致
+    for (int i = 0; i < 3000; ++i)
+    {
+        int val = static_cast<int>(rng() % 2000);
+        auto hint = tree.Find(static_cast<int>(rng() % 2000));
+        auto res = tree.InsertUniqueHint(hint, val);
+        assert(*res.first == val);
+        assert(res.second == ref.insert(val).second);
+    }
+    assert(tree.IsValidRBTree());
+    auto rit = ref.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++rit)
+        assert(*it == *rit);
+    assert(rit == ref.end());
+
+    // 有序追加：用 end() 作提示，最小/最大值随插入 O(1) 更新
+    RBTree<int> sorted;
+    for (int i = 0; i < 1000; ++i)
+    {
+        sorted.InsertUniqueHint(sorted.end(), i);
+        assert(*sorted.begin() == 0);
+        auto last = sorted.end();
+        --last;
+        assert(*last == i);
+    }
+    assert(sorted.IsValidRBTree());
+
+    // 可重复插入的提示：等价元素插在 hint 之前
+    RBTree<int> multi;
+    for (int i = 0; i < 10; ++i)
+        multi.Insert(i);
+    auto five = multi.Find(5);
+    auto pos = multi.EmplaceMultiHint(five, 5);
+    ++pos;
+    assert(pos == five);
+    assert(multi.IsValidRBTree());
+    cout << "unique/hint insert passed" << endl;
+}
+
+void TestInsertSorted()
+{
+    // 每种大小都能直接建成合法的红黑树
+    for (int n = 0; n <= 300; ++n)
+    {
+        std::vector<int> values;
+        for (int i = 0; i < n; ++i)
+            values.push_back(i * 2);
+        RBTree<int> tree;
+        assert(tree.InsertSorted(values.begin(), values.end(), true, 0) == static_cast<size_t>(n));
+        assert(tree.IsValidRBTree());
+        int expect = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it, expect += 2)
+            assert(*it == expect);
+        assert(expect == n * 2);
+        if (n > 0)
+        {
+            auto last = tree.end();
+            --last;
+            assert(*last == (n - 1) * 2);
+        }
+        // 重建之后仍然可以正常插入和删除
+        tree.Insert(1);
+        tree.Erase(0);
+        assert(tree.IsValidRBTree());
+    }
+
+    // 与现有元素归并：跳过等价元素，现有节点的地址不变
+    RBTree<int> tree;
+    std::set<int> ref;
+    std::mt19937 rng(5);
+    for (int i = 0; i < 500; ++i)
+    {
+        int val = static_cast<int>(rng() % 2000);
+        tree.InsertUnique(val);
+        ref.insert(val);
+    }
+    int *addr = &*tree.begin();
+    int addrVal = *addr;
+    std::vector<int> sorted;
+    for (int i = 0; i < 1000; ++i)
+        sorted.push_back(static_cast<int>(rng() % 2000));
+    std::sort(sorted.begin(), sorted.end());
+    size_t before = ref.size();
+    size_t expectInserted = 0;
+    for (int val : sorted)
+        expectInserted += ref.insert(val).second;
+    assert(tree.InsertSorted(sorted.begin(), sorted.end(), true, before) == expectInserted);
+    assert(tree.IsValidRBTree());
+    assert(&*tree.Find(addrVal) == addr);
+    auto rit = ref.begin();
+    for (auto it = tree.begin(); it != tree.end(); ++it, ++rit)
+        assert(*it == *rit);
+    assert(rit == ref.end());
+
+    // 可重复：等价元素全部保留
+    RBTree<int> multi;
+    std::vector<int> dup = {1, 1, 2, 3, 3, 3};
+    multi.InsertSorted(dup.begin(), dup.end(), false, 0);
+    multi.InsertSorted(dup.begin(), dup.end(), false, dup.size());
+    assert(multi.Count(3) == 6 && multi.Count(1) == 4 && multi.IsValidRBTree());
+
+    // 往大树里补少量元素（m * log2(n) < n）走逐个带提示插入，补大量元素走归并重建，两条路的结果都和 std 一致
+    for (size_t m : {size_t(8), size_t(3000)})
+    {
+        RBTree<int> big, bigMulti;
+        std::set<int> bigRef;
+        std::multiset<int> bigMultiRef;
+        for (int i = 0; i < 4096; ++i)
+        {
+            big.InsertUnique(i * 2);
+            bigMulti.Insert(i * 2);
+            bigRef.insert(i * 2);
+            bigMultiRef.insert(i * 2);
+        }
+        std::vector<int> batch;
+        for (size_t i = 0; i < m; ++i)
+            batch.push_back(static_cast<int>(rng() % 8300) - 50);   // 有比最小值还小、比最大值还大的，也有重复的
+        batch.push_back(batch.front());
+        std::sort(batch.begin(), batch.end());
+        size_t inserted = 0;
+        for (int val : batch)
+            inserted += bigRef.insert(val).second;
+        bigMultiRef.insert(batch.begin(), batch.end());
+        assert(big.InsertSorted(batch.begin(), batch.end(), true, 4096) == inserted);
+        assert(bigMulti.InsertSorted(batch.begin(), batch.end(), false, 4096) == batch.size());
+        assert(big.IsValidRBTree() && bigMulti.IsValidRBTree());
+        assert(std::equal(bigRef.begin(), bigRef.end(), big.begin()));
+        assert(std::equal(bigMultiRef.begin(), bigMultiRef.end(), bigMulti.begin()));
+    }
+    cout << "insert sorted passed" << endl;
+}
+
+// 维护子树大小的红黑树：插入、删除、摘下再挂回、批量建树、拷贝之后，Select / Rank 都与有序数组一致
+void TestOrderStatistic()
+{
+    typedef RBTree<int, std::less<int>, MyAlloc<int>, RBTreeSizeAugment> OSTree;
+    OSTree tree;
+    std::multiset<int> ref;
+    std::mt19937 rng(7);
+    auto check = [&](OSTree &t) {
+        assert(t.IsValidRBTree());
+        std::vector<int> sorted(ref.begin(), ref.end());
+        for (size_t k = 0; k < sorted.size(); ++k)
+        {
+            auto it = t.Select(k);
+            assert(*it == sorted[k] && t.Rank(it) == k);
+        }
+        assert(t.Select(sorted.size()) == t.end() && t.Rank(t.end()) == sorted.size());
+        for (int key = -1; key <= 201; key += 3)
+        {
+            size_t less = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+            assert(t.Rank(key) == less && t.Count(key) == ref.count(key));
+        }
+    };
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        int val = static_cast<int>(rng() % 200);
+        if (rng() % 3 != 0 || ref.empty())
+        {
+            if (round % 2)
+                tree.Insert(val);
+            else
+                tree.EmplaceMultiHint(tree.Select(rng() % (ref.size() + 1)), val);
+            ref.insert(val);
+        }
+        else
+        {
+            assert(tree.Erase(val) == ref.erase(val));
+        }
+        if (round % 200 == 0)
+            check(tree);
+    }
+    check(tree);
+
+    // 摘下的节点挂到另一棵树后子树大小重新计算
+    OSTree other;
+    auto node = tree.Extract(tree.Select(0));
+    ref.erase(ref.begin());
+    other.InsertNode(node);
+    assert(other.Select(0) != other.end() && other.Select(1) == other.end() && other.Rank(node->_val + 1) == 1);
+    check(tree);
+
+    OSTree copy(tree);
+    check(copy);
+
+    std::vector<int> more = {0, 50, 50, 199};
+    tree.InsertSorted(more.begin(), more.end(), false, ref.size());
+    ref.insert(more.begin(), more.end());
+    check(tree);
+
+    OSTree built;
+    std::vector<int> sorted(ref.begin(), ref.end());
+    built.BuildSorted(sorted.begin(), sorted.end(), false);
+    check(built);
+    cout << "order statistic passed" << endl;
+}
+
 int main()
 {
     TestInsertAndTraverse();
+    TestEraseKeepsBalance();
+    TestUniqueAndHintInsert();
+    TestInsertSorted();
+    TestOrderStatistic();
     /// [Insert] insert element:10 5 20 3 7 15 30 1 6 8
     /// [Inorder Traverse] thr result of inorder:1 3 5 6 7 8 10 15 20 30
     /// [Reverse Traverse] reverse : 30 20 15 10 8 7 6 5 3 1
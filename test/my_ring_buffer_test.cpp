@@ -0,0 +1,311 @@
+/**
+ * @file      my_ring_buffer_test.cpp
+ * @brief     [测试ring_buffer / circular_buffer：绕回、两种满时策略、as_spans / free_spans、不传播的分配器与 set_capacity 的异常安全、作为 queue 的底层容器]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_ring_buffer.h"
+#include "my_queue.h"
+
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    int g_live = 0;
+}
+
+/// 统计存活对象个数，检查构造和析构是否成对
+struct Tracked {
+    int value;
+
+    Tracked(int v) : value(v) { ++g_live; }
+
+    Tracked(const Tracked &other) : value(other.value) { ++g_live; }
+
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++g_live; }
+
+    Tracked &operator=(const Tracked &) = default;
+
+    Tracked &operator=(Tracked &&) = default;
+
+    ~Tracked() { --g_live; }
+};
+
+/// 随机 push / pop 与 std::deque 对照，计数一直递增，槽位反复绕回
+template<typename Ring>
+void check_against_std(Ring &ring, size_t capacity) {
+    std::mt19937 rng(44);
+    std::deque<int> expect;
+    for (int round = 0; round < 20000; ++round) {
+        if (rng() % 3 != 0) {
+            int v = static_cast<int>(rng() % 1000);
+            bool pushed = ring.push_back(v);
+            if (expect.size() < capacity) {
+                assert(pushed);
+                expect.push_back(v);
+            } else if constexpr (Ring::overflow_policy == my::ring_overflow::overwrite) {
+                assert(pushed);
+                expect.pop_front();
+                expect.push_back(v);
+            } else {
+                assert(!pushed);
+            }
+        } else if (!expect.empty()) {
+            assert(ring.front() == expect.front());
+            if (rng() % 2) {
+                ring.pop_front();
+                expect.pop_front();
+            } else {
+                assert(ring.back() == expect.back());
+                ring.pop_back();
+                expect.pop_back();
+            }
+        }
+        assert(ring.size() == expect.size());
+        assert(ring.full() == (expect.size() == capacity));
+        if (round % 97 == 0) {
+            assert(std::equal(expect.begin(), expect.end(), ring.begin(), ring.end()));
+            for (size_t i = 0; i < expect.size(); ++i) {
+                assert(ring[i] == expect[i]);
+            }
+        }
+    }
+}
+
+void test_ring_buffer_policies() {
+    my::ring_buffer<int, 16> reject;
+    check_against_std(reject, 16);
+    /// 容量不是 2 的幂：槽位数取 8，逻辑容量仍然是 5
+    my::ring_buffer<int, 5, my::ring_overflow::overwrite> overwrite;
+    check_against_std(overwrite, 5);
+    my::circular_buffer<int> runtime(100);
+    check_against_std(runtime, 100);
+    my::circular_buffer<int, std::allocator<int>, my::ring_overflow::overwrite> runtimeOverwrite(7);
+    check_against_std(runtimeOverwrite, 7);
+    std::cout << "test_ring_buffer_policies passed\n";
+}
+
+void test_spans() {
+    my::ring_buffer<int, 8> ring;
+    for (int i = 0; i < 6; ++i) {
+        ring.push_back(i);
+    }
+    ring.consume(4);
+    for (int i = 6; i < 12; ++i) {
+        ring.push_back(i);
+    }
+    /// 计数 4..11 对应槽位 4..7, 0..3
+    auto [first, second] = ring.as_spans();
+    assert(first.size() == 4 && second.size() == 4);
+    assert(first[0] == 4 && first[3] == 7 && second[0] == 8 && second[3] == 11);
+    assert(first.data() + 4 == second.data() + 8);
+
+    /// 读出一部分，再直接写进空闲空间
+    std::vector<int> out;
+    ring.pop_front_n(5, std::back_inserter(out));
+    assert((out == std::vector<int>{4, 5, 6, 7, 8}));
+    auto [free1, free2] = ring.free_spans();
+    assert(free1.size() + free2.size() == 5);
+    int next = 12;
+    for (int &slot : free1) {
+        slot = next++;
+    }
+    for (int &slot : free2) {
+        slot = next++;
+    }
+    ring.commit(free1.size() + free2.size());
+    assert(ring.full());
+    for (size_t i = 0; i < ring.size(); ++i) {
+        assert(ring[i] == static_cast<int>(9 + i));
+    }
+
+    const auto &cring = ring;
+    auto [c1, c2] = cring.as_spans();
+    assert(c1.size() + c2.size() == 8);
+    std::cout << "test_spans passed\n";
+}
+
+void test_object_lifetime() {
+    {
+        my::ring_buffer<Tracked, 4, my::ring_overflow::overwrite> ring;
+        for (int i = 0; i < 10; ++i) {
+            ring.emplace_back(i);
+        }
+        assert(g_live == 4 && ring.front().value == 6);
+        my::ring_buffer<Tracked, 4, my::ring_overflow::overwrite> copy(ring);
+        assert(g_live == 8 && copy.back().value == 9);
+        my::ring_buffer<Tracked, 4, my::ring_overflow::overwrite> other;
+        other.emplace_back(100);
+        other.swap(copy);
+        assert(other.size() == 4 && copy.size() == 1 && copy.front().value == 100);
+
+        my::circular_buffer<Tracked> circ(3);
+        circ.emplace_back(1);
+        circ.emplace_back(2);
+        circ.emplace_back(3);
+        assert(!circ.emplace_back(4));
+        circ.set_capacity(2);
+        assert(circ.size() == 2 && circ.front().value == 2 && circ.capacity() == 2);
+        circ.set_capacity(10);
+        assert(circ.push_back(Tracked(5)) && circ.size() == 3);
+        my::circular_buffer<Tracked> moved(std::move(circ));
+        assert(moved.size() == 3 && circ.size() == 0 && circ.capacity() == 0);
+        my::circular_buffer<Tracked> assigned;
+        assigned = moved;
+        assert(assigned.size() == 3 && assigned.back().value == 5);
+        std::vector<Tracked> out;
+        assigned.pop_front_n(2, std::back_inserter(out));
+        assert(out[0].value == 2 && out[1].value == 3 && assigned.size() == 1);
+    }
+    assert(g_live == 0);
+    std::cout << "test_object_lifetime passed\n";
+}
+
+void test_overwrite_self_reference() {
+    /// 满了之后 push_back(front())：参数引用的正是要被丢掉的队头
+    my::ring_buffer<std::string, 4, my::ring_overflow::overwrite> rb;
+    for (int i = 0; i < 4; ++i) {
+        rb.push_back(std::string(40, static_cast<char>('a' + i)));     /// 超过 SSO，析构后内容一定失效
+    }
+    const std::string oldFront = rb.front();
+    assert(rb.push_back(rb.front()));
+    assert(rb.size() == 4 && rb.back() == oldFront && rb.front() == std::string(40, 'b'));
+    assert(rb.emplace_back(rb.front()));
+    assert(rb.back() == std::string(40, 'b') && rb.front() == std::string(40, 'c'));
+    std::cout << "test_overwrite_self_reference passed\n";
+}
+
+/// 每个分配器对象对应一个 arena，数组必须由分配它的 arena 释放；不传播（allocator_traits 的默认值）
+struct arena {
+    int live = 0;
+};
+
+template<typename T>
+struct arena_alloc {
+    using value_type = T;
+
+    arena *owner;
+
+    explicit arena_alloc(arena *a) : owner(a) {}
+
+    template<typename U>
+    arena_alloc(const arena_alloc<U> &other) : owner(other.owner) {}
+
+    T *allocate(size_t n) {
+        ++owner->live;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, size_t n) {
+        assert(owner->live > 0 && "freed through an allocator that did not allocate it");
+        --owner->live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const arena_alloc &other) const { return owner == other.owner; }
+};
+
+/// 可以让拷贝和移动抛异常
+struct FlakyCopy {
+    static inline bool fail = false;
+    std::string value;
+
+    FlakyCopy(std::string v) : value(std::move(v)) {}
+
+    FlakyCopy(const FlakyCopy &other) : value(other.value) {
+        if (fail) throw std::runtime_error("copy");
+    }
+
+    FlakyCopy(FlakyCopy &&other) : value(std::move(other.value)) {
+        if (fail) throw std::runtime_error("move");
+    }
+};
+
+void test_allocator_and_strong_resize() {
+    arena a, b;
+    {
+        using buffer = my::circular_buffer<int, arena_alloc<int>>;
+        buffer x(8, arena_alloc<int>(&a));
+        buffer y(4, arena_alloc<int>(&b));
+        for (int i = 0; i < 4; ++i) {
+            x.push_back(i);
+            y.push_back(10 + i);
+        }
+        /// 分配器不相等且不传播：拷贝和移动赋值都逐个搬元素，数组留在各自的 arena
+        x = y;
+        assert(x.size() == 4 && x.front() == 10 && x.get_allocator().owner == &a);
+        y.push_back(99);
+        x = std::move(y);
+        assert(x.size() == 4 && x.back() == 13 && x.get_allocator().owner == &a);
+        x.set_capacity(2);
+        assert(x.size() == 2 && x.front() == 12 && a.live == 1 && b.live == 1);
+    }
+    assert(a.live == 0 && b.live == 0);
+
+    /// 移动会抛异常的类型：set_capacity 中途失败时原来的元素一个不少
+    my::circular_buffer<FlakyCopy> flaky(4);
+    for (int i = 0; i < 4; ++i) {
+        flaky.emplace_back(std::to_string(i) + " long enough to live on the heap");
+    }
+    FlakyCopy::fail = true;
+    bool thrown = false;
+    try {
+        flaky.set_capacity(2);
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    FlakyCopy::fail = false;
+    assert(thrown && flaky.size() == 4 && flaky.capacity() == 4);
+    assert(flaky.front().value == "0 long enough to live on the heap" && flaky.back().value[0] == '3');
+    flaky.set_capacity(2);
+    assert(flaky.size() == 2 && flaky.front().value[0] == '2');
+    std::cout << "test_allocator_and_strong_resize passed\n";
+}
+
+void test_as_queue_sequence() {
+    my::queue<std::string, my::ring_buffer<std::string, 64>> q;
+    for (int i = 0; i < 10; ++i) {
+        q.push(std::to_string(i));
+    }
+    assert(q.size() == 10 && q.front() == "0" && q.back() == "9");
+    q.pop();
+    assert(q.front() == "1");
+
+    my::queue<int, my::circular_buffer<int>> bounded(my::circular_buffer<int>(1024));
+    std::vector<int> batch(600);
+    for (int i = 0; i < 600; ++i) {
+        batch[i] = i;
+    }
+    bounded.push_range(batch.begin(), batch.end());
+    bounded.push_range(batch);      /// 只放得下 424 个
+    assert(bounded.size() == 1024 && bounded.back() == 423);
+    std::vector<int> out(700);
+    bounded.pop_n(out.size(), out.begin());
+    assert(out[0] == 0 && out[599] == 599 && out[600] == 0 && out[699] == 99);
+    assert(bounded.size() == 324 && bounded.front() == 100);
+
+    /// reject 策略下 push 把是否成功交给调用方
+    my::queue<int, my::ring_buffer<int, 2>> rejecting;
+    assert(rejecting.push(1) && rejecting.push(2));
+    assert(!rejecting.push(3) && !rejecting.emplace_back(4));
+    assert(rejecting.size() == 2 && rejecting.back() == 2);
+    std::cout << "test_as_queue_sequence passed\n";
+}
+
+int main() {
+    test_ring_buffer_policies();
+    test_spans();
+    test_object_lifetime();
+    test_overwrite_self_reference();
+    test_allocator_and_strong_resize();
+    test_as_queue_sequence();
+    return 0;
+}
@@ -7,6 +7,96 @@
 
 #include "my_set.h"
 #include <vector>
+#include <cassert>
+#include <string>
+
+void test_set_node_ops() {
+    my::set<int> a;
+    my::set<int> b;
+    for (int i = 0; i < 10; ++i) a.insert(i);
+    b.insert(3);
+
+    int *addr = &*a.find(5);
+    auto nh = a.extract(5);
+    assert(!nh.empty() && nh.value() == 5 && a.size() == 9);
+    auto res = b.insert(std::move(nh));
+    assert(res.inserted && &*res.position == addr);
+
+    auto res2 = b.insert(a.extract(3));     /// 3 已存在，节点留在返回值中
+    assert(!res2.inserted && res2.node.value() == 3);
+
+    b.merge(a);
+    assert(a.size() == 0 && b.size() == 10);
+    /// 已有的元素留在 source 中，转移过来的节点地址不变
+    my::set<int> c;
+    for (int v : {1, 2, 20}) c.insert(v);
+    int *addr20 = &*c.find(20);
+    b.merge(c);
+    assert(c.size() == 2 && *c.begin() == 1 && b.size() == 11 && &*b.find(20) == addr20);
+    b.erase(20);
+    assert(b.erase(7) == 1 && b.count(7) == 0 && b.size() == 9);
+    std::cout << "set node ops passed\n";
+}
+
+/// 自定义比较器：按绝对值排序
+struct AbsLess {
+    bool operator()(int a, int b) const {
+        return (a < 0 ? -a : a) < (b < 0 ? -b : b);
+    }
+};
+
+void test_set_compare_and_copy() {
+    my::set<int, AbsLess> s;
+    for (int v : {3, -1, -4, 1, 5, -9, 2}) {
+        s.insert(v);
+    }
+    assert(s.size() == 6);      /// 1 和 -1 等价
+    std::vector<int> order;
+    for (int v : s) order.push_back(v);
+    assert((order == std::vector<int>{-1, 2, 3, -4, 5, -9}));
+    assert(s.count(-3) == 1 && s.find(9) != s.end());
+
+    my::set<int, AbsLess> copy(s);
+    copy.erase(3);
+    assert(s.count(3) == 1 && copy.count(3) == 0);
+    copy.clear();
+    assert(copy.empty() && copy.begin() == copy.end());
+    copy.swap(s);
+    assert(copy.size() == 6 && s.empty());
+
+    my::set<std::string, std::less<>> names;
+    names.insert("bob");
+    names.insert("alice");
+    assert(names.contains("alice") && *names.lower_bound("b") == "bob");
+    std::cout << "set compare/copy passed\n";
+}
+
+void test_set_hint_insert() {
+    my::set<int> s;
+    for (int i = 0; i < 1000; ++i) {
+        auto it = s.insert(s.end(), i);
+        assert(*it == i);
+    }
+    assert(s.size() == 1000);
+    assert(*s.insert(s.begin(), 500) == 500 && s.size() == 1000);
+    assert(s.emplace(1000).second && !s.emplace(1000).second && s.size() == 1001);
+    assert(*s.emplace_hint(s.begin(), -1) == -1 && *s.begin() == -1);
+    int expect = -1;
+    for (int v : s) assert(v == expect++);
+    std::cout << "set hint insert passed\n";
+}
+
+void test_set_sorted_construction() {
+    std::vector<int> sorted;
+    for (int i = 0; i < 1000; ++i) sorted.push_back(i);
+    my::set<int> s(my::sorted_unique, sorted.begin(), sorted.end());
+    assert(s.size() == 1000 && *s.begin() == 0 && s.contains(999));
+
+    std::vector<int> more = {-5, 0, 500, 1000, 1000, 2000};
+    s.insert_sorted(more.begin(), more.end());
+    assert(s.size() == 1003 && *s.begin() == -5 && s.contains(2000));
+    std::cout << "set sorted construction passed\n";
+}
 
 int main() {
     my::set<int> s;
@@ -27,5 +117,10 @@ int main() {
     if (it != s.end()) std::cout << *it << '\n';
 
     std::cout << "set size: " << s.size() << '\n';
+
+    test_set_node_ops();
+    test_set_compare_and_copy();
+    test_set_hint_insert();
+    test_set_sorted_construction();
 }
 
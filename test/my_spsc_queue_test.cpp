@@ -0,0 +1,215 @@
+/**
+ * @file      my_spsc_queue_test.cpp
+ * @brief     [测试spsc_queue：单线程语义和绕回、批量操作、两个线程之间按顺序传递、阻塞模式、对象生命周期]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_spsc_queue.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    int g_live = 0;
+}
+
+/// 统计存活对象个数，检查构造和析构是否成对
+struct Tracked {
+    int value;
+
+    Tracked(int v = 0) : value(v) { ++g_live; }
+
+    Tracked(const Tracked &other) : value(other.value) { ++g_live; }
+
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++g_live; }
+
+    Tracked &operator=(const Tracked &) = default;
+
+    Tracked &operator=(Tracked &&) = default;
+
+    ~Tracked() { --g_live; }
+};
+
+void test_single_thread() {
+    /// 容量 5，内部 8 个槽位
+    my::spsc_queue<int> q(5);
+    assert(q.capacity() == 5 && q.empty_approx());
+    int out = -1;
+    assert(!q.try_pop(out) && q.front() == nullptr);
+    int next = 0;
+    int expect = 0;
+    /// 反复填满再取一部分，下标一直递增，槽位多次绕回
+    for (int round = 0; round < 1000; ++round) {
+        while (q.try_push(next)) {
+            ++next;
+        }
+        assert(q.size_approx() == 5);
+        for (int k = 0; k < round % 5 + 1; ++k) {
+            assert(*q.front() == expect);
+            assert(q.try_pop(out) && out == expect++);
+        }
+    }
+    while (q.try_pop(out)) {
+        assert(out == expect++);
+    }
+    assert(expect == next);
+
+    my::spsc_queue<std::string> s(2);
+    assert(s.try_emplace(3, 'a'));
+    assert(s.try_push(std::string("bb")));
+    assert(!s.try_push(std::string("cc")));
+    assert(*s.front() == "aaa");
+    s.pop_front();
+    assert(*s.front() == "bb");
+    std::cout << "test_single_thread passed\n";
+}
+
+void test_batch() {
+    my::spsc_queue<int> q(10);
+    std::vector<int> in(25);
+    for (int i = 0; i < 25; ++i) {
+        in[i] = i;
+    }
+    assert(q.try_push_n(in.begin(), 25) == 10);
+    assert(q.try_push_n(in.begin(), 1) == 0);
+    std::vector<int> out;
+    assert(q.try_pop_n(std::back_inserter(out), 4) == 4);
+    assert(q.try_push_n(in.begin() + 10, 15) == 4);
+    assert(q.try_pop_n(std::back_inserter(out), 100) == 10);
+    assert(q.try_pop_n(std::back_inserter(out), 100) == 0);
+    assert(out.size() == 14);
+    for (int i = 0; i < 14; ++i) {
+        assert(out[i] == i);
+    }
+
+    /// 单遍输入迭代器
+    std::istringstream text("1 2 3");
+    assert(q.try_push_n(std::istream_iterator<int>(text), 3) == 3);
+    int v = 0;
+    assert(q.try_pop(v) && v == 1);
+    std::cout << "test_batch passed\n";
+}
+
+/// 生产者和消费者各一个线程，消费者看到的顺序必须和入队顺序一致
+template<typename Queue>
+void transfer_in_order(Queue &q, int count, bool batch) {
+    std::thread producer([&] {
+        if (batch) {
+            int buf[32];
+            int next = 0;
+            while (next < count) {
+                int n = 0;
+                while (n < 32 && next + n < count) {
+                    buf[n] = next + n;
+                    ++n;
+                }
+                int pushed = static_cast<int>(q.try_push_n(buf, static_cast<size_t>(n)));
+                next += pushed;
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            for (int i = 0; i < count; ++i) {
+                while (!q.try_push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+    int expect = 0;
+    int buf[17];
+    while (expect < count) {
+        size_t got = batch ? q.try_pop_n(buf, 17) : q.try_pop(buf[0]);
+        if (got == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < got; ++i) {
+            assert(buf[i] == expect++);
+        }
+    }
+    producer.join();
+    assert(q.empty_approx());
+}
+
+void test_two_threads() {
+    my::spsc_queue<int> q(64);
+    transfer_in_order(q, 200000, false);
+    transfer_in_order(q, 200000, true);
+    std::cout << "test_two_threads passed\n";
+}
+
+/// 阻塞模式：队列很小，双方频繁地等待空间 / 等待数据并进入 futex 睡眠
+void test_blocking() {
+    my::spsc_queue<std::string, true> q(4);
+    const int count = 50000;
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            q.push(std::to_string(i));
+        }
+        std::vector<std::string> tail;
+        for (int i = count; i < count + 100; ++i) {
+            tail.push_back(std::to_string(i));
+        }
+        q.push_n(tail.begin(), tail.size());
+    });
+    std::string s;
+    for (int i = 0; i < count; ++i) {
+        q.pop(s);
+        assert(s == std::to_string(i));
+    }
+    std::vector<std::string> rest;
+    while (rest.size() < 100) {
+        q.pop_n(std::back_inserter(rest), 100 - rest.size());
+    }
+    producer.join();
+    for (int i = 0; i < 100; ++i) {
+        assert(rest[i] == std::to_string(count + i));
+    }
+
+    /// 消费者先睡，生产者晚一些才入队
+    my::spsc_queue<int, true> late(1);
+    std::thread sleeper([&] {
+        int v = 0;
+        late.pop(v);
+        assert(v == 42);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    late.push(42);
+    sleeper.join();
+    std::cout << "test_blocking passed\n";
+}
+
+void test_object_lifetime() {
+    {
+        my::spsc_queue<Tracked> q(7);
+        for (int i = 0; i < 5; ++i) {
+            q.try_emplace(i);
+        }
+        Tracked out;
+        q.try_pop(out);
+        assert(out.value == 0 && g_live == 5);
+        std::vector<Tracked> batch(3, Tracked(9));
+        assert(q.try_push_n(batch.begin(), 3) == 3);
+        assert(g_live == 1 + 7 + 3);
+    }
+    /// 析构时队列中剩余的元素也要析构
+    assert(g_live == 0);
+    std::cout << "test_object_lifetime passed\n";
+}
+
+int main() {
+    test_single_thread();
+    test_batch();
+    test_two_threads();
+    test_blocking();
+    test_object_lifetime();
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file      my_static_search_index_test.cpp
+ * @brief     [测试static_search_index：与 std::lower_bound / std::upper_bound 逐个对照]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_static_search_index.h"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/// 各种大小（包括满二叉树和最深一层只有一个节点的情况），每个可能的查找位置都对照
+void test_against_std_all_sizes() {
+    for (int n = 0; n <= 300; ++n) {
+        my::vector<int> sorted;
+        for (int i = 0; i < n; ++i) {
+            sorted.push_back(i * 2);
+        }
+        my::static_search_index<int> index(sorted);
+        assert(index.size() == static_cast<size_t>(n));
+        for (int key = -1; key <= 2 * n + 1; ++key) {
+            size_t lb = std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+            size_t ub = std::upper_bound(sorted.begin(), sorted.end(), key) - sorted.begin();
+            assert(index.lower_bound(key) == lb);
+            assert(index.upper_bound(key) == ub);
+            const int *found = index.find(key);
+            assert((found != nullptr) == (key % 2 == 0 && key >= 0 && key < 2 * n));
+            assert(!found || *found == key);
+        }
+    }
+    std::cout << "test_against_std_all_sizes passed\n";
+}
+
+void test_duplicates_and_batch() {
+    std::mt19937 rng(3);
+    std::vector<int> values(5000);
+    for (auto &v: values) {
+        v = static_cast<int>(rng() % 700);
+    }
+    std::sort(values.begin(), values.end());
+    my::static_search_index<int> index(values.begin(), values.end());
+
+    std::vector<int> queries(1237);
+    for (auto &q: queries) {
+        q = static_cast<int>(rng() % 720) - 10;
+    }
+    std::vector<size_t> lbs(queries.size());
+    std::vector<size_t> ubs(queries.size());
+    assert(index.lower_bound(queries.begin(), queries.end(), lbs.begin()) == lbs.end());
+    index.upper_bound(queries.begin(), queries.end(), ubs.begin());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        auto range = std::equal_range(values.begin(), values.end(), queries[i]);
+        assert(lbs[i] == static_cast<size_t>(range.first - values.begin()));
+        assert(ubs[i] == static_cast<size_t>(range.second - values.begin()));
+        assert(index.equal_range(queries[i]) == std::make_pair(lbs[i], ubs[i]));
+    }
+
+    /// 拷贝和移动之后结果不变
+    my::static_search_index<int> copy(index);
+    my::static_search_index<int> moved(std::move(index));
+    assert(index.empty() && copy.lower_bound(350) == moved.lower_bound(350));
+
+    my::static_search_index<int> empty;
+    std::vector<size_t> out(3);
+    std::vector<int> some = {1, 2, 3};
+    empty.lower_bound(some.begin(), some.end(), out.begin());
+    assert(out[0] == 0 && empty.upper_bound(5) == 0 && !empty.contains(1));
+    std::cout << "test_duplicates_and_batch passed\n";
+}
+
+/// 自定义比较器（降序）和非算术 key
+void test_custom_compare() {
+    my::vector<int> desc = {9, 7, 7, 5, 1};
+    my::static_search_index<int, std::greater<int>> index(desc);
+    assert(index.lower_bound(7) == 1 && index.upper_bound(7) == 3 && index.lower_bound(0) == 5);
+
+    std::vector<std::string> words = {"apple", "banana", "cherry", "date"};
+    my::static_search_index<std::string> wordIndex(words.begin(), words.end());
+    assert(wordIndex.lower_bound("c") == 2 && wordIndex.contains("date") && !wordIndex.contains("fig"));
+    std::cout << "test_custom_compare passed\n";
+}
+
+int main() {
+    test_against_std_all_sizes();
+    test_duplicates_and_batch();
+    test_custom_compare();
+    return 0;
+}
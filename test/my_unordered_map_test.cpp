@@ -6,6 +6,7 @@
  */
 
 #include "my_unordered_map.h"
+#include "my_unordered_multimap.h"
 #include "my_string.h"
 
 #include <cassert>
@@ -70,12 +71,174 @@ void test_swap_and_clear() {
     std::cout << "test_swap_and_clear success.\n";
 }
 
+/// 统计拷贝/移动次数的键类型
+struct CountedKey {
+    static int copies;
+    static int moves;
+    int id;
+
+    explicit CountedKey(int i) : id(i) {}
+
+    CountedKey(const CountedKey &other) : id(other.id) { ++copies; }
+
+    CountedKey(CountedKey &&other) noexcept : id(other.id) { ++moves; }
+
+    bool operator==(const CountedKey &other) const { return id == other.id; }
+};
+
+int CountedKey::copies = 0;
+int CountedKey::moves = 0;
+
+struct CountedKeyHash {
+    size_t operator()(const CountedKey &k) const { return std::hash<int>()(k.id); }
+};
+
+void test_emplace_and_try_emplace() {
+    my::unordered_map<int, std::string> map;
+    auto [it1, ok1] = map.emplace(1, "one");
+    assert(ok1 && it1->second == "one");
+    auto [it2, ok2] = map.emplace(1, "uno");
+    assert(!ok2 && it2->second == "one");
+
+    std::string value = "two";
+    assert(map.try_emplace(2, std::move(value)).second);
+    assert(value.empty());
+
+    /// key 已存在时 try_emplace 不会移动参数
+    std::string other = "deux";
+    assert(!map.try_emplace(2, std::move(other)).second);
+    assert(other == "deux");
+    assert(map.find(2)->second == "two");
+
+    auto [it3, ok3] = map.insert_or_assign(2, "TWO");
+    assert(!ok3 && it3->second == "TWO");
+    assert(map.insert_or_assign(3, "three").second);
+
+    auto hinted = map.try_emplace(map.cbegin(), 4, "four");
+    assert(hinted->first == 4);
+    assert(map.emplace_hint(map.cbegin(), 5, "five")->second == "five");
+    assert(map.insert(map.cbegin(), std::pair<const int, std::string>(6, "six"))->second == "six");
+    assert(map.size() == 6);
+    std::cout << "test_emplace_and_try_emplace success.\n";
+}
+
+void test_no_key_copy_on_lookup() {
+    my::unordered_map<CountedKey, int, CountedKeyHash> map;
+    CountedKey k(7);
+
+    CountedKey::copies = CountedKey::moves = 0;
+    map[k] = 1;                         /// 新 key：只拷贝一次进节点
+    assert(CountedKey::copies == 1 && CountedKey::moves == 0);
+
+    CountedKey::copies = CountedKey::moves = 0;
+    map[k] += 1;                        /// 已有 key：不构造任何 key
+    map.try_emplace(k, 100);
+    map.insert_or_assign(k, 5);
+    assert(CountedKey::copies == 0 && CountedKey::moves == 0);
+    assert(map[k] == 5);
+
+    CountedKey::copies = CountedKey::moves = 0;
+    map[CountedKey(8)] = 8;             /// 右值 key：直接移动进节点
+    assert(CountedKey::copies == 0 && CountedKey::moves == 1);
+
+    CountedKey::copies = CountedKey::moves = 0;
+    map.insert(std::pair<const CountedKey, int>(CountedKey(8), 0));   /// 已存在：不会创建节点
+    assert(CountedKey::copies == 0);
+    assert(map.size() == 2);
+    std::cout << "test_no_key_copy_on_lookup success.\n";
+}
+
+void test_transparent_lookup() {
+    my::unordered_map<my::string, int, my::string_hash, my::string_equal> m;
+    m.insert({my::string("alpha"), 1});
+    m.insert({my::string("beta"), 2});
+
+    /// string_hash / string_equal 声明了 is_transparent，可以直接用 const char* 和 string_view 查找
+    assert(m.find("alpha")->second == 1);
+    assert(m.find(std::string_view("beta"))->second == 2);
+    assert(m.find("gamma") == m.end());
+    assert(m.contains("beta"));
+    assert(m.count("alpha") == 1);
+    assert(m.count("gamma") == 0);
+
+    const auto &cm = m;
+    assert(cm.find("alpha") != cm.end());
+
+    std::cout << "test_transparent_lookup passed\n";
+}
+
+void test_extract_insert_merge() {
+    my::unordered_map<int, std::string> a;
+    my::unordered_map<int, std::string> b;
+    for (int i = 0; i < 100; ++i) {
+        a[i] = std::to_string(i);
+    }
+
+    /// extract + insert：节点地址不变，说明没有重新分配
+    const std::string *addr = &a.find(42)->second;
+    auto nh = a.extract(42);
+    assert(!nh.empty() && nh.key() == 42 && nh.mapped() == "42");
+    assert(a.size() == 99 && a.find(42) == a.end());
+    auto res = b.insert(std::move(nh));
+    assert(res.inserted && nh.empty());
+    assert(&res.position->second == addr);
+
+    /// 修改 key 后再插回
+    auto nh2 = b.extract(b.find(42));
+    nh2.key() = 1000;
+    a.insert(std::move(nh2));
+    assert(a.find(1000)->second == "42");
+
+    /// key 已存在：节点留在返回值中
+    b[7] = "seven";
+    auto res2 = b.insert(a.extract(7));
+    assert(!res2.inserted && res2.node.key() == 7 && res2.position->second == "seven");
+
+    /// 不存在的 key 返回空句柄
+    assert(a.extract(12345).empty());
+
+    /// merge：已存在的 key（7）留在 source 中
+    b.merge(a);
+    assert(b.size() == 100);
+    assert(a.size() == 0);
+    for (int i = 0; i < 100; ++i) {
+        if (i != 42) {
+            assert(b.contains(i));
+        }
+    }
+    b[3] = "x";
+    my::unordered_map<int, std::string> c;
+    c[3] = "c3";
+    c[500] = "c500";
+    b.merge(c);
+    assert(c.size() == 1 && c.contains(3) && b.find(500)->second == "c500");
+
+    /// 与 unordered_multimap 互相 merge：unique 一侧每个 key 只接收一个节点
+    my::unordered_multimap<int, std::string> mm;
+    mm.insert({600, "a"});
+    mm.insert({600, "b"});
+    mm.insert({3, "dup"});
+    b.merge(mm);
+    assert(b.contains(600) && mm.size() == 2 && mm.count(600) == 1 && mm.count(3) == 1);
+    mm.merge(b);
+    assert(b.size() == 0 && mm.count(600) == 2 && mm.count(3) == 2);
+    my::unordered_map<int, std::string> tmp;
+    tmp[700] = "x";
+    b.merge(std::move(tmp));
+    assert(b.size() == 1 && b.contains(700));
+    std::cout << "test_extract_insert_merge success.\n";
+}
+
 int main() {
     test_basic_insert_and_find();
     test_operator_indexing();
     test_erase_and_size();
     test_at_and_exception();
     test_swap_and_clear();
+    test_emplace_and_try_emplace();
+    test_no_key_copy_on_lookup();
+    test_transparent_lookup();
+    test_extract_insert_merge();
 
     std::cout << "all test passed.\n";
     /**
@@ -54,6 +54,15 @@ int main() {
     assert(ms3.count(42) == 1);
     assert(ms2.count(100) == 1);
 
+    // 右值插入、emplace 与带提示插入
+    int v = 7;
+    ms.insert(my::move(v));
+    ms.emplace(7);
+    ms.emplace_hint(ms.end(), 7);
+    ms.insert(ms.end(), 8);
+    assert(ms.count(7) == 3);
+    assert(ms.count(8) == 1);
+
     std::cout << "All tests passed.\n";
     return 0;
 }
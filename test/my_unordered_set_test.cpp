@@ -5,8 +5,10 @@
  * @version   1.0
  */
 #include "my_unordered_set.h"
+#include "my_unordered_multiset.h"
 #include <iostream>
 #include <vector>
+#include <string>
 #include <cassert>
 
 void test_unordered_set() {
@@ -95,9 +97,58 @@ void test_unordered_set_unique_insert()
     std::cout << "All test_unordered_set_unique_insert tests passed." << std::endl;
 }
 
+void test_unordered_set_move_and_emplace()
+{
+    my::unordered_set<std::string> uset;
+    std::string s = "hello";
+    assert(uset.insert(std::move(s)).second);
+    assert(s.empty());
+
+    /// 已存在时右值不会被移动
+    std::string dup = "hello";
+    assert(!uset.insert(std::move(dup)).second);
+    assert(dup == "hello");
+
+    auto [it, ok] = uset.emplace(3, 'x');
+    assert(ok && *it == "xxx");
+    assert(*uset.emplace_hint(uset.cbegin(), "world") == "world");
+    assert(*uset.insert(uset.cbegin(), std::string("hint")) == "hint");
+    assert(uset.size() == 4);
+
+    std::cout << "All test_unordered_set_move_and_emplace tests passed." << std::endl;
+}
+
+void test_unordered_set_node_ops() {
+    my::unordered_set<std::string> a;
+    my::unordered_set<std::string> b;
+    a.insert("x");
+    a.insert("y");
+    a.insert("z");
+    b.insert("y");
+
+    auto nh = a.extract("x");
+    assert(nh && nh.value() == "x" && a.size() == 2);
+    auto res = b.insert(std::move(nh));
+    assert(res.inserted && *res.position == "x");
+
+    b.merge(a);     /// "y" 重复，留在 a 中
+    assert(b.size() == 3 && a.size() == 1 && a.contains("y"));
+
+    my::unordered_multiset<std::string> ms;
+    ms.insert("w");
+    ms.insert("w");
+    b.merge(ms);    /// 第二个 "w" 留在 ms 中
+    assert(b.size() == 4 && ms.size() == 1);
+    ms.merge(b);
+    assert(b.size() == 0 && ms.size() == 5 && ms.count("w") == 2);
+    std::cout << "test_unordered_set_node_ops passed" << std::endl;
+}
+
 int main() {
     test_unordered_set_unique_insert();
     test_unordered_set();
+    test_unordered_set_move_and_emplace();
+    test_unordered_set_node_ops();
 
 
     return 0;
@@ -0,0 +1,301 @@
+/**
+ * @file      my_unrolled_list_test.cpp
+ * @brief     [测试unrolled_list：随机插入删除与 std::list 对照（节点分裂与合并）、双向迭代、整节点 splice、拷贝移动交换、对象生命周期]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_unrolled_list.h"
+
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    int g_live = 0;
+}
+
+/// 统计存活对象个数，检查构造和析构是否成对
+struct Tracked {
+    int value;
+
+    Tracked(int v = 0) : value(v) { ++g_live; }
+
+    Tracked(const Tracked &other) : value(other.value) { ++g_live; }
+
+    Tracked(Tracked &&other) noexcept : value(other.value) { ++g_live; }
+
+    Tracked &operator=(const Tracked &) = default;
+
+    Tracked &operator=(Tracked &&) = default;
+
+    ~Tracked() { --g_live; }
+
+    bool operator==(const Tracked &other) const { return value == other.value; }
+};
+
+template<typename List, typename Expect>
+void check_same(const List &lst, const Expect &expect) {
+    assert(lst.size() == expect.size());
+    assert(std::equal(expect.begin(), expect.end(), lst.begin(), lst.end()));
+    /// 反向遍历
+    auto it = lst.end();
+    for (auto e = expect.rbegin(); e != expect.rend(); ++e) {
+        --it;
+        assert(*it == *e);
+    }
+    assert(it == lst.begin());
+}
+
+/// 每个节点只有 4 个元素，随机位置的插入和删除会频繁地分裂和合并节点
+template<typename T, typename Make>
+void test_against_std(Make make) {
+    std::mt19937 rng(49);
+    my::unrolled_list<T, 4> lst;
+    std::list<T> expect;
+    for (int round = 0; round < 20000; ++round) {
+        size_t size = expect.size();
+        switch (rng() % 6) {
+            case 0:
+            case 1: {
+                size_t pos = rng() % (size + 1);
+                T value = make(static_cast<int>(rng() % 1000));
+                auto it = lst.insert(std::next(lst.begin(), pos), value);
+                expect.insert(std::next(expect.begin(), pos), value);
+                assert(*it == value && std::distance(lst.begin(), it) == static_cast<ptrdiff_t>(pos));
+                break;
+            }
+            case 2: {
+                if (size == 0) {
+                    break;
+                }
+                size_t pos = rng() % size;
+                auto it = lst.erase(std::next(lst.begin(), pos));
+                auto eit = expect.erase(std::next(expect.begin(), pos));
+                assert(std::distance(lst.begin(), it) == static_cast<ptrdiff_t>(pos));
+                assert((it == lst.end()) == (eit == expect.end()));
+                break;
+            }
+            case 3: {
+                T value = make(round);
+                if (rng() % 2) {
+                    lst.push_back(value);
+                    expect.push_back(value);
+                } else {
+                    lst.push_front(value);
+                    expect.push_front(value);
+                }
+                break;
+            }
+            case 4: {
+                if (size == 0) {
+                    break;
+                }
+                assert(lst.front() == expect.front() && lst.back() == expect.back());
+                if (rng() % 2) {
+                    lst.pop_back();
+                    expect.pop_back();
+                } else {
+                    lst.pop_front();
+                    expect.pop_front();
+                }
+                break;
+            }
+            default: {
+                /// 区间插入和区间删除
+                size_t pos = rng() % (size + 1);
+                std::vector<T> batch;
+                for (int i = 0; i < static_cast<int>(rng() % 9); ++i) {
+                    batch.push_back(make(i));
+                }
+                auto it = lst.insert(std::next(lst.begin(), pos), batch.begin(), batch.end());
+                expect.insert(std::next(expect.begin(), pos), batch.begin(), batch.end());
+                assert(std::distance(lst.begin(), it) == static_cast<ptrdiff_t>(pos));
+                size_t first = rng() % (expect.size() + 1);
+                size_t count = rng() % (expect.size() - first + 1) / 2;
+                lst.erase(std::next(lst.begin(), first), std::next(lst.begin(), first + count));
+                expect.erase(std::next(expect.begin(), first), std::next(expect.begin(), first + count));
+                break;
+            }
+        }
+        if (round % 64 == 0) {
+            check_same(lst, expect);
+            /// 不变式：没有空节点
+            assert(lst.node_count() <= lst.size());
+        }
+    }
+    check_same(lst, expect);
+    std::cout << "test_against_std passed\n";
+}
+
+/// 顺序追加时节点被填满；大量删除之后节点会合并，平均占用率不低于半满（首尾节点除外）
+void test_density() {
+    my::unrolled_list<int, 16> lst;
+    for (int i = 0; i < 1600; ++i) {
+        lst.push_back(i);
+    }
+    assert(lst.node_count() == 100);
+    /// 删除偶数
+    for (auto it = lst.begin(); it != lst.end();) {
+        if (*it % 2 == 0) {
+            it = lst.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    assert(lst.size() == 800 && lst.node_count() <= 100);
+    int expect = 1;
+    for (int v : lst) {
+        assert(v == expect);
+        expect += 2;
+    }
+    size_t before = lst.node_count();
+    size_t released = lst.compact();
+    assert(lst.node_count() == 50 && released == before - 50);
+    assert(lst.front() == 1 && lst.back() == 1599);
+    std::cout << "test_density passed\n";
+}
+
+void test_splice() {
+    using List = my::unrolled_list<int, 4>;
+    List a{1, 2, 3, 4, 5, 6, 7, 8};
+    List b{10, 20, 30};
+    /// 插入点在节点中间：先分裂再挂上整串节点
+    a.splice(std::next(a.cbegin(), 2), b);
+    assert(b.empty() && b.node_count() == 0);
+    assert((a == List{1, 2, 10, 20, 30, 3, 4, 5, 6, 7, 8}));
+
+    /// 整个节点移动：5 所在节点是 {5, 6, 7, 8}
+    List c;
+    auto moved = c.splice_node(c.cend(), a, std::next(a.cbegin(), 7));
+    assert(*moved == 5 && c.size() == 4 && c.node_count() == 1);
+    assert((c == List{5, 6, 7, 8}));
+    assert((a == List{1, 2, 10, 20, 30, 3, 4}) && a.size() == 7);
+
+    /// 同一个链表内把末节点移到开头
+    c.splice(c.cend(), a);
+    auto last = std::prev(c.cend());
+    c.splice_node(c.cbegin(), c, last);
+    assert(c.front() == 3 && c.back() == 30 && c.size() == 11);
+    std::cout << "test_splice passed\n";
+}
+
+void test_copy_move_swap() {
+    using List = my::unrolled_list<std::string, 3>;
+    List a;
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(std::to_string(i));
+    }
+    List copy(a);
+    assert(copy == a);
+    List moved(std::move(copy));
+    assert(copy.empty() && moved == a);
+    List empty;
+    empty.swap(moved);
+    assert(moved.empty() && empty == a);
+    /// 交换之后两边都还能正常修改和遍历
+    moved.push_back("x");
+    empty.push_front("y");
+    assert(moved.size() == 1 && empty.front() == "y" && empty.size() == 11);
+    List assigned;
+    assigned = empty;
+    assigned = std::move(moved);
+    assert(assigned.size() == 1 && assigned.front() == "x");
+
+    std::istringstream in("4 5 6");
+    my::unrolled_list<int, 2> fromInput{std::istream_iterator<int>(in), std::istream_iterator<int>()};
+    assert(fromInput.size() == 3 && fromInput.back() == 6);
+    const auto &cref = fromInput;
+    int sum = 0;
+    for (auto it = cref.cbegin(); it != cref.cend(); ++it) {
+        sum += *it;
+    }
+    assert(sum == 15);
+    std::cout << "test_copy_move_swap passed\n";
+}
+
+void test_object_lifetime() {
+    {
+        my::unrolled_list<Tracked, 4> lst;
+        for (int i = 0; i < 50; ++i) {
+            lst.emplace(lst.cbegin(), i);
+        }
+        assert(g_live == 50);
+        for (int i = 0; i < 20; ++i) {
+            lst.erase(std::next(lst.cbegin(), i));
+        }
+        assert(g_live == 30);
+        lst.resize(40, Tracked(7));
+        assert(g_live == 40);
+        my::unrolled_list<Tracked, 4> other(lst);
+        other.splice(other.cbegin(), lst);
+        assert(g_live == 80 && lst.empty());
+        other.compact();
+        assert(g_live == 80);
+    }
+    assert(g_live == 0);
+    std::cout << "test_object_lifetime passed\n";
+}
+
+/// 构造函数可能抛异常
+struct ThrowOnNegative {
+    int value;
+
+    ThrowOnNegative(int v) : value(v) {
+        if (v < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+
+    bool operator==(const ThrowOnNegative &other) const { return value == other.value; }
+};
+
+void test_exception_and_aliasing() {
+    my::unrolled_list<ThrowOnNegative, 4> lst;
+    for (int i = 0; i < 4; ++i) {
+        lst.emplace_back(i);
+    }
+    /// 需要新节点时构造抛异常：新节点不能留在链表里
+    int thrown = 0;
+    try {
+        lst.emplace_back(-1);
+    } catch (const std::runtime_error &) {
+        ++thrown;
+    }
+    try {
+        lst.emplace(lst.cend(), -1);
+    } catch (const std::runtime_error &) {
+        ++thrown;
+    }
+    assert(thrown == 2 && lst.node_count() == 1);
+    check_same(lst, std::vector<ThrowOnNegative>{0, 1, 2, 3});
+    lst.emplace_back(4);
+    assert(lst.node_count() == 2 && lst.back().value == 4);
+
+    /// 满节点插入时参数引用着将要被分裂搬走的后一半
+    const std::string suffix = " long enough to live on the heap";
+    my::unrolled_list<std::string, 4> strs;
+    for (int i = 0; i < 4; ++i) {
+        strs.push_back(std::to_string(i) + suffix);
+    }
+    strs.insert(std::next(strs.cbegin()), *std::next(strs.cbegin(), 3));
+    check_same(strs, std::vector<std::string>{"0" + suffix, "3" + suffix, "1" + suffix, "2" + suffix, "3" + suffix});
+    std::cout << "test_exception_and_aliasing passed\n";
+}
+
+int main() {
+    test_against_std<int>([](int v) { return v; });
+    test_against_std<std::string>([](int v) { return std::to_string(v) + " with a suffix long enough to allocate"; });
+    test_density();
+    test_splice();
+    test_copy_move_swap();
+    test_object_lifetime();
+    test_exception_and_aliasing();
+    return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file      my_ws_deque_test.cpp
+ * @brief     [测试ws_deque：所有者后进先出、窃取者先进先出、增长；并发压力测试检查每个元素恰好被取走一次]
+ * @author    Weijh
+ * @version   1.0
+ */
+
+#include "my_ws_deque.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+void test_single_thread() {
+    my::ws_deque<int> d(2);
+    assert(d.empty_approx() && !d.pop().has_value() && !d.steal().has_value());
+    for (int i = 0; i < 100; ++i) {
+        d.push(i);
+    }
+    assert(d.size_approx() == 100 && d.capacity() == 128);
+    /// 顶部先进先出，底部后进先出
+    assert(*d.steal() == 0);
+    assert(*d.steal() == 1);
+    assert(*d.pop() == 99);
+    assert(*d.pop() == 98);
+    int expectTop = 2;
+    int expectBottom = 97;
+    while (expectTop <= expectBottom) {
+        if (expectTop % 2) {
+            assert(*d.steal() == expectTop++);
+        } else {
+            assert(*d.pop() == expectBottom--);
+        }
+    }
+    assert(!d.pop().has_value() && !d.steal().has_value());
+
+    /// 下标一直前进，槽位反复绕回，中间穿插增长
+    int next = 0;
+    int stolen = 0;
+    for (int round = 0; round < 1000; ++round) {
+        for (int k = 0; k < round % 7 + 1; ++k) {
+            d.push(next++);
+        }
+        for (int k = 0; k < round % 5; ++k) {
+            auto v = d.steal();
+            if (v.has_value()) {
+                assert(*v == stolen++);
+            }
+        }
+    }
+    while (d.steal().has_value()) {
+        ++stolen;
+    }
+    assert(stolen == next);
+    std::cout << "test_single_thread passed\n";
+}
+
+/// 所有者一边 push 一边偶尔 pop，几个窃取者不停地 steal；每个值必须恰好被取走一次
+template<typename T, typename Make, typename Index>
+void stress(size_t initialCapacity, int thieves, int count, Make make, Index index) {
+    my::ws_deque<T> d(initialCapacity);
+    std::vector<std::atomic<int>> taken(count);
+    std::atomic<bool> done(false);
+    std::atomic<int> stolenTotal(0);
+    std::vector<std::thread> threads;
+    for (int k = 0; k < thieves; ++k) {
+        threads.emplace_back([&] {
+            int local = 0;
+            while (!done.load(std::memory_order_acquire) || !d.empty_approx()) {
+                auto v = d.steal();
+                if (v.has_value()) {
+                    taken[index(*v)].fetch_add(1, std::memory_order_relaxed);
+                    ++local;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            stolenTotal.fetch_add(local);
+        });
+    }
+    int popped = 0;
+    for (int i = 0; i < count; ++i) {
+        d.push(make(i));
+        /// 经常把队列弹到只剩一两个元素，制造所有者和窃取者争抢最后一个元素的情况
+        if (i % 3 == 0) {
+            while (d.size_approx() > 1) {
+                auto v = d.pop();
+                if (!v.has_value()) {
+                    break;
+                }
+                taken[index(*v)].fetch_add(1, std::memory_order_relaxed);
+                ++popped;
+            }
+        }
+        if (i % 1000 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    while (true) {
+        auto v = d.pop();
+        if (!v.has_value()) {
+            break;
+        }
+        taken[index(*v)].fetch_add(1, std::memory_order_relaxed);
+        ++popped;
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (auto &c : taken) {
+        assert(c.load() == 1);
+    }
+    assert(popped + stolenTotal.load() == count);
+}
+
+void test_stress() {
+    auto identity = [](int i) { return i; };
+    stress<int>(2, 3, 200000, identity, identity);
+    stress<int>(1024, 1, 200000, identity, identity);
+    /// 任务指针
+    std::vector<int> tasks(100000);
+    for (int i = 0; i < 100000; ++i) {
+        tasks[i] = i;
+    }
+    stress<int *>(4, 4, 100000, [&](int i) { return &tasks[i]; }, [](int *p) { return *p; });
+    std::cout << "test_stress passed\n";
+}
+
+/// 只有所有者push，窃取者把队列从空窃取到空，反复经过“空 -> 一个元素 -> 空”
+void test_steal_only_empty_edges() {
+    my::ws_deque<int> d(8);
+    const int count = 100000;
+    std::atomic<long long> sum(0);
+    std::atomic<int> got(0);
+    std::vector<std::thread> thieves;
+    for (int k = 0; k < 2; ++k) {
+        thieves.emplace_back([&] {
+            long long local = 0;
+            while (got.load(std::memory_order_relaxed) < count) {
+                auto v = d.steal();
+                if (v.has_value()) {
+                    local += *v;
+                    got.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(local);
+        });
+    }
+    for (int i = 1; i <= count; ++i) {
+        d.push(i);
+        if (i % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto &t : thieves) {
+        t.join();
+    }
+    assert(sum.load() == static_cast<long long>(count) * (count + 1) / 2);
+    std::cout << "test_steal_only_empty_edges passed\n";
+}
+
+int main() {
+    test_single_thread();
+    test_stress();
+    test_steal_only_empty_edges();
+    return 0;
+}